@@ -1,8 +1,14 @@
 ﻿#pragma once
 
+#include "EventDispatcher.hpp"
+#include "FrameLimiter.hpp"
 #include "Window.hpp"
 #include "Timer.hpp"
 #include "IRenderer.hpp"
+#include "JobSystem.hpp"
+#include "StartupGraph.hpp"
+#include "metrics/Metrics.hpp"
+#include "metrics/MetricsServer.hpp"
 
 namespace Zenyth {
 
@@ -11,6 +17,10 @@ namespace Zenyth {
 		uint32_t     width = 1280;
 		uint32_t     height = 720;
 		bool         resizable = true;
+		uint32_t     workerThreads = 0; // 0 = hardware_concurrency - 1, at least 1
+		double       frameRateLimit = 0.0; // frames per second, 0 = unlimited
+		FramePacing  framePacing = FramePacing::Smooth;
+		std::string  metricsEndpoint;     // empty = no metrics server, see MetricsServerDesc::endpoint
 	};
 
 	class Application {
@@ -28,11 +38,29 @@ namespace Zenyth {
 		void Run();
 		void Stop() { m_running = false; }
 
-		[[nodiscard]] Window& GetWindow() const { return *m_window; }
+		// Opens another window, pumped by the frame loop next to the main one until it is closed.
+		// Its events reach OnEvent() like the main window's; tell them apart by Event::window.
+		Window& OpenWindow(const WindowDesc& desc);
+
+		// Created during Run() by the "window" startup task; startup tasks that use it must depend on
+		// "window". Throws when called before it exists.
+		[[nodiscard]] Window& GetWindow() const;
 		[[nodiscard]] Timer& GetTimer() const { return *m_timer; }
 		[[nodiscard]] IRenderer* GetRenderer() const { return m_renderer.get(); }
+		[[nodiscard]] JobSystem& GetJobSystem() const { return *m_jobs; }
+		[[nodiscard]] FrameLimiter& GetFrameLimiter() const { return *m_frameLimiter; }
+		// Listeners see window events before OnEvent(), which only runs for unconsumed events
+		[[nodiscard]] EventDispatcher& GetEvents() { return m_events; }
+		// Engine metrics are registered up front; add your own before Run() or from OnInit().
+		// Only published when AppDesc::metricsEndpoint is set.
+		[[nodiscard]] MetricsRegistry& GetMetrics() { return m_metrics; }
+		// Null until Run(); holds per-subsystem startup timings afterwards
+		[[nodiscard]] const StartupGraph* GetStartup() const { return m_startup.get(); }
 
 	protected:
+		// Adds subsystems to startup before anything is initialized. Tasks may depend on the built-in
+		// "window", "renderer.device" and "renderer" tasks; OnInit() runs after every non-deferred one.
+		virtual void OnConfigureStartup(StartupGraph& startup) {}
 		virtual void OnInit() {}
 		virtual void OnShutdown() {}
 		virtual void OnUpdate(float dt) = 0;
@@ -40,11 +68,24 @@ namespace Zenyth {
 		virtual void OnEvent(const Event& e);
 
 	private:
+		void Startup();
+		void PumpWindows();
 		void OnWindowEvent(const Event& e);
+		void RegisterMetrics();
+
+		std::unique_ptr<Window>              m_window;
+		std::vector<std::unique_ptr<Window>> m_extraWindows;
+		std::unique_ptr<Timer>               m_timer;
+		std::unique_ptr<IRenderer>           m_renderer;
+		std::unique_ptr<JobSystem>           m_jobs;
+		std::unique_ptr<FrameLimiter>        m_frameLimiter;
+		std::unique_ptr<StartupGraph>        m_startup; // after m_jobs: deferred tasks still run on it
+		EventDispatcher                      m_events;
 
-		std::unique_ptr<Window>    m_window;
-		std::unique_ptr<Timer>     m_timer;
-		std::unique_ptr<IRenderer> m_renderer;
+		MetricsRegistry                      m_metrics;
+		Counter*                             m_framesMetric = nullptr;
+		Histogram*                           m_frameTimeMetric = nullptr;
+		std::unique_ptr<MetricsServer>       m_metricsServer; // after what its readers use, so it stops first
 
 		bool     m_running = false;
 		AppDesc  m_desc;
@@ -0,0 +1,22 @@
+#pragma once
+
+// Compiles a single function for AVX2 + FMA so it can sit next to baseline SSE code and be
+// selected at runtime with GetCpuFeatures(). MSVC emits AVX2 intrinsics without a target switch.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ZENYTH_TARGET_AVX2
+#else
+#define ZENYTH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace Zenyth {
+
+	struct CpuFeatures {
+		bool sse41 = false;
+		bool avx2 = false; // implies OS support for saving YMM state
+		bool fma = false;
+	};
+
+	// Detected once on first use
+	[[nodiscard]] const CpuFeatures& GetCpuFeatures() noexcept;
+
+} // namespace Zenyth
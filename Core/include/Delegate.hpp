@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Zenyth {
+
+	template<typename Signature, size_t InlineSize = 2 * sizeof(void*)>
+	class Delegate;
+
+	// Non-allocating callable reference. The callable is copied into fixed inline storage and
+	// invoked through a single function pointer; there is no heap fallback, so anything that does
+	// not fit, or is not trivially copyable, is rejected at compile time. Capture pointers, not
+	// owning objects.
+	//
+	// Bind<&T::Method>(object) produces a delegate whose stub calls the member directly, which is
+	// what event sources should store instead of a lambda forwarding to a member.
+	template<typename R, typename... Args, size_t InlineSize>
+	class Delegate<R(Args...), InlineSize> {
+	public:
+		Delegate() = default;
+		Delegate(std::nullptr_t) noexcept {}
+
+		template<typename F>
+			requires (!std::is_same_v<std::remove_cvref_t<F>, Delegate>) && std::is_invocable_r_v<R, std::remove_cvref_t<F>&, Args...>
+		Delegate(F&& fn) noexcept {
+			using Fn = std::remove_cvref_t<F>;
+			static_assert(sizeof(Fn) <= InlineSize, "Delegate : callable does not fit the inline storage");
+			static_assert(alignof(Fn) <= alignof(void*), "Delegate : callable is over-aligned");
+			static_assert(std::is_trivially_copyable_v<Fn> && std::is_trivially_destructible_v<Fn>,
+				"Delegate : callable must be trivially copyable and destructible");
+
+			::new (static_cast<void*>(m_storage)) Fn(std::forward<F>(fn));
+			m_invoke = [](std::byte* storage, Args... args) -> R {
+				return (*std::launder(reinterpret_cast<Fn*>(storage)))(std::forward<Args>(args)...);
+			};
+		}
+
+		template<auto Method, typename T>
+		[[nodiscard]] static Delegate Bind(T* object) noexcept {
+			return Delegate([object](Args... args) -> R { return (object->*Method)(std::forward<Args>(args)...); });
+		}
+
+		R operator()(Args... args) const {
+			return m_invoke(m_storage, std::forward<Args>(args)...);
+		}
+
+		[[nodiscard]] explicit operator bool() const noexcept { return m_invoke != nullptr; }
+
+	private:
+		using Invoke = R (*)(std::byte*, Args...);
+
+		alignas(void*) mutable std::byte m_storage[InlineSize]{};
+		Invoke m_invoke = nullptr;
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+namespace Zenyth {
+	enum class EventType {
+		WindowClose,
+		WindowResize,
+		KeyDown,
+		KeyUp,
+		MouseMove,
+		MouseButtonDown,
+		MouseButtonUp,
+		MouseWheel,
+	};
+
+	// Keep in sync with the last EventType
+	inline constexpr uint32_t EventTypeCount = static_cast<uint32_t>(EventType::MouseWheel) + 1;
+
+	struct WindowCloseEvent {};
+	struct WindowResizeEvent { uint32_t width, height; };
+	struct KeyEvent { uint32_t keycode; bool repeat; };
+	struct MouseMoveEvent { int32_t x, y; };
+	struct MouseButtonEvent { uint8_t button; int32_t x, y; };  // button: 0=L,1=R,2=M
+	struct MouseWheelEvent { float delta; };
+
+	struct Event {
+		EventType type;
+		uint32_t  window; // Window::GetId() of the window that raised it
+		union {
+			WindowCloseEvent  close;
+			WindowResizeEvent resize;
+			KeyEvent          key;
+			MouseMoveEvent    mouseMove;
+			MouseButtonEvent  mouseButton;
+			MouseWheelEvent   mouseWheel;
+		};
+	};
+
+} // namespace Zenyth
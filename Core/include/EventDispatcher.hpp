@@ -0,0 +1,65 @@
+#pragma once
+#include "Delegate.hpp"
+#include "Event.hpp"
+
+#include <array>
+
+namespace Zenyth {
+
+	// Routes events to listeners subscribed to their EventType, highest priority first (ties in
+	// subscription order). A handler returns true to consume the event, which stops it there.
+	// Listener tables are fixed arrays per event type: subscribing and dispatching never allocate.
+	//
+	// Handlers may unsubscribe any listener, themselves included, while an event is being
+	// dispatched; subscribing from a handler is not allowed.
+	class EventDispatcher {
+	public:
+		static constexpr uint32_t MaxListenersPerType = 16;
+
+		using Handler = Delegate<bool(const Event&)>;
+
+		struct ListenerId {
+			uint32_t value = 0;
+
+			[[nodiscard]] explicit operator bool() const noexcept { return value != 0; }
+		};
+
+		ListenerId Subscribe(EventType type, Handler handler, int32_t priority = 0);
+
+		template<auto Method, typename T>
+		ListenerId Subscribe(const EventType type, T* object, const int32_t priority = 0) {
+			return Subscribe(type, Handler::Bind<Method>(object), priority);
+		}
+
+		void Unsubscribe(ListenerId id) noexcept;
+
+		// Returns whether a listener consumed the event
+		bool Dispatch(const Event& e);
+
+		[[nodiscard]] uint32_t ListenerCount(const EventType type) const noexcept {
+			return m_buckets[static_cast<uint32_t>(type)].count;
+		}
+
+	private:
+		struct Listener {
+			Handler  handler;
+			int32_t  priority = 0;
+			uint32_t id = 0;
+			bool     removed = false; // unsubscribed during dispatch; the handler may still be running
+		};
+
+		struct Bucket {
+			std::array<Listener, MaxListenersPerType> listeners;
+			uint32_t count = 0;
+			bool     dirty = false; // listeners were unsubscribed during dispatch
+		};
+
+		static void Compact(Bucket& bucket) noexcept;
+
+		std::array<Bucket, EventTypeCount> m_buckets;
+		uint32_t m_nextSerial = 1;
+		uint32_t m_dispatchDepth = 0;
+		bool     m_pendingCompact = false;
+	};
+
+} // namespace Zenyth
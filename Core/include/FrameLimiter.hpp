@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace Zenyth {
+
+	enum class FramePacing {
+		// Sample input, simulate and render, then wait out the rest of the frame: even frame cadence
+		Smooth,
+		// Wait first, until just enough time is left for the frame's predicted work, then sample
+		// input: presents still land on the frame deadline but input is as fresh as possible
+		LowLatency
+	};
+
+	struct FrameLimiterDesc {
+		double      targetFps = 0.0;    // 0 = unlimited
+		FramePacing pacing = FramePacing::Smooth;
+		double      minSpinMs = 0.5;    // never trust the OS sleep closer to a deadline than this
+	};
+
+	// Caps the frame rate without burning a core. Each wait sleeps on a high resolution timer
+	// (CREATE_WAITABLE_TIMER_HIGH_RESOLUTION on Windows, nanosleep elsewhere) until shortly before
+	// the deadline, then spins for the remainder. The spin margin follows a running estimate of how
+	// late the OS wakes the thread up, so it stays small on a quiet machine and grows under load.
+	//
+	// Deadlines advance by whole periods, so one slow frame does not shift every later frame.
+	class FrameLimiter {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct WaitTimes {
+			double sleepSeconds = 0.0;
+			double spinSeconds = 0.0;
+		};
+
+		explicit FrameLimiter(const FrameLimiterDesc& desc = {});
+		~FrameLimiter();
+
+		FrameLimiter(const FrameLimiter&) = delete;
+		FrameLimiter& operator=(const FrameLimiter&) = delete;
+
+		// Call before sampling input; waits in LowLatency mode
+		WaitTimes BeginFrame();
+		// Call after presenting; waits in Smooth mode
+		WaitTimes EndFrame();
+
+		void SetTargetFps(double fps) noexcept;
+		void SetPacing(FramePacing pacing) noexcept { m_desc.pacing = pacing; }
+
+		[[nodiscard]] const FrameLimiterDesc& Desc()             const noexcept { return m_desc; }
+		[[nodiscard]] bool                    IsLimited()        const noexcept { return m_period.count() > 0; }
+		[[nodiscard]] double                  PredictedWorkMs()  const noexcept { return m_workEstimate * 1e3; }
+		[[nodiscard]] double                  SpinMarginMs()     const noexcept { return SpinMargin() * 1e3; }
+
+	private:
+		// Sleeps and spins until `until`
+		WaitTimes WaitUntil(Clock::time_point until);
+		void      Sleep(double seconds);
+		void      AdvanceDeadline(Clock::time_point now) noexcept;
+		[[nodiscard]] double SpinMargin() const noexcept;
+
+		FrameLimiterDesc  m_desc;
+		Clock::duration   m_period{ 0 };
+		Clock::time_point m_deadline{};
+		Clock::time_point m_frameStart{};
+
+		// Running estimates, in seconds
+		double m_oversleep = 0.0;
+		double m_oversleepDeviation = 0.0;
+		double m_workEstimate = 0.0;
+		double m_workDeviation = 0.0;
+
+#ifdef _WIN32
+		void* m_timer = nullptr;
+#endif
+	};
+
+} // namespace Zenyth
@@ -1,14 +1,31 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 
 namespace Zenyth {
 
+	// Totals since the renderer was created. Implementations bump them as they record commands;
+	// they are read from other threads (metrics), so they stay plain relaxed atomics.
+	struct RenderCounters {
+		std::atomic<uint64_t> drawCalls{ 0 };
+		std::atomic<uint64_t> stateChanges{ 0 }; // pipeline, root signature and binding changes
+	};
+
 	class IRenderer {
 	public:
 		virtual ~IRenderer() = default;
+		// Window independent setup (adapter, device, queues). Runs on a job worker during startup,
+		// concurrently with window creation, and always before Init().
+		virtual void CreateDevice() {}
 		virtual void Init(HWND hwnd, uint32_t width, uint32_t height) = 0;
 		virtual void BeginFrame() = 0;
 		virtual void EndFrame() = 0;
 		virtual void Resize(uint32_t width, uint32_t height) = 0;
+
+		[[nodiscard]] const RenderCounters& Counters() const noexcept { return m_counters; }
+
+	protected:
+		RenderCounters m_counters;
 	};
 
 }
\ No newline at end of file
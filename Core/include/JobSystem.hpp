@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Zenyth {
+
+	// Tracks a group of submitted jobs; reaches zero once all of them finished, whether they
+	// returned or threw.
+	class JobCounter {
+	public:
+		[[nodiscard]] bool     IsDone()  const noexcept { return m_pending.load(std::memory_order_acquire) == 0; }
+		[[nodiscard]] uint32_t Pending() const noexcept { return m_pending.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+		std::atomic<uint32_t>      m_pending = 0;
+		// First exception thrown by one of the jobs, published by the decrement of m_pending
+		mutable std::atomic_flag   m_failed;
+		mutable std::exception_ptr m_error;
+	};
+
+	class JobSystem {
+	public:
+		using Job = std::function<void()>;
+
+		// workerCount == 0 picks hardware_concurrency - 1, but at least one: the calling thread only
+		// helps while waiting, and work submitted without waiting (deferred startup tasks) needs a worker
+		explicit JobSystem(uint32_t workerCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+		void Submit(JobCounter& counter, Job job);
+
+		// Blocks until the counter reaches zero, running queued jobs in the meantime. Rethrows the
+		// first exception thrown by one of its jobs, after all of them finished.
+		void Wait(const JobCounter& counter);
+
+		// Splits [0, count) into ranges of at most `grain` items and calls fn(begin, end) for each.
+		// Blocks until every range has been processed, then rethrows the first exception fn threw.
+		template<typename F>
+		void ParallelFor(uint32_t count, uint32_t grain, F&& fn);
+
+		// Worker threads plus the calling thread.
+		[[nodiscard]] uint32_t ThreadCount() const noexcept { return static_cast<uint32_t>(m_workers.size()) + 1; }
+		[[nodiscard]] uint32_t QueueDepth() const;
+		// Jobs finished since construction, by any thread
+		[[nodiscard]] uint64_t ExecutedCount() const noexcept { return m_executed.load(std::memory_order_relaxed); }
+
+		// 0 for threads that are not owned by a job system, 1..N for workers.
+		[[nodiscard]] static uint32_t ThreadIndex() noexcept;
+
+	private:
+		struct Entry {
+			Job         job;
+			JobCounter* counter;
+		};
+
+		void WorkerLoop(uint32_t index);
+		bool TryRunOne();
+		void Run(Entry& entry);
+
+		std::vector<std::thread> m_workers;
+		std::deque<Entry>        m_queue;
+		mutable std::mutex       m_mutex;
+		std::condition_variable  m_wake;
+		bool                     m_quit = false;
+		std::atomic<uint64_t>    m_executed{ 0 };
+	};
+
+	template<typename F>
+	void JobSystem::ParallelFor(const uint32_t count, uint32_t grain, F&& fn) {
+		if (count == 0)
+			return;
+		if (grain == 0)
+			grain = 1;
+
+		if (count <= grain || m_workers.empty()) {
+			fn(0u, count);
+			return;
+		}
+
+		JobCounter counter;
+		// The calling thread takes the first range itself
+		for (uint32_t begin = grain; begin < count; begin += grain) {
+			const uint32_t end = std::min(begin + grain, count);
+			Submit(counter, [&fn, begin, end] { fn(begin, end); });
+		}
+		// Ranges still queued reference fn and counter: wait for them even if the first one throws
+		std::exception_ptr error;
+		try {
+			fn(0u, grain);
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		Wait(counter);
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,158 @@
+#pragma once
+#include "JobSystem.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Zenyth {
+
+	enum class StartupThread {
+		Any,  // a job system worker
+		Main  // the thread calling Run(); for window creation and other thread-affine APIs
+	};
+
+	struct StartupTiming {
+		std::string_view name;
+		double           startMs = 0.0;   // since Run() was called
+		double           durationMs = 0.0;
+		uint32_t         thread = 0;      // JobSystem::ThreadIndex(), 0 for the main thread
+		bool             deferred = false;
+		bool             skipped = false; // a dependency failed
+	};
+
+	// Subsystem initialization as a dependency graph. Every task starts as soon as the tasks it
+	// depends on have finished, so independent subsystems initialize concurrently on the job system
+	// while main-thread tasks run on the caller. Deferred tasks are scheduled the same way, but Run()
+	// does not wait for them: use them for warmups that the first frame does not need.
+	//
+	// Each task is timed; the critical path is the chain of tasks that bounded the total time.
+	class StartupGraph {
+	public:
+		using Init = std::function<void()>;
+
+		StartupGraph() = default;
+		~StartupGraph();
+
+		StartupGraph(const StartupGraph&) = delete;
+		StartupGraph& operator=(const StartupGraph&) = delete;
+
+		void Add(std::string name, std::vector<std::string> dependencies, Init init, StartupThread thread = StartupThread::Any);
+		// Deferred tasks always run on workers and only deferred tasks may depend on them
+		void AddDeferred(std::string name, std::vector<std::string> dependencies, Init init);
+
+		// Returns once every non-deferred task finished. If a task throws, the tasks depending on it
+		// are skipped and the first exception is rethrown here once the rest have finished.
+		void Run(JobSystem& jobs);
+		// Blocks until the deferred tasks finished; exceptions thrown by them are rethrown here
+		void WaitDeferred();
+
+		[[nodiscard]] bool                        Contains(std::string_view name) const noexcept;
+		[[nodiscard]] std::vector<std::string>    TaskNames(bool includeDeferred = true) const;
+		// Finished tasks ordered by start time; deferred tasks appear once they completed
+		[[nodiscard]] std::vector<StartupTiming>  Timings() const;
+		[[nodiscard]] std::vector<std::string_view> CriticalPath() const;
+		[[nodiscard]] double                      TotalMs() const noexcept { return m_totalMs; }
+
+	private:
+		struct Task {
+			std::string              name;
+			std::vector<std::string> dependencyNames;
+			Init                     init;
+			StartupThread            thread = StartupThread::Any;
+			bool                     deferred = false;
+
+			std::vector<uint32_t>    dependencies;
+			std::vector<uint32_t>    dependents;
+			std::atomic<uint32_t>    remaining{ 0 };
+			std::atomic<bool>        failed{ false };
+			std::atomic<bool>        done{ false };
+			double                   startMs = 0.0;
+			double                   durationMs = 0.0;
+			uint32_t                 threadIndex = 0;
+			bool                     skipped = false;
+		};
+
+		void AddTask(std::string name, std::vector<std::string> dependencies, Init init, StartupThread thread, bool deferred);
+		void Resolve();
+		void Schedule(uint32_t task);
+		void Execute(uint32_t task);
+		void Fail(std::exception_ptr error, bool deferred);
+
+		std::vector<std::unique_ptr<Task>> m_tasks;
+		JobSystem*                         m_jobs = nullptr;
+		std::chrono::steady_clock::time_point m_origin;
+		double                             m_totalMs = 0.0;
+
+		JobCounter              m_critical;
+		JobCounter              m_deferred;
+		std::atomic<uint32_t>   m_pendingCritical{ 0 };
+
+		std::mutex              m_mutex;
+		std::condition_variable m_wake;
+		std::vector<uint32_t>   m_mainQueue;
+		std::exception_ptr      m_error;
+		std::exception_ptr      m_deferredError;
+	};
+
+	// Constructs a non-critical object on first use instead of at startup. Get() is thread-safe;
+	// Prewarm() starts construction on the job system so the first Get() finds it ready.
+	template<typename T>
+	class Lazy {
+	public:
+		using Factory = std::function<std::unique_ptr<T>()>;
+
+		explicit Lazy(Factory factory) : m_factory(std::move(factory)) {}
+
+		~Lazy() {
+			if (m_jobs)
+				m_jobs->Wait(m_prewarm);
+		}
+
+		Lazy(const Lazy&) = delete;
+		Lazy& operator=(const Lazy&) = delete;
+
+		T& Get() {
+			std::call_once(m_once, [this] {
+				m_value = m_factory();
+				if (!m_value)
+					throw std::runtime_error("Lazy::Get : factory returned null");
+				m_ready.store(m_value.get(), std::memory_order_release);
+			});
+			return *m_value;
+		}
+
+		// Never blocks; null until constructed
+		[[nodiscard]] T*   TryGet()  const noexcept { return m_ready.load(std::memory_order_acquire); }
+		[[nodiscard]] bool IsReady() const noexcept { return TryGet() != nullptr; }
+
+		void Prewarm(JobSystem& jobs) {
+			if (m_jobs || IsReady())
+				return;
+			m_jobs = &jobs;
+			jobs.Submit(m_prewarm, [this] {
+				try {
+					(void)Get();
+				}
+				catch (...) {
+					// Left unconstructed; the next Get() retries and reports the error to its caller
+				}
+			});
+		}
+
+	private:
+		Factory            m_factory;
+		std::once_flag     m_once;
+		std::unique_ptr<T> m_value;
+		std::atomic<T*>    m_ready{ nullptr };
+		JobSystem*         m_jobs = nullptr;
+		JobCounter         m_prewarm;
+	};
+
+} // namespace Zenyth
@@ -1,10 +1,25 @@
 #pragma once
+#include <array>
 #include <cstdint>
 
 namespace Zenyth {
 
+	// Frame timing over the last Timer::StatsWindow frames
+	struct FrameStats {
+		double averageMs = 0.0;
+		double minMs = 0.0;
+		double maxMs = 0.0;
+		double p99Ms = 0.0;
+		double jitterMs = 0.0;  // standard deviation of the frame time
+		double sleepMs = 0.0;   // per frame, spent blocked in the frame limiter
+		double spinMs = 0.0;    // per frame, spent spinning in the frame limiter
+		double busyRatio = 0.0; // share of the frame the main thread kept a core busy
+	};
+
 	class Timer {
 	public:
+		static constexpr uint32_t StatsWindow = 128;
+
 		Timer();
 
 		// Call once per frame. Returns delta time in seconds.
@@ -12,11 +27,21 @@ namespace Zenyth {
 
 		void Reset();
 
-		[[nodiscard]] float    DeltaTime()  const { return m_deltaTime; }
-		[[nodiscard]] double   TotalTime()  const { return m_totalTime; }
-		[[nodiscard]] uint64_t FrameCount() const { return m_frameCount; }
+		// Adds frame limiter waits to the frame in progress
+		void RecordWait(double sleepSeconds, double spinSeconds) noexcept;
+
+		[[nodiscard]] float      DeltaTime()  const { return m_deltaTime; }
+		[[nodiscard]] double     TotalTime()  const { return m_totalTime; }
+		[[nodiscard]] uint64_t   FrameCount() const { return m_frameCount; }
+		[[nodiscard]] FrameStats Stats()      const;
 
 	private:
+		struct Sample {
+			float frame = 0.f; // seconds
+			float sleep = 0.f;
+			float spin = 0.f;
+		};
+
 		int64_t  m_frequency = 0;
 		int64_t  m_prevTime = 0;
 		int64_t  m_startTime = 0;
@@ -24,6 +49,10 @@ namespace Zenyth {
 		float    m_deltaTime = 0.f;
 		double   m_totalTime = 0.0;
 		uint64_t m_frameCount = 0;
+
+		double   m_pendingSleep = 0.0;
+		double   m_pendingSpin = 0.0;
+		std::array<Sample, StatsWindow> m_samples{};
 	};
 
 } // namespace Zenyth
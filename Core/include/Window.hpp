@@ -1,47 +1,35 @@
 #pragma once
+#include "Delegate.hpp"
+#include "Event.hpp"
 
-namespace Zenyth {
-	enum class EventType {
-		WindowClose,
-		WindowResize,
-		KeyDown,
-		KeyUp,
-		MouseMove,
-		MouseButtonDown,
-		MouseButtonUp,
-		MouseWheel,
-	};
-
-	struct WindowCloseEvent {};
-	struct WindowResizeEvent { uint32_t width, height; };
-	struct KeyEvent { uint32_t keycode; bool repeat; };
-	struct MouseMoveEvent { int32_t x, y; };
-	struct MouseButtonEvent { uint8_t button; int32_t x, y; };  // button: 0=L,1=R,2=M
-	struct MouseWheelEvent { float delta; };
-
-	struct Event {
-		EventType type;
-		union {
-			WindowCloseEvent  close;
-			WindowResizeEvent resize;
-			KeyEvent          key;
-			MouseMoveEvent    mouseMove;
-			MouseButtonEvent  mouseButton;
-			MouseWheelEvent   mouseWheel;
-		};
-	};
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-	using EventCallback = std::function<void(const Event&)>;
+namespace Zenyth {
+	using EventCallback = Delegate<void(const Event&)>;
 
 	struct WindowDesc {
 		std::wstring title = L"Engine";
 		uint32_t     width = 1280;
 		uint32_t     height = 720;
 		bool         resizable = true;
+		// While the user drags a border, a new size is only reported once it held this long
+		float        resizeDebounceSeconds = 0.1f;
 	};
-	
+
+	// Native window whose creation and message pump live on a thread of its own, so the modal
+	// move/size loop Windows runs inside DispatchMessage never blocks the frame loop. The window
+	// thread only queues events; PumpMessages() hands them to the callback on the frame thread.
+	// Resizes are coalesced: at most one WindowResize per PumpMessages(), carrying the latest size.
+	//
+	// Each instance owns its window thread, so any number of windows may be open at once.
 	class Window {
 	public:
+		// Returns once the native window exists; creation errors are rethrown here
 		explicit Window(const WindowDesc& desc);
 		~Window();
 
@@ -50,33 +38,65 @@ namespace Zenyth {
 		Window(Window&&) = delete;
 		Window& operator=(Window&&) = delete;
 
-		[[nodiscard]] bool PumpMessages() const;
+		// Frame thread: delivers queued events. Returns false once the native window is gone.
+		[[nodiscard]] bool PumpMessages();
 
-		void SetEventCallback(EventCallback cb) { m_callback = std::move(cb); }
+		// Destroys the native window on its thread; PumpMessages() returns false afterwards
+		void Close();
+
+		void SetEventCallback(const EventCallback cb) { m_callback = cb; }
 
 		[[nodiscard]] HWND     GetHandle() const { return m_hwnd; }
+		[[nodiscard]] uint32_t GetId()     const { return m_id; }
+		// Last size delivered by PumpMessages()
 		[[nodiscard]] uint32_t GetWidth()  const { return m_width; }
 		[[nodiscard]] uint32_t GetHeight() const { return m_height; }
+		[[nodiscard]] bool     IsOpen()    const { return m_open.load(std::memory_order_acquire); }
 
 	private:
+		// Posted to the window to have its own thread destroy it
+		static constexpr UINT WM_ZENYTH_DESTROY = WM_APP + 1;
+
+		void MessageLoop(const WindowDesc& desc, std::promise<void>& created);
 		void RegisterWindowClass() const;
 		void CreateNativeWindow(const WindowDesc& desc);
 
 		static LRESULT CALLBACK WndProcStatic(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
 		LRESULT WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
 
+		// Window thread
+		void QueueEvent(const Event& e);
+		// Frame thread
 		void EmitEvent(const Event& e) const;
+		void EmitResize();
 
-		HWND          m_hwnd = nullptr;
+		static uint64_t PackSize(const uint32_t width, const uint32_t height) { return static_cast<uint64_t>(width) << 32 | height; }
+
+		HWND          m_hwnd = nullptr; // set before the constructor returns, then constant
 		HINSTANCE     m_hInst = nullptr;
+		uint32_t      m_id = 0;
+		bool          m_resizable = true;
+		std::wstring  m_className;
+
+		// Frame thread
 		uint32_t      m_width = 0;
 		uint32_t      m_height = 0;
-		bool          m_resizable = true;
 		EventCallback m_callback;
+		std::vector<Event> m_delivering;
+		uint64_t      m_seenSize = 0;
+		std::chrono::steady_clock::time_point m_seenSizeAt{};
+		std::chrono::duration<float> m_resizeDebounce{};
 
-		std::wstring  m_className;
+		// Shared with the window thread
+		std::mutex            m_queueMutex;
+		std::vector<Event>    m_queue;
+		std::atomic<uint64_t> m_latestSize{ 0 };
+		std::atomic<bool>     m_sizing{ false }; // inside the modal move/size loop
+		std::atomic<bool>     m_open{ false };
+
+		std::thread m_thread;
 
-		static uint32_t s_windowCount;
+		static std::atomic<uint32_t> s_windowCount;
 	};
 
 } // namespace Zenyth
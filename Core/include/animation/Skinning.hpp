@@ -0,0 +1,72 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "math/quaternion.hpp"
+#include "memory/UploadRing.hpp"
+
+#include <span>
+
+namespace Zenyth {
+
+	// Up to four bone influences per vertex; unused slots carry a zero weight (any valid bone index)
+	struct SkinInfluence {
+		uint16_t bones[4];
+		float    weights[4]; // expected to sum to 1
+	};
+
+	// Bind-pose vertex streams; positions and normals are packed xyz triples
+	struct SkinningInput {
+		std::span<const float>         positions;
+		std::span<const float>         normals;    // optional
+		std::span<const SkinInfluence> influences;
+
+		[[nodiscard]] uint32_t VertexCount() const noexcept { return static_cast<uint32_t>(influences.size()); }
+	};
+
+	// Skinned output, laid out for direct use as a vertex buffer (24 bytes)
+	struct SkinnedVertex {
+		float position[3];
+		float normal[3];
+	};
+
+	// Rigid transform as a unit dual quaternion: real part is the rotation, dual part encodes translation
+	struct alignas(32) DualQuat {
+		float real[4]; // x, y, z, w
+		float dual[4];
+
+		[[nodiscard]] static DualQuat FromRotationTranslation(const zenyth::math::quat& rotation, const zenyth::math::vec3& translation) noexcept;
+		// Scale and shear are discarded
+		[[nodiscard]] static DualQuat FromMatrix(const zenyth::math::mat4& rigid) noexcept;
+	};
+
+	enum class SkinningPath : uint8_t {
+		Auto,   // widest path the CPU supports
+		Scalar, // reference implementation
+		Sse,
+		Avx2,   // AVX2 + FMA
+	};
+
+	// Vertices handed to a single job
+	inline constexpr uint32_t SkinningJobGrain = 2048;
+
+	// palette[i] = boneWorld[i] * inverseBind[i]
+	void BuildSkinningPalette(std::span<const zenyth::math::mat4> boneWorld, std::span<const zenyth::math::mat4> inverseBind,
+		std::span<zenyth::math::mat4> palette) noexcept;
+
+	// Linear blend skinning. Normals are transformed by the blended matrix and renormalized, which is
+	// exact for rotation and uniform scale. out must hold input.VertexCount() vertices; it may be
+	// write-combined upload memory, which is only ever written sequentially with streaming stores.
+	void SkinLinear(std::span<const zenyth::math::mat4> palette, const SkinningInput& input, std::span<SkinnedVertex> out,
+		JobSystem* jobs = nullptr, SkinningPath path = SkinningPath::Auto);
+
+	// Dual quaternion skinning: keeps volume around twisting joints, rigid bones only
+	void SkinDualQuat(std::span<const DualQuat> palette, const SkinningInput& input, std::span<SkinnedVertex> out,
+		JobSystem* jobs = nullptr, SkinningPath path = SkinningPath::Auto);
+
+	// Allocates the output from this frame's upload memory and skins into it;
+	// returns an empty allocation when the ring is full
+	[[nodiscard]] UploadRing::Allocation SkinLinear(std::span<const zenyth::math::mat4> palette, const SkinningInput& input,
+		UploadRing& ring, JobSystem* jobs = nullptr, SkinningPath path = SkinningPath::Auto);
+	[[nodiscard]] UploadRing::Allocation SkinDualQuat(std::span<const DualQuat> palette, const SkinningInput& input,
+		UploadRing& ring, JobSystem* jobs = nullptr, SkinningPath path = SkinningPath::Auto);
+
+} // namespace Zenyth
@@ -0,0 +1,159 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// On-disk layout of cooked asset packs (.zpak). Everything is little endian and laid out so a
+// pack can be memory mapped and read in place: the header points at a table of entries sorted
+// by name hash, and every payload starts on a PayloadAlignment boundary so vertex, index and
+// texel data can be handed to GPU upload without copying.
+namespace Zenyth {
+
+	inline constexpr uint32_t PackMagic = 0x4B41505A; // "ZPAK"
+	inline constexpr uint16_t PackVersion = 1;
+
+	// Matches D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT so texture payloads can be copied from as-is
+	inline constexpr uint32_t PayloadAlignment = 512;
+	inline constexpr uint32_t MeshSectionAlignment = 64;
+
+	// FNV-1a, used for entry lookup
+	[[nodiscard]] constexpr uint64_t HashAssetName(const std::string_view name) noexcept {
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (const char c : name) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	enum class AssetType : uint16_t {
+		Raw,
+		Mesh,
+		Texture,
+		Scene,
+	};
+
+	struct PackHeader {
+		uint32_t magic;
+		uint16_t version;
+		uint16_t headerSize;
+		uint32_t entryCount;
+		uint32_t payloadAlignment;
+		uint64_t entryTableOffset;
+		uint64_t nameTableOffset;
+		uint64_t nameTableSize;
+		uint64_t fileSize;
+		uint8_t  reserved[16];
+	};
+
+	struct PackEntry {
+		uint64_t  nameHash;
+		uint64_t  offset;     // from the start of the file
+		uint64_t  size;
+		uint32_t  nameOffset; // NUL-terminated string in the name table
+		AssetType type;
+		uint16_t  flags;
+	};
+
+	enum class IndexFormat : uint32_t {
+		UInt16 = 2,
+		UInt32 = 4,
+	};
+
+	enum class VertexLayout : uint32_t {
+		Custom,
+		// float3 position, float3 normal, float2 uv; 32 bytes
+		PositionNormalUV,
+		// unorm16x4 position relative to the mesh bounds, snorm8x4 normal, half2 uv; 16 bytes
+		QuantizedPositionNormalUV,
+	};
+
+	// A contiguous range of the index buffer (and of the meshlet table) drawing one level of detail.
+	// All levels share the mesh's vertex buffer.
+	struct MeshLod {
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		uint32_t meshletOffset;
+		uint32_t meshletCount;
+		float    error;          // simplification error relative to the mesh extent
+		uint32_t reserved;
+	};
+
+	// Vertices index into the meshlet vertex array (which indexes the mesh vertex buffer); triangles are
+	// byte triplets of meshlet-local vertex indices, each meshlet's run padded to 4 bytes.
+	// Backface cone test: cull when dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff.
+	struct MeshletDesc {
+		uint32_t vertexOffset;
+		uint32_t triangleOffset; // in bytes
+		uint16_t vertexCount;
+		uint16_t triangleCount;
+		float    center[3];
+		float    radius;
+		float    coneApex[3];
+		float    coneAxis[3];
+		float    coneCutoff;
+		uint32_t reserved[2];
+	};
+
+	// Mesh payload: MeshHeader, then each section at its payload-relative offset
+	struct MeshHeader {
+		uint32_t     vertexCount;
+		uint32_t     indexCount;   // across all LODs
+		uint32_t     vertexStride;
+		IndexFormat  indexFormat;
+		VertexLayout vertexLayout;
+		uint32_t     lodCount;     // 0 for a single level using the whole index buffer
+		uint32_t     meshletCount;
+		uint32_t     meshletVertexCount;
+		uint32_t     meshletTriangleBytes;
+		uint32_t     reserved;
+		uint64_t     vertexOffset;
+		uint64_t     indexOffset;
+		uint64_t     lodOffset;
+		uint64_t     meshletOffset;
+		uint64_t     meshletVertexOffset;
+		uint64_t     meshletTriangleOffset;
+		float        boundsMin[3];
+		float        boundsMax[3];
+	};
+
+	enum class TextureFormat : uint32_t {
+		RGBA8,
+		RGBA8_SRGB,
+		BC1,
+		BC1_SRGB,
+		BC3,
+		BC3_SRGB,
+		BC4,
+		BC5,
+		BC7,
+		BC7_SRGB,
+	};
+
+	// One per mip and array slice, slice-major, following the TextureHeader
+	struct TextureSubresource {
+		uint64_t offset; // payload-relative
+		uint64_t size;
+		uint32_t rowPitch;
+		uint32_t rowCount;
+	};
+
+	struct TextureHeader {
+		uint32_t      width;
+		uint32_t      height;
+		uint32_t      arraySize;
+		uint32_t      mipCount;
+		TextureFormat format;
+		uint32_t      reserved;
+	};
+
+	static_assert(sizeof(PackHeader) == 64);
+	static_assert(sizeof(PackEntry) == 32);
+	static_assert(sizeof(MeshLod) == 24);
+	static_assert(sizeof(MeshletDesc) == 64);
+	static_assert(sizeof(MeshHeader) == 112);
+	static_assert(sizeof(TextureSubresource) == 24);
+	static_assert(sizeof(TextureHeader) == 24);
+	static_assert(std::is_trivially_copyable_v<PackHeader> && std::is_trivially_copyable_v<PackEntry>);
+
+} // namespace Zenyth
@@ -0,0 +1,92 @@
+#pragma once
+#include "assets/AssetFormat.hpp"
+#include "assets/MappedFile.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Zenyth {
+
+	struct MeshView {
+		const MeshHeader*            header = nullptr;
+		std::span<const std::byte>   vertices;
+		std::span<const std::byte>   indices;
+		std::span<const MeshLod>     lods;
+		std::span<const MeshletDesc> meshlets;
+		std::span<const uint32_t>    meshletVertices;
+		std::span<const uint8_t>     meshletTriangles;
+	};
+
+	struct TextureView {
+		const TextureHeader*               header = nullptr;
+		std::span<const TextureSubresource> subresources; // slice-major
+		std::span<const std::byte>         payload;       // subresource offsets are relative to this
+	};
+
+	// Read-only view over a memory-mapped .zpak. Opening validates the header and tables once;
+	// lookups binary-search the sorted entry table and return spans straight into the mapping.
+	class AssetPack {
+	public:
+		explicit AssetPack(const std::filesystem::path& path);
+
+		AssetPack(const AssetPack&) = delete;
+		AssetPack& operator=(const AssetPack&) = delete;
+
+		[[nodiscard]] const PackEntry*     Find(std::string_view name) const noexcept;
+		[[nodiscard]] const PackEntry*     Find(uint64_t nameHash) const noexcept;
+		[[nodiscard]] std::span<const PackEntry> Entries() const noexcept { return m_entries; }
+		[[nodiscard]] std::string_view     GetName(const PackEntry& entry) const noexcept;
+
+		[[nodiscard]] std::span<const std::byte> GetPayload(const PackEntry& entry) const noexcept;
+		[[nodiscard]] std::optional<MeshView>    GetMesh(const PackEntry& entry) const;
+		[[nodiscard]] std::optional<TextureView> GetTexture(const PackEntry& entry) const;
+
+		[[nodiscard]] const MappedFile&            File() const noexcept { return m_file; }
+		[[nodiscard]] const std::filesystem::path& Path() const noexcept { return m_path; }
+
+	private:
+		void Validate() const;
+
+		std::filesystem::path      m_path;
+		MappedFile                 m_file;
+		const PackHeader*          m_header = nullptr;
+		std::span<const PackEntry> m_entries;
+		std::string_view           m_names;
+	};
+
+	// Builds a .zpak in memory; used by the cooker and tools
+	class AssetPackWriter {
+	public:
+		void Add(std::string name, AssetType type, std::span<const std::byte> payload);
+		// Writes the mapped file as the payload without copying it into memory first
+		void AddMapped(std::string name, AssetType type, MappedFile file);
+		// Section offsets and LOD/meshlet counts in desc are filled in from the spans
+		void AddMesh(std::string name, const MeshHeader& desc, std::span<const std::byte> vertices, std::span<const std::byte> indices,
+			std::span<const MeshLod> lods = {}, std::span<const MeshletDesc> meshlets = {},
+			std::span<const uint32_t> meshletVertices = {}, std::span<const uint8_t> meshletTriangles = {});
+		void AddTexture(std::string name, const TextureHeader& desc, std::span<const std::span<const std::byte>> subresources,
+			std::span<const uint32_t> rowPitches, std::span<const uint32_t> rowCounts);
+
+		void Write(const std::filesystem::path& path) const;
+
+		[[nodiscard]] size_t EntryCount() const noexcept { return m_assets.size(); }
+
+		// The encoded payload of the index-th asset added, e.g. to cache it
+		[[nodiscard]] AssetType                  GetType(const size_t index)    const noexcept { return m_assets[index].type; }
+		[[nodiscard]] std::span<const std::byte> GetPayload(const size_t index) const noexcept { return m_assets[index].Payload(); }
+
+	private:
+		struct PendingAsset {
+			std::string            name;
+			AssetType              type;
+			std::vector<std::byte> payload;
+			MappedFile             mapped; // used instead of payload when open
+
+			[[nodiscard]] std::span<const std::byte> Payload() const noexcept { return mapped.IsOpen() ? mapped.Data() : std::span<const std::byte>(payload); }
+		};
+
+		std::vector<PendingAsset> m_assets;
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,119 @@
+#pragma once
+#include "assets/AssetPack.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+namespace Zenyth {
+
+	using AssetHandle = uint32_t;
+	inline constexpr AssetHandle InvalidAsset = ~0u;
+
+	enum class AssetState : uint8_t {
+		Unloaded,
+		Queued,
+		Ready,
+	};
+
+	// Streams assets out of mounted packs on a background thread.
+	//
+	// Requests are served highest priority first. "Loading" an asset means paging its payload
+	// into memory (prefetch + touch) so that the data returned by GetData() is usable without
+	// stalling the caller; nothing is copied. Resident bytes are kept under the memory budget by
+	// evicting unreferenced assets, lowest priority first. Released assets stay resident as a
+	// cache until the budget needs them back.
+	class AssetStreamer {
+	public:
+		using LoadedCallback = std::function<void(AssetHandle)>;
+
+		explicit AssetStreamer(size_t memoryBudget);
+		~AssetStreamer();
+
+		AssetStreamer(const AssetStreamer&) = delete;
+		AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+		// Later mounts shadow assets of the same name in earlier ones. An asset that is referenced
+		// when a pack is mounted keeps its pack until its last reference goes; the next Request()
+		// then resolves it against the newest mounts.
+		void Mount(std::shared_ptr<AssetPack> pack);
+		void Mount(const std::filesystem::path& path);
+
+		// Returns InvalidAsset when no mounted pack contains the name. Each call adds a reference.
+		// Names are compared in full, so names sharing a hash get distinct assets; a bare hash
+		// takes the first asset with it.
+		[[nodiscard]] AssetHandle Request(std::string_view name, float priority);
+		[[nodiscard]] AssetHandle Request(uint64_t nameHash, float priority);
+		void UpdatePriority(AssetHandle handle, float priority);
+		void Release(AssetHandle handle);
+
+		[[nodiscard]] AssetState                 GetState(AssetHandle handle) const;
+		// Empty until the asset is Ready
+		[[nodiscard]] std::span<const std::byte> GetData(AssetHandle handle) const;
+		[[nodiscard]] const PackEntry*           GetEntry(AssetHandle handle) const;
+		[[nodiscard]] const AssetPack*           GetPack(AssetHandle handle) const;
+
+		// Called on the loader thread right after an asset becomes Ready
+		void SetLoadedCallback(LoadedCallback callback);
+
+		// Blocks until nothing loadable is left in the queue
+		void WaitIdle();
+
+		void                 SetMemoryBudget(size_t bytes);
+		[[nodiscard]] size_t MemoryBudget()  const noexcept { return m_budget.load(std::memory_order_relaxed); }
+		[[nodiscard]] size_t ResidentBytes() const noexcept { return m_resident.load(std::memory_order_relaxed); }
+		[[nodiscard]] size_t QueuedCount() const;
+
+	private:
+		struct Asset {
+			const AssetPack* pack = nullptr;
+			const PackEntry* entry = nullptr;
+			float            priority = 0.0f;
+			uint32_t         refCount = 0;
+			uint32_t         serial = 0; // bumped on every priority change; stale queue items are skipped
+			AssetState       state = AssetState::Unloaded;
+		};
+
+		struct QueueItem {
+			float       priority;
+			AssetHandle handle;
+			uint32_t    serial;
+
+			bool operator<(const QueueItem& other) const noexcept { return priority < other.priority; }
+		};
+
+		AssetHandle Acquire(uint64_t nameHash, std::optional<std::string_view> name, float priority);
+		// Newest mount first; an empty name matches on the hash alone
+		[[nodiscard]] std::pair<const AssetPack*, const PackEntry*> Resolve(uint64_t nameHash, std::optional<std::string_view> name) const;
+		void LoaderLoop();
+		void Enqueue(AssetHandle handle);
+		// Frees unreferenced resident assets until `bytes` more fit in the budget; false if they cannot
+		bool MakeRoom(size_t bytes);
+		void Evict(AssetHandle handle);
+		[[nodiscard]] bool HasLoadableWork() const;
+
+		mutable std::mutex                             m_mutex;
+		std::condition_variable                        m_wake;
+		std::condition_variable                        m_idle;
+		std::vector<std::shared_ptr<AssetPack>>        m_packs;
+		std::deque<Asset>                              m_assets;
+		std::unordered_multimap<uint64_t, AssetHandle> m_lookup; // name hash -> handles, several on collisions
+		std::priority_queue<QueueItem>                 m_queue;
+		LoadedCallback                                 m_onLoaded;
+		AssetHandle                                    m_loadingAsset = InvalidAsset; // being paged in, outside the lock
+		bool                                           m_stalled = false; // top of the queue does not fit the budget
+		bool                                           m_stop = false;
+
+		std::atomic<size_t> m_budget;
+		std::atomic<size_t> m_resident = 0;
+		std::thread         m_loader;
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Zenyth {
+
+	// Read-only memory mapping of a whole file (MapViewOfFile on Windows, mmap elsewhere)
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		[[nodiscard]] bool                       IsOpen() const noexcept { return m_data != nullptr; }
+		[[nodiscard]] std::span<const std::byte> Data()   const noexcept { return { m_data, m_size }; }
+		[[nodiscard]] size_t                     Size()   const noexcept { return m_size; }
+
+		// Asks the OS to page the range in ahead of use
+		void Prefetch(size_t offset, size_t size) const noexcept;
+		// Lets the OS drop the range from memory; it is re-read from disk on next access. Pages the
+		// range shares with neighbouring data are kept.
+		void Evict(size_t offset, size_t size) const noexcept;
+
+	private:
+		void Close() noexcept;
+
+		const std::byte* m_data = nullptr;
+		size_t           m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#else
+		int   m_fd = -1;
+#endif
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,86 @@
+#pragma once
+#include "ecs/Entity.hpp"
+
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Zenyth::ecs {
+
+	// Fixed-size, cache-line aligned block holding `count` entities of one archetype.
+	// Every component gets its own contiguous array inside the block (SoA per component),
+	// with each array starting on a cache line boundary.
+	struct Chunk {
+		std::byte* data = nullptr;
+		uint32_t   count = 0;
+	};
+
+	struct Slot {
+		uint32_t chunk = 0;
+		uint32_t row = 0;
+	};
+
+	class Archetype {
+	public:
+		explicit Archetype(const ComponentMask& mask);
+		~Archetype();
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+		Archetype(Archetype&&) = delete;
+		Archetype& operator=(Archetype&&) = delete;
+
+		[[nodiscard]] const ComponentMask&        Mask()          const noexcept { return m_mask; }
+		[[nodiscard]] std::span<const ComponentId> Components()   const noexcept { return m_components; }
+		[[nodiscard]] uint32_t                     ChunkCapacity() const noexcept { return m_capacity; }
+		[[nodiscard]] uint32_t                     ChunkCount()    const noexcept { return static_cast<uint32_t>(m_chunks.size()); }
+		[[nodiscard]] uint32_t                     EntityCount()   const noexcept { return m_entityCount; }
+
+		[[nodiscard]] Chunk&       GetChunk(const uint32_t index)       noexcept { return m_chunks[index]; }
+		[[nodiscard]] const Chunk& GetChunk(const uint32_t index) const noexcept { return m_chunks[index]; }
+
+		// Column index of a component inside this archetype, or -1 if absent
+		[[nodiscard]] int32_t ColumnOf(ComponentId id) const noexcept;
+
+		[[nodiscard]] void* ColumnData(const Chunk& chunk, const uint32_t column) const noexcept {
+			return chunk.data + m_offsets[column];
+		}
+
+		template<typename T>
+		[[nodiscard]] T* Column(const Chunk& chunk, const uint32_t column) const noexcept {
+			return std::launder(reinterpret_cast<T*>(ColumnData(chunk, column)));
+		}
+
+		[[nodiscard]] Entity* Entities(const Chunk& chunk) const noexcept {
+			return std::launder(reinterpret_cast<Entity*>(chunk.data));
+		}
+
+		[[nodiscard]] void* ComponentAt(const Slot slot, const uint32_t column) const noexcept {
+			return m_chunks[slot.chunk].data + m_offsets[column] + static_cast<size_t>(slot.row) * m_sizes[column];
+		}
+
+		// Reserves a row at the end of the archetype. Component storage is left uninitialised.
+		[[nodiscard]] Slot Allocate(Entity entity);
+
+		// Destroys the components at `slot` and relocates the last row into the hole.
+		// Returns the entity that was moved into `slot`, or NullEntity if the slot was the last row.
+		Entity Erase(Slot slot);
+
+		// Cached structural transitions
+		std::unordered_map<ComponentId, Archetype*> addEdges;
+		std::unordered_map<ComponentId, Archetype*> removeEdges;
+
+	private:
+		void ComputeLayout();
+
+		ComponentMask            m_mask;
+		std::vector<ComponentId> m_components;
+		std::vector<uint32_t>    m_offsets;
+		std::vector<uint32_t>    m_sizes;
+		std::vector<Chunk>       m_chunks;
+		uint32_t                 m_capacity = 0;
+		uint32_t                 m_entityCount = 0;
+	};
+
+} // namespace Zenyth::ecs
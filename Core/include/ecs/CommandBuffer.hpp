@@ -0,0 +1,90 @@
+#pragma once
+#include "ecs/World.hpp"
+
+#include <mutex>
+
+namespace Zenyth::ecs {
+
+	// Records structural changes so they can be applied once iteration is over.
+	// Recording is thread-safe, so jobs spawned by Query::ParallelEach can share one buffer.
+	// Spawn() hands out placeholder entities that are only valid inside the same buffer and are
+	// resolved to real entities on Playback().
+	class CommandBuffer {
+	public:
+		static constexpr uint32_t PendingGeneration = ~0u;
+
+		CommandBuffer() = default;
+		~CommandBuffer();
+
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+		CommandBuffer(CommandBuffer&&) = delete;
+		CommandBuffer& operator=(CommandBuffer&&) = delete;
+
+		Entity Spawn();
+		void   Destroy(Entity entity);
+
+		template<typename T>
+		void Add(Entity entity, T&& component);
+
+		template<typename T>
+		void Remove(Entity entity);
+
+		void Playback(World& world);
+		void Clear();
+
+		[[nodiscard]] bool Empty() const;
+
+	private:
+		enum class Op : uint8_t { Spawn, Destroy, Apply };
+
+		using ApplyFn = void (*)(World& world, Entity entity, void* payload);
+		using DiscardFn = void (*)(void* payload);
+
+		struct Command {
+			Op        op;
+			Entity    entity;
+			void*     payload = nullptr;
+			ApplyFn   apply = nullptr;
+			DiscardFn discard = nullptr;
+		};
+
+		static constexpr size_t BlockSize = 16 * 1024;
+
+		// Caller must hold m_mutex. Payload addresses stay stable until Clear().
+		void* AllocatePayload(size_t size, size_t alignment);
+		void  Record(const Command& command);
+
+		mutable std::mutex                          m_mutex;
+		std::vector<Command>                        m_commands;
+		std::vector<std::unique_ptr<std::byte[]>>   m_blocks;
+		std::byte*                                  m_current = nullptr;
+		size_t                                      m_blockOffset = 0;
+		uint32_t                                    m_spawnCount = 0;
+	};
+
+	template<typename T>
+	void CommandBuffer::Add(const Entity entity, T&& component) {
+		using U = std::remove_cvref_t<T>;
+
+		std::lock_guard lock(m_mutex);
+		void* payload = ::new (AllocatePayload(sizeof(U), alignof(U))) U(std::forward<T>(component));
+
+		Record({
+			Op::Apply, entity, payload,
+			[](World& world, const Entity e, void* p) { world.Emplace<U>(e, std::move(*static_cast<U*>(p))); },
+			[](void* p) { static_cast<U*>(p)->~U(); }
+		});
+	}
+
+	template<typename T>
+	void CommandBuffer::Remove(const Entity entity) {
+		std::lock_guard lock(m_mutex);
+		Record({
+			Op::Apply, entity, nullptr,
+			[](World& world, const Entity e, void*) { world.Remove<T>(e); },
+			nullptr
+		});
+	}
+
+} // namespace Zenyth::ecs
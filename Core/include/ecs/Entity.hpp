@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+
+namespace Zenyth::ecs {
+
+	// Generational handle: index into the world's entity table plus the generation
+	// it was issued with. A destroyed slot bumps its generation so stale handles fail lookups.
+	struct Entity {
+		uint32_t index = ~0u;
+		uint32_t generation = 0;
+
+		[[nodiscard]] constexpr bool IsNull() const noexcept { return index == ~0u; }
+		[[nodiscard]] constexpr uint64_t Id() const noexcept { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+		constexpr bool operator==(const Entity&) const noexcept = default;
+	};
+
+	inline constexpr Entity NullEntity{};
+
+	inline constexpr uint32_t MaxComponents = 64;
+	inline constexpr size_t   CacheLineSize = 64;
+	inline constexpr size_t   ChunkSize = 16 * 1024;
+
+	using ComponentId = uint32_t;
+	using ComponentMask = std::bitset<MaxComponents>;
+
+	// Type-erased description of a component, enough to relocate and destroy it inside a chunk.
+	struct ComponentInfo {
+		const char* name = nullptr;
+		uint32_t    size = 0;
+		uint32_t    alignment = 0;
+		bool        trivial = true;
+
+		void (*moveConstruct)(void* dst, void* src) = nullptr;
+		void (*destroy)(void* ptr) = nullptr;
+	};
+
+	class ComponentRegistry {
+	public:
+		template<typename T>
+		[[nodiscard]] static ComponentId Id() noexcept {
+			static const ComponentId id = Register(MakeInfo<T>());
+			return id;
+		}
+
+		[[nodiscard]] static const ComponentInfo& Info(ComponentId id) noexcept;
+		[[nodiscard]] static uint32_t Count() noexcept;
+
+	private:
+		template<typename T>
+		static ComponentInfo MakeInfo() noexcept {
+			static_assert(std::is_nothrow_move_constructible_v<T>, "ECS components must be nothrow move constructible");
+			static_assert(alignof(T) <= CacheLineSize, "ECS components cannot be over-aligned past a cache line");
+
+			ComponentInfo info;
+			info.name = typeid(T).name();
+			info.size = static_cast<uint32_t>(sizeof(T));
+			info.alignment = static_cast<uint32_t>(alignof(T));
+			info.trivial = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+			info.moveConstruct = [](void* dst, void* src) { ::new (dst) T(std::move(*static_cast<T*>(src))); };
+			info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+			return info;
+		}
+
+		static ComponentId Register(const ComponentInfo& info);
+	};
+
+	template<typename... Ts>
+	[[nodiscard]] ComponentMask MakeMask() noexcept {
+		ComponentMask mask;
+		(mask.set(ComponentRegistry::Id<std::remove_cvref_t<Ts>>()), ...);
+		return mask;
+	}
+
+} // namespace Zenyth::ecs
@@ -0,0 +1,192 @@
+#pragma once
+#include "ecs/World.hpp"
+#include "JobSystem.hpp"
+
+#include <array>
+#include <span>
+#include <tuple>
+
+namespace Zenyth::ecs {
+
+	// Iterates every entity owning all of Ts (plus With<>, minus Without<>).
+	// Matching archetypes are cached and refreshed incrementally as the world grows.
+	//
+	//   Query<Position, const Velocity> q(world);
+	//   q.Each([](Position& p, const Velocity& v) { ... });
+	//   q.EachChunk([](std::span<const Entity>, std::span<Position> p, std::span<const Velocity> v) { ... });
+	template<typename... Ts>
+	class Query {
+		static_assert(sizeof...(Ts) > 0, "Query needs at least one component");
+		static_assert((!std::is_reference_v<Ts> && ...), "Query components must be value types (use const T for read-only)");
+
+	public:
+		explicit Query(World& world)
+			: m_world(&world), m_include(MakeMask<Ts...>()) {}
+
+		template<typename... Us>
+		Query& With() { m_include |= MakeMask<Us...>(); Reset(); return *this; }
+
+		template<typename... Us>
+		Query& Without() { m_exclude |= MakeMask<Us...>(); Reset(); return *this; }
+
+		// fn(Ts&...) or fn(Entity, Ts&...)
+		template<typename F>
+		void Each(F&& fn);
+
+		// fn(std::span<const Entity>, std::span<Ts>...) once per chunk
+		template<typename F>
+		void EachChunk(F&& fn);
+
+		// Same as Each/EachChunk, with chunks distributed over the job system.
+		// fn runs concurrently: it must only touch the entity it is given and record
+		// structural changes into a CommandBuffer.
+		template<typename F>
+		void ParallelEach(JobSystem& jobs, F&& fn, uint32_t chunksPerJob = 4);
+
+		template<typename F>
+		void ParallelEachChunk(JobSystem& jobs, F&& fn, uint32_t chunksPerJob = 4);
+
+		[[nodiscard]] uint32_t Count();
+
+	private:
+		struct Match {
+			Archetype*                          archetype;
+			std::array<uint32_t, sizeof...(Ts)> columns;
+		};
+
+		struct WorkItem {
+			uint32_t match;
+			uint32_t chunk;
+		};
+
+		void Reset() { m_matches.clear(); m_scanned = 0; }
+		void Refresh();
+
+		template<typename F>
+		void RunChunk(const Match& match, const Chunk& chunk, F& fn) const;
+
+		template<typename F>
+		void RunRows(const Match& match, const Chunk& chunk, F& fn) const;
+
+		template<size_t... Is>
+		static auto Columns(const Match& match, const Chunk& chunk, std::index_sequence<Is...>) {
+			return std::tuple<Ts*...>{ match.archetype->template Column<std::remove_cv_t<Ts>>(chunk, match.columns[Is])... };
+		}
+
+		World*             m_world;
+		ComponentMask      m_include;
+		ComponentMask      m_exclude;
+		std::vector<Match> m_matches;
+		size_t             m_scanned = 0;
+	};
+
+	template<typename... Ts>
+	void Query<Ts...>::Refresh() {
+		const auto& archetypes = m_world->m_archetypes;
+		for (; m_scanned < archetypes.size(); ++m_scanned) {
+			Archetype* archetype = archetypes[m_scanned].get();
+			const ComponentMask& mask = archetype->Mask();
+			if ((mask & m_include) != m_include || (mask & m_exclude).any())
+				continue;
+
+			Match match{ archetype, {} };
+			size_t i = 0;
+			((match.columns[i++] = static_cast<uint32_t>(archetype->ColumnOf(ComponentRegistry::Id<std::remove_cv_t<Ts>>()))), ...);
+			m_matches.push_back(match);
+		}
+	}
+
+	template<typename... Ts>
+	template<typename F>
+	void Query<Ts...>::RunChunk(const Match& match, const Chunk& chunk, F& fn) const {
+		const auto columns = Columns(match, chunk, std::index_sequence_for<Ts...>{});
+		const std::span<const Entity> entities(match.archetype->Entities(chunk), chunk.count);
+
+		std::apply([&](auto*... ptrs) {
+			fn(entities, std::span<Ts>(ptrs, chunk.count)...);
+		}, columns);
+	}
+
+	template<typename... Ts>
+	template<typename F>
+	void Query<Ts...>::RunRows(const Match& match, const Chunk& chunk, F& fn) const {
+		const auto columns = Columns(match, chunk, std::index_sequence_for<Ts...>{});
+		const Entity* entities = match.archetype->Entities(chunk);
+
+		std::apply([&](auto*... ptrs) {
+			for (uint32_t row = 0; row < chunk.count; ++row) {
+				if constexpr (std::is_invocable_v<F&, Entity, Ts&...>)
+					fn(entities[row], ptrs[row]...);
+				else
+					fn(ptrs[row]...);
+			}
+		}, columns);
+	}
+
+	template<typename... Ts>
+	template<typename F>
+	void Query<Ts...>::Each(F&& fn) {
+		Refresh();
+		World::IterationScope scope(*m_world);
+
+		for (const Match& match : m_matches) {
+			for (uint32_t c = 0; c < match.archetype->ChunkCount(); ++c)
+				RunRows(match, match.archetype->GetChunk(c), fn);
+		}
+	}
+
+	template<typename... Ts>
+	template<typename F>
+	void Query<Ts...>::EachChunk(F&& fn) {
+		Refresh();
+		World::IterationScope scope(*m_world);
+
+		for (const Match& match : m_matches) {
+			for (uint32_t c = 0; c < match.archetype->ChunkCount(); ++c)
+				RunChunk(match, match.archetype->GetChunk(c), fn);
+		}
+	}
+
+	template<typename... Ts>
+	template<typename F>
+	void Query<Ts...>::ParallelEach(JobSystem& jobs, F&& fn, const uint32_t chunksPerJob) {
+		ParallelEachChunk(jobs, [&fn](std::span<const Entity> entities, std::span<Ts>... columns) {
+			for (size_t row = 0; row < entities.size(); ++row) {
+				if constexpr (std::is_invocable_v<F&, Entity, Ts&...>)
+					fn(entities[row], columns[row]...);
+				else
+					fn(columns[row]...);
+			}
+		}, chunksPerJob);
+	}
+
+	template<typename... Ts>
+	template<typename F>
+	void Query<Ts...>::ParallelEachChunk(JobSystem& jobs, F&& fn, const uint32_t chunksPerJob) {
+		Refresh();
+		World::IterationScope scope(*m_world);
+
+		std::vector<WorkItem> items;
+		for (uint32_t m = 0; m < m_matches.size(); ++m) {
+			for (uint32_t c = 0; c < m_matches[m].archetype->ChunkCount(); ++c)
+				items.push_back({ m, c });
+		}
+
+		jobs.ParallelFor(static_cast<uint32_t>(items.size()), chunksPerJob, [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				const Match& match = m_matches[items[i].match];
+				RunChunk(match, match.archetype->GetChunk(items[i].chunk), fn);
+			}
+		});
+	}
+
+	template<typename... Ts>
+	uint32_t Query<Ts...>::Count() {
+		Refresh();
+		uint32_t count = 0;
+		for (const Match& match : m_matches)
+			count += match.archetype->EntityCount();
+		return count;
+	}
+
+} // namespace Zenyth::ecs
@@ -0,0 +1,116 @@
+#pragma once
+#include "ecs/Archetype.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Zenyth::ecs {
+
+	class CommandBuffer;
+
+	template<typename... Ts>
+	class Query;
+
+	// Owns every entity and its components. Entities with the same component set share an
+	// archetype and are packed into its chunks, so queries walk dense arrays instead of
+	// chasing pointers. Structural changes (create/destroy/add/remove) are not allowed while a
+	// query is iterating; record them into a CommandBuffer and play it back afterwards.
+	class World {
+	public:
+		World();
+		~World();
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+		World(World&&) = delete;
+		World& operator=(World&&) = delete;
+
+		Entity Create();
+
+		template<typename... Ts>
+		Entity Create(Ts&&... components);
+
+		void Destroy(Entity entity);
+
+		[[nodiscard]] bool IsAlive(Entity entity) const noexcept;
+
+		// Constructs T in place, or assigns over the existing component
+		template<typename T, typename... Args>
+		T& Emplace(Entity entity, Args&&... args);
+
+		template<typename T>
+		std::remove_cvref_t<T>& Add(Entity entity, T&& component) {
+			return Emplace<std::remove_cvref_t<T>>(entity, std::forward<T>(component));
+		}
+
+		template<typename T>
+		void Remove(Entity entity);
+
+		template<typename T>
+		[[nodiscard]] bool Has(Entity entity) const noexcept;
+
+		template<typename T>
+		[[nodiscard]] T* TryGet(Entity entity) noexcept;
+
+		template<typename T>
+		[[nodiscard]] T& Get(Entity entity);
+
+		[[nodiscard]] uint32_t EntityCount()    const noexcept { return m_aliveCount; }
+		[[nodiscard]] uint32_t ArchetypeCount() const noexcept { return static_cast<uint32_t>(m_archetypes.size()); }
+		[[nodiscard]] bool     IsIterating()    const noexcept { return m_iterating != 0; }
+
+		// World-owned buffer for changes made from inside queries
+		[[nodiscard]] CommandBuffer& Deferred() noexcept { return *m_deferred; }
+		void FlushDeferred();
+
+	private:
+		template<typename... Ts>
+		friend class Query;
+		friend class CommandBuffer;
+
+		struct Record {
+			Archetype* archetype = nullptr;
+			Slot       slot;
+			uint32_t   generation = 0;
+		};
+
+		struct MaskHash {
+			size_t operator()(const ComponentMask& mask) const noexcept { return std::hash<ComponentMask>{}(mask); }
+		};
+
+		// RAII marker held by queries for the duration of an iteration
+		struct IterationScope {
+			explicit IterationScope(World& world) noexcept : m_world(world) { ++m_world.m_iterating; }
+			~IterationScope() { --m_world.m_iterating; }
+			World& m_world;
+		};
+
+		[[nodiscard]] Record&       Lookup(Entity entity);
+		[[nodiscard]] const Record* TryLookup(Entity entity) const noexcept;
+
+		Entity AllocateEntity();
+		void   CheckStructural(const char* where) const;
+
+		Archetype* GetOrCreateArchetype(const ComponentMask& mask);
+		Archetype* AddTarget(Archetype* from, ComponentId id);
+		Archetype* RemoveTarget(Archetype* from, ComponentId id);
+
+		// Relocates an entity's shared components into `to`; components absent from `to` are destroyed
+		Slot MoveEntity(Entity entity, Record& record, Archetype* to);
+
+		std::vector<std::unique_ptr<Archetype>>                 m_archetypes;
+		std::unordered_map<ComponentMask, Archetype*, MaskHash> m_archetypeLookup;
+		Archetype*                                              m_root = nullptr;
+
+		std::vector<Record>   m_records;
+		std::vector<uint32_t> m_freeList;
+		uint32_t              m_aliveCount = 0;
+		uint32_t              m_iterating = 0;
+
+		std::unique_ptr<CommandBuffer> m_deferred;
+	};
+
+} // namespace Zenyth::ecs
+
+#include "ecs/World.tpp"
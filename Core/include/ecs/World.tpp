@@ -0,0 +1,78 @@
+#pragma once
+
+namespace Zenyth::ecs {
+
+	template<typename... Ts>
+	Entity World::Create(Ts&&... components) {
+		CheckStructural("World::Create");
+
+		const Entity entity = AllocateEntity();
+		Archetype* archetype = GetOrCreateArchetype(MakeMask<Ts...>());
+
+		Record& record = m_records[entity.index];
+		record.archetype = archetype;
+		record.slot = archetype->Allocate(entity);
+
+		(::new (archetype->ComponentAt(record.slot, archetype->ColumnOf(ComponentRegistry::Id<std::remove_cvref_t<Ts>>())))
+			std::remove_cvref_t<Ts>(std::forward<Ts>(components)), ...);
+
+		return entity;
+	}
+
+	template<typename T, typename... Args>
+	T& World::Emplace(const Entity entity, Args&&... args) {
+		Record& record = Lookup(entity);
+		const ComponentId id = ComponentRegistry::Id<T>();
+
+		if (const int32_t column = record.archetype->ColumnOf(id); column >= 0) {
+			T& existing = *std::launder(static_cast<T*>(record.archetype->ComponentAt(record.slot, column)));
+			existing = T(std::forward<Args>(args)...);
+			return existing;
+		}
+
+		CheckStructural("World::Emplace");
+
+		Archetype* target = AddTarget(record.archetype, id);
+		const Slot slot = MoveEntity(entity, record, target);
+		return *::new (target->ComponentAt(slot, target->ColumnOf(id))) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void World::Remove(const Entity entity) {
+		Record& record = Lookup(entity);
+		const ComponentId id = ComponentRegistry::Id<T>();
+		if (!record.archetype->Mask().test(id))
+			return;
+
+		CheckStructural("World::Remove");
+		MoveEntity(entity, record, RemoveTarget(record.archetype, id));
+	}
+
+	template<typename T>
+	bool World::Has(const Entity entity) const noexcept {
+		const Record* record = TryLookup(entity);
+		return record && record->archetype->Mask().test(ComponentRegistry::Id<T>());
+	}
+
+	template<typename T>
+	T* World::TryGet(const Entity entity) noexcept {
+		const Record* record = TryLookup(entity);
+		if (!record)
+			return nullptr;
+
+		const int32_t column = record->archetype->ColumnOf(ComponentRegistry::Id<T>());
+		if (column < 0)
+			return nullptr;
+
+		return std::launder(static_cast<T*>(record->archetype->ComponentAt(record->slot, column)));
+	}
+
+	template<typename T>
+	T& World::Get(const Entity entity) {
+		T* component = TryGet<T>(entity);
+		if (!component)
+			throw std::runtime_error("World::Get : entity does not have the requested component");
+		return *component;
+	}
+
+} // namespace Zenyth::ecs
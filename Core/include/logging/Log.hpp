@@ -0,0 +1,129 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <string_view>
+
+// Lowest severity compiled in (0 = Trace ... 5 = Fatal); calls below it generate no code
+#ifndef ZENYTH_LOG_MIN_SEVERITY
+#ifdef NDEBUG
+#define ZENYTH_LOG_MIN_SEVERITY 2
+#else
+#define ZENYTH_LOG_MIN_SEVERITY 0
+#endif
+#endif
+
+// Bit i enables Category(i); disabled categories generate no code
+#ifndef ZENYTH_LOG_CATEGORIES
+#define ZENYTH_LOG_CATEGORIES 0xFFFFFFFFu
+#endif
+
+namespace Zenyth::logging {
+
+	enum class Severity : uint8_t {
+		Trace,
+		Debug,
+		Info,
+		Warning,
+		Error,
+		Fatal
+	};
+
+	enum class Category : uint8_t {
+		General,
+		Core,
+		Jobs,
+		Assets,
+		Renderer,
+		Physics,
+		Animation,
+		Game
+	};
+
+	[[nodiscard]] std::string_view ToString(Severity severity) noexcept;
+	[[nodiscard]] std::string_view ToString(Category category) noexcept;
+
+	[[nodiscard]] constexpr bool IsEnabled(const Severity severity, const Category category) noexcept {
+		return static_cast<int>(severity) >= ZENYTH_LOG_MIN_SEVERITY
+			&& ((static_cast<uint32_t>(ZENYTH_LOG_CATEGORIES) >> static_cast<uint32_t>(category)) & 1u) != 0;
+	}
+
+	// Everything about a log statement that is known at compile time. Each call site has one static
+	// instance and records refer to it by address, so the format string is never copied.
+	struct Site {
+		const char* format;
+		const char* file;
+		uint32_t    line;
+		Severity    severity;
+		Category    category;
+	};
+
+	// A decoded record as handed to sinks; text is only valid during Sink::Write()
+	struct Message {
+		Severity         severity;
+		Category         category;
+		std::chrono::system_clock::time_point time;
+		uint32_t         thread;    // small index in order of first log call, not the OS id
+		const char*      file;
+		uint32_t         line;
+		std::string_view text;
+	};
+
+	// Sinks run on the logger thread only and need no locking of their own. A fatal record logged
+	// from a sink is written straight to stderr, since flushing from there would deadlock.
+	class Sink {
+	public:
+		virtual ~Sink() = default;
+
+		virtual void Write(const Message& message) = 0;
+		virtual void Flush() {}
+	};
+
+	struct LoggerConfig {
+		size_t                    ringBytes = 64 * 1024; // per logging thread
+		std::chrono::milliseconds drainInterval{ 5 };
+	};
+
+	// Asynchronous logger. A log call serializes the site address and its raw arguments into a
+	// lock-free ring owned by the calling thread and returns; a background thread drains every ring,
+	// runs std::format on its own time and hands the text to the sinks in timestamp order.
+	// A full ring drops the record rather than wait; drops are counted and reported.
+	//
+	// Records written before Start() wait in the rings, and are lost if the ring fills first.
+	class Logger {
+	public:
+		static void Start(const LoggerConfig& config = {});
+		// Drains every ring, flushes the sinks and joins the logger thread
+		static void Stop();
+
+		// Sinks may only be changed while the logger is stopped
+		static void AddSink(std::unique_ptr<Sink> sink);
+		static void ClearSinks();
+
+		// Blocks until everything logged so far has reached the sinks; returns at once when called
+		// from a sink
+		static void Flush();
+
+		[[nodiscard]] static uint64_t DroppedCount() noexcept;
+		[[nodiscard]] static bool     IsRunning() noexcept;
+	};
+
+} // namespace Zenyth::logging
+
+#include "logging/Log.tpp"
+
+#define ZENYTH_LOG(severity, category, format, ...)                                                                  \
+	do {                                                                                                             \
+		if constexpr (::Zenyth::logging::IsEnabled(severity, category)) {                                            \
+			static constexpr ::Zenyth::logging::Site zenythLogSite{ format, __FILE__, __LINE__, severity, category }; \
+			::Zenyth::logging::detail::Write(zenythLogSite, format __VA_OPT__(,) __VA_ARGS__);                       \
+		}                                                                                                            \
+	} while (false)
+
+#define ZENYTH_LOG_TRACE(category, format, ...) ZENYTH_LOG(::Zenyth::logging::Severity::Trace, ::Zenyth::logging::Category::category, format __VA_OPT__(,) __VA_ARGS__)
+#define ZENYTH_LOG_DEBUG(category, format, ...) ZENYTH_LOG(::Zenyth::logging::Severity::Debug, ::Zenyth::logging::Category::category, format __VA_OPT__(,) __VA_ARGS__)
+#define ZENYTH_LOG_INFO(category, format, ...)  ZENYTH_LOG(::Zenyth::logging::Severity::Info, ::Zenyth::logging::Category::category, format __VA_OPT__(,) __VA_ARGS__)
+#define ZENYTH_LOG_WARN(category, format, ...)  ZENYTH_LOG(::Zenyth::logging::Severity::Warning, ::Zenyth::logging::Category::category, format __VA_OPT__(,) __VA_ARGS__)
+#define ZENYTH_LOG_ERROR(category, format, ...) ZENYTH_LOG(::Zenyth::logging::Severity::Error, ::Zenyth::logging::Category::category, format __VA_OPT__(,) __VA_ARGS__)
+#define ZENYTH_LOG_FATAL(category, format, ...) ZENYTH_LOG(::Zenyth::logging::Severity::Fatal, ::Zenyth::logging::Category::category, format __VA_OPT__(,) __VA_ARGS__)
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <tuple>
+
+namespace Zenyth::logging::detail {
+
+	// How each argument type is stored in a record and what std::format sees when it is decoded.
+	// Strings are copied (the caller's buffer may be gone by the time the record is formatted);
+	// everything else is copied as raw bytes.
+	template<typename T>
+	struct ArgCodec;
+
+	template<typename T>
+		requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+	struct ArgCodec<T> {
+		using Decoded = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+
+		static size_t Size(const T&) noexcept { return sizeof(Decoded); }
+
+		static std::byte* Encode(std::byte* out, const T value) noexcept {
+			const auto decoded = static_cast<Decoded>(value);
+			std::memcpy(out, &decoded, sizeof(decoded));
+			return out + sizeof(decoded);
+		}
+
+		static Decoded Decode(const std::byte*& in) noexcept {
+			Decoded value;
+			std::memcpy(&value, in, sizeof(value));
+			in += sizeof(value);
+			return value;
+		}
+	};
+
+	struct StringCodec {
+		using Decoded = std::string_view;
+
+		static size_t Size(const std::string_view text) noexcept { return sizeof(uint32_t) + text.size(); }
+
+		static std::byte* Encode(std::byte* out, const std::string_view text) noexcept {
+			const auto length = static_cast<uint32_t>(text.size());
+			std::memcpy(out, &length, sizeof(length));
+			std::memcpy(out + sizeof(length), text.data(), length);
+			return out + sizeof(length) + length;
+		}
+
+		static Decoded Decode(const std::byte*& in) noexcept {
+			uint32_t length;
+			std::memcpy(&length, in, sizeof(length));
+			const std::string_view text(reinterpret_cast<const char*>(in + sizeof(length)), length);
+			in += sizeof(length) + length;
+			return text;
+		}
+	};
+
+	template<> struct ArgCodec<const char*> : StringCodec {};
+	template<> struct ArgCodec<char*> : StringCodec {};
+	template<> struct ArgCodec<std::string> : StringCodec {};
+	template<> struct ArgCodec<std::string_view> : StringCodec {};
+
+	template<typename T>
+		requires std::is_pointer_v<T> && (!std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char>)
+	struct ArgCodec<T> {
+		using Decoded = const void*;
+
+		static size_t Size(T) noexcept { return sizeof(Decoded); }
+
+		static std::byte* Encode(std::byte* out, const T value) noexcept {
+			const Decoded pointer = value;
+			std::memcpy(out, &pointer, sizeof(pointer));
+			return out + sizeof(pointer);
+		}
+
+		static Decoded Decode(const std::byte*& in) noexcept {
+			Decoded pointer;
+			std::memcpy(&pointer, in, sizeof(pointer));
+			in += sizeof(pointer);
+			return pointer;
+		}
+	};
+
+	template<typename T>
+	using Codec = ArgCodec<std::decay_t<T>>;
+
+	using DecodeFn = void (*)(const Site& site, const std::byte* payload, std::string& out);
+
+	// Runs on the logger thread; braced initialization decodes the arguments left to right
+	template<typename... Args>
+	void Decode(const Site& site, const std::byte* payload, std::string& out) {
+		std::tuple<typename Codec<Args>::Decoded...> values{ Codec<Args>::Decode(payload)... };
+		std::apply([&](auto&... decoded) {
+			std::vformat_to(std::back_inserter(out), site.format, std::make_format_args(decoded...));
+		}, values);
+	}
+
+	// Reserves a record in the calling thread's ring; null when the ring is full
+	[[nodiscard]] std::byte* BeginRecord(const Site& site, DecodeFn decode, size_t payloadSize) noexcept;
+	void CommitRecord(const Site& site) noexcept;
+
+	// The format_string parameter only exists to check the format against the arguments at compile time
+	template<typename... Args>
+	void Write(const Site& site, std::format_string<typename Codec<Args>::Decoded...>, const Args&... args) noexcept {
+		const size_t payloadSize = (size_t{ 0 } + ... + Codec<Args>::Size(args));
+		std::byte* out = BeginRecord(site, &Decode<Args...>, payloadSize);
+		if (!out)
+			return;
+
+		((out = Codec<Args>::Encode(out, args)), ...);
+		CommitRecord(site);
+	}
+
+} // namespace Zenyth::logging::detail
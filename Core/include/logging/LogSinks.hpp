@@ -0,0 +1,44 @@
+#pragma once
+#include "logging/Log.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace Zenyth::logging {
+
+	// "hh:mm:ss.mmm [Level] [Category] text\n", UTC
+	void FormatLine(const Message& message, std::string& out);
+
+	// stdout, or stderr from Error up
+	class ConsoleSink final : public Sink {
+	public:
+		void Write(const Message& message) override;
+		void Flush() override;
+
+	private:
+		std::string m_line;
+	};
+
+	class FileSink final : public Sink {
+	public:
+		explicit FileSink(const std::filesystem::path& path, bool append = false);
+
+		void Write(const Message& message) override;
+		void Flush() override;
+
+	private:
+		std::ofstream m_file;
+		std::string   m_line;
+	};
+
+	// OutputDebugString on Windows; does nothing elsewhere
+	class DebuggerSink final : public Sink {
+	public:
+		void Write(const Message& message) override;
+
+	private:
+		std::string m_line;
+	};
+
+} // namespace Zenyth::logging
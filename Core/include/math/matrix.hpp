@@ -2,70 +2,604 @@
 #include "math/vector.hpp"
 #include <immintrin.h>
 #include <numbers>
+#include <utility>
 
 namespace zenyth::math {
+	// Column-major R x C float matrix; a scalar, constexpr fallback for any size. The shapes the
+	// engine leans on are specialized: 4x4 (mat4, one SSE register per column) and 3x4 (mat3x4,
+	// affine transforms as three SSE rows). 2x2 and 3x3 use this template and additionally get
+	// determinant() and inverse().
+	template<std::size_t R, std::size_t C>
+	class matN {
+	public:
+		static constexpr std::size_t width = C;
+		static constexpr std::size_t height = R;
+		static constexpr std::size_t size = R * C;
+
+		constexpr matN() noexcept = default;
+		constexpr explicit matN(const float diagonal) noexcept {
+			for (std::size_t i = 0; i < std::min(R, C); ++i)
+				m_data[i * R + i] = diagonal;
+		}
+
+		[[nodiscard]] static constexpr matN identity() noexcept requires (R == C) { return matN(1.0f); }
+		[[nodiscard]] static constexpr matN zero() noexcept { return {}; }
+
+		[[nodiscard]] constexpr matN operator+(const matN& rhs) const noexcept { return Map(rhs, [](float a, float b) { return a + b; }); }
+		[[nodiscard]] constexpr matN operator-(const matN& rhs) const noexcept { return Map(rhs, [](float a, float b) { return a - b; }); }
+		[[nodiscard]] constexpr matN operator*(const float scalar) const noexcept { return Map(*this, [scalar](float a, float) { return a * scalar; }); }
+		[[nodiscard]] constexpr matN operator/(const float scalar) const noexcept { return *this * (1.0f / scalar); }
+
+		// rhs may be any matN, specializations included
+		template<std::size_t K>
+		[[nodiscard]] constexpr matN<R, K> operator*(const matN<C, K>& rhs) const noexcept {
+			matN<R, K> out;
+			for (std::size_t c = 0; c < K; ++c) {
+				for (std::size_t r = 0; r < R; ++r) {
+					float sum = 0.0f;
+					for (std::size_t k = 0; k < C; ++k)
+						sum += (*this)[r, k] * rhs[k, c];
+					out[r, c] = sum;
+				}
+			}
+			return out;
+		}
+
+		[[nodiscard]] constexpr vecN<float, R> operator*(const vecN<float, C>& v) const noexcept {
+			std::array<float, R> out{};
+			for (std::size_t c = 0; c < C; ++c) {
+				for (std::size_t r = 0; r < R; ++r)
+					out[r] += (*this)[r, c] * v[c];
+			}
+			return [&]<std::size_t... I>(std::index_sequence<I...>) { return vecN<float, R>(out[I]...); }(std::make_index_sequence<R>());
+		}
+
+		[[nodiscard]] constexpr matN<C, R> transpose() const noexcept {
+			matN<C, R> out;
+			for (std::size_t c = 0; c < C; ++c) {
+				for (std::size_t r = 0; r < R; ++r)
+					out[c, r] = (*this)[r, c];
+			}
+			return out;
+		}
+
+		[[nodiscard]] constexpr float determinant() const noexcept requires (R == C && R <= 3) {
+			const matN& m = *this;
+			if constexpr (R == 1)
+				return m[0, 0];
+			else if constexpr (R == 2)
+				return m[0, 0] * m[1, 1] - m[0, 1] * m[1, 0];
+			else
+				return m[0, 0] * (m[1, 1] * m[2, 2] - m[1, 2] * m[2, 1])
+					- m[0, 1] * (m[1, 0] * m[2, 2] - m[1, 2] * m[2, 0])
+					+ m[0, 2] * (m[1, 0] * m[2, 1] - m[1, 1] * m[2, 0]);
+		}
+
+		// Adjugate over determinant; singular matrices give non-finite elements
+		[[nodiscard]] constexpr matN inverse() const noexcept requires (R == C && R <= 3) {
+			const matN& m = *this;
+			const float invDet = 1.0f / determinant();
+			matN out;
+			if constexpr (R == 1) {
+				out[0, 0] = invDet;
+			}
+			else if constexpr (R == 2) {
+				out[0, 0] = m[1, 1] * invDet;  out[0, 1] = -m[0, 1] * invDet;
+				out[1, 0] = -m[1, 0] * invDet; out[1, 1] = m[0, 0] * invDet;
+			}
+			else {
+				for (std::size_t r = 0; r < 3; ++r) {
+					for (std::size_t c = 0; c < 3; ++c) {
+						// Cofactor of (c, r), i.e. the transposed cofactor matrix
+						const std::size_t r0 = (c + 1) % 3, r1 = (c + 2) % 3;
+						const std::size_t c0 = (r + 1) % 3, c1 = (r + 2) % 3;
+						out[r, c] = (m[r0, c0] * m[r1, c1] - m[r0, c1] * m[r1, c0]) * invDet;
+					}
+				}
+			}
+			return out;
+		}
+
+		[[nodiscard]] constexpr float operator[](const std::size_t r, const std::size_t c) const noexcept { return m_data[c * R + r]; }
+		[[nodiscard]] constexpr float& operator[](const std::size_t r, const std::size_t c) noexcept { return m_data[c * R + r]; }
+
+		[[nodiscard]] const void* data() const noexcept { return m_data.data(); }
+		[[nodiscard]] void* data() noexcept { return m_data.data(); }
+
+	private:
+		template<typename F>
+		[[nodiscard]] constexpr matN Map(const matN& rhs, F&& fn) const noexcept {
+			matN out;
+			for (std::size_t i = 0; i < size; ++i)
+				out.m_data[i] = fn(m_data[i], rhs.m_data[i]);
+			return out;
+		}
+
+		std::array<float, R * C> m_data{};
+	};
+
+	using mat2 = matN<2, 2>;
+	using mat3 = matN<3, 3>;
+	using mat3x4 = matN<3, 4>;
+	using mat4 = matN<4, 4>;
+
 	// Column-major right handed 4x4 matrix
 	// Memory layout: col0(x,y,z,w), col1(x,y,z,w), col2(x,y,z,w), col3(x,y,z,w)
-	class mat4 {
+	//
+	// Everything except the inverse is inline and constexpr. Constant evaluation works on m_data
+	// with scalar code; at run time the same functions use SSE on m_col.
+	template<>
+	class matN<4, 4> {
 	public:
-		mat4() noexcept;
-		explicit mat4(float diagonal) noexcept;
-		mat4(const vec4& col0, const vec4& col1, const vec4& col2, const vec4& col3) noexcept;
+		constexpr matN() noexcept : m_data{} {}
+		constexpr explicit matN(float diagonal) noexcept;
+		constexpr matN(const vec4& col0, const vec4& col1, const vec4& col2, const vec4& col3) noexcept;
 
 		static constexpr uint32_t width = 4;
 		static constexpr uint32_t height = 4;
 		static constexpr uint32_t size = width * height;
 
-		[[nodiscard]] static mat4 identity() noexcept;
-		[[nodiscard]] static mat4 zero() noexcept;
+		[[nodiscard]] static constexpr mat4 identity() noexcept { return mat4(1.0f); }
+		[[nodiscard]] static constexpr mat4 zero() noexcept { return {}; }
 
-		[[nodiscard]] static mat4 from_basis(const vec3& right, const vec3& up, const vec3& forward) noexcept;
-		[[nodiscard]] static mat4 from_axis_angle(const vec3& axis, float angle_rad) noexcept;
-		[[nodiscard]] static mat4 from_euler(float pitch, float yaw, float roll) noexcept;
-		[[nodiscard]] static mat4 from_scale(const vec3& scale) noexcept;
-		[[nodiscard]] static mat4 from_translation(const vec3& t) noexcept;
+		// Maps the x, y and z axes onto right, up and forward
+		[[nodiscard]] static constexpr mat4 from_basis(const vec3& right, const vec3& up, const vec3& forward) noexcept;
+		[[nodiscard]] static constexpr mat4 from_axis_angle(const vec3& axis, float angle_rad) noexcept;
+		// Roll about z first, then pitch about x, then yaw about y
+		[[nodiscard]] static constexpr mat4 from_euler(float pitch, float yaw, float roll) noexcept;
+		[[nodiscard]] static constexpr mat4 from_scale(const vec3& scale) noexcept;
+		[[nodiscard]] static constexpr mat4 from_translation(const vec3& t) noexcept;
 
-		[[nodiscard]] mat4 operator+(const mat4& rhs) const noexcept;
-		[[nodiscard]] mat4 operator-(const mat4& rhs) const noexcept;
-		[[nodiscard]] mat4 operator*(float scalar) const noexcept;
-		[[nodiscard]] mat4 operator/(float scalar) const noexcept;
-		[[nodiscard]] mat4 operator*(const mat4& rhs) const noexcept;
+		[[nodiscard]] constexpr mat4 operator+(const mat4& rhs) const noexcept;
+		[[nodiscard]] constexpr mat4 operator-(const mat4& rhs) const noexcept;
+		[[nodiscard]] constexpr mat4 operator*(float scalar) const noexcept;
+		[[nodiscard]] constexpr mat4 operator/(float scalar) const noexcept { return *this * (1.0f / scalar); }
+		[[nodiscard]] constexpr mat4 operator*(const mat4& rhs) const noexcept;
 
-		mat4& operator+=(const mat4& rhs) noexcept;
-		mat4& operator-=(const mat4& rhs) noexcept;
-		mat4& operator*=(float scalar) noexcept;
-		mat4& operator/=(float scalar) noexcept;
-		mat4& operator*=(const mat4& rhs) noexcept;
+		constexpr mat4& operator+=(const mat4& rhs) noexcept { return *this = *this + rhs; }
+		constexpr mat4& operator-=(const mat4& rhs) noexcept { return *this = *this - rhs; }
+		constexpr mat4& operator*=(const float scalar) noexcept { return *this = *this * scalar; }
+		constexpr mat4& operator/=(const float scalar) noexcept { return *this = *this / scalar; }
+		constexpr mat4& operator*=(const mat4& rhs) noexcept { return *this = *this * rhs; }
 
-		[[nodiscard]] mat4  transpose() const noexcept;
+		[[nodiscard]] constexpr mat4 transpose() const noexcept;
 		[[nodiscard]] float determinant() const noexcept;
 		[[nodiscard]] mat4  inverse() const noexcept;
-		[[nodiscard]] mat4  inverse_transpose() const noexcept;
+		[[nodiscard]] mat4  inverse_transpose() const noexcept { return inverse().transpose(); }
 
 		// Transform a position; applies translation
-		[[nodiscard]] vec3 transform_point(const vec3& p)  const noexcept;
+		[[nodiscard]] constexpr vec3 transform_point(const vec3& p)  const noexcept;
 		// Transform a direction: ignores translation
-		[[nodiscard]] vec3 transform_normal(const vec3& n) const noexcept;
+		[[nodiscard]] constexpr vec3 transform_normal(const vec3& n) const noexcept;
 
-		[[nodiscard]] vec4 operator*(const vec4& v) const noexcept;
+		[[nodiscard]] constexpr vec4 operator*(const vec4& v) const noexcept;
 
-		[[nodiscard]] static mat4 look_at(const vec3& eye, const vec3& center, const vec3& up) noexcept;
-		[[nodiscard]] static mat4 perspective(float fov_y, float aspect, float near_z, float far_z) noexcept;
-		[[nodiscard]] static mat4 orthographic(float left, float right, float bottom, float top, float near_z, float far_z) noexcept;
-		[[nodiscard]] static mat4 perspective_reverse_z(float fov_y, float aspect, float near_z) noexcept;
+		[[nodiscard]] static constexpr mat4 look_at(const vec3& eye, const vec3& center, const vec3& up) noexcept;
+		// Projections are right handed and map depth to [0, 1]
+		[[nodiscard]] static constexpr mat4 perspective(float fov_y, float aspect, float near_z, float far_z) noexcept;
+		[[nodiscard]] static constexpr mat4 orthographic(float left, float right, float bottom, float top, float near_z, float far_z) noexcept;
+		// Infinite far plane, depth 1 at near_z falling towards 0 at infinity
+		[[nodiscard]] static constexpr mat4 perspective_reverse_z(float fov_y, float aspect, float near_z) noexcept;
 
-		[[nodiscard]] float operator[](const std::size_t r, const std::size_t c) const noexcept { return m_data[c * 4 + r]; }
-		[[nodiscard]] float& operator[](const std::size_t r, const std::size_t c) noexcept { return m_data[c * 4 + r];}
+		[[nodiscard]] constexpr float operator[](const std::size_t r, const std::size_t c) const noexcept { return m_data[c * 4 + r]; }
+		[[nodiscard]] constexpr float& operator[](const std::size_t r, const std::size_t c) noexcept { return m_data[c * 4 + r];}
 
 		[[nodiscard]] const void* data() const noexcept { return m_data; }
 		[[nodiscard]] void* data() noexcept { return m_data; }
 
 	private:
-		mat4(__m128 c0, __m128 c1, __m128 c2, __m128 c3) noexcept;
+		friend class matN<3, 4>;
+		matN(const __m128 c0, const __m128 c1, const __m128 c2, const __m128 c3) noexcept : m_col{ c0, c1, c2, c3 } {}
+
+		[[nodiscard]] static __m128 Combine(const __m128 (&cols)[4], const __m128 v) noexcept {
+			__m128 r = _mm_mul_ps(cols[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = _mm_add_ps(r, _mm_mul_ps(cols[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm_add_ps(r, _mm_mul_ps(cols[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+			return _mm_add_ps(r, _mm_mul_ps(cols[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+		}
 
 		union {
-			float m_data[16] {};
+			float m_data[16];
 			__m128 m_col[4];
 		};
 	};
+
+	// Affine transform stored as the top three rows of a 4x4 matrix, the last row being implicitly
+	// 0 0 0 1. Takes 48 bytes instead of 64, and composing two costs 9 multiplies per row of
+	// four lanes instead of 16 per column. Row-major: m_row[r] = (r0, r1, r2, translation r).
+	template<>
+	class matN<3, 4> {
+	public:
+		constexpr matN() noexcept : m_data{} {}
+		constexpr explicit matN(float diagonal) noexcept;
+		constexpr matN(const vec4& row0, const vec4& row1, const vec4& row2) noexcept;
+		// Drops the last row, which must be 0 0 0 1 for the result to mean the same transform
+		constexpr explicit matN(const mat4& m) noexcept;
+
+		static constexpr uint32_t width = 4;
+		static constexpr uint32_t height = 3;
+		static constexpr uint32_t size = width * height;
+
+		[[nodiscard]] static constexpr mat3x4 identity() noexcept { return mat3x4(1.0f); }
+		[[nodiscard]] static constexpr mat3x4 from_translation(const vec3& t) noexcept;
+		[[nodiscard]] static constexpr mat3x4 from_scale(const vec3& scale) noexcept;
+
+		[[nodiscard]] constexpr mat4 to_mat4() const noexcept;
+
+		// Composition: applies rhs first, then this
+		[[nodiscard]] constexpr mat3x4 operator*(const mat3x4& rhs) const noexcept;
+		constexpr mat3x4& operator*=(const mat3x4& rhs) noexcept { return *this = *this * rhs; }
+
+		[[nodiscard]] constexpr vec3 transform_point(const vec3& p) const noexcept;
+		[[nodiscard]] constexpr vec3 transform_normal(const vec3& n) const noexcept;
+
+		// Inverse of the affine transform; the linear part must be invertible
+		[[nodiscard]] constexpr mat3x4 inverse() const noexcept;
+
+		[[nodiscard]] constexpr float operator[](const std::size_t r, const std::size_t c) const noexcept { return m_data[r * 4 + c]; }
+		[[nodiscard]] constexpr float& operator[](const std::size_t r, const std::size_t c) noexcept { return m_data[r * 4 + c]; }
+
+		[[nodiscard]] const void* data() const noexcept { return m_data; }
+		[[nodiscard]] void* data() noexcept { return m_data; }
+
+	private:
+		union {
+			float m_data[12];
+			__m128 m_row[3];
+		};
+	};
+
+#pragma region mat4
+
+	constexpr mat4::matN(const float diagonal) noexcept
+		: m_data{ diagonal, 0.0f, 0.0f, 0.0f, 0.0f, diagonal, 0.0f, 0.0f, 0.0f, 0.0f, diagonal, 0.0f, 0.0f, 0.0f, 0.0f, diagonal } {}
+
+	constexpr mat4::matN(const vec4& col0, const vec4& col1, const vec4& col2, const vec4& col3) noexcept
+		: m_data{} {
+		if (std::is_constant_evaluated()) {
+			const vec4* cols[4] = { &col0, &col1, &col2, &col3 };
+			for (std::size_t c = 0; c < 4; ++c) {
+				for (std::size_t r = 0; r < 4; ++r)
+					m_data[c * 4 + r] = (*cols[c])[r];
+			}
+		}
+		else {
+			m_col[0] = col0.m_simd;
+			m_col[1] = col1.m_simd;
+			m_col[2] = col2.m_simd;
+			m_col[3] = col3.m_simd;
+		}
+	}
+
+	constexpr mat4 mat4::from_basis(const vec3& right, const vec3& up, const vec3& forward) noexcept {
+		return {
+			vec4(right.x(), right.y(), right.z(), 0.0f),
+			vec4(up.x(), up.y(), up.z(), 0.0f),
+			vec4(forward.x(), forward.y(), forward.z(), 0.0f),
+			vec4(0.0f, 0.0f, 0.0f, 1.0f)
+		};
+	}
+
+	constexpr mat4 mat4::from_axis_angle(const vec3& axis, const float angle_rad) noexcept {
+		const vec3  n = axis / axis.length();
+		const float c = math::cos(angle_rad), s = math::sin(angle_rad), t = 1.0f - c;
+		const float x = n.x(), y = n.y(), z = n.z();
+
+		return {
+			vec4(t * x * x + c, t * x * y + s * z, t * x * z - s * y, 0.0f),
+			vec4(t * x * y - s * z, t * y * y + c, t * y * z + s * x, 0.0f),
+			vec4(t * x * z + s * y, t * y * z - s * x, t * z * z + c, 0.0f),
+			vec4(0.0f, 0.0f, 0.0f, 1.0f)
+		};
+	}
+
+	constexpr mat4 mat4::from_euler(const float pitch, const float yaw, const float roll) noexcept {
+		return from_axis_angle(vec3(0.0f, 1.0f, 0.0f), yaw)
+			* from_axis_angle(vec3(1.0f, 0.0f, 0.0f), pitch)
+			* from_axis_angle(vec3(0.0f, 0.0f, 1.0f), roll);
+	}
+
+	constexpr mat4 mat4::from_scale(const vec3& scale) noexcept {
+		return {
+			vec4(scale.x(), 0.0f, 0.0f, 0.0f),
+			vec4(0.0f, scale.y(), 0.0f, 0.0f),
+			vec4(0.0f, 0.0f, scale.z(), 0.0f),
+			vec4(0.0f, 0.0f, 0.0f, 1.0f)
+		};
+	}
+
+	constexpr mat4 mat4::from_translation(const vec3& t) noexcept {
+		return {
+			vec4(1.0f, 0.0f, 0.0f, 0.0f),
+			vec4(0.0f, 1.0f, 0.0f, 0.0f),
+			vec4(0.0f, 0.0f, 1.0f, 0.0f),
+			vec4(t.x(), t.y(), t.z(), 1.0f)
+		};
+	}
+
+	constexpr mat4 mat4::operator+(const mat4& rhs) const noexcept {
+		if (std::is_constant_evaluated()) {
+			mat4 out;
+			for (std::size_t i = 0; i < 16; ++i)
+				out.m_data[i] = m_data[i] + rhs.m_data[i];
+			return out;
+		}
+		return {
+			_mm_add_ps(m_col[0], rhs.m_col[0]), _mm_add_ps(m_col[1], rhs.m_col[1]),
+			_mm_add_ps(m_col[2], rhs.m_col[2]), _mm_add_ps(m_col[3], rhs.m_col[3])
+		};
+	}
+
+	constexpr mat4 mat4::operator-(const mat4& rhs) const noexcept {
+		if (std::is_constant_evaluated()) {
+			mat4 out;
+			for (std::size_t i = 0; i < 16; ++i)
+				out.m_data[i] = m_data[i] - rhs.m_data[i];
+			return out;
+		}
+		return {
+			_mm_sub_ps(m_col[0], rhs.m_col[0]), _mm_sub_ps(m_col[1], rhs.m_col[1]),
+			_mm_sub_ps(m_col[2], rhs.m_col[2]), _mm_sub_ps(m_col[3], rhs.m_col[3])
+		};
+	}
+
+	constexpr mat4 mat4::operator*(const float scalar) const noexcept {
+		if (std::is_constant_evaluated()) {
+			mat4 out;
+			for (std::size_t i = 0; i < 16; ++i)
+				out.m_data[i] = m_data[i] * scalar;
+			return out;
+		}
+		const __m128 s = _mm_set1_ps(scalar);
+		return {
+			_mm_mul_ps(m_col[0], s), _mm_mul_ps(m_col[1], s),
+			_mm_mul_ps(m_col[2], s), _mm_mul_ps(m_col[3], s)
+		};
+	}
+
+	constexpr mat4 mat4::operator*(const mat4& rhs) const noexcept {
+		if (std::is_constant_evaluated()) {
+			mat4 out;
+			for (std::size_t c = 0; c < 4; ++c) {
+				for (std::size_t r = 0; r < 4; ++r) {
+					float sum = 0.0f;
+					for (std::size_t k = 0; k < 4; ++k)
+						sum += m_data[k * 4 + r] * rhs.m_data[c * 4 + k];
+					out.m_data[c * 4 + r] = sum;
+				}
+			}
+			return out;
+		}
+		// Each result column is a linear combination of our columns weighted by the rhs column
+		return { Combine(m_col, rhs.m_col[0]), Combine(m_col, rhs.m_col[1]), Combine(m_col, rhs.m_col[2]), Combine(m_col, rhs.m_col[3]) };
+	}
+
+	constexpr mat4 mat4::transpose() const noexcept {
+		if (std::is_constant_evaluated()) {
+			mat4 out;
+			for (std::size_t c = 0; c < 4; ++c) {
+				for (std::size_t r = 0; r < 4; ++r)
+					out.m_data[r * 4 + c] = m_data[c * 4 + r];
+			}
+			return out;
+		}
+		__m128 c0 = m_col[0], c1 = m_col[1], c2 = m_col[2], c3 = m_col[3];
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+		return { c0, c1, c2, c3 };
+	}
+
+	constexpr vec4 mat4::operator*(const vec4& v) const noexcept {
+		if (std::is_constant_evaluated()) {
+			float out[4] = {};
+			for (std::size_t c = 0; c < 4; ++c) {
+				for (std::size_t r = 0; r < 4; ++r)
+					out[r] += m_data[c * 4 + r] * v[c];
+			}
+			return { out[0], out[1], out[2], out[3] };
+		}
+		return vec4{ Combine(m_col, v.m_simd) };
+	}
+
+	constexpr vec3 mat4::transform_point(const vec3& p) const noexcept {
+		const vec4 r = *this * vec4{ p.x(), p.y(), p.z(), 1.0f };
+		return { r.x(), r.y(), r.z() };
+	}
+
+	constexpr vec3 mat4::transform_normal(const vec3& n) const noexcept {
+		const vec4 r = *this * vec4{ n.x(), n.y(), n.z(), 0.0f };
+		return { r.x(), r.y(), r.z() };
+	}
+
+	constexpr mat4 mat4::look_at(const vec3& eye, const vec3& center, const vec3& up) noexcept {
+		const vec3 f = (center - eye) / (center - eye).length();
+		const vec3 s = f.cross(up) / f.cross(up).length();
+		const vec3 u = s.cross(f);
+
+		return {
+			vec4(s.x(), u.x(), -f.x(), 0.0f),
+			vec4(s.y(), u.y(), -f.y(), 0.0f),
+			vec4(s.z(), u.z(), -f.z(), 0.0f),
+			vec4(-s.dot(eye), -u.dot(eye), f.dot(eye), 1.0f)
+		};
+	}
+
+	constexpr mat4 mat4::perspective(const float fov_y, const float aspect, const float near_z, const float far_z) noexcept {
+		const float y = 1.0f / math::tan(fov_y * 0.5f);
+
+		return {
+			vec4(y / aspect, 0.0f, 0.0f, 0.0f),
+			vec4(0.0f, y, 0.0f, 0.0f),
+			vec4(0.0f, 0.0f, far_z / (near_z - far_z), -1.0f),
+			vec4(0.0f, 0.0f, near_z * far_z / (near_z - far_z), 0.0f)
+		};
+	}
+
+	constexpr mat4 mat4::orthographic(const float left, const float right, const float bottom, const float top, const float near_z, const float far_z) noexcept {
+		return {
+			vec4(2.0f / (right - left), 0.0f, 0.0f, 0.0f),
+			vec4(0.0f, 2.0f / (top - bottom), 0.0f, 0.0f),
+			vec4(0.0f, 0.0f, 1.0f / (near_z - far_z), 0.0f),
+			vec4((left + right) / (left - right), (top + bottom) / (bottom - top), near_z / (near_z - far_z), 1.0f)
+		};
+	}
+
+	constexpr mat4 mat4::perspective_reverse_z(const float fov_y, const float aspect, const float near_z) noexcept {
+		const float y = 1.0f / math::tan(fov_y * 0.5f);
+
+		return {
+			vec4(y / aspect, 0.0f, 0.0f, 0.0f),
+			vec4(0.0f, y, 0.0f, 0.0f),
+			vec4(0.0f, 0.0f, 0.0f, -1.0f),
+			vec4(0.0f, 0.0f, near_z, 0.0f)
+		};
+	}
+
+#pragma endregion
+
+#pragma region mat3x4
+
+	constexpr mat3x4::matN(const float diagonal) noexcept
+		: m_data{ diagonal, 0.0f, 0.0f, 0.0f, 0.0f, diagonal, 0.0f, 0.0f, 0.0f, 0.0f, diagonal, 0.0f } {}
+
+	constexpr mat3x4::matN(const vec4& row0, const vec4& row1, const vec4& row2) noexcept
+		: m_data{} {
+		if (std::is_constant_evaluated()) {
+			const vec4* rows[3] = { &row0, &row1, &row2 };
+			for (std::size_t r = 0; r < 3; ++r) {
+				for (std::size_t c = 0; c < 4; ++c)
+					m_data[r * 4 + c] = (*rows[r])[c];
+			}
+		}
+		else {
+			m_row[0] = row0.m_simd;
+			m_row[1] = row1.m_simd;
+			m_row[2] = row2.m_simd;
+		}
+	}
+
+	constexpr mat3x4::matN(const mat4& m) noexcept
+		: m_data{} {
+		if (std::is_constant_evaluated()) {
+			for (std::size_t r = 0; r < 3; ++r) {
+				for (std::size_t c = 0; c < 4; ++c)
+					m_data[r * 4 + c] = m[r, c];
+			}
+		}
+		else {
+			__m128 c0 = m.m_col[0], c1 = m.m_col[1], c2 = m.m_col[2], c3 = m.m_col[3];
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			m_row[0] = c0;
+			m_row[1] = c1;
+			m_row[2] = c2;
+		}
+	}
+
+	constexpr mat3x4 mat3x4::from_translation(const vec3& t) noexcept {
+		mat3x4 out(1.0f);
+		out[0, 3] = t.x();
+		out[1, 3] = t.y();
+		out[2, 3] = t.z();
+		return out;
+	}
+
+	constexpr mat3x4 mat3x4::from_scale(const vec3& scale) noexcept {
+		mat3x4 out;
+		out[0, 0] = scale.x();
+		out[1, 1] = scale.y();
+		out[2, 2] = scale.z();
+		return out;
+	}
+
+	constexpr mat4 mat3x4::to_mat4() const noexcept {
+		const mat3x4& m = *this;
+		return {
+			vec4(m[0, 0], m[1, 0], m[2, 0], 0.0f),
+			vec4(m[0, 1], m[1, 1], m[2, 1], 0.0f),
+			vec4(m[0, 2], m[1, 2], m[2, 2], 0.0f),
+			vec4(m[0, 3], m[1, 3], m[2, 3], 1.0f)
+		};
+	}
+
+	constexpr mat3x4 mat3x4::operator*(const mat3x4& rhs) const noexcept {
+		if (std::is_constant_evaluated()) {
+			mat3x4 out;
+			for (std::size_t r = 0; r < 3; ++r) {
+				for (std::size_t c = 0; c < 4; ++c) {
+					float sum = c == 3 ? m_data[r * 4 + 3] : 0.0f;
+					for (std::size_t k = 0; k < 3; ++k)
+						sum += m_data[r * 4 + k] * rhs.m_data[k * 4 + c];
+					out.m_data[r * 4 + c] = sum;
+				}
+			}
+			return out;
+		}
+
+		// Row r of the result is a combination of the rhs rows weighted by our row r, plus our
+		// translation in the last lane
+		const __m128 translationLane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+		mat3x4 out;
+		for (int r = 0; r < 3; ++r) {
+			const __m128 row = m_row[r];
+			__m128 v = _mm_mul_ps(rhs.m_row[0], _mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)));
+			v = _mm_add_ps(v, _mm_mul_ps(rhs.m_row[1], _mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1))));
+			v = _mm_add_ps(v, _mm_mul_ps(rhs.m_row[2], _mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2))));
+			out.m_row[r] = _mm_add_ps(v, _mm_and_ps(row, translationLane));
+		}
+		return out;
+	}
+
+	constexpr vec3 mat3x4::transform_point(const vec3& p) const noexcept {
+		if (std::is_constant_evaluated()) {
+			const mat3x4& m = *this;
+			return {
+				m[0, 0] * p.x() + m[0, 1] * p.y() + m[0, 2] * p.z() + m[0, 3],
+				m[1, 0] * p.x() + m[1, 1] * p.y() + m[1, 2] * p.z() + m[1, 3],
+				m[2, 0] * p.x() + m[2, 1] * p.y() + m[2, 2] * p.z() + m[2, 3]
+			};
+		}
+		const __m128 v = _mm_insert_ps(p.m_simd, _mm_set_ss(1.0f), 0x30);
+		const __m128 x = _mm_dp_ps(m_row[0], v, 0xF1);
+		const __m128 y = _mm_dp_ps(m_row[1], v, 0xF2);
+		const __m128 z = _mm_dp_ps(m_row[2], v, 0xF4);
+		return vec3{ _mm_or_ps(_mm_or_ps(x, y), z) };
+	}
+
+	constexpr vec3 mat3x4::transform_normal(const vec3& n) const noexcept {
+		if (std::is_constant_evaluated()) {
+			const mat3x4& m = *this;
+			return {
+				m[0, 0] * n.x() + m[0, 1] * n.y() + m[0, 2] * n.z(),
+				m[1, 0] * n.x() + m[1, 1] * n.y() + m[1, 2] * n.z(),
+				m[2, 0] * n.x() + m[2, 1] * n.y() + m[2, 2] * n.z()
+			};
+		}
+		const __m128 x = _mm_dp_ps(m_row[0], n.m_simd, 0x71);
+		const __m128 y = _mm_dp_ps(m_row[1], n.m_simd, 0x72);
+		const __m128 z = _mm_dp_ps(m_row[2], n.m_simd, 0x74);
+		return vec3{ _mm_or_ps(_mm_or_ps(x, y), z) };
+	}
+
+	constexpr mat3x4 mat3x4::inverse() const noexcept {
+		const mat3x4& m = *this;
+		mat3 linear;
+		for (std::size_t r = 0; r < 3; ++r) {
+			for (std::size_t c = 0; c < 3; ++c)
+				linear[r, c] = m[r, c];
+		}
+		const mat3 inv = linear.inverse();
+
+		mat3x4 out;
+		for (std::size_t r = 0; r < 3; ++r) {
+			float translation = 0.0f;
+			for (std::size_t c = 0; c < 3; ++c) {
+				out[r, c] = inv[r, c];
+				translation -= inv[r, c] * m[c, 3];
+			}
+			out[r, 3] = translation;
+		}
+		return out;
+	}
+
+#pragma endregion
+
 } // namespace zenyth::math
@@ -0,0 +1,116 @@
+#pragma once
+#include "math/matrix.hpp"
+
+namespace zenyth::math {
+	// Unit quaternion (x, y, z, w) with w as the scalar part
+	class quat {
+	public:
+		constexpr quat() noexcept : m_components{ 0.0f, 0.0f, 0.0f, 1.0f } {}
+		constexpr quat(const float x, const float y, const float z, const float w) noexcept : m_components{ x, y, z, w } {}
+
+		[[nodiscard]] static constexpr quat identity() noexcept { return {}; }
+		[[nodiscard]] static constexpr quat from_axis_angle(const vec3& axis, float angle_rad) noexcept;
+
+		[[nodiscard]] constexpr float x() const noexcept { return m_components.m_x; }
+		[[nodiscard]] constexpr float y() const noexcept { return m_components.m_y; }
+		[[nodiscard]] constexpr float z() const noexcept { return m_components.m_z; }
+		[[nodiscard]] constexpr float w() const noexcept { return m_components.m_w; }
+
+		constexpr float& x() noexcept { return m_components.m_x; }
+		constexpr float& y() noexcept { return m_components.m_y; }
+		constexpr float& z() noexcept { return m_components.m_z; }
+		constexpr float& w() noexcept { return m_components.m_w; }
+
+		// Hamilton product: applies rhs first, then this
+		[[nodiscard]] constexpr quat operator*(const quat& rhs) const noexcept;
+		[[nodiscard]] constexpr quat operator*(float scalar) const noexcept;
+		[[nodiscard]] constexpr quat operator+(const quat& rhs) const noexcept;
+
+		[[nodiscard]] constexpr quat  conjugate() const noexcept { return { -x(), -y(), -z(), w() }; }
+		[[nodiscard]] constexpr quat  normalized() const noexcept { return *this * (1.0f / length()); }
+		[[nodiscard]] constexpr float dot(const quat& other) const noexcept;
+		[[nodiscard]] constexpr float length() const noexcept { return math::sqrt(dot(*this)); }
+
+		[[nodiscard]] constexpr vec3   rotate(const vec3& v) const noexcept;
+		[[nodiscard]] constexpr mat4   to_mat4() const noexcept;
+		[[nodiscard]] constexpr mat3x4 to_mat3x4() const noexcept;
+
+	private:
+		explicit quat(const __m128 simd) noexcept : m_simd(simd) {}
+
+		union {
+			struct { float m_x, m_y, m_z, m_w; } m_components;
+			__m128 m_simd;
+		};
+	};
+
+	constexpr quat quat::from_axis_angle(const vec3& axis, const float angle_rad) noexcept {
+		const vec3  n = axis / axis.length();
+		const float s = math::sin(angle_rad * 0.5f);
+		return { n.x() * s, n.y() * s, n.z() * s, math::cos(angle_rad * 0.5f) };
+	}
+
+	constexpr quat quat::operator*(const quat& rhs) const noexcept {
+		const auto& a = m_components;
+		const auto& b = rhs.m_components;
+		return {
+			a.m_w * b.m_x + a.m_x * b.m_w + a.m_y * b.m_z - a.m_z * b.m_y,
+			a.m_w * b.m_y - a.m_x * b.m_z + a.m_y * b.m_w + a.m_z * b.m_x,
+			a.m_w * b.m_z + a.m_x * b.m_y - a.m_y * b.m_x + a.m_z * b.m_w,
+			a.m_w * b.m_w - a.m_x * b.m_x - a.m_y * b.m_y - a.m_z * b.m_z
+		};
+	}
+
+	constexpr quat quat::operator*(const float scalar) const noexcept {
+		if (std::is_constant_evaluated())
+			return { x() * scalar, y() * scalar, z() * scalar, w() * scalar };
+		return quat{ _mm_mul_ps(m_simd, _mm_set1_ps(scalar)) };
+	}
+
+	constexpr quat quat::operator+(const quat& rhs) const noexcept {
+		if (std::is_constant_evaluated())
+			return { x() + rhs.x(), y() + rhs.y(), z() + rhs.z(), w() + rhs.w() };
+		return quat{ _mm_add_ps(m_simd, rhs.m_simd) };
+	}
+
+	constexpr float quat::dot(const quat& other) const noexcept {
+		if (std::is_constant_evaluated())
+			return x() * other.x() + y() * other.y() + z() * other.z() + w() * other.w();
+		return _mm_cvtss_f32(_mm_dp_ps(m_simd, other.m_simd, 0xF1));
+	}
+
+	constexpr vec3 quat::rotate(const vec3& v) const noexcept {
+		// v' = v + 2w(q x v) + 2(q x (q x v))
+		const vec3 q{ m_components.m_x, m_components.m_y, m_components.m_z };
+		const vec3 t = q.cross(v) * 2.0f;
+		return v + t * m_components.m_w + q.cross(t);
+	}
+
+	constexpr mat4 quat::to_mat4() const noexcept {
+		const auto& [x, y, z, w] = m_components;
+		const float xx = x * x, yy = y * y, zz = z * z;
+		const float xy = x * y, xz = x * z, yz = y * z;
+		const float wx = w * x, wy = w * y, wz = w * z;
+
+		return {
+			vec4{ 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f },
+			vec4{ 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f },
+			vec4{ 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f },
+			vec4{ 0.0f, 0.0f, 0.0f, 1.0f }
+		};
+	}
+
+	// Same rotation as to_mat4(), written straight into rows
+	constexpr mat3x4 quat::to_mat3x4() const noexcept {
+		const auto& [x, y, z, w] = m_components;
+		const float xx = x * x, yy = y * y, zz = z * z;
+		const float xy = x * y, xz = x * z, yz = y * z;
+		const float wx = w * x, wy = w * y, wz = w * z;
+
+		return {
+			vec4{ 1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy), 0.0f },
+			vec4{ 2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx), 0.0f },
+			vec4{ 2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy), 0.0f }
+		};
+	}
+} // namespace zenyth::math
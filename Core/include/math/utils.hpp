@@ -1,8 +1,81 @@
 #pragma once
 #include "constants.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
 namespace zenyth::math {
 	[[nodiscard]] constexpr float rad(const float deg) noexcept { return deg * PI / 180.0f; }
 	[[nodiscard]] constexpr float deg(const float rad) noexcept { return rad * 180.0f / PI; }
 	[[nodiscard]] constexpr float clamp(const float val, const float min, const float max) noexcept { return std::min(max, std::max(val, min)); }
+
+	namespace detail {
+		// Compile time stand-ins for <cmath>, evaluated in double and accurate to float precision
+		constexpr double sqrt_newton(const double x) noexcept {
+			if (!(x > 0.0))
+				return 0.0;
+			double r = x > 1.0 ? x : 1.0;
+			for (int i = 0; i < 128; ++i) {
+				const double next = 0.5 * (r + x / r);
+				if (next >= r)
+					break;
+				r = next;
+			}
+			return r;
+		}
+
+		constexpr double wrap_pi(double x) noexcept {
+			constexpr double Pi = std::numbers::pi;
+			x -= static_cast<double>(static_cast<long long>(x / (2.0 * Pi))) * 2.0 * Pi;
+			if (x > Pi)  x -= 2.0 * Pi;
+			if (x < -Pi) x += 2.0 * Pi;
+			return x;
+		}
+
+		constexpr double sin_series(double x) noexcept {
+			x = wrap_pi(x);
+			double term = x, sum = x;
+			for (int i = 1; i < 12; ++i) {
+				term *= -x * x / static_cast<double>((2 * i) * (2 * i + 1));
+				sum += term;
+			}
+			return sum;
+		}
+
+		constexpr double cos_series(double x) noexcept {
+			x = wrap_pi(x);
+			double term = 1.0, sum = 1.0;
+			for (int i = 1; i < 12; ++i) {
+				term *= -x * x / static_cast<double>((2 * i - 1) * (2 * i));
+				sum += term;
+			}
+			return sum;
+		}
+	} // namespace detail
+
+	// <cmath> at run time, usable in constant expressions
+	[[nodiscard]] constexpr float sqrt(const float x) noexcept {
+		if (std::is_constant_evaluated())
+			return static_cast<float>(detail::sqrt_newton(x));
+		return std::sqrt(x);
+	}
+
+	[[nodiscard]] constexpr float sin(const float x) noexcept {
+		if (std::is_constant_evaluated())
+			return static_cast<float>(detail::sin_series(x));
+		return std::sin(x);
+	}
+
+	[[nodiscard]] constexpr float cos(const float x) noexcept {
+		if (std::is_constant_evaluated())
+			return static_cast<float>(detail::cos_series(x));
+		return std::cos(x);
+	}
+
+	[[nodiscard]] constexpr float tan(const float x) noexcept {
+		if (std::is_constant_evaluated())
+			return static_cast<float>(detail::sin_series(x) / detail::cos_series(x));
+		return std::tan(x);
+	}
 } // namespace zenyth::math
@@ -1,114 +1,300 @@
 #pragma once
+#include "math/utils.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <immintrin.h>
+#include <type_traits>
 
 namespace zenyth::math {
-	class vec2 {
+	template<std::size_t R, std::size_t C>
+	class matN;
+
+	// Fixed size vector of any arithmetic type. float 2, 3 and 4 are specialized below as vec2
+	// (plain floats) and the SSE backed vec3 and vec4; all of them are usable in constant expressions.
+	template<typename T, std::size_t N>
+	class vecN {
+	public:
+		static_assert(std::is_arithmetic_v<T> && N > 0);
+		static constexpr std::size_t size = N;
+
+		constexpr vecN() noexcept = default;
+		constexpr explicit vecN(const T scalar) noexcept { m_data.fill(scalar); }
+
+		template<typename... Ts>
+			requires (N > 1 && sizeof...(Ts) == N && (std::convertible_to<Ts, T> && ...))
+		constexpr vecN(const Ts... values) noexcept : m_data{ static_cast<T>(values)... } {}
+
+		[[nodiscard]] constexpr T  operator[](const std::size_t i) const noexcept { return m_data[i]; }
+		[[nodiscard]] constexpr T& operator[](const std::size_t i) noexcept { return m_data[i]; }
+
+		[[nodiscard]] constexpr vecN operator+(const vecN& other) const noexcept { return Map(other, [](T a, T b) { return a + b; }); }
+		[[nodiscard]] constexpr vecN operator-(const vecN& other) const noexcept { return Map(other, [](T a, T b) { return a - b; }); }
+		[[nodiscard]] constexpr vecN operator*(const T scalar) const noexcept { return Map(*this, [scalar](T a, T) { return a * scalar; }); }
+		[[nodiscard]] constexpr vecN operator/(const T scalar) const noexcept { return Map(*this, [scalar](T a, T) { return a / scalar; }); }
+		[[nodiscard]] constexpr vecN operator-() const noexcept { return Map(*this, [](T a, T) { return -a; }); }
+
+		constexpr void operator+=(const vecN& other) noexcept { *this = *this + other; }
+		constexpr void operator-=(const vecN& other) noexcept { *this = *this - other; }
+		constexpr void operator*=(const T scalar) noexcept { *this = *this * scalar; }
+		constexpr void operator/=(const T scalar) noexcept { *this = *this / scalar; }
+
+		[[nodiscard]] constexpr bool operator==(const vecN& other) const noexcept = default;
+
+		// Component-wise
+		[[nodiscard]] constexpr vecN min(const vecN& other) const noexcept { return Map(other, [](T a, T b) { return b < a ? b : a; }); }
+		[[nodiscard]] constexpr vecN max(const vecN& other) const noexcept { return Map(other, [](T a, T b) { return a < b ? b : a; }); }
+
+		[[nodiscard]] constexpr T dot(const vecN& other) const noexcept {
+			T sum{};
+			for (std::size_t i = 0; i < N; ++i)
+				sum += m_data[i] * other.m_data[i];
+			return sum;
+		}
+		[[nodiscard]] constexpr T length_sq() const noexcept { return dot(*this); }
+		[[nodiscard]] constexpr float length() const noexcept { return math::sqrt(static_cast<float>(length_sq())); }
+
+	private:
+		template<typename F>
+		[[nodiscard]] constexpr vecN Map(const vecN& other, F&& fn) const noexcept {
+			vecN out;
+			for (std::size_t i = 0; i < N; ++i)
+				out.m_data[i] = static_cast<T>(fn(m_data[i], other.m_data[i]));
+			return out;
+		}
+
+		std::array<T, N> m_data{};
+	};
+
+	using vec2 = vecN<float, 2>;
+	using vec3 = vecN<float, 3>;
+	using vec4 = vecN<float, 4>;
+
+	template<>
+	class vecN<float, 2> {
 	public:
-		explicit vec2(float scalar);
-		vec2(float x, float y);
-		vec2();
+		static constexpr std::size_t size = 2;
 
-		[[nodiscard]] float x() const noexcept;
-		[[nodiscard]] float y() const noexcept;
+		constexpr explicit vecN(const float scalar) noexcept : m_x(scalar), m_y(scalar) {}
+		constexpr vecN(const float x, const float y) noexcept : m_x(x), m_y(y) {}
+		constexpr vecN() noexcept : m_x(0.0f), m_y(0.0f) {}
 
-		float& x() noexcept;
-		float& y() noexcept;
+		[[nodiscard]] constexpr float x() const noexcept { return m_x; }
+		[[nodiscard]] constexpr float y() const noexcept { return m_y; }
 
-		[[nodiscard]] vec2 operator+(const vec2& other) const noexcept;
-		[[nodiscard]] vec2 operator-(const vec2& other) const noexcept;
-		[[nodiscard]] vec2 operator*(float scalar) const noexcept;
-		[[nodiscard]] vec2 operator/(float scalar) const noexcept;
+		constexpr float& x() noexcept { return m_x; }
+		constexpr float& y() noexcept { return m_y; }
 
-		void operator+=(const vec2& other) noexcept;
-		void operator-=(const vec2& other) noexcept;
-		void operator*=(float scalar) noexcept;
-		void operator/=(float scalar) noexcept;
+		[[nodiscard]] constexpr float operator[](const std::size_t i) const noexcept { return i == 0 ? m_x : m_y; }
 
-		[[nodiscard]] vec2 operator-() const noexcept;
+		[[nodiscard]] constexpr vec2 operator+(const vec2& other) const noexcept { return { m_x + other.m_x, m_y + other.m_y }; }
+		[[nodiscard]] constexpr vec2 operator-(const vec2& other) const noexcept { return { m_x - other.m_x, m_y - other.m_y }; }
+		[[nodiscard]] constexpr vec2 operator*(const float scalar) const noexcept { return { m_x * scalar, m_y * scalar }; }
+		[[nodiscard]] constexpr vec2 operator/(const float scalar) const noexcept { return { m_x / scalar, m_y / scalar }; }
 
-		[[nodiscard]] float dot(const vec2& other) const noexcept;
-		[[nodiscard]] float length_sq() const noexcept;
-		[[nodiscard]] float length() const noexcept;
+		constexpr void operator+=(const vec2& other) noexcept { m_x += other.m_x; m_y += other.m_y; }
+		constexpr void operator-=(const vec2& other) noexcept { m_x -= other.m_x; m_y -= other.m_y; }
+		constexpr void operator*=(const float scalar) noexcept { m_x *= scalar; m_y *= scalar; }
+		constexpr void operator/=(const float scalar) noexcept { m_x /= scalar; m_y /= scalar; }
+
+		[[nodiscard]] constexpr vec2 operator-() const noexcept { return { -m_x, -m_y }; }
+
+		[[nodiscard]] constexpr float dot(const vec2& other) const noexcept { return m_x * other.m_x + m_y * other.m_y; }
+		[[nodiscard]] constexpr float length_sq() const noexcept { return dot(*this); }
+		[[nodiscard]] constexpr float length() const noexcept { return math::sqrt(length_sq()); }
 	protected:
 		float m_x, m_y;
 	};
 
-	class vec3 {
+	// Constant evaluation only ever touches m_components; the SSE paths read and write m_simd
+	template<>
+	class vecN<float, 3> {
 	public:
-		explicit vec3(float scalar);
-		vec3(float x, float y, float z);
-		vec3();
+		static constexpr std::size_t size = 3;
+
+		constexpr explicit vecN(const float scalar) noexcept : m_components{ scalar, scalar, scalar, 0.0f } {}
+		constexpr vecN(const float x, const float y, const float z) noexcept : m_components{ x, y, z, 0.0f } {}
+		constexpr vecN() noexcept : m_components{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+
+		[[nodiscard]] constexpr float x() const noexcept { return m_components.m_x; }
+		[[nodiscard]] constexpr float y() const noexcept { return m_components.m_y; }
+		[[nodiscard]] constexpr float z() const noexcept { return m_components.m_z; }
+
+		constexpr float& x() noexcept { return m_components.m_x; }
+		constexpr float& y() noexcept { return m_components.m_y; }
+		constexpr float& z() noexcept { return m_components.m_z; }
 
-		[[nodiscard]] float x() const noexcept;
-		[[nodiscard]] float y() const noexcept;
-		[[nodiscard]] float z() const noexcept;
+		[[nodiscard]] constexpr float operator[](const std::size_t i) const noexcept { return i == 0 ? x() : i == 1 ? y() : z(); }
 
-		float& x() noexcept;
-		float& y() noexcept;
-		float& z() noexcept;
+		[[nodiscard]] constexpr vec3 operator+(const vec3& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() + other.x(), y() + other.y(), z() + other.z() };
+			return vec3{ _mm_add_ps(m_simd, other.m_simd) };
+		}
 
-		[[nodiscard]] vec3 operator+(const vec3& other) const noexcept;
-		[[nodiscard]] vec3 operator-(const vec3& other) const noexcept;
-		[[nodiscard]] vec3 operator*(float scalar) const noexcept;
-		[[nodiscard]] vec3 operator/(float scalar) const noexcept;
+		[[nodiscard]] constexpr vec3 operator-(const vec3& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() - other.x(), y() - other.y(), z() - other.z() };
+			return vec3{ _mm_sub_ps(m_simd, other.m_simd) };
+		}
 
-		void operator+=(const vec3& other) noexcept;
-		void operator-=(const vec3& other) noexcept;
-		void operator*=(float scalar) noexcept;
-		void operator/=(float scalar) noexcept;
+		[[nodiscard]] constexpr vec3 operator*(const float scalar) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() * scalar, y() * scalar, z() * scalar };
+			return vec3{ _mm_mul_ps(m_simd, _mm_set1_ps(scalar)) };
+		}
 
-		[[nodiscard]] vec3 operator-() const noexcept;
+		[[nodiscard]] constexpr vec3 operator/(const float scalar) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() / scalar, y() / scalar, z() / scalar };
+			return vec3{ _mm_div_ps(m_simd, _mm_set1_ps(scalar)) };
+		}
 
-		[[nodiscard]] vec3 cross(const vec3& other) const noexcept;
+		constexpr void operator+=(const vec3& other) noexcept { *this = *this + other; }
+		constexpr void operator-=(const vec3& other) noexcept { *this = *this - other; }
+		constexpr void operator*=(const float scalar) noexcept { *this = *this * scalar; }
+		constexpr void operator/=(const float scalar) noexcept { *this = *this / scalar; }
 
-		[[nodiscard]] float dot(const vec3& other) const noexcept;
-		[[nodiscard]] float length_sq() const noexcept;
-		[[nodiscard]] float length() const noexcept;
+		[[nodiscard]] constexpr vec3 operator-() const noexcept {
+			if (std::is_constant_evaluated())
+				return { -x(), -y(), -z() };
+			return vec3{ _mm_sub_ps(_mm_setzero_ps(), m_simd) };
+		}
+
+		[[nodiscard]] constexpr vec3 cross(const vec3& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { y() * other.z() - z() * other.y(), z() * other.x() - x() * other.z(), x() * other.y() - y() * other.x() };
+
+			// left term
+			const __m128 a_yzx = _mm_shuffle_ps(m_simd, m_simd, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 b_zxy = _mm_shuffle_ps(other.m_simd, other.m_simd, _MM_SHUFFLE(3, 1, 0, 2));
+			const __m128 left = _mm_mul_ps(a_yzx, b_zxy);
+
+			// right term
+			const __m128 a_zxy = _mm_shuffle_ps(m_simd, m_simd, _MM_SHUFFLE(3, 1, 0, 2));
+			const __m128 b_yzx = _mm_shuffle_ps(other.m_simd, other.m_simd, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 right = _mm_mul_ps(a_zxy, b_yzx);
+
+			return vec3{ _mm_sub_ps(left, right) };
+		}
+
+		// Component-wise
+		[[nodiscard]] constexpr vec3 min(const vec3& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { std::min(x(), other.x()), std::min(y(), other.y()), std::min(z(), other.z()) };
+			return vec3{ _mm_min_ps(m_simd, other.m_simd) };
+		}
+
+		[[nodiscard]] constexpr vec3 max(const vec3& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { std::max(x(), other.x()), std::max(y(), other.y()), std::max(z(), other.z()) };
+			return vec3{ _mm_max_ps(m_simd, other.m_simd) };
+		}
+
+		[[nodiscard]] constexpr float dot(const vec3& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return x() * other.x() + y() * other.y() + z() * other.z();
+			return _mm_cvtss_f32(_mm_dp_ps(m_simd, other.m_simd, 0x71));
+		}
+
+		[[nodiscard]] constexpr float length_sq() const noexcept { return dot(*this); }
+		[[nodiscard]] constexpr float length() const noexcept { return math::sqrt(length_sq()); }
 	protected:
-		explicit vec3(const __m128 simd) : m_simd(simd) {};
+		template<std::size_t R, std::size_t C>
+		friend class matN;
+		explicit vecN(const __m128 simd) noexcept : m_simd(simd) {}
 
 		union {
-			struct { float m_x, m_y, m_z, m_w; } m_components{};
+			struct { float m_x, m_y, m_z, m_w; } m_components;
 			__m128 m_simd;
 		};
 	};
 
-	class vec4 {
+	template<>
+	class vecN<float, 4> {
 	public:
-		explicit vec4(float scalar);
-		vec4(float x, float y, float z, float w);
-		vec4();
-
-		[[nodiscard]] float x() const noexcept;
-		[[nodiscard]] float y() const noexcept;
-		[[nodiscard]] float z() const noexcept;
-		[[nodiscard]] float w() const noexcept;
-
-		float& x() noexcept;
-		float& y() noexcept;
-		float& z() noexcept;
-		float& w() noexcept;
-
-		[[nodiscard]] vec4 operator+(const vec4& other) const noexcept;
-		[[nodiscard]] vec4 operator-(const vec4& other) const noexcept;
-		[[nodiscard]] vec4 operator*(float scalar) const noexcept;
-		[[nodiscard]] vec4 operator/(float scalar) const noexcept;
-
-		void operator+=(const vec4& other) noexcept;
-		void operator-=(const vec4& other) noexcept;
-		void operator*=(float scalar) noexcept;
-		void operator/=(float scalar) noexcept;
-
-		[[nodiscard]] vec4 operator-() const noexcept;
-
-		[[nodiscard]] float dot(const vec4& other) const noexcept;
-		[[nodiscard]] float length_sq() const noexcept;
-		[[nodiscard]] float length() const noexcept;
+		static constexpr std::size_t size = 4;
+
+		constexpr explicit vecN(const float scalar) noexcept : m_components{ scalar, scalar, scalar, scalar } {}
+		constexpr vecN(const float x, const float y, const float z, const float w) noexcept : m_components{ x, y, z, w } {}
+		constexpr vecN() noexcept : m_components{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+
+		[[nodiscard]] constexpr float x() const noexcept { return m_components.m_x; }
+		[[nodiscard]] constexpr float y() const noexcept { return m_components.m_y; }
+		[[nodiscard]] constexpr float z() const noexcept { return m_components.m_z; }
+		[[nodiscard]] constexpr float w() const noexcept { return m_components.m_w; }
+
+		constexpr float& x() noexcept { return m_components.m_x; }
+		constexpr float& y() noexcept { return m_components.m_y; }
+		constexpr float& z() noexcept { return m_components.m_z; }
+		constexpr float& w() noexcept { return m_components.m_w; }
+
+		[[nodiscard]] constexpr float operator[](const std::size_t i) const noexcept { return i == 0 ? x() : i == 1 ? y() : i == 2 ? z() : w(); }
+
+		[[nodiscard]] constexpr vec4 operator+(const vec4& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() + other.x(), y() + other.y(), z() + other.z(), w() + other.w() };
+			return vec4{ _mm_add_ps(m_simd, other.m_simd) };
+		}
+
+		[[nodiscard]] constexpr vec4 operator-(const vec4& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() - other.x(), y() - other.y(), z() - other.z(), w() - other.w() };
+			return vec4{ _mm_sub_ps(m_simd, other.m_simd) };
+		}
+
+		[[nodiscard]] constexpr vec4 operator*(const float scalar) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() * scalar, y() * scalar, z() * scalar, w() * scalar };
+			return vec4{ _mm_mul_ps(m_simd, _mm_set1_ps(scalar)) };
+		}
+
+		[[nodiscard]] constexpr vec4 operator/(const float scalar) const noexcept {
+			if (std::is_constant_evaluated())
+				return { x() / scalar, y() / scalar, z() / scalar, w() / scalar };
+			return vec4{ _mm_div_ps(m_simd, _mm_set1_ps(scalar)) };
+		}
+
+		constexpr void operator+=(const vec4& other) noexcept { *this = *this + other; }
+		constexpr void operator-=(const vec4& other) noexcept { *this = *this - other; }
+		constexpr void operator*=(const float scalar) noexcept { *this = *this * scalar; }
+		constexpr void operator/=(const float scalar) noexcept { *this = *this / scalar; }
+
+		[[nodiscard]] constexpr vec4 operator-() const noexcept {
+			if (std::is_constant_evaluated())
+				return { -x(), -y(), -z(), -w() };
+			return vec4{ _mm_sub_ps(_mm_setzero_ps(), m_simd) };
+		}
+
+		// Component-wise
+		[[nodiscard]] constexpr vec4 min(const vec4& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { std::min(x(), other.x()), std::min(y(), other.y()), std::min(z(), other.z()), std::min(w(), other.w()) };
+			return vec4{ _mm_min_ps(m_simd, other.m_simd) };
+		}
+
+		[[nodiscard]] constexpr vec4 max(const vec4& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return { std::max(x(), other.x()), std::max(y(), other.y()), std::max(z(), other.z()), std::max(w(), other.w()) };
+			return vec4{ _mm_max_ps(m_simd, other.m_simd) };
+		}
+
+		[[nodiscard]] constexpr float dot(const vec4& other) const noexcept {
+			if (std::is_constant_evaluated())
+				return x() * other.x() + y() * other.y() + z() * other.z() + w() * other.w();
+			return _mm_cvtss_f32(_mm_dp_ps(m_simd, other.m_simd, 0xF1));
+		}
+
+		[[nodiscard]] constexpr float length_sq() const noexcept { return dot(*this); }
+		[[nodiscard]] constexpr float length() const noexcept { return math::sqrt(length_sq()); }
 	private:
-		friend class mat4;
-		explicit vec4(const __m128 simd) : m_simd(simd) {};
+		template<std::size_t R, std::size_t C>
+		friend class matN;
+		explicit vecN(const __m128 simd) noexcept : m_simd(simd) {}
 
 		union {
-			struct { float m_x, m_y, m_z, m_w; } m_components{};
+			struct { float m_x, m_y, m_z, m_w; } m_components;
 			__m128 m_simd;
 		};
 	};
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Zenyth {
+
+	// Bump allocator for per-frame scratch results. Allocations live until Reset(); when a frame
+	// needed more than one block, Reset() replaces them with a single block of the combined size so
+	// steady-state frames allocate from one contiguous range and never touch the heap.
+	//
+	// Not thread-safe: hand each thread its own arena or allocate from one thread.
+	class LinearArena {
+	public:
+		explicit LinearArena(size_t blockSize = 64 * 1024);
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		[[nodiscard]] void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Uninitialized storage for count objects; only for types that need no destructor
+		template<typename T>
+		[[nodiscard]] std::span<T> Allocate(const size_t count) {
+			static_assert(std::is_trivially_destructible_v<T>, "LinearArena never runs destructors");
+			if (count == 0)
+				return {};
+			return { static_cast<T*>(Allocate(count * sizeof(T), alignof(T))), count };
+		}
+
+		void Reset() noexcept;
+
+		[[nodiscard]] size_t UsedBytes()     const noexcept { return m_used; }
+		[[nodiscard]] size_t CapacityBytes() const noexcept;
+		// Most bytes used by any frame that has been Reset(); unlike the rest, safe to read from any thread
+		[[nodiscard]] size_t HighWaterBytes() const noexcept { return m_highWater.load(std::memory_order_relaxed); }
+
+	private:
+		struct Block {
+			std::unique_ptr<std::byte[]> memory;
+			size_t                       size = 0;
+		};
+
+		void AddBlock(size_t minSize);
+
+		std::vector<Block>  m_blocks;
+		size_t              m_blockSize;
+		size_t              m_offset = 0; // into m_blocks.back()
+		size_t              m_used = 0;
+		std::atomic<size_t> m_highWater{ 0 };
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace Zenyth {
+
+	// Per-frame ring allocator over CPU-visible upload memory (a persistently mapped D3D12 upload
+	// heap, or an owned heap block when running headless). Everything allocated during a frame stays
+	// valid until BeginFrame() has been called FramesInFlight more times, by which point the GPU is
+	// expected to have consumed it.
+	//
+	// Allocate() is lock-free and may be called from any thread; BeginFrame() must not overlap it.
+	class UploadRing {
+	public:
+		static constexpr uint32_t MaxFramesInFlight = 4;
+		static constexpr size_t   MaxAlignment = 256; // constant buffer placement alignment
+
+		struct Allocation {
+			std::byte* data = nullptr;
+			uint64_t   offset = 0; // from the start of the ring's memory, for GPU addressing
+			size_t     size = 0;
+
+			[[nodiscard]] explicit operator bool() const noexcept { return data != nullptr; }
+
+			template<typename T>
+			[[nodiscard]] std::span<T> As() const noexcept { return { reinterpret_cast<T*>(data), size / sizeof(T) }; }
+		};
+
+		UploadRing() = default;
+		// memory must be MaxAlignment aligned and outlive the ring
+		UploadRing(std::span<std::byte> memory, uint32_t framesInFlight);
+		// Owns a heap block; for tools and headless runs
+		UploadRing(size_t capacity, uint32_t framesInFlight);
+
+		UploadRing(const UploadRing&) = delete;
+		UploadRing& operator=(const UploadRing&) = delete;
+
+		// Returns an empty allocation when the in-flight frames leave no room
+		[[nodiscard]] Allocation Allocate(size_t size, size_t alignment = 16) noexcept;
+
+		template<typename T>
+		[[nodiscard]] Allocation Allocate(const size_t count) noexcept { return Allocate(count * sizeof(T), std::max<size_t>(alignof(T), 16)); }
+
+		// Starts a new frame and recycles the memory of the frame that left the in-flight window
+		void BeginFrame() noexcept;
+
+		[[nodiscard]] size_t   Capacity()       const noexcept { return m_memory.size(); }
+		[[nodiscard]] size_t   UsedBytes()      const noexcept;
+		[[nodiscard]] uint64_t FrameIndex()     const noexcept { return m_frame; }
+		[[nodiscard]] uint32_t FramesInFlight() const noexcept { return m_framesInFlight; }
+		// Most bytes ever in flight at the start of a frame; safe to read from any thread
+		[[nodiscard]] size_t   HighWaterBytes() const noexcept { return m_highWater.load(std::memory_order_relaxed); }
+
+	private:
+		void Init(std::span<std::byte> memory, uint32_t framesInFlight);
+
+		std::vector<std::byte> m_owned;
+		std::span<std::byte>   m_memory;
+		uint32_t               m_framesInFlight = 1;
+
+		// Offsets grow monotonically; the physical position is offset % capacity
+		std::atomic<uint64_t>                  m_head{ 0 };
+		uint64_t                               m_tail = 0;
+		uint64_t                               m_frame = 0;
+		std::array<uint64_t, MaxFramesInFlight> m_frameStart{};
+		std::atomic<size_t>                    m_highWater{ 0 };
+	};
+
+} // namespace Zenyth
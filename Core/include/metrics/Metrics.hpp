@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Zenyth {
+
+	// Metric values are plain atomics: updating one from the frame thread is a single relaxed
+	// read-modify-write, and readers (the metrics server) never block writers.
+
+	// Monotonic total
+	class Counter {
+	public:
+		void Add(const uint64_t n = 1) noexcept { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+		[[nodiscard]] uint64_t Value() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<uint64_t> m_value{ 0 };
+	};
+
+	// Value that may go up and down
+	class Gauge {
+	public:
+		void Set(const double value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+		void Add(const double delta) noexcept { m_value.fetch_add(delta, std::memory_order_relaxed); }
+		// High-water mark: keeps the larger of the current and the given value
+		void SetMax(double value) noexcept;
+
+		[[nodiscard]] double Value() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<double> m_value{ 0.0 };
+	};
+
+	// Distribution over fixed buckets; Observe() is one bucket increment plus the count and sum
+	class Histogram {
+	public:
+		// Inclusive upper bounds, ascending; a final +Inf bucket is implied
+		explicit Histogram(std::span<const double> bounds);
+
+		void Observe(double value) noexcept;
+
+		struct Snapshot {
+			std::vector<uint64_t> buckets; // per bucket, not cumulative; the last one is +Inf
+			uint64_t              count = 0;
+			double                sum = 0.0;
+		};
+
+		// Buckets are read one by one while writers carry on, so a snapshot may be off by the
+		// observations made while it was taken
+		[[nodiscard]] Snapshot Read() const;
+		// Interpolated within the bucket holding the q-th observation of the difference between
+		// two snapshots; 0 when nothing was observed in between
+		[[nodiscard]] double Quantile(double q, const Snapshot& now, const Snapshot& before) const noexcept;
+
+		[[nodiscard]] std::span<const double> Bounds() const noexcept { return m_bounds; }
+
+		// count bounds from start, each factor times the previous one
+		[[nodiscard]] static std::vector<double> ExponentialBounds(double start, double factor, uint32_t count);
+
+	private:
+		std::vector<double>                      m_bounds;
+		std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+		std::atomic<uint64_t>                    m_count{ 0 };
+		std::atomic<double>                      m_sum{ 0.0 };
+	};
+
+	enum class MetricType : uint8_t {
+		Counter,
+		Gauge,
+		Histogram,
+	};
+
+	// Named metrics, grouped into families that share a name, help text and type; series within a
+	// family differ by labels, given in exposition syntax (`view="main",kind="opaque"`).
+	//
+	// Registering locks and may allocate, so do it up front; the returned references stay valid
+	// for the lifetime of the registry. Format*() may run on any thread and calls the *Fn
+	// readers there, so those must be safe to call concurrently with the frame.
+	class MetricsRegistry {
+	public:
+		using Reader = std::function<double()>;
+
+		Counter&   AddCounter(std::string_view name, std::string_view help, std::string_view labels = {});
+		Gauge&     AddGauge(std::string_view name, std::string_view help, std::string_view labels = {});
+		// Quantiles are also published as the gauge family <name>_quantile, computed over the last
+		// completed window (see SetQuantileWindow()), or over everything so far until the first one
+		// closes. A window without observations repeats the previous one.
+		Histogram& AddHistogram(std::string_view name, std::string_view help, std::span<const double> bounds,
+			std::string_view labels = {}, std::span<const double> quantiles = {});
+
+		// Windows are timed, not tied to scrapes, so several scrapers see the same quantiles. A
+		// window closes on the first Format*() call at least this long after it opened.
+		void SetQuantileWindow(std::chrono::steady_clock::duration window);
+
+		static constexpr std::chrono::seconds DefaultQuantileWindow{ 10 };
+
+		// Values read at publish time, for state that already lives elsewhere
+		void AddCounterFn(std::string_view name, std::string_view help, Reader reader, std::string_view labels = {});
+		void AddGaugeFn(std::string_view name, std::string_view help, Reader reader, std::string_view labels = {});
+
+		// Prometheus text exposition format, version 0.0.4
+		[[nodiscard]] std::string FormatText();
+
+		// Compact little-endian encoding of the same samples:
+		//   header  u32 magic "ZMET", u16 version, u16 reserved, u32 sample count
+		//   sample  u8 type (MetricType), u8 reserved, u16 series length, series (name{labels}), f64 value
+		[[nodiscard]] std::vector<std::byte> FormatBinary();
+
+		static constexpr uint32_t BinaryMagic = 0x54454D5A; // "ZMET"
+		static constexpr uint16_t BinaryVersion = 1;
+
+		[[nodiscard]] size_t SeriesCount() const;
+
+	private:
+		struct Series {
+			std::string                           labels;
+			std::unique_ptr<Counter>              counter;
+			std::unique_ptr<Gauge>                gauge;
+			std::unique_ptr<Histogram>            histogram;
+			Reader                                reader;
+			std::vector<double>                   quantiles;
+			Histogram::Snapshot                   previous;      // at the start of the current quantile window
+			std::chrono::steady_clock::time_point windowStart;
+			bool                                  windowClosed = false;
+			std::vector<double>                   lastQuantiles; // of the last completed window
+		};
+
+		struct Family {
+			std::string        name;
+			std::string        help;
+			MetricType         type;
+			std::deque<Series> series; // deque: references handed out must stay put
+		};
+
+		struct Sample {
+			std::string series;
+			MetricType  type;
+			double      value;
+		};
+
+		Series& AddSeries(std::string_view name, std::string_view help, MetricType type, std::string_view labels);
+		// Calls emit(family, samples) per family, plus once per quantile family
+		template<typename Emit>
+		void Collect(Emit&& emit);
+
+		mutable std::mutex                  m_mutex;
+		std::deque<Family>                  m_families;
+		std::chrono::steady_clock::duration m_quantileWindow = DefaultQuantileWindow;
+	};
+
+} // namespace Zenyth
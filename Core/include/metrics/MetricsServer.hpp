@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Zenyth {
+
+	class MetricsRegistry;
+
+	struct MetricsServerDesc {
+		// "host:port" for loopback TCP (port 0 picks a free one) or "unix:<path>" for a Unix domain socket
+		std::string endpoint = "127.0.0.1:9464";
+	};
+
+	// Serves a MetricsRegistry over a minimal HTTP/1.0 responder on its own thread:
+	//   GET /metrics      Prometheus text format
+	//   GET /metrics.bin  MetricsRegistry::FormatBinary()
+	// One request per connection. All formatting happens on the server thread; the frame thread
+	// only ever touches the metric atomics.
+	class MetricsServer {
+	public:
+		// Binds and starts listening; throws std::runtime_error if the endpoint cannot be bound
+		MetricsServer(MetricsRegistry& registry, const MetricsServerDesc& desc = {});
+		~MetricsServer();
+
+		MetricsServer(const MetricsServer&) = delete;
+		MetricsServer& operator=(const MetricsServer&) = delete;
+
+		// The bound endpoint, with the actual port when 0 was asked for
+		[[nodiscard]] const std::string& Endpoint() const noexcept { return m_endpoint; }
+		[[nodiscard]] uint64_t ScrapeCount() const noexcept { return m_scrapes.load(std::memory_order_relaxed); }
+
+	private:
+		void Serve();
+		void Respond(intptr_t client);
+
+		MetricsRegistry&      m_registry;
+		std::string           m_endpoint;
+		std::string           m_unixPath; // removed again on shutdown
+		intptr_t              m_listener = -1;
+		std::atomic<bool>     m_running{ true };
+		std::atomic<uint64_t> m_scrapes{ 0 };
+		std::thread           m_thread;
+	};
+
+	// Fetches path from a MetricsServer endpoint and returns the response body. A stand-in for
+	// a real scraper in tools and tests; throws std::runtime_error on connection or HTTP errors.
+	[[nodiscard]] std::string ScrapeMetrics(std::string_view endpoint, std::string_view path = "/metrics");
+
+} // namespace Zenyth
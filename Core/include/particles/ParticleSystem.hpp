@@ -0,0 +1,133 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "math/vector.hpp"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Zenyth {
+
+	// Keeps particles on the side where dot(normal, p) + distance >= 0
+	struct ParticlePlane {
+		float normal[3];
+		float distance;
+	};
+
+	// Keeps particles outside the sphere
+	struct ParticleSphere {
+		float center[3];
+		float radius;
+	};
+
+	// Pulls (positive strength) or pushes particles with a softened inverse-square falloff
+	struct ParticleAttractor {
+		float center[3];
+		float strength;
+	};
+
+	struct EmitterDesc {
+		uint32_t capacity = 65536;
+		float    rate = 1000.0f;          // particles per second
+		float    lifetimeMin = 1.0f;      // seconds
+		float    lifetimeMax = 2.0f;
+
+		float    position[3] = {};
+		float    spawnRadius = 0.0f;
+		float    velocity[3] = { 0.0f, 1.0f, 0.0f };
+		float    velocitySpread = 0.5f;   // magnitude of the random offset added to velocity
+
+		float    gravity[3] = { 0.0f, -9.81f, 0.0f };
+		float    drag = 0.0f;             // linear, per second
+		float    restitution = 0.5f;      // normal velocity kept after a bounce
+		float    friction = 0.1f;         // tangential velocity lost on a bounce
+
+		float    colorStart[4] = { 1.0f, 1.0f, 1.0f, 1.0f }; // linear RGBA, interpolated over the lifetime
+		float    colorEnd[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+		float    sizeStart = 0.1f;
+		float    sizeEnd = 0.1f;
+
+		std::vector<ParticlePlane>     planes;
+		std::vector<ParticleSphere>    spheres;
+		std::vector<ParticleAttractor> attractors;
+	};
+
+	// One pool of particles stored as separate attribute arrays. Update() integrates, collides,
+	// recolors and compacts in a single pass of eight particles at a time (AVX2, scalar fallback):
+	// dead particles are squeezed out by a lookup-table lane permute rather than per-particle branches,
+	// so live particles always occupy [0, Count()) in emission order.
+	class ParticleEmitter {
+	public:
+		explicit ParticleEmitter(EmitterDesc desc, uint32_t seed = 1);
+
+		ParticleEmitter(const ParticleEmitter&) = delete;
+		ParticleEmitter& operator=(const ParticleEmitter&) = delete;
+
+		// Simulates existing particles, then spawns new ones according to the rate
+		void Update(float dt);
+
+		// Spawns up to count particles immediately; returns how many fit
+		uint32_t Emit(uint32_t count);
+
+		// Radix sorts live particles far to near along `forward` as seen from `eye`; see SortedIndices()
+		void SortBackToFront(const zenyth::math::vec3& eye, const zenyth::math::vec3& forward);
+
+		// Simulation parameters may be edited between updates; capacity is fixed at construction
+		[[nodiscard]] EmitterDesc&       Desc() noexcept { return m_desc; }
+		[[nodiscard]] const EmitterDesc& Desc() const noexcept { return m_desc; }
+
+		[[nodiscard]] uint32_t Count()    const noexcept { return m_count; }
+		[[nodiscard]] uint32_t Capacity() const noexcept { return m_desc.capacity; }
+
+		[[nodiscard]] std::span<const float>    PositionX() const noexcept { return { m_posX.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    PositionY() const noexcept { return { m_posY.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    PositionZ() const noexcept { return { m_posZ.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    VelocityX() const noexcept { return { m_velX.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    VelocityY() const noexcept { return { m_velY.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    VelocityZ() const noexcept { return { m_velZ.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    Age()       const noexcept { return { m_age.data(), m_count }; }
+		[[nodiscard]] std::span<const float>    Size()      const noexcept { return { m_size.data(), m_count }; }
+		[[nodiscard]] std::span<const uint32_t> Color()     const noexcept { return { m_color.data(), m_count }; } // RGBA8, R in the low byte
+
+		// Result of the last SortBackToFront(); invalidated by Update() and Emit()
+		[[nodiscard]] std::span<const uint32_t> SortedIndices() const noexcept { return m_sorted; }
+
+	private:
+		[[nodiscard]] float Random() noexcept; // [0, 1)
+
+		EmitterDesc m_desc;
+		uint32_t    m_count = 0;
+		uint32_t    m_rng;
+		float       m_spawnAccumulator = 0.0f;
+
+		// Attributes, padded to a multiple of 8 so the wide kernel never needs a tail loop
+		std::vector<float>    m_posX, m_posY, m_posZ;
+		std::vector<float>    m_velX, m_velY, m_velZ;
+		std::vector<float>    m_age, m_invLifetime;
+		std::vector<float>    m_size;
+		std::vector<uint32_t> m_color;
+
+		std::vector<uint32_t> m_sorted, m_sortKeys, m_sortScratch, m_sortKeyScratch;
+	};
+
+	// Owns a set of emitters and runs them in parallel, one emitter per job
+	class ParticleSystem {
+	public:
+		ParticleEmitter& CreateEmitter(EmitterDesc desc);
+		void             DestroyEmitter(const ParticleEmitter& emitter);
+
+		// jobs may be null to update on the calling thread
+		void Update(float dt, JobSystem* jobs = nullptr);
+		void SortBackToFront(const zenyth::math::vec3& eye, const zenyth::math::vec3& forward, JobSystem* jobs = nullptr);
+
+		[[nodiscard]] uint32_t ParticleCount() const noexcept;
+		[[nodiscard]] uint32_t EmitterCount()  const noexcept { return static_cast<uint32_t>(m_emitters.size()); }
+		[[nodiscard]] ParticleEmitter&       GetEmitter(const uint32_t index) noexcept { return *m_emitters[index]; }
+		[[nodiscard]] const ParticleEmitter& GetEmitter(const uint32_t index) const noexcept { return *m_emitters[index]; }
+
+	private:
+		std::vector<std::unique_ptr<ParticleEmitter>> m_emitters;
+		uint32_t                                      m_nextSeed = 1;
+	};
+
+} // namespace Zenyth
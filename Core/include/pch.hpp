@@ -1,5 +1,6 @@
 #pragma once
 
+#ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers.
 #endif
@@ -7,6 +8,7 @@
 // Windows
 #include <windows.h>
 #include <windowsx.h>
+#endif
 
 
 // STL
@@ -27,8 +29,19 @@
 #include <exception>
 #include <concepts>
 #include <type_traits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <span>
+#include <bitset>
+#include <deque>
+#include <cstring>
+#include <new>
 
+#ifdef _WIN32
 #include <wrl.h>
 #include <shellapi.h>
+#endif
 #include <cmath>
 #include <cstdint>
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "assets/AssetStreamer.hpp"
+#include "math/matrix.hpp"
+
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Zenyth {
+
+	using LodHandle = uint32_t;
+	inline constexpr LodHandle InvalidLod = ~0u;
+
+	// One level of a LOD chain, finest first
+	struct LodLevel {
+		float    error = 0.0f; // world-space geometric error against full detail; non-decreasing along the chain
+		uint64_t asset = 0;    // name hash of the level's data in the streamer, 0 for none
+	};
+
+	// The camera as far as LOD selection is concerned
+	struct LodView {
+		zenyth::math::vec3 position;
+		float              pixelsPerUnit = 0.0f; // screen pixels covered by one world unit at distance 1
+
+		// From a mat4::perspective (or perspective_reverse_z) projection and the viewport height in pixels
+		[[nodiscard]] static LodView FromProjection(const zenyth::math::vec3& position, const zenyth::math::mat4& projection, float viewportHeight) noexcept {
+			return { position, 0.5f * viewportHeight * projection[1, 1] };
+		}
+	};
+
+	struct LodSettings {
+		float pixelError = 1.0f;  // coarsest level whose projected error stays under this is selected
+		float hysteresis = 0.25f; // a coarser level must also be under pixelError * (1 - hysteresis) to be picked
+	};
+
+	// Picks a level of detail per object from the projected screen-space error of its chain, and
+	// drives an AssetStreamer with the same metric.
+	//
+	// Objects are bounding spheres stored as SoA arrays; Update() evaluates four of them per SSE
+	// pass, split across the job system. Refining happens as soon as the current level's error
+	// exceeds pixelError, coarsening only once the coarser level is below the hysteresis band, so
+	// objects near a threshold do not flip back and forth every frame.
+	//
+	// With a streamer, every object holds a reference on its coarsest level (requested up front at
+	// the highest priority, so something can always be drawn) and one on its selected level. The
+	// selected level's priority is the error in pixels it removes, i.e. the projected error of the
+	// next coarser level: the most visible detail streams in first, and the streamer's budget
+	// evicts the least visible. Objects sharing an asset share its priority in the streamer, so
+	// each asset gets the highest priority among its holders, and only when that changed.
+	//
+	// Not thread-safe, except that SetBounds() on distinct handles may run concurrently outside
+	// Update(); Update() uses the job system internally.
+	class LodSystem {
+	public:
+		static constexpr uint32_t MaxLevels = 4;
+
+		// streamer may be null to select levels only; it must outlive the system
+		explicit LodSystem(AssetStreamer* streamer = nullptr, const LodSettings& settings = {});
+		~LodSystem();
+
+		LodSystem(const LodSystem&) = delete;
+		LodSystem& operator=(const LodSystem&) = delete;
+
+		LodHandle Add(std::span<const LodLevel> levels, const zenyth::math::vec3& center, float radius);
+		void      Remove(LodHandle handle);
+		void      SetBounds(LodHandle handle, const zenyth::math::vec3& center, float radius);
+
+		// jobs may be null to update on the calling thread
+		void Update(const LodView& view, JobSystem* jobs = nullptr);
+
+		void                             SetSettings(const LodSettings& settings) noexcept { m_settings = settings; }
+		[[nodiscard]] const LodSettings& Settings() const noexcept { return m_settings; }
+
+		// Valid after the last Update()
+		[[nodiscard]] uint32_t GetLevel(LodHandle handle) const;
+		// Projected error of the selected level, in pixels
+		[[nodiscard]] float    GetScreenError(LodHandle handle) const;
+		[[nodiscard]] float    GetPriority(LodHandle handle) const;
+		// The streamer's handle for the selected level, InvalidAsset without one
+		[[nodiscard]] AssetHandle GetAsset(LodHandle handle) const;
+
+		[[nodiscard]] bool     IsValid(LodHandle handle) const noexcept;
+		[[nodiscard]] uint32_t Count()           const noexcept { return m_count; }
+		[[nodiscard]] uint32_t LastChangeCount() const noexcept { return m_lastChangeCount; }
+
+		// Minimum number of objects handed to a single job
+		static constexpr uint32_t JobGrain = 4096;
+
+	private:
+		static constexpr uint32_t NoIndex = ~0u;
+
+		[[nodiscard]] uint32_t Dense(LodHandle handle) const;
+		[[nodiscard]] bool     IsCoarsest(uint32_t index, int32_t level) const noexcept;
+		void     Resize(uint32_t count);
+		void     Clear(uint32_t index) noexcept;
+		void     Move(uint32_t from, uint32_t to) noexcept;
+		uint32_t SelectRange(const LodView& view, uint32_t begin, uint32_t end) noexcept;
+		void     Stream();
+
+		AssetStreamer* m_streamer;
+		LodSettings    m_settings;
+
+		// SoA, padded to a multiple of four with objects that always stay at level 0
+		std::vector<float>                           m_centerX, m_centerY, m_centerZ, m_radius;
+		std::array<std::vector<float>, MaxLevels>    m_error; // +inf past the end of a chain
+		std::vector<int32_t>                         m_level;
+		std::vector<float>                           m_screenError;
+		std::vector<float>                           m_priority;
+
+		// Streaming state, per object
+		std::vector<std::array<uint64_t, MaxLevels>> m_assets;
+		std::vector<AssetHandle>                     m_held;      // selected level, unless it is the coarsest
+		std::vector<int32_t>                         m_heldLevel; // level m_held belongs to, -1 before the first request
+		std::vector<AssetHandle>                     m_base;      // coarsest level
+
+		// Streaming state, per held asset
+		std::unordered_map<AssetHandle, float>       m_assetPriority; // highest among its holders, rebuilt by Stream()
+		std::unordered_map<AssetHandle, float>       m_sentPriority;  // last priority the streamer was given
+
+		std::vector<LodHandle> m_denseToHandle;
+		std::vector<uint32_t>  m_handleToDense;
+		std::vector<LodHandle> m_freeHandles;
+
+		uint32_t m_count = 0;
+		uint32_t m_lastChangeCount = 0;
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,101 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "math/quaternion.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace Zenyth {
+
+	using TransformHandle = uint32_t;
+	inline constexpr TransformHandle InvalidTransform = ~0u;
+
+	// Links an ECS entity to its node in a TransformHierarchy
+	struct TransformComponent {
+		TransformHandle handle = InvalidTransform;
+	};
+
+	// Scene graph of local TRS transforms stored as SoA arrays, kept in breadth-first order so
+	// every depth level is one contiguous range and parents always precede their children.
+	// Setting a local transform only flags the node; Update() propagates the flags down and
+	// recomputes world matrices for dirty subtrees, four nodes at a time, one level after the
+	// other with each level split across the job system.
+	//
+	// Handles stay stable across re-sorting. Structural changes (create, reparent, destroy) are
+	// cheap to record; the breadth-first order is rebuilt once at the next Update().
+	class TransformHierarchy {
+	public:
+		TransformHierarchy() = default;
+
+		TransformHierarchy(const TransformHierarchy&) = delete;
+		TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+		TransformHandle Create(TransformHandle parent = InvalidTransform);
+
+		// Removes the node and its whole subtree. Their handles are invalid right away; the storage
+		// and the handles themselves are reclaimed on the next Update().
+		void Destroy(TransformHandle handle);
+
+		void SetParent(TransformHandle handle, TransformHandle parent);
+		[[nodiscard]] TransformHandle GetParent(TransformHandle handle) const;
+
+		void SetLocalPosition(TransformHandle handle, const zenyth::math::vec3& position);
+		void SetLocalRotation(TransformHandle handle, const zenyth::math::quat& rotation);
+		void SetLocalScale(TransformHandle handle, const zenyth::math::vec3& scale);
+		void SetLocal(TransformHandle handle, const zenyth::math::vec3& position,
+			const zenyth::math::quat& rotation, const zenyth::math::vec3& scale);
+
+		[[nodiscard]] zenyth::math::vec3 GetLocalPosition(TransformHandle handle) const;
+		[[nodiscard]] zenyth::math::quat GetLocalRotation(TransformHandle handle) const;
+		[[nodiscard]] zenyth::math::vec3 GetLocalScale(TransformHandle handle) const;
+
+		// Valid after the last Update(); use to_mat4() where a full 4x4 matrix is needed
+		[[nodiscard]] const zenyth::math::mat3x4& GetWorldMatrix(TransformHandle handle) const;
+
+		// jobs may be null to update on the calling thread
+		void Update(JobSystem* jobs = nullptr);
+
+		// Both walk up the hierarchy while a Destroy() is waiting for the next Update()
+		[[nodiscard]] bool     IsValid(TransformHandle handle) const noexcept;
+		[[nodiscard]] uint32_t Count()           const noexcept;
+		[[nodiscard]] uint32_t DepthCount()      const noexcept { return m_levelStart.empty() ? 0 : static_cast<uint32_t>(m_levelStart.size() - 1); }
+		[[nodiscard]] uint32_t LastUpdateCount() const noexcept { return m_lastUpdateCount; }
+
+		// Minimum number of nodes of one level handed to a single job
+		static constexpr uint32_t JobGrain = 1024;
+
+	private:
+		static constexpr uint32_t NoParent = ~0u;
+
+		[[nodiscard]] uint32_t Dense(TransformHandle handle) const;
+		[[nodiscard]] bool     IsDestroyed(uint32_t index) const noexcept;
+		void MarkDirty(uint32_t index) noexcept;
+
+		void     Rebuild();
+		uint32_t UpdateRange(uint32_t begin, uint32_t end) noexcept;
+		void     ComputeBatch(const uint32_t* indices, uint32_t count) noexcept;
+
+		// Local TRS, SoA
+		std::vector<float> m_posX, m_posY, m_posZ;
+		std::vector<float> m_rotX, m_rotY, m_rotZ, m_rotW;
+		std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+
+		std::vector<uint32_t>             m_parent; // dense index, NoParent for roots
+		std::vector<uint8_t>              m_dirty;
+		std::vector<uint8_t>              m_alive;
+		std::vector<zenyth::math::mat3x4> m_world; // affine, 48 bytes per node
+
+		// m_levelStart[d]..m_levelStart[d + 1] is depth d; only meaningful while !m_needsRebuild
+		std::vector<uint32_t> m_levelStart;
+
+		std::vector<TransformHandle> m_denseToHandle;
+		std::vector<uint32_t>        m_handleToDense;
+		std::vector<TransformHandle> m_freeHandles;
+
+		bool     m_needsRebuild = false;
+		bool     m_pendingDestroy = false; // nodes under a destroyed one are still stored
+		bool     m_anyDirty = false;
+		uint32_t m_lastUpdateCount = 0;
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,63 @@
+#pragma once
+#include "math/vector.hpp"
+
+#include <limits>
+
+namespace Zenyth {
+
+	// Axis-aligned bounding box. Default constructed boxes are empty (min > max) so that
+	// expanding them with the first point or box yields exactly that point or box.
+	struct AABB {
+		zenyth::math::vec3 min{ std::numeric_limits<float>::max() };
+		zenyth::math::vec3 max{ -std::numeric_limits<float>::max() };
+
+		[[nodiscard]] static AABB FromCenterExtents(const zenyth::math::vec3& center, const zenyth::math::vec3& extents) noexcept {
+			return { center - extents, center + extents };
+		}
+
+		void Expand(const zenyth::math::vec3& point) noexcept { min = min.min(point); max = max.max(point); }
+		void Expand(const AABB& other) noexcept { min = min.min(other.min); max = max.max(other.max); }
+
+		[[nodiscard]] zenyth::math::vec3 Center()  const noexcept { return (min + max) * 0.5f; }
+		[[nodiscard]] zenyth::math::vec3 Extents() const noexcept { return (max - min) * 0.5f; }
+
+		[[nodiscard]] bool IsEmpty() const noexcept {
+			return min.x() > max.x() || min.y() > max.y() || min.z() > max.z();
+		}
+
+		[[nodiscard]] float SurfaceArea() const noexcept {
+			if (IsEmpty())
+				return 0.0f;
+			const zenyth::math::vec3 d = max - min;
+			return 2.0f * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+		}
+
+		[[nodiscard]] bool Overlaps(const AABB& other) const noexcept {
+			return min.x() <= other.max.x() && max.x() >= other.min.x()
+				&& min.y() <= other.max.y() && max.y() >= other.min.y()
+				&& min.z() <= other.max.z() && max.z() >= other.min.z();
+		}
+
+		[[nodiscard]] bool Contains(const zenyth::math::vec3& p) const noexcept {
+			return p.x() >= min.x() && p.x() <= max.x()
+				&& p.y() >= min.y() && p.y() <= max.y()
+				&& p.z() >= min.z() && p.z() <= max.z();
+		}
+	};
+
+	struct Ray {
+		zenyth::math::vec3 origin;
+		zenyth::math::vec3 direction;
+		float              tMax = std::numeric_limits<float>::infinity();
+	};
+
+	struct RayHit {
+		static constexpr uint32_t None = ~0u;
+
+		uint32_t primitive = None;
+		float    t = std::numeric_limits<float>::infinity();
+
+		[[nodiscard]] bool IsHit() const noexcept { return primitive != None; }
+	};
+
+} // namespace Zenyth
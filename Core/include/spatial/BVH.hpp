@@ -0,0 +1,143 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "spatial/AABB.hpp"
+#include "spatial/Frustum.hpp"
+
+#include <bit>
+#include <immintrin.h>
+#include <span>
+#include <vector>
+
+namespace Zenyth {
+
+	// Bounding volume hierarchy over a set of primitive AABBs.
+	//
+	// Build() runs a binned SAH split on a binary tree (subtrees above ParallelBuildThreshold
+	// primitives are built on the job system), then collapses it into 4-wide nodes stored in
+	// depth-first order with SoA child bounds, so each traversal step tests all four children
+	// with one set of SSE instructions. Refit() updates bounds in place for moving primitives
+	// without changing the topology; rebuild once the tree quality degrades.
+	//
+	// Query callbacks receive the primitive's index in the span passed to Build().
+	class BVH {
+	public:
+		static constexpr uint32_t Width = 4;
+		static constexpr uint32_t MaxLeafSize = 4;
+		static constexpr uint32_t BinCount = 16;
+		static constexpr uint32_t ParallelBuildThreshold = 4096;
+
+		static constexpr int32_t EmptyLane = std::numeric_limits<int32_t>::min();
+
+		// child[k] >= 0: inner node index; child[k] < 0: leaf holding count[k] primitives from ~child[k]
+		struct alignas(64) Node {
+			float    minX[Width], minY[Width], minZ[Width];
+			float    maxX[Width], maxY[Width], maxZ[Width];
+			int32_t  child[Width];
+			uint32_t count[Width];
+		};
+
+		BVH() = default;
+
+		void Build(std::span<const AABB> boxes, JobSystem* jobs = nullptr);
+
+		// boxes must match the count and order given to Build()
+		void Refit(std::span<const AABB> boxes);
+
+		// Closest hit against the primitive boxes themselves
+		[[nodiscard]] RayHit RayCast(const Ray& ray) const;
+
+		// Closest hit using a custom primitive test: float intersect(uint32_t primitive, const Ray& ray, float tMax),
+		// returning the hit distance or +inf on a miss
+		template<typename F>
+		[[nodiscard]] RayHit RayCast(const Ray& ray, F&& intersect) const;
+
+		void RayCastBatch(std::span<const Ray> rays, std::span<RayHit> hits, JobSystem* jobs = nullptr) const;
+
+		template<typename F>
+		void RayCastBatch(std::span<const Ray> rays, std::span<RayHit> hits, JobSystem* jobs, F&& intersect) const;
+
+		// fn(uint32_t primitive) for every primitive whose box intersects the frustum
+		template<typename F>
+		void QueryFrustum(const Frustum& frustum, F&& fn) const;
+
+		// fn(uint32_t query, uint32_t primitive); runs queries concurrently when jobs is set
+		template<typename F>
+		void QueryFrustumBatch(std::span<const Frustum> frustums, JobSystem* jobs, F&& fn) const;
+
+		// fn(uint32_t primitive) for every primitive whose box overlaps `box`
+		template<typename F>
+		void QueryOverlap(const AABB& box, F&& fn) const;
+
+		template<typename F>
+		void QueryOverlapBatch(std::span<const AABB> boxes, JobSystem* jobs, F&& fn) const;
+
+		[[nodiscard]] const AABB& Bounds()         const noexcept { return m_bounds; }
+		[[nodiscard]] bool        Empty()          const noexcept { return m_nodes.empty(); }
+		[[nodiscard]] uint32_t    NodeCount()      const noexcept { return static_cast<uint32_t>(m_nodes.size()); }
+		[[nodiscard]] uint32_t    PrimitiveCount() const noexcept { return static_cast<uint32_t>(m_primIndices.size()); }
+
+		[[nodiscard]] std::span<const Node> Nodes() const noexcept { return m_nodes; }
+
+	private:
+		struct BuildNode;
+		struct BuildContext;
+
+		// Node stack for traversal; spills to the heap only for pathologically deep trees
+		class TraversalStack {
+		public:
+			void Push(const uint32_t node) {
+				if (m_size < InlineSize)
+					m_inline[m_size] = node;
+				else
+					m_overflow.push_back(node);
+				++m_size;
+			}
+
+			uint32_t Pop() {
+				if (--m_size < InlineSize)
+					return m_inline[m_size];
+				const uint32_t node = m_overflow.back();
+				m_overflow.pop_back();
+				return node;
+			}
+
+			[[nodiscard]] bool Empty() const noexcept { return m_size == 0; }
+
+		private:
+			static constexpr uint32_t InlineSize = 128;
+
+			uint32_t              m_inline[InlineSize];
+			uint32_t              m_size = 0;
+			std::vector<uint32_t> m_overflow;
+		};
+
+		static void     Split(BuildContext& ctx, uint32_t nodeIndex, uint32_t start, uint32_t count);
+		uint32_t        Collapse(const std::vector<BuildNode>& tree, uint32_t binaryIndex);
+		static void     SetLane(Node& node, uint32_t lane, const AABB& box) noexcept;
+		static AABB     LaneBounds(const Node& node, uint32_t lane) noexcept;
+
+		// Bitmask of children hit by the ray, with entry distances in tNear
+		static int IntersectRay(const Node& node, const __m128 origin[3], const __m128 invDir[3],
+			__m128 tMax, __m128& tNear) noexcept;
+		static int IntersectBox(const Node& node, const AABB& box) noexcept;
+		// Bitmask of children not rejected by the frustum; `inside` receives the fully contained ones
+		static int IntersectFrustum(const Node& node, const Frustum& frustum, int& inside) noexcept;
+
+		static float IntersectPrimitive(const AABB& box, const Ray& ray, float tMax) noexcept;
+
+		// Closest hit with intersect(leafIndex, ray, tMax); the returned primitive is a leaf index
+		template<typename F>
+		[[nodiscard]] RayHit TraverseRay(const Ray& ray, F&& intersect) const;
+
+		template<typename F>
+		void EmitSubtree(int32_t child, uint32_t count, F& fn) const;
+
+		std::vector<Node>     m_nodes;
+		std::vector<uint32_t> m_primIndices; // leaf order -> caller index
+		std::vector<AABB>     m_leafBoxes;   // leaf order
+		AABB                  m_bounds;
+	};
+
+} // namespace Zenyth
+
+#include "spatial/BVH.tpp"
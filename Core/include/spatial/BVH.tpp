@@ -0,0 +1,205 @@
+#pragma once
+
+namespace Zenyth {
+
+	template<typename F>
+	RayHit BVH::RayCast(const Ray& ray, F&& intersect) const {
+		RayHit hit = TraverseRay(ray, [&](const uint32_t leaf, const Ray& r, const float tMax) {
+			return intersect(m_primIndices[leaf], r, tMax);
+		});
+		if (hit.IsHit())
+			hit.primitive = m_primIndices[hit.primitive];
+		return hit;
+	}
+
+	template<typename F>
+	RayHit BVH::TraverseRay(const Ray& ray, F&& intersect) const {
+		RayHit hit;
+		if (m_nodes.empty())
+			return hit;
+
+		const float dir[3] = { ray.direction.x(), ray.direction.y(), ray.direction.z() };
+		const __m128 origin[3] = {
+			_mm_set1_ps(ray.origin.x()), _mm_set1_ps(ray.origin.y()), _mm_set1_ps(ray.origin.z())
+		};
+		const __m128 invDir[3] = {
+			_mm_set1_ps(1.0f / dir[0]), _mm_set1_ps(1.0f / dir[1]), _mm_set1_ps(1.0f / dir[2])
+		};
+
+		float closest = ray.tMax;
+
+		// Inner nodes only; leaves are resolved as soon as their lane is hit
+		TraversalStack stack;
+		stack.Push(0);
+
+		while (!stack.Empty()) {
+			const Node& node = m_nodes[stack.Pop()];
+
+			__m128 tNear;
+			int mask = IntersectRay(node, origin, invDir, _mm_set1_ps(closest), tNear);
+			if (!mask)
+				continue;
+
+			alignas(16) float near[Width];
+			_mm_store_ps(near, tNear);
+
+			// Push inner children far to near so the nearest one is popped first
+			uint32_t order[Width];
+			uint32_t hits = 0;
+			for (; mask; mask &= mask - 1) {
+				const uint32_t lane = static_cast<uint32_t>(std::countr_zero(static_cast<unsigned>(mask)));
+				if (node.child[lane] == EmptyLane)
+					continue;
+
+				if (node.child[lane] < 0) {
+					const uint32_t first = static_cast<uint32_t>(~node.child[lane]);
+					for (uint32_t p = first; p < first + node.count[lane]; ++p) {
+						const float t = intersect(p, ray, closest);
+						if (t < closest) {
+							closest = t;
+							hit = { p, t };
+						}
+					}
+					continue;
+				}
+
+				uint32_t slot = hits++;
+				for (; slot > 0 && near[order[slot - 1]] < near[lane]; --slot)
+					order[slot] = order[slot - 1];
+				order[slot] = lane;
+			}
+
+			for (uint32_t k = 0; k < hits; ++k)
+				stack.Push(static_cast<uint32_t>(node.child[order[k]]));
+		}
+
+		return hit;
+	}
+
+	template<typename F>
+	void BVH::RayCastBatch(std::span<const Ray> rays, std::span<RayHit> hits, JobSystem* jobs, F&& intersect) const {
+		const auto run = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				hits[i] = RayCast(rays[i], intersect);
+		};
+
+		const uint32_t count = static_cast<uint32_t>(std::min(rays.size(), hits.size()));
+		if (jobs)
+			jobs->ParallelFor(count, 64, run);
+		else
+			run(0, count);
+	}
+
+	template<typename F>
+	void BVH::EmitSubtree(const int32_t child, const uint32_t count, F& fn) const {
+		if (child == EmptyLane)
+			return;
+
+		if (child < 0) {
+			const uint32_t first = static_cast<uint32_t>(~child);
+			for (uint32_t p = first; p < first + count; ++p)
+				fn(m_primIndices[p]);
+			return;
+		}
+
+		const Node& node = m_nodes[child];
+		for (uint32_t lane = 0; lane < Width; ++lane)
+			EmitSubtree(node.child[lane], node.count[lane], fn);
+	}
+
+	template<typename F>
+	void BVH::QueryFrustum(const Frustum& frustum, F&& fn) const {
+		if (m_nodes.empty())
+			return;
+
+		TraversalStack stack;
+		stack.Push(0);
+
+		while (!stack.Empty()) {
+			const Node& node = m_nodes[stack.Pop()];
+
+			int inside = 0;
+			for (int mask = IntersectFrustum(node, frustum, inside); mask; mask &= mask - 1) {
+				const uint32_t lane = static_cast<uint32_t>(std::countr_zero(static_cast<unsigned>(mask)));
+				const int32_t  child = node.child[lane];
+				if (child == EmptyLane)
+					continue;
+
+				// Fully contained children skip every further plane test
+				if (inside & (1 << lane)) {
+					EmitSubtree(child, node.count[lane], fn);
+				}
+				else if (child < 0) {
+					const uint32_t first = static_cast<uint32_t>(~child);
+					for (uint32_t p = first; p < first + node.count[lane]; ++p) {
+						if (frustum.Intersects(m_leafBoxes[p]))
+							fn(m_primIndices[p]);
+					}
+				}
+				else {
+					stack.Push(static_cast<uint32_t>(child));
+				}
+			}
+		}
+	}
+
+	template<typename F>
+	void BVH::QueryFrustumBatch(std::span<const Frustum> frustums, JobSystem* jobs, F&& fn) const {
+		const auto run = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t q = begin; q < end; ++q)
+				QueryFrustum(frustums[q], [&fn, q](const uint32_t primitive) { fn(q, primitive); });
+		};
+
+		const uint32_t count = static_cast<uint32_t>(frustums.size());
+		if (jobs)
+			jobs->ParallelFor(count, 1, run);
+		else
+			run(0, count);
+	}
+
+	template<typename F>
+	void BVH::QueryOverlap(const AABB& box, F&& fn) const {
+		if (m_nodes.empty())
+			return;
+
+		TraversalStack stack;
+		stack.Push(0);
+
+		while (!stack.Empty()) {
+			const Node& node = m_nodes[stack.Pop()];
+
+			for (int mask = IntersectBox(node, box); mask; mask &= mask - 1) {
+				const uint32_t lane = static_cast<uint32_t>(std::countr_zero(static_cast<unsigned>(mask)));
+				const int32_t  child = node.child[lane];
+				if (child == EmptyLane)
+					continue;
+
+				if (child < 0) {
+					const uint32_t first = static_cast<uint32_t>(~child);
+					for (uint32_t p = first; p < first + node.count[lane]; ++p) {
+						if (m_leafBoxes[p].Overlaps(box))
+							fn(m_primIndices[p]);
+					}
+				}
+				else {
+					stack.Push(static_cast<uint32_t>(child));
+				}
+			}
+		}
+	}
+
+	template<typename F>
+	void BVH::QueryOverlapBatch(std::span<const AABB> boxes, JobSystem* jobs, F&& fn) const {
+		const auto run = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t q = begin; q < end; ++q)
+				QueryOverlap(boxes[q], [&fn, q](const uint32_t primitive) { fn(q, primitive); });
+		};
+
+		const uint32_t count = static_cast<uint32_t>(boxes.size());
+		if (jobs)
+			jobs->ParallelFor(count, 16, run);
+		else
+			run(0, count);
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,108 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "memory/LinearArena.hpp"
+#include "spatial/AABB.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Zenyth {
+
+	// Two bodies whose boxes overlap; a < b
+	struct BroadphasePair {
+		uint32_t a;
+		uint32_t b;
+	};
+
+	struct BroadphaseDesc {
+		uint32_t sweepAxis = 0;     // 0 = x, 1 = y, 2 = z; pick the axis the bodies are most spread along
+
+		// Multi-box pruning: worldBounds is cut into regionsU x regionsV cells over the two axes
+		// other than the sweep axis, and each cell runs its own sweep (in parallel when given a
+		// job system). Bodies outside worldBounds belong to the nearest edge cells.
+		AABB     worldBounds;
+		uint32_t regionsU = 1;
+		uint32_t regionsV = 1;
+	};
+
+	// Incremental sort-and-sweep broadphase for many moving boxes.
+	//
+	// Each region keeps its bodies sorted by their minimum on the sweep axis from one FindPairs() to
+	// the next, so frame-to-frame motion is absorbed by an insertion sort that is close to linear.
+	// The sweep then tests each body against the following ones eight at a time (AVX2, SSE fallback)
+	// on the two remaining axes, stopping at the first body that starts past its maximum.
+	// A pair straddling several regions is reported only by the region that owns the minimum corner
+	// of the overlap, so the result holds every overlapping pair exactly once.
+	class Broadphase {
+	public:
+		explicit Broadphase(const BroadphaseDesc& desc = {});
+
+		Broadphase(const Broadphase&) = delete;
+		Broadphase& operator=(const Broadphase&) = delete;
+
+		// Handles of removed bodies are reused after the next FindPairs(). Infinite bounds are stored
+		// as the largest finite floats; NaN bounds throw.
+		[[nodiscard]] uint32_t Add(const AABB& box);
+		void                   Move(uint32_t handle, const AABB& box);
+		void                   Remove(uint32_t handle);
+
+		// All overlapping pairs, in a span allocated from arena; valid until the arena is reset
+		[[nodiscard]] std::span<const BroadphasePair> FindPairs(LinearArena& arena, JobSystem* jobs = nullptr);
+
+		[[nodiscard]] uint32_t BodyCount()   const noexcept { return m_bodyCount; }
+		[[nodiscard]] uint32_t RegionCount() const noexcept { return static_cast<uint32_t>(m_regions.size()); }
+		[[nodiscard]] const AABB& GetBox(const uint32_t handle) const noexcept { return m_bodies[handle].box; }
+
+	private:
+		// Inclusive range of region cells a body touches
+		struct CellRect {
+			uint16_t u0 = 1, u1 = 0, v0 = 1, v1 = 0; // empty by default
+
+			[[nodiscard]] bool Contains(const uint32_t u, const uint32_t v) const noexcept {
+				return u >= u0 && u <= u1 && v >= v0 && v <= v1;
+			}
+		};
+
+		struct Body {
+			AABB     box;
+			CellRect cells;         // as of the last FindPairs()
+			bool     alive = false;
+			bool     dirty = false;
+		};
+
+		struct SortEntry {
+			float    key;
+			uint32_t handle;
+		};
+
+		struct Region {
+			uint32_t u = 0, v = 0;
+			std::vector<SortEntry> entries;   // sorted by key as of the last FindPairs()
+			std::vector<uint32_t>  added;
+
+			// Sweep data in sorted order, padded with sentinels so the wide kernel needs no tail
+			std::vector<float>    sweepMin, sweepMax, uMin, uMax, vMin, vMax;
+			std::vector<uint32_t> handles;
+
+			std::vector<BroadphasePair> pairs;
+		};
+
+		[[nodiscard]] CellRect ComputeCells(const AABB& box) const noexcept;
+		[[nodiscard]] uint32_t CellU(float value) const noexcept;
+		[[nodiscard]] uint32_t CellV(float value) const noexcept;
+		void MarkDirty(uint32_t handle);
+		void CommitMoves();
+		void UpdateRegion(Region& region);
+
+		BroadphaseDesc        m_desc;
+		uint32_t              m_axisU, m_axisV;
+		float                 m_cellScaleU = 0.0f, m_cellScaleV = 0.0f;
+		std::vector<Body>     m_bodies;
+		std::vector<uint32_t> m_freeHandles;
+		std::vector<uint32_t> m_dirty;
+		std::vector<uint32_t> m_pendingFree;
+		std::vector<Region>   m_regions;
+		uint32_t              m_bodyCount = 0;
+	};
+
+} // namespace Zenyth
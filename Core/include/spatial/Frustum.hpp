@@ -0,0 +1,26 @@
+#pragma once
+#include "spatial/AABB.hpp"
+#include "math/matrix.hpp"
+
+namespace Zenyth {
+
+	// Six inward-facing planes (n.p + d >= 0 inside), extracted from a view-projection matrix
+	// using the D3D clip volume (0 <= z <= w).
+	class Frustum {
+	public:
+		enum Plane : uint32_t { Left, Right, Bottom, Top, Near, Far, Count };
+
+		Frustum() = default;
+		explicit Frustum(const zenyth::math::mat4& viewProjection) noexcept;
+
+		[[nodiscard]] const zenyth::math::vec4& GetPlane(const uint32_t plane) const noexcept { return m_planes[plane]; }
+
+		// True unless the box is entirely behind one of the planes
+		[[nodiscard]] bool Intersects(const AABB& box) const noexcept;
+		[[nodiscard]] bool Contains(const AABB& box) const noexcept;
+
+	private:
+		std::array<zenyth::math::vec4, Count> m_planes;
+	};
+
+} // namespace Zenyth
@@ -0,0 +1,34 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "texture/Image.hpp"
+
+#include <cstddef>
+
+namespace Zenyth {
+
+	enum class BlockFormat : uint8_t {
+		BC1, // RGB, 4 bpp; alpha is dropped
+		BC3, // RGBA, 8 bpp; BC1 color plus a BC4 alpha block
+		BC4, // R, 4 bpp
+		BC5, // RG, 8 bpp; two BC4 blocks, for normal maps
+		BC7, // RGBA, 8 bpp
+	};
+
+	enum class CompressionQuality : uint8_t {
+		Fast,   // principal axis fit only; BC7 uses mode 6
+		Normal, // least squares refinement; BC7 also tries mode 1 on the most promising partitions
+		High,   // endpoint neighbourhood search; BC7 searches every mode 1 partition
+	};
+
+	[[nodiscard]] uint32_t BlockBytes(BlockFormat format) noexcept;
+	[[nodiscard]] size_t   CompressedSize(BlockFormat format, uint32_t width, uint32_t height) noexcept;
+
+	// Encodes one 4x4 block of RGBA8 pixels (64 bytes, row-major) into BlockBytes(format) bytes
+	void EncodeBlock(BlockFormat format, const uint8_t* rgba, CompressionQuality quality, uint8_t* out) noexcept;
+
+	// Encodes a whole image in row-major block order; partial edge blocks repeat the last row/column.
+	// Block rows are spread over `jobs` when set. Palette searches use AVX2 when the CPU has it.
+	void CompressImage(const ImageView& image, BlockFormat format, CompressionQuality quality,
+		std::span<std::byte> out, JobSystem* jobs = nullptr);
+
+} // namespace Zenyth
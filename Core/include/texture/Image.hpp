@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Zenyth {
+
+	// Non-owning RGBA8 pixels, top row first
+	struct ImageView {
+		const uint8_t* pixels = nullptr;
+		uint32_t       width = 0;
+		uint32_t       height = 0;
+		uint32_t       rowPitch = 0; // bytes
+
+		[[nodiscard]] const uint8_t* Row(const uint32_t y) const noexcept { return pixels + static_cast<size_t>(y) * rowPitch; }
+	};
+
+	// Tightly packed RGBA8 image
+	struct Image {
+		uint32_t             width = 0;
+		uint32_t             height = 0;
+		std::vector<uint8_t> pixels;
+
+		Image() = default;
+		Image(const uint32_t w, const uint32_t h) : width(w), height(h), pixels(static_cast<size_t>(w) * h * 4) {}
+
+		[[nodiscard]] ImageView View() const noexcept { return { pixels.data(), width, height, width * 4 }; }
+		[[nodiscard]] uint8_t*  Row(const uint32_t y) noexcept { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+	};
+
+} // namespace Zenyth
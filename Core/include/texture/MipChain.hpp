@@ -0,0 +1,24 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "texture/Image.hpp"
+
+namespace Zenyth {
+
+	enum class MipFilter : uint8_t {
+		Box,    // 2x2 average; cheapest, slightly blurry
+		Kaiser, // 8-tap Kaiser windowed sinc; keeps detail in distant mips
+	};
+
+	struct MipSettings {
+		MipFilter filter = MipFilter::Kaiser;
+		bool      srgb = true;      // filter color in linear space; alpha is always linear
+		uint32_t  maxLevels = 0;    // including the base level, 0 for a full chain
+	};
+
+	[[nodiscard]] uint32_t MipLevelCount(uint32_t width, uint32_t height) noexcept;
+
+	// Returns mip levels 1..N (the base level is not copied). Each level is filtered from the previous
+	// one in float, so rounding does not accumulate down the chain. Rows are spread over `jobs` when set.
+	[[nodiscard]] std::vector<Image> GenerateMips(const ImageView& base, const MipSettings& settings, JobSystem* jobs = nullptr);
+
+} // namespace Zenyth
@@ -1,74 +1,185 @@
 #include "pch.hpp"
 #include "Application.hpp"
+#include "logging/Log.hpp"
 
 namespace Zenyth {
 	Application::Application(const AppDesc& desc)
 		: m_desc(desc)
 	{
-		WindowDesc wd;
-		wd.title = desc.title;
-		wd.width = desc.width;
-		wd.height = desc.height;
-		wd.resizable = desc.resizable;
-
-		m_window = std::make_unique<Window>(wd);
+		// Only what startup itself needs; the window and renderer are created by Startup()
 		m_timer = std::make_unique<Timer>();
+		m_jobs = std::make_unique<JobSystem>(desc.workerThreads);
+		m_frameLimiter = std::make_unique<FrameLimiter>(FrameLimiterDesc{ .targetFps = desc.frameRateLimit, .pacing = desc.framePacing });
+		RegisterMetrics();
+	}
 
-		m_window->SetEventCallback([this](const Event& e) {
-			OnWindowEvent(e);
-		});
+	void Application::RegisterMetrics() {
+		// The frame loop only feeds these two; everything else is read when the server publishes
+		m_framesMetric = &m_metrics.AddCounter("zenyth_frames_total", "Frames run");
+
+		const std::vector<double> frameBounds = Histogram::ExponentialBounds(0.001, 1.25, 24); // 1 ms to ~170 ms
+		constexpr double frameQuantiles[] = { 0.5, 0.9, 0.99 };
+		m_frameTimeMetric = &m_metrics.AddHistogram("zenyth_frame_time_seconds", "Frame time as measured by the timer",
+			frameBounds, {}, frameQuantiles);
+
+		m_metrics.AddGaugeFn("zenyth_jobs_threads", "Job system threads, including the main thread",
+			[this] { return static_cast<double>(m_jobs->ThreadCount()); });
+		m_metrics.AddGaugeFn("zenyth_jobs_queue_depth", "Jobs waiting to run",
+			[this] { return static_cast<double>(m_jobs->QueueDepth()); });
+		m_metrics.AddCounterFn("zenyth_jobs_executed_total", "Jobs finished",
+			[this] { return static_cast<double>(m_jobs->ExecutedCount()); });
+
+		m_metrics.AddCounterFn("zenyth_renderer_draw_calls_total", "Draw calls recorded",
+			[this] { return m_renderer ? static_cast<double>(m_renderer->Counters().drawCalls.load(std::memory_order_relaxed)) : 0.0; });
+		m_metrics.AddCounterFn("zenyth_renderer_state_changes_total", "Pipeline and binding changes recorded",
+			[this] { return m_renderer ? static_cast<double>(m_renderer->Counters().stateChanges.load(std::memory_order_relaxed)) : 0.0; });
+
+		m_metrics.AddCounterFn("zenyth_log_dropped_total", "Log records dropped on full rings",
+			[] { return static_cast<double>(logging::Logger::DroppedCount()); });
 	}
 
 	void Application::SetRenderer(std::unique_ptr<IRenderer> renderer) {
 		m_renderer = std::move(renderer);
 	}
 
-	void Application::Run() {
+	Window& Application::GetWindow() const {
 		if (!m_window)
-			throw std::runtime_error("Application::Run : window not created");
+			throw std::runtime_error("Application::GetWindow : the main window does not exist before Run() creates it");
+		return *m_window;
+	}
+
+	Window& Application::OpenWindow(const WindowDesc& desc) {
+		auto window = std::make_unique<Window>(desc);
+		window->SetEventCallback(EventCallback::Bind<&Application::OnWindowEvent>(this));
+		return *m_extraWindows.emplace_back(std::move(window));
+	}
+
+	void Application::PumpWindows() {
+		if (!m_window->PumpMessages())
+			m_running = false;
+
+		// By index: handlers may open more windows
+		for (size_t i = 0; i < m_extraWindows.size(); ++i)
+			m_extraWindows[i]->PumpMessages();
+		std::erase_if(m_extraWindows, [](const std::unique_ptr<Window>& window) { return !window->IsOpen(); });
+	}
+
+	void Application::Startup() {
+		m_startup = std::make_unique<StartupGraph>();
+		StartupGraph& startup = *m_startup;
+
+		// The window runs its own message thread, so it can be created off the main thread
+		startup.Add("window", {}, [this] {
+			WindowDesc wd;
+			wd.title = m_desc.title;
+			wd.width = m_desc.width;
+			wd.height = m_desc.height;
+			wd.resizable = m_desc.resizable;
+
+			m_window = std::make_unique<Window>(wd);
+			m_window->SetEventCallback(EventCallback::Bind<&Application::OnWindowEvent>(this));
+		});
+
+		startup.Add("renderer.device", {}, [this] { m_renderer->CreateDevice(); });
+
+		startup.Add("renderer", { "window", "renderer.device" }, [this] {
+			m_renderer->Init(m_window->GetHandle(), m_window->GetWidth(), m_window->GetHeight());
+		}, StartupThread::Main);
+
+		OnConfigureStartup(startup);
+
+		startup.Add("app", startup.TaskNames(false), [this] { OnInit(); }, StartupThread::Main);
+
+		// Published once everything it reads exists; failing to bind must not stop the app
+		if (!m_desc.metricsEndpoint.empty()) {
+			startup.AddDeferred("metrics", { "app" }, [this] {
+				try {
+					m_metricsServer = std::make_unique<MetricsServer>(m_metrics, MetricsServerDesc{ .endpoint = m_desc.metricsEndpoint });
+					ZENYTH_LOG_INFO(Core, "metrics: serving on {}", std::string_view(m_metricsServer->Endpoint()));
+				}
+				catch (const std::exception& e) {
+					ZENYTH_LOG_ERROR(Core, "metrics: {}", std::string_view(e.what()));
+				}
+			});
+		}
+		startup.Run(*m_jobs);
+
+		for (const StartupTiming& timing : startup.Timings()) {
+			ZENYTH_LOG_INFO(Core, "startup: {} took {:.2f} ms (at {:.2f} ms, thread {})",
+				timing.name, timing.durationMs, timing.startMs, timing.thread);
+		}
+
+		std::string criticalPath;
+		for (const std::string_view name : startup.CriticalPath())
+			criticalPath += (criticalPath.empty() ? "" : " -> ") + std::string(name);
+		ZENYTH_LOG_INFO(Core, "startup: {:.2f} ms, critical path {}", startup.TotalMs(), std::string_view(criticalPath));
+	}
+
+	void Application::Run() {
 		if (!m_renderer)
 			throw std::runtime_error("Application::Run : renderer not created");
 
-		m_renderer->Init(m_window->GetHandle(),
-			m_window->GetWidth(),
-			m_window->GetHeight());
-
-		m_timer->Reset();
+		// Before startup, so OnInit() can still Stop()
 		m_running = true;
+		Startup();
 
-		OnInit();
+		m_timer->Reset();
 
 		while (m_running) {
-			if (!m_window->PumpMessages())
-				m_running = false;
+			// Low latency pacing waits here, so the messages pumped below are as fresh as possible
+			const FrameLimiter::WaitTimes beforeInput = m_frameLimiter->BeginFrame();
+			m_timer->RecordWait(beforeInput.sleepSeconds, beforeInput.spinSeconds);
+
+			// Window threads only queue; moving or resizing a window never stalls this loop
+			PumpWindows();
 			if (!m_running) break;
 
 			const float dt = m_timer->Tick();
+			m_framesMetric->Add();
+			m_frameTimeMetric->Observe(dt);
 			OnUpdate(dt);
 
 			m_renderer->BeginFrame();
 			OnRender();
 			m_renderer->EndFrame();
+
+			const FrameLimiter::WaitTimes afterPresent = m_frameLimiter->EndFrame();
+			m_timer->RecordWait(afterPresent.sleepSeconds, afterPresent.spinSeconds);
 		}
 
+		// Deferred startup work may still be using the renderer
+		m_startup->WaitDeferred();
+		// Before the app and the renderer tear down what the metric readers look at
+		m_metricsServer.reset();
+
 		OnShutdown();
 		
 		m_renderer.reset();
+		m_extraWindows.clear();
 	}
 
 	void Application::OnWindowEvent(const Event& e) {
-		OnEvent(e);
+		if (!m_events.Dispatch(e))
+			OnEvent(e);
 	}
 
 	void Application::OnEvent(const Event& e) {
 		switch (e.type) {
 
 		case EventType::WindowClose:
-			Stop();
+			if (e.window == m_window->GetId()) {
+				Stop();
+				break;
+			}
+			for (const std::unique_ptr<Window>& window : m_extraWindows) {
+				if (window->GetId() == e.window)
+					window->Close();
+			}
 			break;
 
+		// Delivered at most once per frame with the latest size, so this is the debounced resize
 		case EventType::WindowResize:
-			if (e.resize.width > 0 && e.resize.height > 0 && m_renderer)
+			if (e.window == m_window->GetId() && e.resize.width > 0 && e.resize.height > 0 && m_renderer)
 				m_renderer->Resize(e.resize.width, e.resize.height);
 			break;
 
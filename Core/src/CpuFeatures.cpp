@@ -0,0 +1,45 @@
+#include "pch.hpp"
+#include "CpuFeatures.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Zenyth {
+
+	namespace {
+		CpuFeatures Detect() noexcept {
+			CpuFeatures features;
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			features.sse41 = (info[2] & (1 << 19)) != 0;
+			features.fma = (info[2] & (1 << 12)) != 0;
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool ymmEnabled = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+
+			if (maxLeaf >= 7) {
+				__cpuidex(info, 7, 0);
+				features.avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+			}
+			features.fma = features.fma && ymmEnabled;
+#else
+			__builtin_cpu_init();
+			features.sse41 = __builtin_cpu_supports("sse4.1");
+			features.avx2 = __builtin_cpu_supports("avx2");
+			features.fma = __builtin_cpu_supports("fma");
+#endif
+			return features;
+		}
+	}
+
+	const CpuFeatures& GetCpuFeatures() noexcept {
+		static const CpuFeatures features = Detect();
+		return features;
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,98 @@
+#include "pch.hpp"
+#include "EventDispatcher.hpp"
+
+namespace Zenyth {
+
+	namespace {
+		// The event type lives in the top byte so Unsubscribe() goes straight to the right bucket
+		constexpr uint32_t SerialBits = 24;
+		constexpr uint32_t SerialMask = (1u << SerialBits) - 1;
+	}
+
+	EventDispatcher::ListenerId EventDispatcher::Subscribe(const EventType type, const Handler handler, const int32_t priority) {
+		if (m_dispatchDepth > 0)
+			throw std::runtime_error("EventDispatcher::Subscribe : cannot subscribe while dispatching");
+		if (!handler)
+			throw std::invalid_argument("EventDispatcher::Subscribe : empty handler");
+
+		Bucket& bucket = m_buckets[static_cast<uint32_t>(type)];
+		if (bucket.count == MaxListenersPerType)
+			throw std::runtime_error("EventDispatcher::Subscribe : too many listeners for one event type");
+
+		const uint32_t serial = m_nextSerial;
+		// Serials run 1..SerialMask: 0 is the invalid id, and wrapping must not spill into the type byte
+		m_nextSerial = m_nextSerial % SerialMask + 1;
+		const uint32_t id = static_cast<uint32_t>(type) << SerialBits | serial;
+
+		// Insert after every listener of equal or higher priority
+		uint32_t slot = bucket.count;
+		while (slot > 0 && bucket.listeners[slot - 1].priority < priority) {
+			bucket.listeners[slot] = bucket.listeners[slot - 1];
+			--slot;
+		}
+		bucket.listeners[slot] = { handler, priority, id };
+		++bucket.count;
+
+		return { id };
+	}
+
+	void EventDispatcher::Unsubscribe(const ListenerId id) noexcept {
+		const uint32_t type = id.value >> SerialBits;
+		if (!id || type >= EventTypeCount)
+			return;
+
+		Bucket& bucket = m_buckets[type];
+		for (uint32_t i = 0; i < bucket.count; ++i) {
+			if (bucket.listeners[i].id != id.value || bucket.listeners[i].removed)
+				continue;
+
+			// Mid-dispatch the slots must stay put, and the handler may be the one running: only flag
+			// it, and compact afterwards
+			if (m_dispatchDepth > 0) {
+				bucket.listeners[i].removed = true;
+				bucket.dirty = true;
+				m_pendingCompact = true;
+			}
+			else {
+				std::copy(bucket.listeners.begin() + i + 1, bucket.listeners.begin() + bucket.count, bucket.listeners.begin() + i);
+				--bucket.count;
+			}
+			return;
+		}
+	}
+
+	bool EventDispatcher::Dispatch(const Event& e) {
+		const Bucket& bucket = m_buckets[static_cast<uint32_t>(e.type)];
+
+		bool consumed = false;
+		{
+			// Restores the depth even when a handler throws
+			struct DepthScope {
+				uint32_t& depth;
+				~DepthScope() { --depth; }
+			} scope{ ++m_dispatchDepth };
+
+			for (uint32_t i = 0; i < bucket.count && !consumed; ++i) {
+				if (const Listener& listener = bucket.listeners[i]; !listener.removed)
+					consumed = listener.handler(e);
+			}
+		}
+
+		if (m_dispatchDepth == 0 && m_pendingCompact) {
+			for (Bucket& dirty : m_buckets) {
+				if (dirty.dirty)
+					Compact(dirty);
+			}
+			m_pendingCompact = false;
+		}
+		return consumed;
+	}
+
+	void EventDispatcher::Compact(Bucket& bucket) noexcept {
+		const auto end = std::remove_if(bucket.listeners.begin(), bucket.listeners.begin() + bucket.count,
+			[](const Listener& listener) { return listener.removed; });
+		bucket.count = static_cast<uint32_t>(end - bucket.listeners.begin());
+		bucket.dirty = false;
+	}
+
+} // namespace Zenyth
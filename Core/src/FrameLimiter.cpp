@@ -0,0 +1,130 @@
+#include "pch.hpp"
+#include "FrameLimiter.hpp"
+
+#include <immintrin.h>
+
+#ifdef _WIN32
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002 // older SDKs only expose it for newer _WIN32_WINNT
+#endif
+#else
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace Zenyth {
+
+	namespace {
+		constexpr double EstimateWeight = 0.1; // exponential moving average weight of a new sample
+
+		double Seconds(const FrameLimiter::Clock::duration d) noexcept {
+			return std::chrono::duration<double>(d).count();
+		}
+
+		void Track(double& mean, double& deviation, const double sample) noexcept {
+			mean += (sample - mean) * EstimateWeight;
+			deviation += (std::abs(sample - mean) - deviation) * EstimateWeight;
+		}
+	}
+
+	FrameLimiter::FrameLimiter(const FrameLimiterDesc& desc) : m_desc(desc) {
+#ifdef _WIN32
+		// High resolution timers exist since Windows 10 1803; older systems get the coarse timer and a wider spin
+		m_timer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (!m_timer)
+			m_timer = ::CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		if (!m_timer)
+			throw std::runtime_error("FrameLimiter : cannot create a waitable timer");
+#endif
+		SetTargetFps(desc.targetFps);
+	}
+
+	FrameLimiter::~FrameLimiter() {
+#ifdef _WIN32
+		if (m_timer)
+			::CloseHandle(m_timer);
+#endif
+	}
+
+	void FrameLimiter::SetTargetFps(const double fps) noexcept {
+		m_desc.targetFps = fps;
+		m_period = fps > 0.0
+			? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+			: Clock::duration{ 0 };
+		m_deadline = {};
+	}
+
+	double FrameLimiter::SpinMargin() const noexcept {
+		const double margin = std::max(m_desc.minSpinMs * 1e-3, m_oversleep + 3.0 * m_oversleepDeviation);
+		return std::min(margin, Seconds(m_period) * 0.5);
+	}
+
+	void FrameLimiter::AdvanceDeadline(const Clock::time_point now) noexcept {
+		m_deadline += m_period;
+		// More than a frame behind (first frame, breakpoint, hitch): restart the schedule from now
+		if (m_deadline + m_period < now)
+			m_deadline = now + m_period;
+	}
+
+	FrameLimiter::WaitTimes FrameLimiter::BeginFrame() {
+		WaitTimes waited;
+		if (IsLimited() && m_desc.pacing == FramePacing::LowLatency) {
+			// Leave the predicted work time plus its usual variation before the deadline
+			const double budget = m_workEstimate + 2.0 * m_workDeviation;
+			const auto start = m_deadline - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budget));
+			waited = WaitUntil(start);
+		}
+		m_frameStart = Clock::now();
+		return waited;
+	}
+
+	FrameLimiter::WaitTimes FrameLimiter::EndFrame() {
+		const Clock::time_point now = Clock::now();
+		Track(m_workEstimate, m_workDeviation, Seconds(now - m_frameStart));
+
+		if (!IsLimited())
+			return {};
+
+		// In LowLatency mode the wait for this deadline happens in the next BeginFrame()
+		AdvanceDeadline(now);
+		return m_desc.pacing == FramePacing::Smooth ? WaitUntil(m_deadline) : WaitTimes{};
+	}
+
+	FrameLimiter::WaitTimes FrameLimiter::WaitUntil(const Clock::time_point until) {
+		WaitTimes waited;
+		Clock::time_point now = Clock::now();
+
+		const double sleep = Seconds(until - now) - SpinMargin();
+		if (sleep > 0.0) {
+			Sleep(sleep);
+			const Clock::time_point woke = Clock::now();
+			const double slept = Seconds(woke - now);
+			Track(m_oversleep, m_oversleepDeviation, slept - sleep);
+			waited.sleepSeconds = slept;
+			now = woke;
+		}
+
+		const Clock::time_point spinStart = now;
+		while (now < until) {
+			_mm_pause();
+			now = Clock::now();
+		}
+		waited.spinSeconds = Seconds(now - spinStart);
+		return waited;
+	}
+
+	void FrameLimiter::Sleep(const double seconds) {
+#ifdef _WIN32
+		LARGE_INTEGER due;
+		due.QuadPart = -static_cast<LONGLONG>(seconds * 1e7); // relative, in 100 ns units
+		if (::SetWaitableTimerEx(m_timer, &due, 0, nullptr, nullptr, nullptr, 0))
+			::WaitForSingleObject(m_timer, INFINITE);
+#else
+		timespec request{};
+		request.tv_sec = static_cast<time_t>(seconds);
+		request.tv_nsec = static_cast<long>((seconds - static_cast<double>(request.tv_sec)) * 1e9);
+		while (::nanosleep(&request, &request) != 0 && errno == EINTR) {}
+#endif
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,112 @@
+#include "pch.hpp"
+#include "JobSystem.hpp"
+
+#include <utility>
+
+namespace Zenyth {
+
+	namespace {
+		thread_local uint32_t t_threadIndex = 0;
+	}
+
+	JobSystem::JobSystem(uint32_t workerCount) {
+		if (workerCount == 0) {
+			const uint32_t hw = std::thread::hardware_concurrency();
+			// Keep one worker even on a single core, see the header
+			workerCount = hw > 1 ? hw - 1 : 1;
+		}
+
+		m_workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; ++i)
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_all();
+
+		for (auto& worker : m_workers)
+			worker.join();
+	}
+
+	void JobSystem::Submit(JobCounter& counter, Job job) {
+		counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+		{
+			std::lock_guard lock(m_mutex);
+			m_queue.push_back({ std::move(job), &counter });
+		}
+		m_wake.notify_one();
+	}
+
+	void JobSystem::Wait(const JobCounter& counter) {
+		while (!counter.IsDone()) {
+			if (!TryRunOne())
+				std::this_thread::yield();
+		}
+
+		if (counter.m_error) {
+			// Reset, so the counter can be reused
+			const std::exception_ptr error = std::exchange(counter.m_error, nullptr);
+			counter.m_failed.clear(std::memory_order_relaxed);
+			std::rethrow_exception(error);
+		}
+	}
+
+	uint32_t JobSystem::QueueDepth() const {
+		std::lock_guard lock(m_mutex);
+		return static_cast<uint32_t>(m_queue.size());
+	}
+
+	uint32_t JobSystem::ThreadIndex() noexcept {
+		return t_threadIndex;
+	}
+
+	void JobSystem::WorkerLoop(const uint32_t index) {
+		t_threadIndex = index;
+
+		for (;;) {
+			Entry entry;
+			{
+				std::unique_lock lock(m_mutex);
+				m_wake.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+				if (m_quit && m_queue.empty())
+					return;
+
+				entry = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+			Run(entry);
+		}
+	}
+
+	bool JobSystem::TryRunOne() {
+		Entry entry;
+		{
+			std::lock_guard lock(m_mutex);
+			if (m_queue.empty())
+				return false;
+
+			entry = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+		Run(entry);
+		return true;
+	}
+
+	void JobSystem::Run(Entry& entry) {
+		try {
+			entry.job();
+		}
+		catch (...) {
+			if (!entry.counter->m_failed.test_and_set(std::memory_order_relaxed))
+				entry.counter->m_error = std::current_exception();
+		}
+		// Always counted down, or Wait() would never return
+		entry.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+		m_executed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+} // namespace Zenyth
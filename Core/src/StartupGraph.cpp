@@ -0,0 +1,261 @@
+#include "pch.hpp"
+#include "StartupGraph.hpp"
+
+#include <utility>
+
+namespace Zenyth {
+
+	StartupGraph::~StartupGraph() {
+		if (m_jobs)
+			m_jobs->Wait(m_deferred);
+	}
+
+	void StartupGraph::Add(std::string name, std::vector<std::string> dependencies, Init init, const StartupThread thread) {
+		AddTask(std::move(name), std::move(dependencies), std::move(init), thread, false);
+	}
+
+	void StartupGraph::AddDeferred(std::string name, std::vector<std::string> dependencies, Init init) {
+		AddTask(std::move(name), std::move(dependencies), std::move(init), StartupThread::Any, true);
+	}
+
+	void StartupGraph::AddTask(std::string name, std::vector<std::string> dependencies, Init init, const StartupThread thread, const bool deferred) {
+		if (m_jobs)
+			throw std::runtime_error("StartupGraph::Add : graph already ran");
+		if (!init)
+			throw std::invalid_argument("StartupGraph::Add : task '" + name + "' has no init function");
+		if (Contains(name))
+			throw std::invalid_argument("StartupGraph::Add : duplicate task '" + name + "'");
+
+		auto task = std::make_unique<Task>();
+		task->name = std::move(name);
+		task->dependencyNames = std::move(dependencies);
+		task->init = std::move(init);
+		task->thread = thread;
+		task->deferred = deferred;
+		m_tasks.push_back(std::move(task));
+	}
+
+	bool StartupGraph::Contains(const std::string_view name) const noexcept {
+		return std::ranges::any_of(m_tasks, [&](const auto& task) { return task->name == name; });
+	}
+
+	std::vector<std::string> StartupGraph::TaskNames(const bool includeDeferred) const {
+		std::vector<std::string> names;
+		for (const auto& task : m_tasks) {
+			if (includeDeferred || !task->deferred)
+				names.push_back(task->name);
+		}
+		return names;
+	}
+
+	void StartupGraph::Resolve() {
+		std::unordered_map<std::string_view, uint32_t> indices;
+		for (uint32_t i = 0; i < m_tasks.size(); ++i)
+			indices.emplace(m_tasks[i]->name, i);
+
+		for (uint32_t i = 0; i < m_tasks.size(); ++i) {
+			Task& task = *m_tasks[i];
+			for (const std::string& name : task.dependencyNames) {
+				const auto it = indices.find(name);
+				if (it == indices.end())
+					throw std::invalid_argument("StartupGraph::Run : '" + task.name + "' depends on unknown task '" + name + "'");
+
+				const Task& dependency = *m_tasks[it->second];
+				if (dependency.deferred && !task.deferred)
+					throw std::invalid_argument("StartupGraph::Run : '" + task.name + "' depends on deferred task '" + name + "'");
+				if (std::ranges::find(task.dependencies, it->second) != task.dependencies.end())
+					continue;
+
+				task.dependencies.push_back(it->second);
+				m_tasks[it->second]->dependents.push_back(i);
+			}
+		}
+
+		// Kahn's algorithm; whatever is left unvisited sits on a cycle
+		std::vector<uint32_t> inDegree(m_tasks.size()), ready;
+		for (uint32_t i = 0; i < m_tasks.size(); ++i) {
+			inDegree[i] = static_cast<uint32_t>(m_tasks[i]->dependencies.size());
+			if (inDegree[i] == 0)
+				ready.push_back(i);
+		}
+
+		size_t visited = 0;
+		while (!ready.empty()) {
+			const uint32_t i = ready.back();
+			ready.pop_back();
+			++visited;
+			for (const uint32_t dependent : m_tasks[i]->dependents) {
+				if (--inDegree[dependent] == 0)
+					ready.push_back(dependent);
+			}
+		}
+
+		if (visited != m_tasks.size()) {
+			std::string cycle;
+			for (uint32_t i = 0; i < m_tasks.size(); ++i) {
+				if (inDegree[i] > 0)
+					cycle += (cycle.empty() ? "'" : ", '") + m_tasks[i]->name + "'";
+			}
+			throw std::invalid_argument("StartupGraph::Run : dependency cycle between " + cycle);
+		}
+	}
+
+	void StartupGraph::Run(JobSystem& jobs) {
+		if (m_jobs)
+			throw std::runtime_error("StartupGraph::Run : graph already ran");
+
+		Resolve();
+
+		m_jobs = &jobs;
+		m_origin = std::chrono::steady_clock::now();
+
+		uint32_t critical = 0;
+		for (const auto& task : m_tasks) {
+			task->remaining.store(static_cast<uint32_t>(task->dependencies.size()), std::memory_order_relaxed);
+			critical += task->deferred ? 0 : 1;
+		}
+		m_pendingCritical.store(critical, std::memory_order_release);
+
+		for (uint32_t i = 0; i < m_tasks.size(); ++i) {
+			if (m_tasks[i]->dependencies.empty())
+				Schedule(i);
+		}
+
+		// Run main-thread tasks as they become ready until every critical task has finished
+		for (;;) {
+			std::unique_lock lock(m_mutex);
+			m_wake.wait(lock, [this] { return !m_mainQueue.empty() || m_pendingCritical.load(std::memory_order_acquire) == 0; });
+			if (m_mainQueue.empty())
+				break;
+
+			const uint32_t task = m_mainQueue.front();
+			m_mainQueue.erase(m_mainQueue.begin());
+			lock.unlock();
+			Execute(task);
+		}
+
+		// The last worker task may still be returning from Execute()
+		jobs.Wait(m_critical);
+		m_totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_origin).count();
+
+		std::exception_ptr error;
+		{
+			std::lock_guard lock(m_mutex);
+			error = std::exchange(m_error, nullptr);
+		}
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	void StartupGraph::WaitDeferred() {
+		if (!m_jobs)
+			return;
+		m_jobs->Wait(m_deferred);
+
+		std::exception_ptr error;
+		{
+			std::lock_guard lock(m_mutex);
+			error = std::exchange(m_deferredError, nullptr);
+		}
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	void StartupGraph::Schedule(const uint32_t index) {
+		Task& task = *m_tasks[index];
+		if (task.thread == StartupThread::Main) {
+			{
+				std::lock_guard lock(m_mutex);
+				m_mainQueue.push_back(index);
+			}
+			m_wake.notify_one();
+			return;
+		}
+		m_jobs->Submit(task.deferred ? m_deferred : m_critical, [this, index] { Execute(index); });
+	}
+
+	void StartupGraph::Execute(const uint32_t index) {
+		Task& task = *m_tasks[index];
+
+		const bool skip = std::ranges::any_of(task.dependencies, [this](const uint32_t dependency) {
+			return m_tasks[dependency]->failed.load(std::memory_order_acquire);
+		});
+
+		const auto start = std::chrono::steady_clock::now();
+		if (skip) {
+			task.failed.store(true, std::memory_order_release);
+		}
+		else {
+			try {
+				task.init();
+			}
+			catch (...) {
+				task.failed.store(true, std::memory_order_release);
+				Fail(std::current_exception(), task.deferred);
+			}
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		task.startMs = std::chrono::duration<double, std::milli>(start - m_origin).count();
+		task.durationMs = std::chrono::duration<double, std::milli>(end - start).count();
+		task.skipped = skip;
+		task.threadIndex = JobSystem::ThreadIndex();
+		task.done.store(true, std::memory_order_release);
+
+		for (const uint32_t dependent : task.dependents) {
+			if (m_tasks[dependent]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Schedule(dependent);
+		}
+
+		if (!task.deferred && m_pendingCritical.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			// Taking the lock orders the notification after the main thread's predicate check
+			{ std::lock_guard lock(m_mutex); }
+			m_wake.notify_one();
+		}
+	}
+
+	void StartupGraph::Fail(std::exception_ptr error, const bool deferred) {
+		std::lock_guard lock(m_mutex);
+		std::exception_ptr& slot = deferred ? m_deferredError : m_error;
+		if (!slot)
+			slot = std::move(error);
+	}
+
+	std::vector<StartupTiming> StartupGraph::Timings() const {
+		std::vector<StartupTiming> timings;
+		for (const auto& task : m_tasks) {
+			if (!task->done.load(std::memory_order_acquire))
+				continue;
+			timings.push_back({ task->name, task->startMs, task->durationMs, task->threadIndex, task->deferred, task->skipped });
+		}
+		std::ranges::sort(timings, {}, &StartupTiming::startMs);
+		return timings;
+	}
+
+	std::vector<std::string_view> StartupGraph::CriticalPath() const {
+		// The task finishing last among the critical ones, then repeatedly the dependency that
+		// finished last before it started
+		const auto finish = [](const Task& task) { return task.startMs + task.durationMs; };
+
+		const Task* current = nullptr;
+		for (const auto& task : m_tasks) {
+			if (!task->deferred && task->done.load(std::memory_order_acquire) && (!current || finish(*task) > finish(*current)))
+				current = task.get();
+		}
+
+		std::vector<std::string_view> path;
+		while (current) {
+			path.push_back(current->name);
+			const Task* latest = nullptr;
+			for (const uint32_t dependency : current->dependencies) {
+				const Task& candidate = *m_tasks[dependency];
+				if (!latest || finish(candidate) > finish(*latest))
+					latest = &candidate;
+			}
+			current = latest;
+		}
+		std::ranges::reverse(path);
+		return path;
+	}
+
+} // namespace Zenyth
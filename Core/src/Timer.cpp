@@ -27,6 +27,9 @@ namespace Zenyth {
 		m_deltaTime = 0.f;
 		m_totalTime = 0.0;
 		m_frameCount = 0;
+		m_pendingSleep = 0.0;
+		m_pendingSpin = 0.0;
+		m_samples = {};
 	}
 
 	float Timer::Tick() {
@@ -38,9 +41,52 @@ namespace Zenyth {
 		m_totalTime = static_cast<double>(now.QuadPart - m_startTime)
 			/ static_cast<double>(m_frequency);
 		m_prevTime = now.QuadPart;
+
+		m_samples[m_frameCount % StatsWindow] = { m_deltaTime, static_cast<float>(m_pendingSleep), static_cast<float>(m_pendingSpin) };
+		m_pendingSleep = 0.0;
+		m_pendingSpin = 0.0;
 		++m_frameCount;
 
 		return m_deltaTime;
 	}
 
+	void Timer::RecordWait(const double sleepSeconds, const double spinSeconds) noexcept {
+		m_pendingSleep += sleepSeconds;
+		m_pendingSpin += spinSeconds;
+	}
+
+	FrameStats Timer::Stats() const {
+		const auto count = static_cast<uint32_t>(std::min<uint64_t>(m_frameCount, StatsWindow));
+		if (count == 0)
+			return {};
+
+		std::array<float, StatsWindow> frames;
+		double total = 0.0, totalSq = 0.0, sleep = 0.0, spin = 0.0;
+		for (uint32_t i = 0; i < count; ++i) {
+			const Sample& sample = m_samples[i];
+			frames[i] = sample.frame;
+			total += sample.frame;
+			totalSq += static_cast<double>(sample.frame) * sample.frame;
+			sleep += sample.sleep;
+			spin += sample.spin;
+		}
+
+		FrameStats stats;
+		const double mean = total / count;
+		stats.averageMs = mean * 1e3;
+		stats.jitterMs = std::sqrt(std::max(0.0, totalSq / count - mean * mean)) * 1e3;
+		stats.sleepMs = sleep / count * 1e3;
+		stats.spinMs = spin / count * 1e3;
+		stats.busyRatio = total > 0.0 ? std::clamp(1.0 - sleep / total, 0.0, 1.0) : 0.0;
+
+		const auto [minIt, maxIt] = std::minmax_element(frames.begin(), frames.begin() + count);
+		stats.minMs = *minIt * 1e3;
+		stats.maxMs = *maxIt * 1e3;
+
+		const auto p99 = frames.begin() + std::min(count - 1, count * 99 / 100);
+		std::nth_element(frames.begin(), p99, frames.begin() + count);
+		stats.p99Ms = *p99 * 1e3;
+		return stats;
+	}
+
 } // namespace Zenyth
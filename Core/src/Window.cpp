@@ -3,26 +3,70 @@
 
 namespace Zenyth {
 
-	uint32_t Window::s_windowCount = 0;
+	std::atomic<uint32_t> Window::s_windowCount{ 0 };
 
 	Window::Window(const WindowDesc& desc)
 		: m_hInst(::GetModuleHandleW(nullptr))
-		, m_width(desc.width)
-		, m_height(desc.height)
+		, m_id(s_windowCount.fetch_add(1, std::memory_order_relaxed))
 		, m_resizable(desc.resizable)
+		, m_resizeDebounce(desc.resizeDebounceSeconds)
 	{
 		// Unique class name per window instance
-		m_className = L"EngineWindow_" + std::to_wstring(s_windowCount++);
+		m_className = L"EngineWindow_" + std::to_wstring(m_id);
 
-		RegisterWindowClass();
-		CreateNativeWindow(desc);
+		std::promise<void> created;
+		std::future<void>  ready = created.get_future();
+		m_thread = std::thread([this, desc, &created] { MessageLoop(desc, created); });
+
+		try {
+			ready.get();
+		}
+		catch (...) {
+			m_thread.join();
+			throw;
+		}
+
+		// The client area may have come out smaller than asked for (e.g. on a small screen)
+		m_seenSize = m_latestSize.load(std::memory_order_acquire);
+		m_width = static_cast<uint32_t>(m_seenSize >> 32);
+		m_height = static_cast<uint32_t>(m_seenSize);
 	}
 
 	Window::~Window() {
-		if (m_hwnd) {
-			::DestroyWindow(m_hwnd);
-			m_hwnd = nullptr;
+		Close();
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	void Window::Close() {
+		// DestroyWindow only works on the thread that created the window
+		if (IsOpen())
+			::PostMessageW(m_hwnd, WM_ZENYTH_DESTROY, 0, 0);
+	}
+
+	void Window::MessageLoop(const WindowDesc& desc, std::promise<void>& created) {
+		try {
+			RegisterWindowClass();
+			CreateNativeWindow(desc);
+		}
+		catch (...) {
+			::UnregisterClassW(m_className.c_str(), m_hInst);
+			created.set_exception(std::current_exception());
+			return;
 		}
+
+		m_open.store(true, std::memory_order_release);
+		created.set_value(); // the constructor's promise is gone after this
+
+		// Blocking is fine here: nothing else runs on this thread, and modal loops started by
+		// DispatchMessage only hold up this thread
+		MSG msg{};
+		while (::GetMessageW(&msg, nullptr, 0, 0) > 0) {
+			::TranslateMessage(&msg);
+			::DispatchMessageW(&msg);
+		}
+
+		m_open.store(false, std::memory_order_release);
 		::UnregisterClassW(m_className.c_str(), m_hInst);
 	}
 
@@ -48,8 +92,8 @@ namespace Zenyth {
 			style &= ~(WS_THICKFRAME | WS_MAXIMIZEBOX);
 
 		RECT rc = { 0, 0,
-					static_cast<LONG>(m_width),
-					static_cast<LONG>(m_height) };
+					static_cast<LONG>(desc.width),
+					static_cast<LONG>(desc.height) };
 		::AdjustWindowRect(&rc, style, FALSE);
 
 		m_hwnd = ::CreateWindowExW(
@@ -72,16 +116,44 @@ namespace Zenyth {
 		::UpdateWindow(m_hwnd);
 	}
 
-	bool Window::PumpMessages() const {
-		MSG msg{};
-		// Drain the entire queue without blocking
-		while (::PeekMessageW(&msg, m_hwnd, 0, 0, PM_REMOVE)) {
-			if (msg.message == WM_QUIT)
-				return false;
-			::TranslateMessage(&msg);
-			::DispatchMessageW(&msg);
+	bool Window::PumpMessages() {
+		{
+			std::lock_guard lock(m_queueMutex);
+			m_delivering.swap(m_queue);
+		}
+
+		// Callbacks may take their time; the window thread keeps queueing into the other buffer
+		for (const Event& e : m_delivering)
+			EmitEvent(e);
+		m_delivering.clear();
+
+		EmitResize();
+		return IsOpen();
+	}
+
+	void Window::EmitResize() {
+		const uint64_t size = m_latestSize.load(std::memory_order_acquire);
+		if (size == PackSize(m_width, m_height))
+			return;
+
+		// While a border is being dragged, wait for the size to settle rather than resizing the
+		// swap chain on every frame of the drag
+		const auto now = std::chrono::steady_clock::now();
+		if (size != m_seenSize) {
+			m_seenSize = size;
+			m_seenSizeAt = now;
 		}
-		return true;
+		if (m_sizing.load(std::memory_order_acquire) && now - m_seenSizeAt < m_resizeDebounce)
+			return;
+
+		m_width = static_cast<uint32_t>(size >> 32);
+		m_height = static_cast<uint32_t>(size);
+
+		Event e{};
+		e.type = EventType::WindowResize;
+		e.window = m_id;
+		e.resize = { m_width, m_height };
+		EmitEvent(e);
 	}
 
 	LRESULT CALLBACK Window::WndProcStatic(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
@@ -105,6 +177,8 @@ namespace Zenyth {
 		return ::DefWindowProcW(hwnd, msg, wparam, lparam);
 	}
 
+	// Runs on the window thread: everything the frame loop sees goes through QueueEvent() or the
+	// atomics
 	LRESULT Window::WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
 		switch (msg) {
 		// Window lifecycle
@@ -112,28 +186,31 @@ namespace Zenyth {
 			Event e{};
 			e.type = EventType::WindowClose;
 			e.close = {};
-			EmitEvent(e);
+			QueueEvent(e);
 			// Don't call DestroyWindow here – let the Application decide
 			return 0;
 		}
 
+		case WM_ZENYTH_DESTROY:
+			::DestroyWindow(hwnd);
+			return 0;
+
 		case WM_DESTROY:
 			::PostQuitMessage(0);
 			return 0;
 
-		case WM_SIZE: {
-			uint32_t w = LOWORD(lparam);
-			uint32_t h = HIWORD(lparam);
-			if (w != m_width || h != m_height) {
-				m_width = w;
-				m_height = h;
-				Event e{};
-				e.type = EventType::WindowResize;
-				e.resize = { w, h };
-				EmitEvent(e);
-			}
+		case WM_ENTERSIZEMOVE:
+			m_sizing.store(true, std::memory_order_release);
+			break;
+
+		case WM_EXITSIZEMOVE:
+			m_sizing.store(false, std::memory_order_release);
+			break;
+
+		case WM_SIZE:
+			// Only the latest size matters; PumpMessages() turns it into at most one event
+			m_latestSize.store(PackSize(LOWORD(lparam), HIWORD(lparam)), std::memory_order_release);
 			return 0;
-		}
 
 		// Keyboard
 
@@ -143,7 +220,7 @@ namespace Zenyth {
 			e.type = EventType::KeyDown;
 			e.key = { static_cast<uint32_t>(wparam),
 					   (lparam & (1 << 30)) != 0 }; // bit 30 = previous key state
-			EmitEvent(e);
+			QueueEvent(e);
 			return 0;
 		}
 
@@ -152,7 +229,7 @@ namespace Zenyth {
 			Event e{};
 			e.type = EventType::KeyUp;
 			e.key = { static_cast<uint32_t>(wparam), false };
-			EmitEvent(e);
+			QueueEvent(e);
 			return 0;
 		}
 
@@ -162,7 +239,7 @@ namespace Zenyth {
 			Event e{};
 			e.type = EventType::MouseMove;
 			e.mouseMove = { GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam) };
-			EmitEvent(e);
+			QueueEvent(e);
 			return 0;
 		}
 
@@ -175,7 +252,7 @@ namespace Zenyth {
 			Event e{};
 			e.type = EventType::MouseButtonDown;
 			e.mouseButton = { btn, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam) };
-			EmitEvent(e);
+			QueueEvent(e);
 			return 0;
 		}
 
@@ -188,7 +265,7 @@ namespace Zenyth {
 			Event e{};
 			e.type = EventType::MouseButtonUp;
 			e.mouseButton = { btn, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam) };
-			EmitEvent(e);
+			QueueEvent(e);
 			return 0;
 		}
 
@@ -196,7 +273,7 @@ namespace Zenyth {
 			Event e{};
 			e.type = EventType::MouseWheel;
 			e.mouseWheel = { static_cast<float>(GET_WHEEL_DELTA_WPARAM(wparam)) / static_cast<float>(WHEEL_DELTA) };
-			EmitEvent(e);
+			QueueEvent(e);
 			return 0;
 		}
 
@@ -207,6 +284,19 @@ namespace Zenyth {
 		return ::DefWindowProcW(hwnd, msg, wparam, lparam);
 	}
 
+	void Window::QueueEvent(const Event& e) {
+		std::lock_guard lock(m_queueMutex);
+
+		// Between two frames only the last cursor position matters
+		if (e.type == EventType::MouseMove && !m_queue.empty() && m_queue.back().type == EventType::MouseMove) {
+			m_queue.back().mouseMove = e.mouseMove;
+			return;
+		}
+
+		m_queue.push_back(e);
+		m_queue.back().window = m_id;
+	}
+
 	void Window::EmitEvent(const Event& e) const {
 		if (m_callback)
 			m_callback(e);
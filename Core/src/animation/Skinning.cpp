@@ -0,0 +1,578 @@
+#include "pch.hpp"
+#include "animation/Skinning.hpp"
+#include "CpuFeatures.hpp"
+
+#include <immintrin.h>
+
+namespace Zenyth {
+
+	using namespace zenyth::math;
+
+	namespace {
+		// Vertices skinned into a cache-resident buffer before being streamed to the output
+		constexpr uint32_t StageSize = 32;
+
+		struct Stage {
+			// Kernels store positions and normals as overlapping 4-wide writes; one spare float absorbs the last one
+			alignas(32) float data[StageSize * 6 + 4];
+
+			[[nodiscard]] float* Vertex(const uint32_t i) noexcept { return data + i * 6; }
+		};
+
+		// Sequential write of a staged run; non-temporal when the destination allows it so
+		// write-combined upload memory sees whole lines and the caches are left alone
+		void Flush(const Stage& stage, SkinnedVertex* out, const uint32_t count) noexcept {
+			const size_t bytes = static_cast<size_t>(count) * sizeof(SkinnedVertex);
+			auto*        dst = reinterpret_cast<float*>(out);
+
+			if (reinterpret_cast<uintptr_t>(dst) % 16 != 0) {
+				std::memcpy(dst, stage.data, bytes);
+				return;
+			}
+
+			const size_t floats = bytes / sizeof(float);
+			size_t       i = 0;
+			for (; i + 4 <= floats; i += 4)
+				_mm_stream_ps(dst + i, _mm_load_ps(stage.data + i));
+			if (i < floats)
+				std::memcpy(dst + i, stage.data + i, (floats - i) * sizeof(float));
+		}
+
+		__m128 LoadFloat3(const float* p) noexcept {
+			return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+		}
+
+		__m128 Cross(const __m128 a, const __m128 b) noexcept {
+			const __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYzx), _mm_mul_ps(aYzx, b));
+			return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+		}
+
+		// Zero stays zero instead of turning into NaN
+		__m128 Normalize3(const __m128 v) noexcept {
+			const __m128 lengthSq = _mm_max_ps(_mm_dp_ps(v, v, 0x7F), _mm_set1_ps(1e-30f));
+			const __m128 estimate = _mm_rsqrt_ps(lengthSq);
+			// One Newton-Raphson step brings rsqrt to full single precision
+			const __m128 refined = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), estimate),
+				_mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_mul_ps(lengthSq, estimate), estimate)));
+			return _mm_mul_ps(v, refined);
+		}
+
+		using LinearKernel = void (*)(const mat4*, const SkinningInput&, SkinnedVertex*, uint32_t, uint32_t);
+		using DualQuatKernel = void (*)(const DualQuat*, const SkinningInput&, SkinnedVertex*, uint32_t, uint32_t);
+
+#pragma region Scalar reference
+		// Plain loops that write straight to the output; the baseline the SIMD paths are checked against
+		void Normalize3(float* v) noexcept {
+			const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+			if (length > 0.0f) {
+				v[0] /= length;
+				v[1] /= length;
+				v[2] /= length;
+			}
+		}
+
+		void Cross(const float* a, const float* b, float* out) noexcept {
+			out[0] = a[1] * b[2] - a[2] * b[1];
+			out[1] = a[2] * b[0] - a[0] * b[2];
+			out[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		void LinearScalar(const mat4* palette, const SkinningInput& input, SkinnedVertex* out, const uint32_t begin, const uint32_t end) {
+			const bool hasNormals = !input.normals.empty();
+
+			for (uint32_t v = begin; v < end; ++v) {
+				const SkinInfluence& influence = input.influences[v];
+
+				// Blended 3x4 affine part, column-major
+				float m[12] = {};
+				for (uint32_t k = 0; k < 4; ++k) {
+					const float  w = influence.weights[k];
+					const float* bone = static_cast<const float*>(palette[influence.bones[k]].data());
+					for (uint32_t c = 0; c < 4; ++c)
+						for (uint32_t r = 0; r < 3; ++r)
+							m[c * 3 + r] += w * bone[c * 4 + r];
+				}
+
+				const float* p = &input.positions[static_cast<size_t>(v) * 3];
+				SkinnedVertex& o = out[v];
+				for (uint32_t r = 0; r < 3; ++r)
+					o.position[r] = m[r] * p[0] + m[3 + r] * p[1] + m[6 + r] * p[2] + m[9 + r];
+
+				if (!hasNormals) {
+					o.normal[0] = o.normal[1] = o.normal[2] = 0.0f;
+					continue;
+				}
+				const float* n = &input.normals[static_cast<size_t>(v) * 3];
+				for (uint32_t r = 0; r < 3; ++r)
+					o.normal[r] = m[r] * n[0] + m[3 + r] * n[1] + m[6 + r] * n[2];
+				Normalize3(o.normal);
+			}
+		}
+
+		void DualQuatScalar(const DualQuat* palette, const SkinningInput& input, SkinnedVertex* out, const uint32_t begin, const uint32_t end) {
+			const bool hasNormals = !input.normals.empty();
+
+			for (uint32_t v = begin; v < end; ++v) {
+				const SkinInfluence& influence = input.influences[v];
+				const DualQuat&      first = palette[influence.bones[0]];
+
+				// Blend in the hemisphere of the first bone so antipodal rotations do not cancel out
+				float real[4] = {}, dual[4] = {};
+				for (uint32_t k = 0; k < 4; ++k) {
+					const DualQuat& dq = palette[influence.bones[k]];
+					const float     sign = dq.real[0] * first.real[0] + dq.real[1] * first.real[1]
+						+ dq.real[2] * first.real[2] + dq.real[3] * first.real[3] < 0.0f ? -1.0f : 1.0f;
+					const float     w = influence.weights[k] * sign;
+					for (uint32_t c = 0; c < 4; ++c) {
+						real[c] += w * dq.real[c];
+						dual[c] += w * dq.dual[c];
+					}
+				}
+
+				const float length = std::sqrt(real[0] * real[0] + real[1] * real[1] + real[2] * real[2] + real[3] * real[3]);
+				const float inv = length > 0.0f ? 1.0f / length : 0.0f;
+				for (uint32_t c = 0; c < 4; ++c) {
+					real[c] *= inv;
+					dual[c] *= inv;
+				}
+
+				// p' = p + 2 r x (r x p + w p) + 2 (w d - d.w r + r x d), with r = real.xyz, w = real.w
+				const auto rotate = [&](const float* p, float* o) {
+					float t[3], u[3];
+					Cross(real, p, t);
+					for (uint32_t c = 0; c < 3; ++c)
+						t[c] += real[3] * p[c];
+					Cross(real, t, u);
+					for (uint32_t c = 0; c < 3; ++c)
+						o[c] = p[c] + 2.0f * u[c];
+				};
+
+				SkinnedVertex& o = out[v];
+				rotate(&input.positions[static_cast<size_t>(v) * 3], o.position);
+
+				float rd[3];
+				Cross(real, dual, rd);
+				for (uint32_t c = 0; c < 3; ++c)
+					o.position[c] += 2.0f * (real[3] * dual[c] - dual[3] * real[c] + rd[c]);
+
+				if (!hasNormals) {
+					o.normal[0] = o.normal[1] = o.normal[2] = 0.0f;
+					continue;
+				}
+				rotate(&input.normals[static_cast<size_t>(v) * 3], o.normal);
+			}
+		}
+
+#pragma endregion
+
+#pragma region SSE
+		void LinearSse(const mat4* palette, const SkinningInput& input, SkinnedVertex* out, const uint32_t begin, const uint32_t end) {
+			const bool hasNormals = !input.normals.empty();
+			Stage stage;
+
+			for (uint32_t chunk = begin; chunk < end; chunk += StageSize) {
+				const uint32_t count = std::min(StageSize, end - chunk);
+
+				for (uint32_t i = 0; i < count; ++i) {
+					const uint32_t       v = chunk + i;
+					const SkinInfluence& influence = input.influences[v];
+
+					__m128 col[4];
+					for (uint32_t k = 0; k < 4; ++k) {
+						const auto*  bone = static_cast<const __m128*>(palette[influence.bones[k]].data());
+						const __m128 w = _mm_set1_ps(influence.weights[k]);
+						for (uint32_t c = 0; c < 4; ++c)
+							col[c] = k == 0 ? _mm_mul_ps(w, bone[c]) : _mm_add_ps(col[c], _mm_mul_ps(w, bone[c]));
+					}
+
+					const float* p = &input.positions[static_cast<size_t>(v) * 3];
+					__m128 position = _mm_add_ps(_mm_mul_ps(col[0], _mm_set1_ps(p[0])), col[3]);
+					position = _mm_add_ps(position, _mm_mul_ps(col[1], _mm_set1_ps(p[1])));
+					position = _mm_add_ps(position, _mm_mul_ps(col[2], _mm_set1_ps(p[2])));
+
+					__m128 normal = _mm_setzero_ps();
+					if (hasNormals) {
+						const float* n = &input.normals[static_cast<size_t>(v) * 3];
+						normal = _mm_mul_ps(col[0], _mm_set1_ps(n[0]));
+						normal = _mm_add_ps(normal, _mm_mul_ps(col[1], _mm_set1_ps(n[1])));
+						normal = _mm_add_ps(normal, _mm_mul_ps(col[2], _mm_set1_ps(n[2])));
+						normal = Normalize3(normal);
+					}
+
+					_mm_storeu_ps(stage.Vertex(i), position);
+					_mm_storeu_ps(stage.Vertex(i) + 3, normal);
+				}
+
+				Flush(stage, out + chunk, count);
+			}
+			_mm_sfence();
+		}
+
+		// Rigid transform of a point (translate = true) or direction by a normalized dual quaternion
+		__m128 TransformDualQuat(const __m128 real, const __m128 dual, const __m128 p, const bool translate) noexcept {
+			const __m128 w = _mm_shuffle_ps(real, real, _MM_SHUFFLE(3, 3, 3, 3));
+			const __m128 t = _mm_add_ps(Cross(real, p), _mm_mul_ps(w, p));
+			__m128 result = _mm_add_ps(p, _mm_mul_ps(_mm_set1_ps(2.0f), Cross(real, t)));
+
+			if (translate) {
+				const __m128 dw = _mm_shuffle_ps(dual, dual, _MM_SHUFFLE(3, 3, 3, 3));
+				const __m128 translation = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(w, dual), _mm_mul_ps(dw, real)), Cross(real, dual));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(2.0f), translation));
+			}
+			return result;
+		}
+
+		// Normalizes the blended dual quaternion and writes the skinned vertex to the stage
+		void FinishDualQuat(__m128 real, __m128 dual, const SkinningInput& input, const uint32_t v, float* dst) noexcept {
+			const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(_mm_dp_ps(real, real, 0xFF), _mm_set1_ps(1e-30f))));
+			real = _mm_mul_ps(real, inv);
+			dual = _mm_mul_ps(dual, inv);
+
+			const __m128 position = TransformDualQuat(real, dual, LoadFloat3(&input.positions[static_cast<size_t>(v) * 3]), true);
+			const __m128 normal = input.normals.empty()
+				? _mm_setzero_ps()
+				: TransformDualQuat(real, dual, LoadFloat3(&input.normals[static_cast<size_t>(v) * 3]), false);
+
+			_mm_storeu_ps(dst, position);
+			_mm_storeu_ps(dst + 3, normal);
+		}
+
+		// Weight with the sign that puts the bone's rotation in the hemisphere of the first bone's
+		__m128 HemisphereWeight(const __m128 real, const __m128 firstReal, const float weight) noexcept {
+			const __m128 sign = _mm_and_ps(_mm_dp_ps(real, firstReal, 0xFF), _mm_set1_ps(-0.0f));
+			return _mm_xor_ps(_mm_set1_ps(weight), sign);
+		}
+
+		void DualQuatSse(const DualQuat* palette, const SkinningInput& input, SkinnedVertex* out, const uint32_t begin, const uint32_t end) {
+			Stage stage;
+
+			for (uint32_t chunk = begin; chunk < end; chunk += StageSize) {
+				const uint32_t count = std::min(StageSize, end - chunk);
+
+				for (uint32_t i = 0; i < count; ++i) {
+					const uint32_t       v = chunk + i;
+					const SkinInfluence& influence = input.influences[v];
+
+					const __m128 firstReal = _mm_load_ps(palette[influence.bones[0]].real);
+					__m128 real = _mm_setzero_ps(), dual = _mm_setzero_ps();
+					for (uint32_t k = 0; k < 4; ++k) {
+						const DualQuat& dq = palette[influence.bones[k]];
+						const __m128    boneReal = _mm_load_ps(dq.real);
+						const __m128    w = HemisphereWeight(boneReal, firstReal, influence.weights[k]);
+						real = _mm_add_ps(real, _mm_mul_ps(w, boneReal));
+						dual = _mm_add_ps(dual, _mm_mul_ps(w, _mm_load_ps(dq.dual)));
+					}
+
+					FinishDualQuat(real, dual, input, v, stage.Vertex(i));
+				}
+
+				Flush(stage, out + chunk, count);
+			}
+			_mm_sfence();
+		}
+#pragma endregion
+
+#pragma region AVX2
+		// Two matrix columns per 256-bit register: the four bones blend with eight FMAs per vertex
+		ZENYTH_TARGET_AVX2 void LinearAvx2(const mat4* palette, const SkinningInput& input, SkinnedVertex* out, const uint32_t begin, const uint32_t end) {
+			const bool hasNormals = !input.normals.empty();
+			Stage stage;
+
+			for (uint32_t chunk = begin; chunk < end; chunk += StageSize) {
+				const uint32_t count = std::min(StageSize, end - chunk);
+
+				for (uint32_t i = 0; i < count; ++i) {
+					const uint32_t       v = chunk + i;
+					const SkinInfluence& influence = input.influences[v];
+
+					__m256 col01 = _mm256_setzero_ps(), col23 = _mm256_setzero_ps();
+					for (uint32_t k = 0; k < 4; ++k) {
+						const auto*  bone = static_cast<const float*>(palette[influence.bones[k]].data());
+						const __m256 w = _mm256_set1_ps(influence.weights[k]);
+						col01 = _mm256_fmadd_ps(w, _mm256_loadu_ps(bone), col01);
+						col23 = _mm256_fmadd_ps(w, _mm256_loadu_ps(bone + 8), col23);
+					}
+
+					// [c0 * x | c1 * y] + [c2 * z | c3 * 1], then fold the halves
+					const float* p = &input.positions[static_cast<size_t>(v) * 3];
+					const __m256 xy = _mm256_set_m128(_mm_set1_ps(p[1]), _mm_set1_ps(p[0]));
+					const __m256 z1 = _mm256_set_m128(_mm_set1_ps(1.0f), _mm_set1_ps(p[2]));
+					const __m256 sum = _mm256_fmadd_ps(col01, xy, _mm256_mul_ps(col23, z1));
+					const __m128 position = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+
+					__m128 normal = _mm_setzero_ps();
+					if (hasNormals) {
+						const float* n = &input.normals[static_cast<size_t>(v) * 3];
+						const __m256 nxy = _mm256_set_m128(_mm_set1_ps(n[1]), _mm_set1_ps(n[0]));
+						const __m256 nz0 = _mm256_set_m128(_mm_setzero_ps(), _mm_set1_ps(n[2]));
+						const __m256 nsum = _mm256_fmadd_ps(col01, nxy, _mm256_mul_ps(col23, nz0));
+						normal = Normalize3(_mm_add_ps(_mm256_castps256_ps128(nsum), _mm256_extractf128_ps(nsum, 1)));
+					}
+
+					_mm_storeu_ps(stage.Vertex(i), position);
+					_mm_storeu_ps(stage.Vertex(i) + 3, normal);
+				}
+
+				_mm256_zeroupper();
+				Flush(stage, out + chunk, count);
+			}
+			_mm_sfence();
+		}
+
+		ZENYTH_TARGET_AVX2 void Cross8(const __m256 ax, const __m256 ay, const __m256 az, const __m256 bx, const __m256 by, const __m256 bz,
+			__m256& x, __m256& y, __m256& z) noexcept
+		{
+			x = _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by));
+			y = _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz));
+			z = _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx));
+		}
+
+		// v + 2 r x (r x v + w v) for eight packed xyz vectors starting at base
+		ZENYTH_TARGET_AVX2 void Rotate8(const __m256* r, const float* base, const __m256i strides, __m256& x, __m256& y, __m256& z) noexcept {
+			const __m256 vx = _mm256_i32gather_ps(base, strides, 4);
+			const __m256 vy = _mm256_i32gather_ps(base + 1, strides, 4);
+			const __m256 vz = _mm256_i32gather_ps(base + 2, strides, 4);
+			__m256 tx, ty, tz, ux, uy, uz;
+			Cross8(r[0], r[1], r[2], vx, vy, vz, tx, ty, tz);
+			tx = _mm256_fmadd_ps(r[3], vx, tx);
+			ty = _mm256_fmadd_ps(r[3], vy, ty);
+			tz = _mm256_fmadd_ps(r[3], vz, tz);
+			Cross8(r[0], r[1], r[2], tx, ty, tz, ux, uy, uz);
+			const __m256 two = _mm256_set1_ps(2.0f);
+			x = _mm256_fmadd_ps(two, ux, vx);
+			y = _mm256_fmadd_ps(two, uy, vy);
+			z = _mm256_fmadd_ps(two, uz, vz);
+		}
+
+		// Blends eight vertices with real and dual parts in one register (one FMA per bone), then
+		// transposes to SoA and normalizes and transforms all eight at once. Leftovers take the SSE path.
+		ZENYTH_TARGET_AVX2 void DualQuatAvx2(const DualQuat* palette, const SkinningInput& input, SkinnedVertex* out, const uint32_t begin, const uint32_t end) {
+			const bool   hasNormals = !input.normals.empty();
+			const __m256 two = _mm256_set1_ps(2.0f);
+			const __m256i strides = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+			Stage stage;
+
+			for (uint32_t chunk = begin; chunk < end; chunk += StageSize) {
+				const uint32_t count = std::min(StageSize, end - chunk);
+				const uint32_t wide = count & ~7u;
+
+				for (uint32_t group = 0; group < wide; group += 8) {
+					alignas(32) float blended[8][8];
+					for (uint32_t i = 0; i < 8; ++i) {
+						const SkinInfluence& influence = input.influences[chunk + group + i];
+
+						const __m128 firstReal = _mm_load_ps(palette[influence.bones[0]].real);
+						__m256 sum = _mm256_setzero_ps();
+						for (uint32_t k = 0; k < 4; ++k) {
+							const __m256 dq = _mm256_load_ps(palette[influence.bones[k]].real);
+							const __m128 sign = _mm_and_ps(_mm_dp_ps(_mm256_castps256_ps128(dq), firstReal, 0xFF), _mm_set1_ps(-0.0f));
+							const __m128 w = _mm_xor_ps(_mm_set1_ps(influence.weights[k]), sign);
+							sum = _mm256_fmadd_ps(_mm256_set_m128(w, w), dq, sum);
+						}
+						_mm256_store_ps(blended[i], sum);
+					}
+
+					// 8x8 transpose: lane i of component c is blended[i][c]
+					__m256 q[8];
+					for (uint32_t c = 0; c < 8; ++c)
+						q[c] = _mm256_setr_ps(blended[0][c], blended[1][c], blended[2][c], blended[3][c],
+							blended[4][c], blended[5][c], blended[6][c], blended[7][c]);
+
+					__m256 lengthSq = _mm256_mul_ps(q[0], q[0]);
+					for (uint32_t c = 1; c < 4; ++c)
+						lengthSq = _mm256_fmadd_ps(q[c], q[c], lengthSq);
+					const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(_mm256_max_ps(lengthSq, _mm256_set1_ps(1e-30f))));
+					for (__m256& component : q)
+						component = _mm256_mul_ps(component, inv);
+					const __m256 &rx = q[0], &ry = q[1], &rz = q[2], &rw = q[3];
+					const __m256 &dx = q[4], &dy = q[5], &dz = q[6], &dw = q[7];
+
+					const size_t first = static_cast<size_t>(chunk + group) * 3;
+					__m256 px, py, pz;
+					Rotate8(q, &input.positions[first], strides, px, py, pz);
+
+					// + 2 (w d - d.w r + r x d)
+					__m256 cx, cy, cz;
+					Cross8(rx, ry, rz, dx, dy, dz, cx, cy, cz);
+					px = _mm256_fmadd_ps(two, _mm256_add_ps(_mm256_fmsub_ps(rw, dx, _mm256_mul_ps(dw, rx)), cx), px);
+					py = _mm256_fmadd_ps(two, _mm256_add_ps(_mm256_fmsub_ps(rw, dy, _mm256_mul_ps(dw, ry)), cy), py);
+					pz = _mm256_fmadd_ps(two, _mm256_add_ps(_mm256_fmsub_ps(rw, dz, _mm256_mul_ps(dw, rz)), cz), pz);
+
+					__m256 nx = _mm256_setzero_ps(), ny = nx, nz = nx;
+					if (hasNormals)
+						Rotate8(q, &input.normals[first], strides, nx, ny, nz);
+
+					alignas(32) float soa[6][8];
+					_mm256_store_ps(soa[0], px);
+					_mm256_store_ps(soa[1], py);
+					_mm256_store_ps(soa[2], pz);
+					_mm256_store_ps(soa[3], nx);
+					_mm256_store_ps(soa[4], ny);
+					_mm256_store_ps(soa[5], nz);
+					for (uint32_t i = 0; i < 8; ++i)
+						for (uint32_t c = 0; c < 6; ++c)
+							stage.Vertex(group + i)[c] = soa[c][i];
+				}
+
+				// The shared SSE code below is not VEX encoded; clear the upper halves to avoid the transition penalty
+				_mm256_zeroupper();
+				for (uint32_t i = wide; i < count; ++i) {
+					const uint32_t       v = chunk + i;
+					const SkinInfluence& influence = input.influences[v];
+
+					const __m128 firstReal = _mm_load_ps(palette[influence.bones[0]].real);
+					__m128 real = _mm_setzero_ps(), dual = _mm_setzero_ps();
+					for (uint32_t k = 0; k < 4; ++k) {
+						const DualQuat& dq = palette[influence.bones[k]];
+						const __m128    boneReal = _mm_load_ps(dq.real);
+						const __m128    w = HemisphereWeight(boneReal, firstReal, influence.weights[k]);
+						real = _mm_add_ps(real, _mm_mul_ps(w, boneReal));
+						dual = _mm_add_ps(dual, _mm_mul_ps(w, _mm_load_ps(dq.dual)));
+					}
+					FinishDualQuat(real, dual, input, v, stage.Vertex(i));
+				}
+
+				Flush(stage, out + chunk, count);
+			}
+			_mm_sfence();
+		}
+#pragma endregion
+
+		SkinningPath Resolve(const SkinningPath path) noexcept {
+			if (path != SkinningPath::Auto)
+				return path;
+			const CpuFeatures& cpu = GetCpuFeatures();
+			return cpu.avx2 && cpu.fma ? SkinningPath::Avx2 : SkinningPath::Sse;
+		}
+
+		void Validate(const char* function, const SkinningInput& input, const size_t outCount) {
+			const size_t count = input.influences.size();
+			if (input.positions.size() < count * 3 || (!input.normals.empty() && input.normals.size() < count * 3))
+				throw std::invalid_argument(std::string(function) + " : vertex streams shorter than the influence stream");
+			if (outCount < count)
+				throw std::invalid_argument(std::string(function) + " : output holds fewer vertices than the input");
+		}
+
+		template<typename Palette, typename Kernel>
+		void Run(const Palette* palette, const SkinningInput& input, SkinnedVertex* out, JobSystem* jobs, Kernel kernel) {
+			const uint32_t count = input.VertexCount();
+			const auto     range = [&](const uint32_t begin, const uint32_t end) { kernel(palette, input, out, begin, end); };
+
+			if (jobs)
+				jobs->ParallelFor(count, SkinningJobGrain, range);
+			else
+				range(0, count);
+		}
+	}
+
+	DualQuat DualQuat::FromRotationTranslation(const quat& rotation, const vec3& translation) noexcept {
+		const quat r = rotation.normalized();
+		// dual = 0.5 * (t, 0) * r
+		const quat d = quat(translation.x(), translation.y(), translation.z(), 0.0f) * r * 0.5f;
+
+		DualQuat dq;
+		dq.real[0] = r.x(); dq.real[1] = r.y(); dq.real[2] = r.z(); dq.real[3] = r.w();
+		dq.dual[0] = d.x(); dq.dual[1] = d.y(); dq.dual[2] = d.z(); dq.dual[3] = d.w();
+		return dq;
+	}
+
+	DualQuat DualQuat::FromMatrix(const mat4& rigid) noexcept {
+		// Strip scale from the basis before extracting the rotation
+		float basis[3][3];
+		for (uint32_t c = 0; c < 3; ++c) {
+			const float length = std::sqrt(rigid[0, c] * rigid[0, c] + rigid[1, c] * rigid[1, c] + rigid[2, c] * rigid[2, c]);
+			const float inv = length > 0.0f ? 1.0f / length : 0.0f;
+			for (uint32_t r = 0; r < 3; ++r)
+				basis[r][c] = rigid[r, c] * inv;
+		}
+
+		// Shepperd's method: branch on the largest diagonal term for stability
+		float q[4];
+		const float trace = basis[0][0] + basis[1][1] + basis[2][2];
+		if (trace > 0.0f) {
+			const float s = std::sqrt(trace + 1.0f) * 2.0f;
+			q[3] = 0.25f * s;
+			q[0] = (basis[2][1] - basis[1][2]) / s;
+			q[1] = (basis[0][2] - basis[2][0]) / s;
+			q[2] = (basis[1][0] - basis[0][1]) / s;
+		}
+		else if (basis[0][0] > basis[1][1] && basis[0][0] > basis[2][2]) {
+			const float s = std::sqrt(1.0f + basis[0][0] - basis[1][1] - basis[2][2]) * 2.0f;
+			q[3] = (basis[2][1] - basis[1][2]) / s;
+			q[0] = 0.25f * s;
+			q[1] = (basis[0][1] + basis[1][0]) / s;
+			q[2] = (basis[0][2] + basis[2][0]) / s;
+		}
+		else if (basis[1][1] > basis[2][2]) {
+			const float s = std::sqrt(1.0f + basis[1][1] - basis[0][0] - basis[2][2]) * 2.0f;
+			q[3] = (basis[0][2] - basis[2][0]) / s;
+			q[0] = (basis[0][1] + basis[1][0]) / s;
+			q[1] = 0.25f * s;
+			q[2] = (basis[1][2] + basis[2][1]) / s;
+		}
+		else {
+			const float s = std::sqrt(1.0f + basis[2][2] - basis[0][0] - basis[1][1]) * 2.0f;
+			q[3] = (basis[1][0] - basis[0][1]) / s;
+			q[0] = (basis[0][2] + basis[2][0]) / s;
+			q[1] = (basis[1][2] + basis[2][1]) / s;
+			q[2] = 0.25f * s;
+		}
+
+		return FromRotationTranslation(quat(q[0], q[1], q[2], q[3]), vec3(rigid[0, 3], rigid[1, 3], rigid[2, 3]));
+	}
+
+	void BuildSkinningPalette(const std::span<const mat4> boneWorld, const std::span<const mat4> inverseBind, const std::span<mat4> palette) noexcept {
+		const size_t count = std::min({ boneWorld.size(), inverseBind.size(), palette.size() });
+		for (size_t i = 0; i < count; ++i)
+			palette[i] = boneWorld[i] * inverseBind[i];
+	}
+
+	void SkinLinear(const std::span<const mat4> palette, const SkinningInput& input, const std::span<SkinnedVertex> out,
+		JobSystem* jobs, const SkinningPath path)
+	{
+		Validate("SkinLinear", input, out.size());
+
+		LinearKernel kernel = LinearSse;
+		switch (Resolve(path)) {
+			case SkinningPath::Scalar: kernel = LinearScalar; break;
+			case SkinningPath::Avx2:   kernel = LinearAvx2; break;
+			default:                   break;
+		}
+		Run(palette.data(), input, out.data(), jobs, kernel);
+	}
+
+	void SkinDualQuat(const std::span<const DualQuat> palette, const SkinningInput& input, const std::span<SkinnedVertex> out,
+		JobSystem* jobs, const SkinningPath path)
+	{
+		Validate("SkinDualQuat", input, out.size());
+
+		DualQuatKernel kernel = DualQuatSse;
+		switch (Resolve(path)) {
+			case SkinningPath::Scalar: kernel = DualQuatScalar; break;
+			case SkinningPath::Avx2:   kernel = DualQuatAvx2; break;
+			default:                   break;
+		}
+		Run(palette.data(), input, out.data(), jobs, kernel);
+	}
+
+	UploadRing::Allocation SkinLinear(const std::span<const mat4> palette, const SkinningInput& input, UploadRing& ring,
+		JobSystem* jobs, const SkinningPath path)
+	{
+		const UploadRing::Allocation allocation = ring.Allocate<SkinnedVertex>(input.VertexCount());
+		if (allocation)
+			SkinLinear(palette, input, allocation.As<SkinnedVertex>(), jobs, path);
+		return allocation;
+	}
+
+	UploadRing::Allocation SkinDualQuat(const std::span<const DualQuat> palette, const SkinningInput& input, UploadRing& ring,
+		JobSystem* jobs, const SkinningPath path)
+	{
+		const UploadRing::Allocation allocation = ring.Allocate<SkinnedVertex>(input.VertexCount());
+		if (allocation)
+			SkinDualQuat(palette, input, allocation.As<SkinnedVertex>(), jobs, path);
+		return allocation;
+	}
+
+} // namespace Zenyth
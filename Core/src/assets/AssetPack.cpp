@@ -0,0 +1,269 @@
+#include "pch.hpp"
+#include "assets/AssetPack.hpp"
+
+namespace Zenyth {
+
+	namespace {
+		constexpr uint64_t AlignUp(const uint64_t value, const uint64_t alignment) noexcept {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		bool InRange(const uint64_t offset, const uint64_t size, const uint64_t limit) noexcept {
+			return offset <= limit && size <= limit - offset;
+		}
+
+		template<typename T>
+		const T* At(std::span<const std::byte> bytes, const uint64_t offset) noexcept {
+			return reinterpret_cast<const T*>(bytes.data() + offset);
+		}
+	}
+
+#pragma region AssetPack
+	AssetPack::AssetPack(const std::filesystem::path& path)
+		: m_path(path)
+		, m_file(path)
+	{
+		Validate();
+
+		const auto data = m_file.Data();
+		m_header = At<PackHeader>(data, 0);
+		m_entries = { At<PackEntry>(data, m_header->entryTableOffset), m_header->entryCount };
+		m_names = { reinterpret_cast<const char*>(data.data() + m_header->nameTableOffset), m_header->nameTableSize };
+	}
+
+	void AssetPack::Validate() const {
+		const auto fail = [this](const char* what) {
+			throw std::runtime_error(std::string("AssetPack : ") + what + " in " + m_path.string());
+		};
+
+		const auto data = m_file.Data();
+		if (data.size() < sizeof(PackHeader))
+			fail("file too small");
+
+		const auto* header = At<PackHeader>(data, 0);
+		if (header->magic != PackMagic)
+			fail("bad magic");
+		if (header->version != PackVersion)
+			fail("unsupported version");
+		if (header->headerSize != sizeof(PackHeader) || header->fileSize != data.size())
+			fail("truncated or corrupt header");
+		if (header->entryTableOffset % alignof(PackEntry) != 0
+			|| !InRange(header->entryTableOffset, uint64_t{ header->entryCount } * sizeof(PackEntry), data.size()))
+			fail("entry table out of bounds");
+		if (!InRange(header->nameTableOffset, header->nameTableSize, data.size())
+			|| (header->nameTableSize > 0 && data[header->nameTableOffset + header->nameTableSize - 1] != std::byte{ 0 }))
+			fail("name table out of bounds");
+		if (header->payloadAlignment == 0 || (header->payloadAlignment & (header->payloadAlignment - 1)) != 0)
+			fail("bad payload alignment");
+
+		const auto* entries = At<PackEntry>(data, header->entryTableOffset);
+		for (uint32_t i = 0; i < header->entryCount; ++i) {
+			const PackEntry& entry = entries[i];
+			if (!InRange(entry.offset, entry.size, data.size()) || entry.offset % header->payloadAlignment != 0)
+				fail("payload out of bounds");
+			if (entry.nameOffset >= header->nameTableSize)
+				fail("name out of bounds");
+			if (i > 0 && entries[i - 1].nameHash > entry.nameHash)
+				fail("entry table not sorted");
+		}
+	}
+
+	const PackEntry* AssetPack::Find(const uint64_t nameHash) const noexcept {
+		const auto it = std::lower_bound(m_entries.begin(), m_entries.end(), nameHash,
+			[](const PackEntry& entry, const uint64_t hash) { return entry.nameHash < hash; });
+		return it != m_entries.end() && it->nameHash == nameHash ? &*it : nullptr;
+	}
+
+	const PackEntry* AssetPack::Find(const std::string_view name) const noexcept {
+		const uint64_t hash = HashAssetName(name);
+		const PackEntry* end = m_entries.data() + m_entries.size();
+		for (const PackEntry* entry = Find(hash); entry && entry != end && entry->nameHash == hash; ++entry) {
+			if (GetName(*entry) == name)
+				return entry;
+		}
+		return nullptr;
+	}
+
+	std::string_view AssetPack::GetName(const PackEntry& entry) const noexcept {
+		return m_names.data() + entry.nameOffset;
+	}
+
+	std::span<const std::byte> AssetPack::GetPayload(const PackEntry& entry) const noexcept {
+		return m_file.Data().subspan(entry.offset, entry.size);
+	}
+
+	std::optional<MeshView> AssetPack::GetMesh(const PackEntry& entry) const {
+		if (entry.type != AssetType::Mesh || entry.size < sizeof(MeshHeader))
+			return std::nullopt;
+
+		const auto payload = GetPayload(entry);
+		const auto* header = At<MeshHeader>(payload, 0);
+
+		MeshView view{ header };
+		const auto section = [&]<typename T>(std::span<const T>& out, const uint64_t offset, const uint64_t count) {
+			if (offset % alignof(T) != 0 || !InRange(offset, count * sizeof(T), payload.size()))
+				throw std::runtime_error("AssetPack::GetMesh : corrupt mesh " + std::string(GetName(entry)));
+			out = { At<T>(payload, offset), count };
+		};
+
+		section(view.vertices, header->vertexOffset, uint64_t{ header->vertexCount } * header->vertexStride);
+		section(view.indices, header->indexOffset, uint64_t{ header->indexCount } * static_cast<uint32_t>(header->indexFormat));
+		section(view.lods, header->lodOffset, header->lodCount);
+		section(view.meshlets, header->meshletOffset, header->meshletCount);
+		section(view.meshletVertices, header->meshletVertexOffset, header->meshletVertexCount);
+		section(view.meshletTriangles, header->meshletTriangleOffset, header->meshletTriangleBytes);
+		return view;
+	}
+
+	std::optional<TextureView> AssetPack::GetTexture(const PackEntry& entry) const {
+		if (entry.type != AssetType::Texture || entry.size < sizeof(TextureHeader))
+			return std::nullopt;
+
+		const auto payload = GetPayload(entry);
+		const auto* header = At<TextureHeader>(payload, 0);
+		const uint64_t count = uint64_t{ header->mipCount } * header->arraySize;
+
+		if (!InRange(sizeof(TextureHeader), count * sizeof(TextureSubresource), payload.size()))
+			throw std::runtime_error("AssetPack::GetTexture : corrupt texture " + std::string(GetName(entry)));
+
+		const std::span subresources{ At<TextureSubresource>(payload, sizeof(TextureHeader)), count };
+		for (const TextureSubresource& sub : subresources) {
+			if (!InRange(sub.offset, sub.size, payload.size()))
+				throw std::runtime_error("AssetPack::GetTexture : corrupt texture " + std::string(GetName(entry)));
+		}
+
+		return TextureView{ header, subresources, payload };
+	}
+#pragma endregion
+
+#pragma region AssetPackWriter
+	void AssetPackWriter::Add(std::string name, const AssetType type, const std::span<const std::byte> payload) {
+		m_assets.push_back({ std::move(name), type, { payload.begin(), payload.end() } });
+	}
+
+	void AssetPackWriter::AddMapped(std::string name, const AssetType type, MappedFile file) {
+		m_assets.push_back({ std::move(name), type, {}, std::move(file) });
+	}
+
+	void AssetPackWriter::AddMesh(std::string name, const MeshHeader& desc, const std::span<const std::byte> vertices, const std::span<const std::byte> indices,
+		const std::span<const MeshLod> lods, const std::span<const MeshletDesc> meshlets,
+		const std::span<const uint32_t> meshletVertices, const std::span<const uint8_t> meshletTriangles)
+	{
+		if (vertices.size() != uint64_t{ desc.vertexCount } * desc.vertexStride
+			|| indices.size() != uint64_t{ desc.indexCount } * static_cast<uint32_t>(desc.indexFormat))
+			throw std::runtime_error("AssetPackWriter::AddMesh : buffer sizes do not match the header");
+
+		MeshHeader header = desc;
+		header.lodCount = static_cast<uint32_t>(lods.size());
+		header.meshletCount = static_cast<uint32_t>(meshlets.size());
+		header.meshletVertexCount = static_cast<uint32_t>(meshletVertices.size());
+		header.meshletTriangleBytes = static_cast<uint32_t>(meshletTriangles.size());
+
+		const std::span<const std::byte> sections[] = {
+			vertices, indices, std::as_bytes(lods), std::as_bytes(meshlets), std::as_bytes(meshletVertices), std::as_bytes(meshletTriangles)
+		};
+		uint64_t* offsets[] = {
+			&header.vertexOffset, &header.indexOffset, &header.lodOffset,
+			&header.meshletOffset, &header.meshletVertexOffset, &header.meshletTriangleOffset
+		};
+
+		uint64_t offset = sizeof(MeshHeader);
+		for (size_t i = 0; i < std::size(sections); ++i) {
+			*offsets[i] = AlignUp(offset, MeshSectionAlignment);
+			offset = *offsets[i] + sections[i].size();
+		}
+
+		std::vector<std::byte> payload(offset);
+		std::memcpy(payload.data(), &header, sizeof(header));
+		for (size_t i = 0; i < std::size(sections); ++i) {
+			if (!sections[i].empty())
+				std::memcpy(payload.data() + *offsets[i], sections[i].data(), sections[i].size());
+		}
+
+		m_assets.push_back({ std::move(name), AssetType::Mesh, std::move(payload) });
+	}
+
+	void AssetPackWriter::AddTexture(std::string name, const TextureHeader& desc, const std::span<const std::span<const std::byte>> subresources,
+		const std::span<const uint32_t> rowPitches, const std::span<const uint32_t> rowCounts)
+	{
+		const size_t count = size_t{ desc.mipCount } * desc.arraySize;
+		if (subresources.size() != count || rowPitches.size() != count || rowCounts.size() != count)
+			throw std::runtime_error("AssetPackWriter::AddTexture : expected mipCount * arraySize subresources");
+
+		std::vector<TextureSubresource> table(count);
+		uint64_t offset = AlignUp(sizeof(TextureHeader) + count * sizeof(TextureSubresource), PayloadAlignment);
+		for (size_t i = 0; i < count; ++i) {
+			table[i] = { offset, subresources[i].size(), rowPitches[i], rowCounts[i] };
+			offset = AlignUp(offset + subresources[i].size(), PayloadAlignment);
+		}
+
+		std::vector<std::byte> payload(count > 0 ? table.back().offset + table.back().size : offset);
+		std::memcpy(payload.data(), &desc, sizeof(desc));
+		if (count > 0)
+			std::memcpy(payload.data() + sizeof(desc), table.data(), count * sizeof(TextureSubresource));
+		for (size_t i = 0; i < count; ++i)
+			std::memcpy(payload.data() + table[i].offset, subresources[i].data(), subresources[i].size());
+
+		m_assets.push_back({ std::move(name), AssetType::Texture, std::move(payload) });
+	}
+
+	void AssetPackWriter::Write(const std::filesystem::path& path) const {
+		std::vector<const PendingAsset*> sorted;
+		sorted.reserve(m_assets.size());
+		for (const auto& asset : m_assets)
+			sorted.push_back(&asset);
+		std::sort(sorted.begin(), sorted.end(), [](const PendingAsset* a, const PendingAsset* b) {
+			return HashAssetName(a->name) < HashAssetName(b->name);
+		});
+
+		std::vector<PackEntry> entries(sorted.size());
+		std::string names;
+		for (size_t i = 0; i < sorted.size(); ++i) {
+			entries[i].nameHash = HashAssetName(sorted[i]->name);
+			entries[i].nameOffset = static_cast<uint32_t>(names.size());
+			entries[i].type = sorted[i]->type;
+			entries[i].flags = 0;
+			entries[i].size = sorted[i]->Payload().size();
+			names.append(sorted[i]->name);
+			names.push_back('\0');
+		}
+
+		PackHeader header{};
+		header.magic = PackMagic;
+		header.version = PackVersion;
+		header.headerSize = sizeof(PackHeader);
+		header.entryCount = static_cast<uint32_t>(entries.size());
+		header.payloadAlignment = PayloadAlignment;
+		header.entryTableOffset = sizeof(PackHeader);
+		header.nameTableOffset = header.entryTableOffset + entries.size() * sizeof(PackEntry);
+		header.nameTableSize = names.size();
+
+		uint64_t offset = header.nameTableOffset + header.nameTableSize;
+		for (PackEntry& entry : entries) {
+			entry.offset = AlignUp(offset, PayloadAlignment);
+			offset = entry.offset + entry.size;
+		}
+		header.fileSize = offset;
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("AssetPackWriter::Write : cannot open " + path.string());
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+		out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+		uint64_t written = header.nameTableOffset + header.nameTableSize;
+		static constexpr char padding[PayloadAlignment] = {};
+		for (size_t i = 0; i < entries.size(); ++i) {
+			out.write(padding, static_cast<std::streamsize>(entries[i].offset - written));
+			out.write(reinterpret_cast<const char*>(sorted[i]->Payload().data()), static_cast<std::streamsize>(entries[i].size));
+			written = entries[i].offset + entries[i].size;
+		}
+
+		if (!out)
+			throw std::runtime_error("AssetPackWriter::Write : failed writing " + path.string());
+	}
+#pragma endregion
+
+} // namespace Zenyth
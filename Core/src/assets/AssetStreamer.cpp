@@ -0,0 +1,294 @@
+#include "pch.hpp"
+#include "assets/AssetStreamer.hpp"
+
+namespace Zenyth {
+
+	namespace {
+		constexpr size_t PageSize = 4096;
+
+		// Reads one byte per page so the faults happen here rather than on the consumer's thread
+		void TouchPages(const std::span<const std::byte> bytes) noexcept {
+			const volatile std::byte* data = bytes.data();
+			std::byte sink{};
+			for (size_t offset = 0; offset < bytes.size(); offset += PageSize)
+				sink ^= data[offset];
+			if (!bytes.empty())
+				sink ^= data[bytes.size() - 1];
+			static_cast<void>(sink);
+		}
+	}
+
+	AssetStreamer::AssetStreamer(const size_t memoryBudget)
+		: m_budget(memoryBudget)
+	{
+		m_loader = std::thread([this] { LoaderLoop(); });
+	}
+
+	AssetStreamer::~AssetStreamer() {
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		m_loader.join();
+	}
+
+	void AssetStreamer::Mount(std::shared_ptr<AssetPack> pack) {
+		std::lock_guard lock(m_mutex);
+		m_packs.push_back(std::move(pack));
+	}
+
+	void AssetStreamer::Mount(const std::filesystem::path& path) {
+		Mount(std::make_shared<AssetPack>(path));
+	}
+
+	AssetHandle AssetStreamer::Request(const std::string_view name, const float priority) {
+		return Acquire(HashAssetName(name), name, priority);
+	}
+
+	AssetHandle AssetStreamer::Request(const uint64_t nameHash, const float priority) {
+		return Acquire(nameHash, std::nullopt, priority);
+	}
+
+	std::pair<const AssetPack*, const PackEntry*> AssetStreamer::Resolve(const uint64_t nameHash, const std::optional<std::string_view> name) const {
+		for (auto p = m_packs.rbegin(); p != m_packs.rend(); ++p) {
+			if (const PackEntry* entry = name ? (*p)->Find(*name) : (*p)->Find(nameHash))
+				return { p->get(), entry };
+		}
+		return { nullptr, nullptr };
+	}
+
+	AssetHandle AssetStreamer::Acquire(const uint64_t nameHash, const std::optional<std::string_view> name, const float priority) {
+		std::lock_guard lock(m_mutex);
+
+		AssetHandle handle = InvalidAsset;
+		const auto [first, last] = m_lookup.equal_range(nameHash);
+		for (auto it = first; it != last && handle == InvalidAsset; ++it) {
+			const Asset& asset = m_assets[it->second];
+			if (!name || asset.pack->GetName(*asset.entry) == *name)
+				handle = it->second;
+		}
+
+		if (handle == InvalidAsset) {
+			const auto [pack, entry] = Resolve(nameHash, name);
+			if (!entry)
+				return InvalidAsset;
+
+			handle = static_cast<AssetHandle>(m_assets.size());
+			m_assets.push_back({ pack, entry, priority });
+			m_lookup.emplace(nameHash, handle);
+		}
+		else if (Asset& asset = m_assets[handle]; asset.refCount == 0 && handle != m_loadingAsset) {
+			// Unreferenced, so it may move to a pack mounted since it was last resolved
+			const auto [pack, entry] = Resolve(nameHash, asset.pack->GetName(*asset.entry));
+			if (entry && entry != asset.entry) {
+				if (asset.state == AssetState::Ready)
+					Evict(handle);
+				asset.pack = pack;
+				asset.entry = entry;
+			}
+		}
+
+		Asset& asset = m_assets[handle];
+		++asset.refCount;
+
+		if (asset.state == AssetState::Unloaded) {
+			asset.priority = priority;
+			Enqueue(handle);
+		}
+		else if (asset.priority != priority) {
+			asset.priority = priority;
+			if (asset.state == AssetState::Queued)
+				Enqueue(handle);
+		}
+		return handle;
+	}
+
+	void AssetStreamer::UpdatePriority(const AssetHandle handle, const float priority) {
+		std::lock_guard lock(m_mutex);
+		if (handle >= m_assets.size())
+			return;
+
+		Asset& asset = m_assets[handle];
+		if (asset.priority == priority)
+			return;
+
+		asset.priority = priority;
+		if (asset.state == AssetState::Queued)
+			Enqueue(handle);
+	}
+
+	void AssetStreamer::Release(const AssetHandle handle) {
+		{
+			std::lock_guard lock(m_mutex);
+			if (handle >= m_assets.size() || m_assets[handle].refCount == 0)
+				return;
+
+			Asset& asset = m_assets[handle];
+			if (--asset.refCount > 0)
+				return;
+
+			if (asset.state == AssetState::Queued) {
+				// Invalidates the queued item
+				asset.state = AssetState::Unloaded;
+				++asset.serial;
+			}
+			// A resident asset just became evictable, which may unblock the queue
+			m_stalled = false;
+		}
+		m_wake.notify_one();
+		m_idle.notify_all();
+	}
+
+	AssetState AssetStreamer::GetState(const AssetHandle handle) const {
+		std::lock_guard lock(m_mutex);
+		return handle < m_assets.size() ? m_assets[handle].state : AssetState::Unloaded;
+	}
+
+	std::span<const std::byte> AssetStreamer::GetData(const AssetHandle handle) const {
+		std::lock_guard lock(m_mutex);
+		if (handle >= m_assets.size() || m_assets[handle].state != AssetState::Ready)
+			return {};
+
+		const Asset& asset = m_assets[handle];
+		return asset.pack->GetPayload(*asset.entry);
+	}
+
+	const PackEntry* AssetStreamer::GetEntry(const AssetHandle handle) const {
+		std::lock_guard lock(m_mutex);
+		return handle < m_assets.size() ? m_assets[handle].entry : nullptr;
+	}
+
+	const AssetPack* AssetStreamer::GetPack(const AssetHandle handle) const {
+		std::lock_guard lock(m_mutex);
+		return handle < m_assets.size() ? m_assets[handle].pack : nullptr;
+	}
+
+	void AssetStreamer::SetLoadedCallback(LoadedCallback callback) {
+		std::lock_guard lock(m_mutex);
+		m_onLoaded = std::move(callback);
+	}
+
+	void AssetStreamer::WaitIdle() {
+		std::unique_lock lock(m_mutex);
+		m_idle.wait(lock, [this] { return m_loadingAsset == InvalidAsset && (m_stalled || !HasLoadableWork()); });
+	}
+
+	void AssetStreamer::SetMemoryBudget(const size_t bytes) {
+		{
+			std::lock_guard lock(m_mutex);
+			m_budget.store(bytes, std::memory_order_relaxed);
+			m_stalled = false;
+		}
+		m_wake.notify_one();
+	}
+
+	size_t AssetStreamer::QueuedCount() const {
+		std::lock_guard lock(m_mutex);
+		return static_cast<size_t>(std::count_if(m_assets.begin(), m_assets.end(),
+			[](const Asset& asset) { return asset.state == AssetState::Queued; }));
+	}
+
+	void AssetStreamer::Enqueue(const AssetHandle handle) {
+		Asset& asset = m_assets[handle];
+		asset.state = AssetState::Queued;
+		m_queue.push({ asset.priority, handle, ++asset.serial });
+		m_stalled = false;
+		m_wake.notify_one();
+	}
+
+	bool AssetStreamer::HasLoadableWork() const {
+		return !m_queue.empty();
+	}
+
+	bool AssetStreamer::MakeRoom(const size_t bytes) {
+		const size_t budget = m_budget.load(std::memory_order_relaxed);
+		size_t resident = m_resident.load(std::memory_order_relaxed);
+		if (resident + bytes <= budget)
+			return true;
+
+		std::vector<AssetHandle> candidates;
+		size_t reclaimable = 0;
+		for (AssetHandle h = 0; h < m_assets.size(); ++h) {
+			const Asset& asset = m_assets[h];
+			if (asset.state == AssetState::Ready && asset.refCount == 0) {
+				candidates.push_back(h);
+				reclaimable += asset.entry->size;
+			}
+		}
+
+		// An asset larger than the whole budget still loads once nothing else is resident
+		if (resident - reclaimable + bytes > budget && resident - reclaimable > 0)
+			return false;
+
+		std::sort(candidates.begin(), candidates.end(), [this](const AssetHandle a, const AssetHandle b) {
+			return m_assets[a].priority < m_assets[b].priority;
+		});
+
+		for (const AssetHandle h : candidates) {
+			if (resident + bytes <= budget)
+				break;
+			resident -= m_assets[h].entry->size;
+			Evict(h);
+		}
+		return true;
+	}
+
+	void AssetStreamer::Evict(const AssetHandle handle) {
+		Asset& asset = m_assets[handle];
+		asset.pack->File().Evict(asset.entry->offset, asset.entry->size);
+		asset.state = AssetState::Unloaded;
+		m_resident.fetch_sub(asset.entry->size, std::memory_order_relaxed);
+	}
+
+	void AssetStreamer::LoaderLoop() {
+		std::unique_lock lock(m_mutex);
+
+		while (true) {
+			m_wake.wait(lock, [this] { return m_stop || (!m_stalled && HasLoadableWork()); });
+			if (m_stop)
+				return;
+
+			const QueueItem item = m_queue.top();
+			Asset& asset = m_assets[item.handle];
+
+			if (asset.state != AssetState::Queued || asset.serial != item.serial) {
+				m_queue.pop();
+				if (m_queue.empty())
+					m_idle.notify_all();
+				continue;
+			}
+
+			if (!MakeRoom(asset.entry->size)) {
+				m_stalled = true;
+				m_idle.notify_all();
+				continue;
+			}
+
+			m_queue.pop();
+			m_loadingAsset = item.handle;
+			m_resident.fetch_add(asset.entry->size, std::memory_order_relaxed);
+
+			const AssetPack* pack = asset.pack;
+			const PackEntry* entry = asset.entry;
+
+			lock.unlock();
+			pack->File().Prefetch(entry->offset, entry->size);
+			TouchPages(pack->GetPayload(*entry));
+			lock.lock();
+
+			// Stays resident even if it was released meanwhile; it is the first to go under pressure
+			asset.state = AssetState::Ready;
+
+			if (m_onLoaded) {
+				const LoadedCallback callback = m_onLoaded;
+				lock.unlock();
+				callback(item.handle);
+				lock.lock();
+			}
+			m_loadingAsset = InvalidAsset;
+			m_idle.notify_all();
+		}
+	}
+
+} // namespace Zenyth
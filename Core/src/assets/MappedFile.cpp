@@ -0,0 +1,179 @@
+#include "pch.hpp"
+#include "assets/MappedFile.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Zenyth {
+
+	namespace {
+		size_t PageSize() noexcept {
+#ifdef _WIN32
+			SYSTEM_INFO info;
+			::GetSystemInfo(&info);
+			return info.dwPageSize;
+#else
+			return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+		}
+
+		// Every page the range touches: fine for hints that only add work
+		std::pair<std::byte*, size_t> OuterPages(const std::byte* base, const size_t offset, const size_t size) noexcept {
+			const size_t begin = offset & ~(PageSize() - 1);
+			return { const_cast<std::byte*>(base) + begin, offset + size - begin };
+		}
+
+		// Only the pages the range covers completely, so data sharing its first or last page stays
+		// resident. The file's last page counts as covered when the range runs to the end of the file.
+		std::pair<std::byte*, size_t> InnerPages(const std::byte* base, const size_t offset, const size_t size, const size_t fileSize) noexcept {
+			const size_t page = PageSize();
+			const size_t begin = (offset + page - 1) & ~(page - 1);
+			const size_t end = offset + size == fileSize ? fileSize : (offset + size) & ~(page - 1);
+			return { const_cast<std::byte*>(base) + begin, end > begin ? end - begin : 0 };
+		}
+	}
+
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::filesystem::path& path) {
+		HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("MappedFile : cannot open " + path.string());
+		m_file = file;
+
+		LARGE_INTEGER size;
+		if (!::GetFileSizeEx(file, &size)) {
+			Close();
+			throw std::runtime_error("MappedFile : cannot query size of " + path.string());
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+		if (m_size == 0)
+			return;
+
+		m_mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping) {
+			Close();
+			throw std::runtime_error("MappedFile : CreateFileMapping failed for " + path.string());
+		}
+
+		m_data = static_cast<const std::byte*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!m_data) {
+			Close();
+			throw std::runtime_error("MappedFile : MapViewOfFile failed for " + path.string());
+		}
+	}
+
+	void MappedFile::Close() noexcept {
+		if (m_data)
+			::UnmapViewOfFile(m_data);
+		if (m_mapping)
+			::CloseHandle(m_mapping);
+		if (m_file)
+			::CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+		m_size = 0;
+	}
+
+	void MappedFile::Prefetch(const size_t offset, const size_t size) const noexcept {
+		if (!m_data || offset >= m_size)
+			return;
+
+		const auto [ptr, length] = OuterPages(m_data, offset, std::min(size, m_size - offset));
+		WIN32_MEMORY_RANGE_ENTRY range{ ptr, length };
+		::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+	}
+
+	void MappedFile::Evict(const size_t offset, const size_t size) const noexcept {
+		if (!m_data || offset >= m_size)
+			return;
+
+		// Unlocking pages that were never locked removes them from the working set
+		const auto [ptr, length] = InnerPages(m_data, offset, std::min(size, m_size - offset), m_size);
+		if (length > 0)
+			::VirtualUnlock(ptr, length);
+	}
+#else
+	MappedFile::MappedFile(const std::filesystem::path& path) {
+		m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (m_fd < 0)
+			throw std::runtime_error("MappedFile : cannot open " + path.string());
+
+		struct stat st {};
+		if (::fstat(m_fd, &st) != 0) {
+			Close();
+			throw std::runtime_error("MappedFile : cannot query size of " + path.string());
+		}
+		m_size = static_cast<size_t>(st.st_size);
+		if (m_size == 0)
+			return;
+
+		void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if (data == MAP_FAILED) {
+			Close();
+			throw std::runtime_error("MappedFile : mmap failed for " + path.string());
+		}
+		m_data = static_cast<const std::byte*>(data);
+	}
+
+	void MappedFile::Close() noexcept {
+		if (m_data)
+			::munmap(const_cast<std::byte*>(m_data), m_size);
+		if (m_fd >= 0)
+			::close(m_fd);
+
+		m_data = nullptr;
+		m_fd = -1;
+		m_size = 0;
+	}
+
+	void MappedFile::Prefetch(const size_t offset, const size_t size) const noexcept {
+		if (!m_data || offset >= m_size)
+			return;
+
+		// madvise wants page aligned ranges; the mapping itself starts on a page
+		const auto [ptr, length] = OuterPages(m_data, offset, std::min(size, m_size - offset));
+		::madvise(ptr, length, MADV_WILLNEED);
+	}
+
+	void MappedFile::Evict(const size_t offset, const size_t size) const noexcept {
+		if (!m_data || offset >= m_size)
+			return;
+
+		// Clean private file pages are simply dropped and faulted back in from the file
+		const auto [ptr, length] = InnerPages(m_data, offset, std::min(size, m_size - offset), m_size);
+		if (length > 0)
+			::madvise(ptr, length, MADV_DONTNEED);
+	}
+#endif
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			Close();
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+#ifdef _WIN32
+			std::swap(m_file, other.m_file);
+			std::swap(m_mapping, other.m_mapping);
+#else
+			std::swap(m_fd, other.m_fd);
+#endif
+		}
+		return *this;
+	}
+
+} // namespace Zenyth
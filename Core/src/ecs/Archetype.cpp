@@ -0,0 +1,162 @@
+#include "pch.hpp"
+#include "ecs/Archetype.hpp"
+
+namespace Zenyth::ecs {
+
+	namespace {
+		constexpr size_t AlignUp(const size_t value, const size_t alignment) noexcept {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		std::byte* AllocateChunk() {
+			return static_cast<std::byte*>(::operator new(ChunkSize, std::align_val_t{ CacheLineSize }));
+		}
+
+		void FreeChunk(std::byte* data) noexcept {
+			::operator delete(data, std::align_val_t{ CacheLineSize });
+		}
+	}
+
+#pragma region ComponentRegistry
+	namespace {
+		std::array<ComponentInfo, MaxComponents> s_components{};
+		std::atomic<uint32_t>                    s_componentCount = 0;
+	}
+
+	ComponentId ComponentRegistry::Register(const ComponentInfo& info) {
+		// Only claim an id while one is left, so a failed registration leaves Count() in range
+		uint32_t id = s_componentCount.load(std::memory_order_relaxed);
+		do {
+			if (id >= MaxComponents)
+				throw std::runtime_error("ComponentRegistry::Register : too many component types");
+		} while (!s_componentCount.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+
+		s_components[id] = info;
+		return id;
+	}
+
+	const ComponentInfo& ComponentRegistry::Info(const ComponentId id) noexcept {
+		return s_components[id];
+	}
+
+	uint32_t ComponentRegistry::Count() noexcept {
+		return s_componentCount.load(std::memory_order_relaxed);
+	}
+#pragma endregion
+
+#pragma region Archetype
+	Archetype::Archetype(const ComponentMask& mask)
+		: m_mask(mask)
+	{
+		for (ComponentId id = 0; id < MaxComponents; ++id) {
+			if (mask.test(id))
+				m_components.push_back(id);
+		}
+		ComputeLayout();
+	}
+
+	Archetype::~Archetype() {
+		for (auto& chunk : m_chunks) {
+			for (uint32_t column = 0; column < m_components.size(); ++column) {
+				const auto& info = ComponentRegistry::Info(m_components[column]);
+				if (info.trivial)
+					continue;
+
+				auto* base = static_cast<std::byte*>(ColumnData(chunk, column));
+				for (uint32_t row = 0; row < chunk.count; ++row)
+					info.destroy(base + static_cast<size_t>(row) * info.size);
+			}
+			FreeChunk(chunk.data);
+		}
+	}
+
+	void Archetype::ComputeLayout() {
+		size_t rowBytes = sizeof(Entity);
+		for (const ComponentId id : m_components)
+			rowBytes += ComponentRegistry::Info(id).size;
+
+		m_sizes.resize(m_components.size());
+		m_offsets.resize(m_components.size());
+
+		// Start from the unpadded estimate and shrink until every column fits with its padding
+		uint32_t capacity = static_cast<uint32_t>(ChunkSize / rowBytes);
+		for (; capacity > 0; --capacity) {
+			size_t offset = AlignUp(sizeof(Entity) * capacity, CacheLineSize);
+			for (size_t column = 0; column < m_components.size(); ++column) {
+				const auto& info = ComponentRegistry::Info(m_components[column]);
+				m_sizes[column] = info.size;
+				m_offsets[column] = static_cast<uint32_t>(offset);
+				offset = AlignUp(offset + static_cast<size_t>(info.size) * capacity, CacheLineSize);
+			}
+			if (offset <= ChunkSize)
+				break;
+		}
+
+		if (capacity == 0)
+			throw std::runtime_error("Archetype::ComputeLayout : components do not fit in a chunk");
+
+		m_capacity = capacity;
+	}
+
+	int32_t Archetype::ColumnOf(const ComponentId id) const noexcept {
+		if (!m_mask.test(id))
+			return -1;
+
+		const auto it = std::lower_bound(m_components.begin(), m_components.end(), id);
+		return static_cast<int32_t>(it - m_components.begin());
+	}
+
+	Slot Archetype::Allocate(const Entity entity) {
+		if (m_chunks.empty() || m_chunks.back().count == m_capacity)
+			m_chunks.push_back({ AllocateChunk(), 0 });
+
+		Chunk& chunk = m_chunks.back();
+		const Slot slot{ static_cast<uint32_t>(m_chunks.size() - 1), chunk.count };
+
+		::new (Entities(chunk) + slot.row) Entity(entity);
+		++chunk.count;
+		++m_entityCount;
+		return slot;
+	}
+
+	Entity Archetype::Erase(const Slot slot) {
+		Chunk& last = m_chunks.back();
+		const Slot lastSlot{ static_cast<uint32_t>(m_chunks.size() - 1), last.count - 1 };
+		const bool isLast = slot.chunk == lastSlot.chunk && slot.row == lastSlot.row;
+
+		for (uint32_t column = 0; column < m_components.size(); ++column) {
+			const auto& info = ComponentRegistry::Info(m_components[column]);
+			void* dst = ComponentAt(slot, column);
+
+			if (info.trivial) {
+				if (!isLast)
+					std::memcpy(dst, ComponentAt(lastSlot, column), info.size);
+				continue;
+			}
+
+			info.destroy(dst);
+			if (!isLast) {
+				void* src = ComponentAt(lastSlot, column);
+				info.moveConstruct(dst, src);
+				info.destroy(src);
+			}
+		}
+
+		Entity moved = NullEntity;
+		if (!isLast) {
+			moved = Entities(last)[lastSlot.row];
+			Entities(m_chunks[slot.chunk])[slot.row] = moved;
+		}
+
+		--last.count;
+		--m_entityCount;
+		if (last.count == 0) {
+			FreeChunk(last.data);
+			m_chunks.pop_back();
+		}
+
+		return moved;
+	}
+#pragma endregion
+
+} // namespace Zenyth::ecs
@@ -0,0 +1,119 @@
+#include "pch.hpp"
+#include "ecs/CommandBuffer.hpp"
+
+namespace Zenyth::ecs {
+
+	CommandBuffer::~CommandBuffer() {
+		Clear();
+	}
+
+	Entity CommandBuffer::Spawn() {
+		std::lock_guard lock(m_mutex);
+		const Entity placeholder{ m_spawnCount++, PendingGeneration };
+		Record({ Op::Spawn, placeholder });
+		return placeholder;
+	}
+
+	void CommandBuffer::Destroy(const Entity entity) {
+		std::lock_guard lock(m_mutex);
+		Record({ Op::Destroy, entity });
+	}
+
+	bool CommandBuffer::Empty() const {
+		std::lock_guard lock(m_mutex);
+		return m_commands.empty();
+	}
+
+	void CommandBuffer::Playback(World& world) {
+		std::vector<Command>                      commands;
+		std::vector<std::unique_ptr<std::byte[]>> blocks;
+		{
+			std::lock_guard lock(m_mutex);
+			commands.swap(m_commands);
+			blocks.swap(m_blocks);
+			m_current = nullptr;
+			m_blockOffset = 0;
+			m_spawnCount = 0;
+		}
+
+		// Payloads are destroyed once playback is over, including when a command throws part way
+		struct DiscardScope {
+			const std::vector<Command>& commands;
+			~DiscardScope() {
+				for (const Command& command : commands) {
+					if (command.discard)
+						command.discard(command.payload);
+				}
+			}
+		} scope{ commands };
+
+		std::vector<Entity> spawned;
+		const auto resolve = [&spawned](const Entity entity) {
+			if (entity.generation != PendingGeneration)
+				return entity;
+			return entity.index < spawned.size() ? spawned[entity.index] : NullEntity;
+		};
+
+		for (const Command& command : commands) {
+			switch (command.op) {
+			case Op::Spawn:
+				spawned.push_back(world.Create());
+				break;
+
+			case Op::Destroy: {
+				const Entity entity = resolve(command.entity);
+				if (world.IsAlive(entity))
+					world.Destroy(entity);
+				break;
+			}
+
+			case Op::Apply: {
+				// Targets may have been destroyed by an earlier command; drop the change silently
+				const Entity entity = resolve(command.entity);
+				if (world.IsAlive(entity))
+					command.apply(world, entity, command.payload);
+				break;
+			}
+			}
+		}
+	}
+
+	void CommandBuffer::Clear() {
+		std::lock_guard lock(m_mutex);
+		for (const Command& command : m_commands) {
+			if (command.discard)
+				command.discard(command.payload);
+		}
+		m_commands.clear();
+		m_blocks.clear();
+		m_current = nullptr;
+		m_blockOffset = 0;
+		m_spawnCount = 0;
+	}
+
+	void* CommandBuffer::AllocatePayload(const size_t size, const size_t alignment) {
+		// Oversized payloads get a dedicated block; the open block stays current
+		if (size + alignment > BlockSize) {
+			auto& block = m_blocks.emplace_back(std::make_unique<std::byte[]>(size + alignment));
+			void* ptr = block.get();
+			size_t space = size + alignment;
+			return std::align(alignment, size, ptr, space);
+		}
+
+		const auto base = reinterpret_cast<uintptr_t>(m_current);
+		size_t offset = ((base + m_blockOffset + alignment - 1) & ~(alignment - 1)) - base;
+		if (!m_current || offset + size > BlockSize) {
+			m_current = m_blocks.emplace_back(std::make_unique<std::byte[]>(BlockSize)).get();
+			const auto fresh = reinterpret_cast<uintptr_t>(m_current);
+			offset = ((fresh + alignment - 1) & ~(alignment - 1)) - fresh;
+		}
+
+		m_blockOffset = offset + size;
+		return m_current + offset;
+	}
+
+	void CommandBuffer::Record(const Command& command) {
+		m_commands.push_back(command);
+	}
+
+} // namespace Zenyth::ecs
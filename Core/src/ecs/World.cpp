@@ -0,0 +1,157 @@
+#include "pch.hpp"
+#include "ecs/World.hpp"
+#include "ecs/CommandBuffer.hpp"
+
+namespace Zenyth::ecs {
+
+	World::World()
+		: m_deferred(std::make_unique<CommandBuffer>())
+	{
+		m_root = GetOrCreateArchetype({});
+	}
+
+	World::~World() = default;
+
+	Entity World::Create() {
+		CheckStructural("World::Create");
+
+		const Entity entity = AllocateEntity();
+		Record& record = m_records[entity.index];
+		record.archetype = m_root;
+		record.slot = m_root->Allocate(entity);
+		return entity;
+	}
+
+	void World::Destroy(const Entity entity) {
+		CheckStructural("World::Destroy");
+
+		Record& record = Lookup(entity);
+		const Entity moved = record.archetype->Erase(record.slot);
+		if (!moved.IsNull())
+			m_records[moved.index].slot = record.slot;
+
+		record.archetype = nullptr;
+		// Skip the generation reserved for CommandBuffer placeholders
+		if (++record.generation == CommandBuffer::PendingGeneration)
+			record.generation = 0;
+
+		m_freeList.push_back(entity.index);
+		--m_aliveCount;
+	}
+
+	bool World::IsAlive(const Entity entity) const noexcept {
+		return TryLookup(entity) != nullptr;
+	}
+
+	void World::FlushDeferred() {
+		m_deferred->Playback(*this);
+	}
+
+	World::Record& World::Lookup(const Entity entity) {
+		if (entity.index >= m_records.size())
+			throw std::runtime_error("World::Lookup : invalid entity");
+
+		Record& record = m_records[entity.index];
+		if (record.generation != entity.generation || !record.archetype)
+			throw std::runtime_error("World::Lookup : stale entity");
+
+		return record;
+	}
+
+	const World::Record* World::TryLookup(const Entity entity) const noexcept {
+		if (entity.index >= m_records.size())
+			return nullptr;
+
+		const Record& record = m_records[entity.index];
+		if (record.generation != entity.generation || !record.archetype)
+			return nullptr;
+
+		return &record;
+	}
+
+	Entity World::AllocateEntity() {
+		uint32_t index;
+		if (!m_freeList.empty()) {
+			index = m_freeList.back();
+			m_freeList.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(m_records.size());
+			m_records.emplace_back();
+		}
+
+		++m_aliveCount;
+		return { index, m_records[index].generation };
+	}
+
+	void World::CheckStructural(const char* where) const {
+		if (m_iterating != 0)
+			throw std::runtime_error(std::string(where) + " : structural change during query iteration, use a CommandBuffer");
+	}
+
+	Archetype* World::GetOrCreateArchetype(const ComponentMask& mask) {
+		if (const auto it = m_archetypeLookup.find(mask); it != m_archetypeLookup.end())
+			return it->second;
+
+		auto& archetype = m_archetypes.emplace_back(std::make_unique<Archetype>(mask));
+		m_archetypeLookup.emplace(mask, archetype.get());
+		return archetype.get();
+	}
+
+	Archetype* World::AddTarget(Archetype* from, const ComponentId id) {
+		if (const auto it = from->addEdges.find(id); it != from->addEdges.end())
+			return it->second;
+
+		ComponentMask mask = from->Mask();
+		mask.set(id);
+
+		Archetype* to = GetOrCreateArchetype(mask);
+		from->addEdges.emplace(id, to);
+		to->removeEdges.emplace(id, from);
+		return to;
+	}
+
+	Archetype* World::RemoveTarget(Archetype* from, const ComponentId id) {
+		if (const auto it = from->removeEdges.find(id); it != from->removeEdges.end())
+			return it->second;
+
+		ComponentMask mask = from->Mask();
+		mask.reset(id);
+
+		Archetype* to = GetOrCreateArchetype(mask);
+		from->removeEdges.emplace(id, to);
+		to->addEdges.emplace(id, from);
+		return to;
+	}
+
+	Slot World::MoveEntity(const Entity entity, Record& record, Archetype* to) {
+		Archetype* from = record.archetype;
+		const Slot source = record.slot;
+		const Slot target = to->Allocate(entity);
+
+		const auto components = to->Components();
+		for (uint32_t column = 0; column < components.size(); ++column) {
+			const int32_t sourceColumn = from->ColumnOf(components[column]);
+			if (sourceColumn < 0)
+				continue;
+
+			const auto& info = ComponentRegistry::Info(components[column]);
+			void* dst = to->ComponentAt(target, column);
+			void* src = from->ComponentAt(source, sourceColumn);
+			if (info.trivial)
+				std::memcpy(dst, src, info.size);
+			else
+				info.moveConstruct(dst, src);
+		}
+
+		// Erase destroys the moved-from leftovers and anything `to` does not keep
+		const Entity moved = from->Erase(source);
+		if (!moved.IsNull())
+			m_records[moved.index].slot = source;
+
+		record.archetype = to;
+		record.slot = target;
+		return target;
+	}
+
+} // namespace Zenyth::ecs
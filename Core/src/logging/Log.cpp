@@ -0,0 +1,398 @@
+#include "pch.hpp"
+#include "logging/Log.hpp"
+#include "logging/LogSinks.hpp"
+
+#include <bit>
+
+namespace Zenyth::logging {
+
+	namespace {
+		constexpr size_t RecordAlignment = 8;
+
+		struct RecordHeader {
+			const Site*      site;      // null: padding up to the end of the ring
+			detail::DecodeFn decode;
+			int64_t          timestamp; // system_clock ticks
+			uint32_t         size;      // whole record, header and padding included
+			uint32_t         reserved;
+		};
+
+		static_assert(sizeof(RecordHeader) % RecordAlignment == 0);
+
+		// Single-producer single-consumer byte ring. The owning thread writes records; the logger
+		// thread (or Flush) reads them. Positions grow monotonically and wrap through the mask.
+		class ThreadRing {
+		public:
+			ThreadRing(const size_t capacity, const uint32_t thread)
+				: m_buffer(std::make_unique_for_overwrite<std::byte[]>(capacity)), m_capacity(capacity), m_thread(thread) {}
+
+			std::byte* Reserve(const size_t recordSize) noexcept {
+				const uint64_t head = m_head.load(std::memory_order_relaxed);
+				const uint64_t tail = m_tail.load(std::memory_order_acquire);
+				const size_t   offset = static_cast<size_t>(head & (m_capacity - 1));
+
+				// Records never wrap: skip what is left of the buffer when the record does not fit
+				const size_t skip = offset + recordSize > m_capacity ? m_capacity - offset : 0;
+				if (head + skip + recordSize - tail > m_capacity)
+					return nullptr;
+
+				if (skip >= sizeof(RecordHeader)) {
+					RecordHeader padding{};
+					padding.size = static_cast<uint32_t>(skip);
+					std::memcpy(m_buffer.get() + offset, &padding, sizeof(padding));
+				}
+				m_pending = head + skip + recordSize;
+				m_reserved = m_buffer.get() + ((head + skip) & (m_capacity - 1));
+				return m_reserved;
+			}
+
+			void Commit() noexcept { m_head.store(m_pending, std::memory_order_release); }
+
+			template<typename F>
+			void Drain(F&& fn) {
+				const uint64_t head = m_head.load(std::memory_order_acquire);
+				uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+				while (tail < head) {
+					const size_t offset = static_cast<size_t>(tail & (m_capacity - 1));
+					if (m_capacity - offset < sizeof(RecordHeader)) {
+						tail += m_capacity - offset;
+						continue;
+					}
+
+					RecordHeader header;
+					std::memcpy(&header, m_buffer.get() + offset, sizeof(header));
+					if (header.site)
+						fn(header, m_buffer.get() + offset + sizeof(header));
+					tail += header.size;
+				}
+				m_tail.store(tail, std::memory_order_release);
+			}
+
+			[[nodiscard]] bool             Empty()    const noexcept { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed); }
+			[[nodiscard]] uint32_t         Thread()   const noexcept { return m_thread; }
+			// The record handed out by the last Reserve(), committed or not
+			[[nodiscard]] const std::byte* Reserved() const noexcept { return m_reserved; }
+
+			std::atomic<bool> retired{ false };
+
+		private:
+			std::unique_ptr<std::byte[]> m_buffer;
+			size_t                       m_capacity;
+			uint32_t                     m_thread;
+			uint64_t                     m_pending = 0;
+			std::byte*                   m_reserved = nullptr;
+
+			alignas(64) std::atomic<uint64_t> m_head{ 0 };
+			alignas(64) std::atomic<uint64_t> m_tail{ 0 };
+		};
+
+		struct Pending {
+			int64_t     timestamp;
+			const Site* site;
+			uint32_t    thread;
+			uint32_t    textOffset;
+			uint32_t    textLength;
+		};
+
+		struct LoggerState {
+			// Ring registration happens once per thread; the hot path never takes this lock
+			std::mutex                               ringsMutex;
+			std::vector<std::shared_ptr<ThreadRing>> rings;
+			uint32_t                                 nextThread = 0;
+			std::atomic<size_t>                      ringBytes{ LoggerConfig{}.ringBytes };
+
+			// Everything below belongs to whoever holds drainMutex
+			std::mutex                         drainMutex;
+			std::vector<std::unique_ptr<Sink>> sinks;
+			std::vector<Pending>               pending;
+			std::string                        text;
+			uint64_t                           reportedDrops = 0;
+
+			std::atomic<uint64_t>     dropped{ 0 };
+			std::atomic<bool>         running{ false };
+			std::atomic<bool>         wake{ false };
+			std::mutex                wakeMutex;
+			std::condition_variable   wakeCondition;
+			std::chrono::milliseconds drainInterval{ 5 };
+			std::thread               thread;
+		};
+
+		LoggerState& State() {
+			static LoggerState state;
+			return state;
+		}
+
+		// Keeps the ring alive for the drainer after its thread exits
+		struct ThreadRingHandle {
+			std::shared_ptr<ThreadRing> ring;
+
+			~ThreadRingHandle() {
+				if (ring)
+					ring->retired.store(true, std::memory_order_release);
+			}
+		};
+
+		thread_local ThreadRingHandle t_ring;
+
+		// Set while the thread holds drainMutex, i.e. while sinks run on it
+		thread_local bool t_draining = false;
+
+		struct DrainScope {
+			std::lock_guard<std::mutex> lock;
+
+			explicit DrainScope(LoggerState& state) : lock(state.drainMutex) { t_draining = true; }
+			~DrainScope() { t_draining = false; }
+		};
+
+		ThreadRing* CurrentRing() {
+			if (!t_ring.ring) {
+				LoggerState& state = State();
+				const size_t bytes = std::bit_ceil(std::max<size_t>(state.ringBytes.load(std::memory_order_relaxed), 4096));
+
+				std::lock_guard lock(state.ringsMutex);
+				t_ring.ring = std::make_shared<ThreadRing>(bytes, state.nextThread++);
+				state.rings.push_back(t_ring.ring);
+			}
+			return t_ring.ring.get();
+		}
+
+		// Caller holds drainMutex
+		void DrainLocked(LoggerState& state) {
+			std::vector<std::shared_ptr<ThreadRing>> rings;
+			{
+				std::lock_guard lock(state.ringsMutex);
+				// Rings of exited threads go once they are empty; they can receive nothing new
+				std::erase_if(state.rings, [](const std::shared_ptr<ThreadRing>& ring) {
+					return ring->retired.load(std::memory_order_acquire) && ring->Empty();
+				});
+				rings = state.rings;
+			}
+
+			state.pending.clear();
+			state.text.clear();
+			for (const auto& ring : rings) {
+				ring->Drain([&](const RecordHeader& header, const std::byte* payload) {
+					const auto offset = static_cast<uint32_t>(state.text.size());
+					try {
+						header.decode(*header.site, payload, state.text);
+					}
+					catch (const std::exception& e) {
+						state.text.resize(offset);
+						state.text.append("<format error: ").append(e.what()).append(">");
+					}
+					state.pending.push_back({ header.timestamp, header.site, ring->Thread(), offset, static_cast<uint32_t>(state.text.size() - offset) });
+				});
+			}
+
+			// Each ring is already in order; merge them by time
+			std::ranges::stable_sort(state.pending, {}, &Pending::timestamp);
+
+			const auto dispatch = [&](const Message& message) {
+				for (const auto& sink : state.sinks)
+					sink->Write(message);
+			};
+
+			for (const Pending& record : state.pending) {
+				dispatch({
+					record.site->severity, record.site->category,
+					std::chrono::system_clock::time_point(std::chrono::system_clock::duration(record.timestamp)),
+					record.thread, record.site->file, record.site->line,
+					std::string_view(state.text).substr(record.textOffset, record.textLength)
+				});
+			}
+
+			if (const uint64_t dropped = state.dropped.load(std::memory_order_relaxed); dropped != state.reportedDrops) {
+				const std::string text = std::format("{} log records dropped: ring full", dropped - state.reportedDrops);
+				state.reportedDrops = dropped;
+				dispatch({ Severity::Warning, Category::Core, std::chrono::system_clock::now(), 0, __FILE__, __LINE__, text });
+			}
+		}
+
+		// For records logged by a sink that cannot wait for the drain: decoded in place and written to
+		// stderr, bypassing the sinks
+		void WriteDirect(const std::byte* record, const uint32_t thread) {
+			RecordHeader header;
+			std::memcpy(&header, record, sizeof(header));
+			const Site& site = *header.site;
+
+			std::string text;
+			try {
+				header.decode(site, record + sizeof(header), text);
+			}
+			catch (const std::exception& e) {
+				text.assign("<format error: ").append(e.what()).append(">");
+			}
+
+			std::string line;
+			FormatLine({
+				site.severity, site.category,
+				std::chrono::system_clock::time_point(std::chrono::system_clock::duration(header.timestamp)),
+				thread, site.file, site.line, text
+			}, line);
+			std::fwrite(line.data(), 1, line.size(), stderr);
+			std::fflush(stderr);
+		}
+
+		void FlushLocked(LoggerState& state) {
+			DrainLocked(state);
+			for (const auto& sink : state.sinks)
+				sink->Flush();
+		}
+
+		void Run(LoggerState& state) {
+			while (state.running.load(std::memory_order_acquire)) {
+				{
+					std::unique_lock lock(state.wakeMutex);
+					state.wakeCondition.wait_for(lock, state.drainInterval, [&] {
+						return state.wake.load(std::memory_order_acquire) || !state.running.load(std::memory_order_acquire);
+					});
+					state.wake.store(false, std::memory_order_relaxed);
+				}
+
+				DrainScope scope(state);
+				DrainLocked(state);
+			}
+		}
+	}
+
+	std::string_view ToString(const Severity severity) noexcept {
+		switch (severity) {
+			case Severity::Trace:   return "Trace";
+			case Severity::Debug:   return "Debug";
+			case Severity::Info:    return "Info";
+			case Severity::Warning: return "Warning";
+			case Severity::Error:   return "Error";
+			case Severity::Fatal:   return "Fatal";
+		}
+		return "?";
+	}
+
+	std::string_view ToString(const Category category) noexcept {
+		switch (category) {
+			case Category::General:   return "General";
+			case Category::Core:      return "Core";
+			case Category::Jobs:      return "Jobs";
+			case Category::Assets:    return "Assets";
+			case Category::Renderer:  return "Renderer";
+			case Category::Physics:   return "Physics";
+			case Category::Animation: return "Animation";
+			case Category::Game:      return "Game";
+		}
+		return "?";
+	}
+
+	namespace detail {
+		std::byte* BeginRecord(const Site& site, const DecodeFn decode, const size_t payloadSize) noexcept {
+			ThreadRing* ring;
+			try {
+				ring = CurrentRing();
+			}
+			catch (...) {
+				State().dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			const size_t size = (sizeof(RecordHeader) + payloadSize + RecordAlignment - 1) & ~(RecordAlignment - 1);
+			std::byte* record = size <= UINT32_MAX ? ring->Reserve(size) : nullptr;
+			if (!record) {
+				State().dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			const RecordHeader header{ &site, decode, std::chrono::system_clock::now().time_since_epoch().count(), static_cast<uint32_t>(size), 0 };
+			std::memcpy(record, &header, sizeof(header));
+			return record + sizeof(header);
+		}
+
+		void CommitRecord(const Site& site) noexcept {
+			ThreadRing& ring = *t_ring.ring;
+
+			// A sink logging a fatal error cannot flush: this thread already holds drainMutex. The
+			// record is written out directly instead and never enters the ring.
+			if (t_draining && site.severity == Severity::Fatal) {
+				try {
+					WriteDirect(ring.Reserved(), ring.Thread());
+				}
+				catch (...) {}
+				return;
+			}
+
+			ring.Commit();
+
+			if (site.severity >= Severity::Error) {
+				LoggerState& state = State();
+				if (site.severity == Severity::Fatal) {
+					// The process is likely about to go down: get everything out now
+					try {
+						Logger::Flush();
+					}
+					catch (...) {}
+				}
+				else if (state.running.load(std::memory_order_relaxed)) {
+					state.wake.store(true, std::memory_order_release);
+					state.wakeCondition.notify_one();
+				}
+			}
+		}
+	}
+
+	void Logger::Start(const LoggerConfig& config) {
+		LoggerState& state = State();
+		if (state.running.exchange(true))
+			throw std::logic_error("Logger::Start : already running");
+
+		state.ringBytes.store(config.ringBytes, std::memory_order_relaxed);
+		state.drainInterval = config.drainInterval;
+		state.thread = std::thread(Run, std::ref(state));
+	}
+
+	void Logger::Stop() {
+		LoggerState& state = State();
+		if (!state.running.exchange(false))
+			return;
+
+		state.wakeCondition.notify_one();
+		state.thread.join();
+
+		DrainScope scope(state);
+		FlushLocked(state);
+	}
+
+	void Logger::AddSink(std::unique_ptr<Sink> sink) {
+		if (IsRunning())
+			throw std::logic_error("Logger::AddSink : sinks cannot change while the logger runs");
+
+		LoggerState& state = State();
+		std::lock_guard lock(state.drainMutex);
+		state.sinks.push_back(std::move(sink));
+	}
+
+	void Logger::ClearSinks() {
+		if (IsRunning())
+			throw std::logic_error("Logger::ClearSinks : sinks cannot change while the logger runs");
+
+		LoggerState& state = State();
+		std::lock_guard lock(state.drainMutex);
+		state.sinks.clear();
+	}
+
+	void Logger::Flush() {
+		// Called from a sink: the drain running on this thread is already under way
+		if (t_draining)
+			return;
+
+		LoggerState& state = State();
+		DrainScope scope(state);
+		FlushLocked(state);
+	}
+
+	uint64_t Logger::DroppedCount() noexcept {
+		return State().dropped.load(std::memory_order_relaxed);
+	}
+
+	bool Logger::IsRunning() noexcept {
+		return State().running.load(std::memory_order_acquire);
+	}
+
+} // namespace Zenyth::logging
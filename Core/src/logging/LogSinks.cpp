@@ -0,0 +1,50 @@
+#include "pch.hpp"
+#include "logging/LogSinks.hpp"
+
+#include <cstdio>
+
+namespace Zenyth::logging {
+
+	void FormatLine(const Message& message, std::string& out) {
+		out.clear();
+		const auto time = std::chrono::floor<std::chrono::milliseconds>(message.time);
+		std::format_to(std::back_inserter(out), "{:%T} [{}] [{}] {}\n",
+			time.time_since_epoch() % std::chrono::days(1), ToString(message.severity), ToString(message.category), message.text);
+	}
+
+	void ConsoleSink::Write(const Message& message) {
+		FormatLine(message, m_line);
+		std::fwrite(m_line.data(), 1, m_line.size(), message.severity >= Severity::Error ? stderr : stdout);
+	}
+
+	void ConsoleSink::Flush() {
+		std::fflush(stdout);
+		std::fflush(stderr);
+	}
+
+	FileSink::FileSink(const std::filesystem::path& path, const bool append)
+		: m_file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc))
+	{
+		if (!m_file)
+			throw std::runtime_error("FileSink : cannot open " + path.string());
+	}
+
+	void FileSink::Write(const Message& message) {
+		FormatLine(message, m_line);
+		m_file.write(m_line.data(), static_cast<std::streamsize>(m_line.size()));
+	}
+
+	void FileSink::Flush() {
+		m_file.flush();
+	}
+
+	void DebuggerSink::Write(const Message& message) {
+#ifdef _WIN32
+		FormatLine(message, m_line);
+		::OutputDebugStringA(m_line.c_str());
+#else
+		(void)message;
+#endif
+	}
+
+} // namespace Zenyth::logging
@@ -2,125 +2,70 @@
 #include "math/matrix.hpp"
 
 namespace zenyth::math {
-	mat4::mat4() noexcept {}
-	mat4::mat4(float diagonal) noexcept {}
-
-	mat4::mat4(const vec4 &col0, const vec4 &col1, const vec4 &col2, const vec4 &col3) noexcept
-		: m_col {col0.m_simd, col1.m_simd, col2.m_simd, col3.m_simd} {}
-
-	mat4 mat4::identity() noexcept {
-		return {};
-	}
-
-	mat4 mat4::zero() noexcept {
-		return {};
-	}
-
-	mat4 mat4::from_basis(const vec3 &right, const vec3 &up, const vec3 &forward) noexcept {
-		return {};
-	}
-
-	mat4 mat4::from_axis_angle(const vec3 &axis, float angle_rad) noexcept {
-		return {};
-	}
-
-	mat4 mat4::from_euler(float pitch, float yaw, float roll) noexcept {
-		return {};
-	}
-
-	mat4 mat4::from_scale(const vec3 &scale) noexcept {
-		return {};
-	}
-
-	mat4 mat4::from_translation(const vec3 &t) noexcept {
-		return {};
-	}
-
-	mat4 mat4::operator+(const mat4 &rhs) const noexcept {
-		return {};
-	}
-
-	mat4 mat4::operator-(const mat4 &rhs) const noexcept {
-		return {};
-	}
-
-	mat4 mat4::operator*(float scalar) const noexcept {
-		return {};
-	}
-
-	mat4 mat4::operator/(float scalar) const noexcept {
-		return {};
-	}
-
-	mat4 mat4::operator*(const mat4 &rhs) const noexcept {
-		return {};
-	}
-
-	mat4& mat4::operator+=(const mat4 &rhs) noexcept {
-		return *this;
-	}
-
-	mat4& mat4::operator-=(const mat4 &rhs) noexcept {
-		return *this;
-	}
-
-	mat4& mat4::operator*=(float scalar) noexcept {
-		return *this;
-	}
-
-	mat4& mat4::operator/=(float scalar) noexcept {
-		return *this;
-	}
-
-	mat4& mat4::operator*=(const mat4 &rhs) noexcept {
-		return *this;
-	}
-
-	mat4 mat4::transpose() const noexcept {
-		return *this;
+	// The general inverse is the only cold path left out of line: it is not used per object per
+	// frame, and a constant-evaluated version has no caller
+	namespace {
+		// 2x2 sub-determinants of the lower (rows 2, 3) and upper (rows 0, 1) halves, shared by
+		// the determinant and the cofactors
+		struct Minors {
+			float s[6];
+			float c[6];
+		};
+
+		Minors ComputeMinors(const mat4& m) noexcept {
+			Minors out;
+			out.s[0] = m[0, 0] * m[1, 1] - m[1, 0] * m[0, 1];
+			out.s[1] = m[0, 0] * m[1, 2] - m[1, 0] * m[0, 2];
+			out.s[2] = m[0, 0] * m[1, 3] - m[1, 0] * m[0, 3];
+			out.s[3] = m[0, 1] * m[1, 2] - m[1, 1] * m[0, 2];
+			out.s[4] = m[0, 1] * m[1, 3] - m[1, 1] * m[0, 3];
+			out.s[5] = m[0, 2] * m[1, 3] - m[1, 2] * m[0, 3];
+
+			out.c[5] = m[2, 2] * m[3, 3] - m[3, 2] * m[2, 3];
+			out.c[4] = m[2, 1] * m[3, 3] - m[3, 1] * m[2, 3];
+			out.c[3] = m[2, 1] * m[3, 2] - m[3, 1] * m[2, 2];
+			out.c[2] = m[2, 0] * m[3, 3] - m[3, 0] * m[2, 3];
+			out.c[1] = m[2, 0] * m[3, 2] - m[3, 0] * m[2, 2];
+			out.c[0] = m[2, 0] * m[3, 1] - m[3, 0] * m[2, 1];
+			return out;
+		}
+
+		float Determinant(const Minors& k) noexcept {
+			return k.s[0] * k.c[5] - k.s[1] * k.c[4] + k.s[2] * k.c[3] + k.s[3] * k.c[2] - k.s[4] * k.c[1] + k.s[5] * k.c[0];
+		}
 	}
 
 	float mat4::determinant() const noexcept {
-		return m_data[0];
+		return Determinant(ComputeMinors(*this));
 	}
 
 	mat4 mat4::inverse() const noexcept {
-		return *this;
-	}
-
-	mat4 mat4::inverse_transpose() const noexcept {
-		return *this;
-	}
-
-	vec3 mat4::transform_point(const vec3 &p) const noexcept {
-		return {m_data[0], m_data[1], m_data[2]};
-	}
-
-	vec3 mat4::transform_normal(const vec3 &n) const noexcept {
-		return {m_data[0], m_data[1], m_data[2]};
-	}
-
-	vec4 mat4::operator*(const vec4 &v) const noexcept {
-		return {m_data[0], m_data[1], m_data[2], m_data[4]};
-	}
-
-	mat4 mat4::look_at(const vec3 &eye, const vec3 &center, const vec3 &up) noexcept {
-		return {};
-	}
-
-	mat4 mat4::perspective(float fov_y, float aspect, float near_z, float far_z) noexcept {
-		return {};
-	}
-
-	mat4 mat4::orthographic(float left, float right, float bottom, float top, float near_z, float far_z) noexcept {
-		return {};
-	}
-
-	mat4 mat4::perspective_reverse_z(float fov_y, float aspect, float near_z) noexcept {
-		return {};
-	}
-
-	mat4::mat4(const __m128 c0, const __m128 c1, const __m128 c2, const __m128 c3) noexcept
-		: m_col {c0, c1, c2, c3} {}
-}
-
+		const mat4&  m = *this;
+		const Minors k = ComputeMinors(m);
+		const float  invDet = 1.0f / Determinant(k);
+		const float* s = k.s;
+		const float* c = k.c;
+
+		mat4 out;
+		out[0, 0] = ( m[1, 1] * c[5] - m[1, 2] * c[4] + m[1, 3] * c[3]) * invDet;
+		out[0, 1] = (-m[0, 1] * c[5] + m[0, 2] * c[4] - m[0, 3] * c[3]) * invDet;
+		out[0, 2] = ( m[3, 1] * s[5] - m[3, 2] * s[4] + m[3, 3] * s[3]) * invDet;
+		out[0, 3] = (-m[2, 1] * s[5] + m[2, 2] * s[4] - m[2, 3] * s[3]) * invDet;
+
+		out[1, 0] = (-m[1, 0] * c[5] + m[1, 2] * c[2] - m[1, 3] * c[1]) * invDet;
+		out[1, 1] = ( m[0, 0] * c[5] - m[0, 2] * c[2] + m[0, 3] * c[1]) * invDet;
+		out[1, 2] = (-m[3, 0] * s[5] + m[3, 2] * s[2] - m[3, 3] * s[1]) * invDet;
+		out[1, 3] = ( m[2, 0] * s[5] - m[2, 2] * s[2] + m[2, 3] * s[1]) * invDet;
+
+		out[2, 0] = ( m[1, 0] * c[4] - m[1, 1] * c[2] + m[1, 3] * c[0]) * invDet;
+		out[2, 1] = (-m[0, 0] * c[4] + m[0, 1] * c[2] - m[0, 3] * c[0]) * invDet;
+		out[2, 2] = ( m[3, 0] * s[4] - m[3, 1] * s[2] + m[3, 3] * s[0]) * invDet;
+		out[2, 3] = (-m[2, 0] * s[4] + m[2, 1] * s[2] - m[2, 3] * s[0]) * invDet;
+
+		out[3, 0] = (-m[1, 0] * c[3] + m[1, 1] * c[1] - m[1, 2] * c[0]) * invDet;
+		out[3, 1] = ( m[0, 0] * c[3] - m[0, 1] * c[1] + m[0, 2] * c[0]) * invDet;
+		out[3, 2] = (-m[3, 0] * s[3] + m[3, 1] * s[1] - m[3, 2] * s[0]) * invDet;
+		out[3, 3] = ( m[2, 0] * s[3] - m[2, 1] * s[1] + m[2, 2] * s[0]) * invDet;
+		return out;
+	}
+} // namespace zenyth::math
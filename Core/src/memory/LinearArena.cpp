@@ -0,0 +1,64 @@
+#include "pch.hpp"
+#include "memory/LinearArena.hpp"
+
+namespace Zenyth {
+
+	LinearArena::LinearArena(const size_t blockSize) : m_blockSize(blockSize) {
+		if (blockSize == 0)
+			throw std::invalid_argument("LinearArena : blockSize must be positive");
+	}
+
+	void* LinearArena::Allocate(const size_t size, const size_t alignment) {
+		if (alignment == 0 || (alignment & (alignment - 1)))
+			throw std::invalid_argument("LinearArena::Allocate : alignment must be a power of two");
+
+		const auto tryBump = [&]() -> void* {
+			if (m_blocks.empty())
+				return nullptr;
+			Block& block = m_blocks.back();
+			const auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+			const size_t start = ((base + m_offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - base;
+			if (start + size > block.size)
+				return nullptr;
+			m_used += start + size - m_offset;
+			m_offset = start + size;
+			return block.memory.get() + start;
+		};
+
+		if (void* p = tryBump())
+			return p;
+		AddBlock(size + alignment);
+		return tryBump();
+	}
+
+	void LinearArena::AddBlock(const size_t minSize) {
+		const size_t size = std::max(m_blockSize, minSize);
+		m_blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(size), size });
+		m_offset = 0;
+	}
+
+	void LinearArena::Reset() noexcept {
+		if (m_used > m_highWater.load(std::memory_order_relaxed))
+			m_highWater.store(m_used, std::memory_order_relaxed);
+
+		if (m_blocks.size() > 1) {
+			// Keep the next frame in one block; if the allocation fails we simply start empty
+			const size_t total = CapacityBytes();
+			m_blocks.clear();
+			try {
+				AddBlock(total);
+			}
+			catch (const std::bad_alloc&) {}
+		}
+		m_offset = 0;
+		m_used = 0;
+	}
+
+	size_t LinearArena::CapacityBytes() const noexcept {
+		size_t total = 0;
+		for (const Block& block : m_blocks)
+			total += block.size;
+		return total;
+	}
+
+} // namespace Zenyth
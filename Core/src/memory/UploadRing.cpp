@@ -0,0 +1,75 @@
+#include "pch.hpp"
+#include "memory/UploadRing.hpp"
+
+namespace Zenyth {
+
+	UploadRing::UploadRing(const std::span<std::byte> memory, const uint32_t framesInFlight) {
+		Init(memory, framesInFlight);
+	}
+
+	UploadRing::UploadRing(const size_t capacity, const uint32_t framesInFlight) {
+		// Over-allocate so the ring itself can start on a MaxAlignment boundary
+		const size_t rounded = (capacity + MaxAlignment - 1) / MaxAlignment * MaxAlignment;
+		m_owned.resize(rounded + MaxAlignment);
+
+		void*  base = m_owned.data();
+		size_t space = m_owned.size();
+		std::align(MaxAlignment, rounded, base, space);
+
+		Init(std::span(static_cast<std::byte*>(base), rounded), framesInFlight);
+	}
+
+	void UploadRing::Init(const std::span<std::byte> memory, const uint32_t framesInFlight) {
+		if (framesInFlight == 0 || framesInFlight > MaxFramesInFlight)
+			throw std::invalid_argument("UploadRing : framesInFlight must be between 1 and " + std::to_string(MaxFramesInFlight));
+		if (memory.empty() || memory.size() % MaxAlignment != 0 || reinterpret_cast<uintptr_t>(memory.data()) % MaxAlignment != 0)
+			throw std::invalid_argument("UploadRing : memory must be a non-empty, 256 byte aligned range");
+
+		m_memory = memory;
+		m_framesInFlight = framesInFlight;
+	}
+
+	UploadRing::Allocation UploadRing::Allocate(const size_t size, const size_t alignment) noexcept {
+		const uint64_t capacity = m_memory.size();
+		if (size == 0 || size > capacity || alignment == 0 || alignment > MaxAlignment || (alignment & (alignment - 1)))
+			return {};
+
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+		uint64_t start;
+		do {
+			start = (head + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+			// Never straddle the end of the buffer; skip to the start of the next lap instead
+			if (start % capacity + size > capacity)
+				start = (start / capacity + 1) * capacity;
+			if (start + size - m_tail > capacity)
+				return {};
+		} while (!m_head.compare_exchange_weak(head, start + size, std::memory_order_relaxed));
+
+		const uint64_t offset = start % capacity;
+		return { m_memory.data() + offset, offset, size };
+	}
+
+	void UploadRing::BeginFrame() noexcept {
+		++m_frame;
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+		// Only this thread writes the mark, so a plain compare is enough
+		if (const auto used = static_cast<size_t>(head - m_tail); used > m_highWater.load(std::memory_order_relaxed))
+			m_highWater.store(used, std::memory_order_relaxed);
+		m_frameStart[m_frame % m_framesInFlight] = head;
+		// The oldest frame still in flight began where the next slot recorded
+		m_tail = m_frameStart[(m_frame + 1) % m_framesInFlight];
+
+		// Nothing in flight: restart at the beginning of the buffer so large allocations need not wrap
+		if (m_tail == head && !m_memory.empty()) {
+			head = (head + m_memory.size() - 1) / m_memory.size() * m_memory.size();
+			m_head.store(head, std::memory_order_relaxed);
+			m_tail = head;
+			m_frameStart.fill(head);
+		}
+	}
+
+	size_t UploadRing::UsedBytes() const noexcept {
+		return static_cast<size_t>(m_head.load(std::memory_order_relaxed) - m_tail);
+	}
+
+} // namespace Zenyth
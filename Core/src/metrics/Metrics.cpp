@@ -0,0 +1,283 @@
+#include "pch.hpp"
+#include "metrics/Metrics.hpp"
+
+namespace Zenyth {
+
+	namespace {
+		bool IsValidName(const std::string_view name) noexcept {
+			if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front())))
+				return false;
+			return std::ranges::all_of(name, [](const char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':'; });
+		}
+
+		const char* TypeName(const MetricType type) noexcept {
+			switch (type) {
+				case MetricType::Counter:   return "counter";
+				case MetricType::Gauge:     return "gauge";
+				case MetricType::Histogram: return "histogram";
+			}
+			return "untyped";
+		}
+
+		std::string FormatValue(const double value) {
+			if (std::isnan(value))
+				return "NaN";
+			if (std::isinf(value))
+				return value > 0.0 ? "+Inf" : "-Inf";
+			return std::format("{}", value);
+		}
+
+		std::string SeriesName(const std::string_view name, const std::string_view labels, const std::string_view extra = {}) {
+			if (labels.empty() && extra.empty())
+				return std::string(name);
+			return std::format("{}{{{}{}{}}}", name, labels, !labels.empty() && !extra.empty() ? "," : "", extra);
+		}
+
+		template<typename T>
+		void Append(std::vector<std::byte>& out, const T value) {
+			const auto bytes = std::as_bytes(std::span(&value, 1));
+			out.insert(out.end(), bytes.begin(), bytes.end());
+		}
+	}
+
+#pragma region Values
+	void Gauge::SetMax(const double value) noexcept {
+		double current = m_value.load(std::memory_order_relaxed);
+		while (current < value && !m_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	}
+
+	Histogram::Histogram(const std::span<const double> bounds)
+		: m_bounds(bounds.begin(), bounds.end())
+		, m_buckets(std::make_unique<std::atomic<uint64_t>[]>(bounds.size() + 1))
+	{
+		if (!std::ranges::is_sorted(m_bounds) || std::ranges::adjacent_find(m_bounds) != m_bounds.end())
+			throw std::invalid_argument("Histogram : bounds must be strictly ascending");
+	}
+
+	void Histogram::Observe(const double value) noexcept {
+		const size_t bucket = std::ranges::lower_bound(m_bounds, value) - m_bounds.begin();
+		m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+		m_sum.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	Histogram::Snapshot Histogram::Read() const {
+		Snapshot snapshot;
+		snapshot.buckets.resize(m_bounds.size() + 1);
+		for (size_t i = 0; i < snapshot.buckets.size(); ++i)
+			snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+		snapshot.count = m_count.load(std::memory_order_relaxed);
+		snapshot.sum = m_sum.load(std::memory_order_relaxed);
+		return snapshot;
+	}
+
+	double Histogram::Quantile(const double q, const Snapshot& now, const Snapshot& before) const noexcept {
+		const auto delta = [&](const size_t i) {
+			const uint64_t old = i < before.buckets.size() ? before.buckets[i] : 0;
+			return now.buckets[i] > old ? now.buckets[i] - old : 0;
+		};
+
+		uint64_t total = 0;
+		for (size_t i = 0; i < now.buckets.size(); ++i)
+			total += delta(i);
+		if (total == 0)
+			return 0.0;
+
+		const double rank = std::clamp(q, 0.0, 1.0) * static_cast<double>(total);
+		double below = 0.0;
+		for (size_t i = 0; i < now.buckets.size(); ++i) {
+			const auto count = static_cast<double>(delta(i));
+			if (count > 0.0 && below + count >= rank) {
+				// The +Inf bucket has no upper edge; report the last finite one
+				if (i == m_bounds.size())
+					return m_bounds.empty() ? 0.0 : m_bounds.back();
+				const double lower = i == 0 ? 0.0 : m_bounds[i - 1];
+				return lower + (m_bounds[i] - lower) * std::clamp((rank - below) / count, 0.0, 1.0);
+			}
+			below += count;
+		}
+		return m_bounds.empty() ? 0.0 : m_bounds.back();
+	}
+
+	std::vector<double> Histogram::ExponentialBounds(const double start, const double factor, const uint32_t count) {
+		if (start <= 0.0 || factor <= 1.0)
+			throw std::invalid_argument("Histogram::ExponentialBounds : start must be positive and factor above 1");
+
+		std::vector<double> bounds(count);
+		double bound = start;
+		for (double& b : bounds) {
+			b = bound;
+			bound *= factor;
+		}
+		return bounds;
+	}
+#pragma endregion
+
+#pragma region MetricsRegistry
+	MetricsRegistry::Series& MetricsRegistry::AddSeries(const std::string_view name, const std::string_view help, const MetricType type, const std::string_view labels) {
+		if (!IsValidName(name))
+			throw std::invalid_argument("MetricsRegistry::Add : invalid metric name " + std::string(name));
+
+		auto family = std::ranges::find(m_families, name, &Family::name);
+		if (family == m_families.end()) {
+			family = m_families.insert(m_families.end(), Family{ std::string(name), std::string(help), type, {} });
+		}
+		else {
+			if (family->type != type)
+				throw std::invalid_argument("MetricsRegistry::Add : " + std::string(name) + " already registered with another type");
+			if (std::ranges::find(family->series, labels, &Series::labels) != family->series.end())
+				throw std::invalid_argument("MetricsRegistry::Add : duplicate series " + SeriesName(name, labels));
+		}
+
+		Series& series = family->series.emplace_back();
+		series.labels = labels;
+		return series;
+	}
+
+	Counter& MetricsRegistry::AddCounter(const std::string_view name, const std::string_view help, const std::string_view labels) {
+		std::lock_guard lock(m_mutex);
+		Series& series = AddSeries(name, help, MetricType::Counter, labels);
+		series.counter = std::make_unique<Counter>();
+		return *series.counter;
+	}
+
+	Gauge& MetricsRegistry::AddGauge(const std::string_view name, const std::string_view help, const std::string_view labels) {
+		std::lock_guard lock(m_mutex);
+		Series& series = AddSeries(name, help, MetricType::Gauge, labels);
+		series.gauge = std::make_unique<Gauge>();
+		return *series.gauge;
+	}
+
+	Histogram& MetricsRegistry::AddHistogram(const std::string_view name, const std::string_view help, const std::span<const double> bounds,
+		const std::string_view labels, const std::span<const double> quantiles)
+	{
+		auto histogram = std::make_unique<Histogram>(bounds);
+
+		std::lock_guard lock(m_mutex);
+		Series& series = AddSeries(name, help, MetricType::Histogram, labels);
+		series.histogram = std::move(histogram);
+		series.quantiles.assign(quantiles.begin(), quantiles.end());
+		series.lastQuantiles.resize(quantiles.size());
+		series.windowStart = std::chrono::steady_clock::now();
+		return *series.histogram;
+	}
+
+	void MetricsRegistry::AddCounterFn(const std::string_view name, const std::string_view help, Reader reader, const std::string_view labels) {
+		std::lock_guard lock(m_mutex);
+		AddSeries(name, help, MetricType::Counter, labels).reader = std::move(reader);
+	}
+
+	void MetricsRegistry::AddGaugeFn(const std::string_view name, const std::string_view help, Reader reader, const std::string_view labels) {
+		std::lock_guard lock(m_mutex);
+		AddSeries(name, help, MetricType::Gauge, labels).reader = std::move(reader);
+	}
+
+	void MetricsRegistry::SetQuantileWindow(const std::chrono::steady_clock::duration window) {
+		std::lock_guard lock(m_mutex);
+		m_quantileWindow = window;
+	}
+
+	size_t MetricsRegistry::SeriesCount() const {
+		std::lock_guard lock(m_mutex);
+		size_t count = 0;
+		for (const Family& family : m_families)
+			count += family.series.size();
+		return count;
+	}
+
+	template<typename Emit>
+	void MetricsRegistry::Collect(Emit&& emit) {
+		std::lock_guard lock(m_mutex);
+		const auto time = std::chrono::steady_clock::now();
+
+		std::vector<Sample> samples;
+		for (Family& family : m_families) {
+			samples.clear();
+			std::vector<Sample> quantiles;
+
+			for (Series& series : family.series) {
+				if (series.reader) {
+					samples.push_back({ SeriesName(family.name, series.labels), family.type, series.reader() });
+				}
+				else if (series.counter) {
+					samples.push_back({ SeriesName(family.name, series.labels), family.type, static_cast<double>(series.counter->Value()) });
+				}
+				else if (series.gauge) {
+					samples.push_back({ SeriesName(family.name, series.labels), family.type, series.gauge->Value() });
+				}
+				else if (series.histogram) {
+					const Histogram&          histogram = *series.histogram;
+					const Histogram::Snapshot now = histogram.Read();
+					const auto                bounds = histogram.Bounds();
+
+					// Exposition buckets are cumulative
+					uint64_t cumulative = 0;
+					for (size_t i = 0; i < now.buckets.size(); ++i) {
+						cumulative += now.buckets[i];
+						const std::string le = std::format("le=\"{}\"", i < bounds.size() ? FormatValue(bounds[i]) : "+Inf");
+						samples.push_back({ SeriesName(family.name + "_bucket", series.labels, le), family.type, static_cast<double>(cumulative) });
+					}
+					samples.push_back({ SeriesName(family.name + "_sum", series.labels), family.type, now.sum });
+					samples.push_back({ SeriesName(family.name + "_count", series.labels), family.type, static_cast<double>(cumulative) });
+
+					// Recomputed when a window closes, and on every call until the first one has
+					const bool close = time - series.windowStart >= m_quantileWindow;
+					const bool update = (close || !series.windowClosed) && now.count != series.previous.count;
+					for (size_t i = 0; i < series.quantiles.size(); ++i) {
+						const double q = series.quantiles[i];
+						if (update)
+							series.lastQuantiles[i] = histogram.Quantile(q, now, series.previous);
+						const std::string label = std::format("quantile=\"{}\"", FormatValue(q));
+						quantiles.push_back({ SeriesName(family.name + "_quantile", series.labels, label), MetricType::Gauge, series.lastQuantiles[i] });
+					}
+					if (close) {
+						series.previous = now;
+						series.windowStart = time;
+						series.windowClosed = true;
+					}
+				}
+			}
+
+			emit(family.name, family.help, family.type, samples);
+			if (!quantiles.empty())
+				emit(family.name + "_quantile", family.help + " (last quantile window)", MetricType::Gauge, quantiles);
+		}
+	}
+
+	std::string MetricsRegistry::FormatText() {
+		std::string text;
+		Collect([&text](const std::string_view name, const std::string_view help, const MetricType type, const std::span<const Sample> samples) {
+			text += std::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, TypeName(type));
+			for (const Sample& sample : samples)
+				text += std::format("{} {}\n", std::string_view(sample.series), FormatValue(sample.value));
+		});
+		return text;
+	}
+
+	std::vector<std::byte> MetricsRegistry::FormatBinary() {
+		std::vector<std::byte> out;
+		Append(out, BinaryMagic);
+		Append(out, BinaryVersion);
+		Append(out, uint16_t{ 0 });
+		Append(out, uint32_t{ 0 }); // patched below
+
+		uint32_t count = 0;
+		Collect([&](std::string_view, std::string_view, MetricType, const std::span<const Sample> samples) {
+			for (const Sample& sample : samples) {
+				const auto length = static_cast<uint16_t>(std::min<size_t>(sample.series.size(), UINT16_MAX));
+				Append(out, static_cast<uint8_t>(sample.type));
+				Append(out, uint8_t{ 0 });
+				Append(out, length);
+				const auto name = std::as_bytes(std::span(sample.series.data(), length));
+				out.insert(out.end(), name.begin(), name.end());
+				Append(out, sample.value);
+				++count;
+			}
+		});
+
+		std::memcpy(out.data() + 8, &count, sizeof(count));
+		return out;
+	}
+#pragma endregion
+
+} // namespace Zenyth
@@ -0,0 +1,307 @@
+#include "pch.hpp"
+#include "metrics/MetricsServer.hpp"
+#include "metrics/Metrics.hpp"
+
+#include <charconv>
+#include <climits>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace Zenyth {
+
+	namespace {
+#pragma region Sockets
+#ifdef _WIN32
+		using Socket = SOCKET;
+		constexpr Socket InvalidSocket = INVALID_SOCKET;
+		constexpr int    SendFlags = 0;
+
+		void CloseSocket(const Socket s) { ::closesocket(s); }
+		int  Poll(pollfd* fds, const ULONG count, const int timeoutMs) { return ::WSAPoll(fds, count, timeoutMs); }
+
+		// Winsock must be started once per process before any socket call
+		void EnsureSockets() {
+			static const int result = [] {
+				WSADATA data;
+				return ::WSAStartup(MAKEWORD(2, 2), &data);
+			}();
+			if (result != 0)
+				throw std::runtime_error("MetricsServer : WSAStartup failed");
+		}
+
+		// AF_UNIX socket files are reparse points with their own tag
+		bool IsSocketFile(const std::string& path) {
+			WIN32_FIND_DATAA data;
+			const HANDLE find = ::FindFirstFileA(path.c_str(), &data);
+			if (find == INVALID_HANDLE_VALUE)
+				return false;
+			::FindClose(find);
+			return (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0 && data.dwReserved0 == IO_REPARSE_TAG_AF_UNIX;
+		}
+#else
+		using Socket = int;
+		constexpr Socket InvalidSocket = -1;
+		constexpr int    SendFlags = MSG_NOSIGNAL;
+
+		void CloseSocket(const Socket s) { ::close(s); }
+		int  Poll(pollfd* fds, const nfds_t count, const int timeoutMs) { return ::poll(fds, count, timeoutMs); }
+		void EnsureSockets() {}
+
+		bool IsSocketFile(const std::string& path) {
+			std::error_code ec;
+			return std::filesystem::symlink_status(path, ec).type() == std::filesystem::file_type::socket;
+		}
+#endif
+
+		// Only ever unlinks a socket, so a mistyped endpoint cannot delete a regular file
+		void RemoveSocketFile(const std::string& path) {
+			std::error_code ec;
+			if (IsSocketFile(path))
+				std::filesystem::remove(path, ec);
+		}
+
+		constexpr std::string_view UnixPrefix = "unix:";
+		constexpr int              PollIntervalMs = 200; // bounds how long shutdown waits for the server thread
+		constexpr size_t           MaxRequestBytes = 8 * 1024;
+
+		struct Address {
+			sockaddr_storage storage{};
+			socklen_t        length = 0;
+			bool             isUnix = false;
+			std::string      unixPath;
+		};
+
+		Address ParseEndpoint(const std::string_view endpoint) {
+			Address address;
+
+			if (endpoint.starts_with(UnixPrefix)) {
+				address.unixPath = endpoint.substr(UnixPrefix.size());
+				auto& un = reinterpret_cast<sockaddr_un&>(address.storage);
+				if (address.unixPath.empty() || address.unixPath.size() >= sizeof(un.sun_path))
+					throw std::invalid_argument("MetricsServer : bad unix socket path in " + std::string(endpoint));
+				un.sun_family = AF_UNIX;
+				std::memcpy(un.sun_path, address.unixPath.data(), address.unixPath.size());
+				address.length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + address.unixPath.size() + 1);
+				address.isUnix = true;
+				return address;
+			}
+
+			const size_t colon = endpoint.rfind(':');
+			if (colon == std::string_view::npos)
+				throw std::invalid_argument("MetricsServer : endpoint must be host:port or unix:path, got " + std::string(endpoint));
+
+			std::string host(endpoint.substr(0, colon));
+			if (host.empty() || host == "localhost")
+				host = "127.0.0.1";
+
+			uint16_t port = 0;
+			const std::string_view portText = endpoint.substr(colon + 1);
+			if (std::from_chars(portText.data(), portText.data() + portText.size(), port).ec != std::errc{})
+				throw std::invalid_argument("MetricsServer : bad port in " + std::string(endpoint));
+
+			auto& in = reinterpret_cast<sockaddr_in&>(address.storage);
+			in.sin_family = AF_INET;
+			in.sin_port = htons(port);
+			if (::inet_pton(AF_INET, host.c_str(), &in.sin_addr) != 1)
+				throw std::invalid_argument("MetricsServer : bad IPv4 address in " + std::string(endpoint));
+			address.length = sizeof(sockaddr_in);
+			return address;
+		}
+
+		bool SendAll(const Socket s, const char* data, size_t size) {
+			while (size > 0) {
+				const auto sent = ::send(s, data, static_cast<int>(std::min<size_t>(size, INT_MAX)), SendFlags);
+				if (sent <= 0)
+					return false;
+				data += sent;
+				size -= static_cast<size_t>(sent);
+			}
+			return true;
+		}
+
+		// Reads until the peer closes, or until the end of the request head when stopAtHead is set
+		std::string Receive(const Socket s, const bool stopAtHead) {
+			std::string data;
+			char chunk[4096];
+			while (true) {
+				const auto received = ::recv(s, chunk, sizeof(chunk), 0);
+				if (received <= 0)
+					break;
+				data.append(chunk, static_cast<size_t>(received));
+				if (stopAtHead && (data.find("\r\n\r\n") != std::string::npos || data.size() >= MaxRequestBytes))
+					break;
+			}
+			return data;
+		}
+
+		void SetReceiveTimeout(const Socket s, const int milliseconds) {
+#ifdef _WIN32
+			const DWORD timeout = milliseconds;
+#else
+			const timeval timeout{ milliseconds / 1000, (milliseconds % 1000) * 1000 };
+#endif
+			::setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+		}
+#pragma endregion
+	}
+
+#pragma region MetricsServer
+	MetricsServer::MetricsServer(MetricsRegistry& registry, const MetricsServerDesc& desc)
+		: m_registry(registry)
+	{
+		EnsureSockets();
+		Address address = ParseEndpoint(desc.endpoint);
+
+		std::error_code ec;
+		if (address.isUnix && std::filesystem::exists(std::filesystem::symlink_status(address.unixPath, ec))) {
+			// A socket file left behind by a previous run would fail the bind; anything else is not ours
+			if (!IsSocketFile(address.unixPath))
+				throw std::runtime_error("MetricsServer : " + address.unixPath + " exists and is not a socket");
+			std::filesystem::remove(address.unixPath, ec);
+		}
+
+		const Socket listener = ::socket(address.storage.ss_family, SOCK_STREAM, 0);
+		if (listener == InvalidSocket)
+			throw std::runtime_error("MetricsServer : could not create socket for " + desc.endpoint);
+
+		if (!address.isUnix) {
+			const int reuse = 1;
+			::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+		}
+
+		if (::bind(listener, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 || ::listen(listener, 8) != 0) {
+			CloseSocket(listener);
+			throw std::runtime_error("MetricsServer : could not listen on " + desc.endpoint);
+		}
+
+		if (address.isUnix) {
+			m_unixPath = address.unixPath;
+			m_endpoint = desc.endpoint;
+		}
+		else {
+			sockaddr_in bound{};
+			socklen_t   length = sizeof(bound);
+			::getsockname(listener, reinterpret_cast<sockaddr*>(&bound), &length);
+			char host[INET_ADDRSTRLEN] = {};
+			::inet_ntop(AF_INET, &bound.sin_addr, host, sizeof(host));
+			m_endpoint = std::format("{}:{}", std::string_view(host), ntohs(bound.sin_port));
+		}
+
+		m_listener = static_cast<intptr_t>(listener);
+		m_thread = std::thread(&MetricsServer::Serve, this);
+	}
+
+	MetricsServer::~MetricsServer() {
+		m_running.store(false, std::memory_order_relaxed);
+		if (m_thread.joinable())
+			m_thread.join();
+
+		CloseSocket(static_cast<Socket>(m_listener));
+		if (!m_unixPath.empty())
+			RemoveSocketFile(m_unixPath);
+	}
+
+	void MetricsServer::Serve() {
+		pollfd listener{};
+		listener.fd = static_cast<Socket>(m_listener);
+		listener.events = POLLIN;
+
+		while (m_running.load(std::memory_order_relaxed)) {
+			listener.revents = 0;
+			if (Poll(&listener, 1, PollIntervalMs) <= 0 || (listener.revents & POLLIN) == 0)
+				continue;
+
+			const Socket client = ::accept(listener.fd, nullptr, nullptr);
+			if (client == InvalidSocket)
+				continue;
+
+			Respond(static_cast<intptr_t>(client));
+			CloseSocket(client);
+		}
+	}
+
+	void MetricsServer::Respond(const intptr_t client) {
+		const auto socket = static_cast<Socket>(client);
+		// A stalled client must not keep the server from noticing shutdown for long
+		SetReceiveTimeout(socket, 1000);
+
+		const std::string request = Receive(socket, true);
+		std::string_view  line = std::string_view(request).substr(0, request.find("\r\n"));
+
+		std::string_view path;
+		if (line.starts_with("GET ")) {
+			line.remove_prefix(4);
+			path = line.substr(0, line.find(' '));
+			path = path.substr(0, path.find('?'));
+		}
+
+		std::string_view status = "200 OK";
+		std::string_view contentType;
+		std::string      body;
+		if (path == "/metrics") {
+			contentType = "text/plain; version=0.0.4; charset=utf-8";
+			body = m_registry.FormatText();
+		}
+		else if (path == "/metrics.bin") {
+			contentType = "application/octet-stream";
+			const std::vector<std::byte> binary = m_registry.FormatBinary();
+			body.assign(reinterpret_cast<const char*>(binary.data()), binary.size());
+		}
+		else {
+			status = "404 Not Found";
+			contentType = "text/plain";
+			body = "not found\n";
+		}
+
+		if (status.starts_with("200"))
+			m_scrapes.fetch_add(1, std::memory_order_relaxed);
+
+		const std::string head = std::format("HTTP/1.0 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\nConnection: close\r\n\r\n",
+			status, contentType, body.size());
+		if (SendAll(socket, head.data(), head.size()))
+			SendAll(socket, body.data(), body.size());
+	}
+#pragma endregion
+
+	std::string ScrapeMetrics(const std::string_view endpoint, const std::string_view path) {
+		EnsureSockets();
+		const Address address = ParseEndpoint(endpoint);
+
+		const Socket s = ::socket(address.storage.ss_family, SOCK_STREAM, 0);
+		if (s == InvalidSocket)
+			throw std::runtime_error("ScrapeMetrics : could not create socket");
+
+		if (::connect(s, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0) {
+			CloseSocket(s);
+			throw std::runtime_error("ScrapeMetrics : could not connect to " + std::string(endpoint));
+		}
+
+		const std::string request = std::format("GET {} HTTP/1.0\r\nHost: zenyth\r\n\r\n", path);
+		SetReceiveTimeout(s, 5000);
+		const bool sent = SendAll(s, request.data(), request.size());
+		const std::string response = sent ? Receive(s, false) : std::string();
+		CloseSocket(s);
+
+		const size_t bodyStart = response.find("\r\n\r\n");
+		if (bodyStart == std::string::npos)
+			throw std::runtime_error("ScrapeMetrics : malformed response from " + std::string(endpoint));
+
+		const std::string_view statusLine = std::string_view(response).substr(0, response.find("\r\n"));
+		if (statusLine.find(" 200 ") == std::string_view::npos)
+			throw std::runtime_error("ScrapeMetrics : " + std::string(statusLine));
+
+		return response.substr(bodyStart + 4);
+	}
+
+} // namespace Zenyth
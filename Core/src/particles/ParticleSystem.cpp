@@ -0,0 +1,425 @@
+#include "pch.hpp"
+#include "particles/ParticleSystem.hpp"
+#include "CpuFeatures.hpp"
+
+#include <bit>
+#include <immintrin.h>
+
+using namespace zenyth::math;
+
+namespace Zenyth {
+
+	namespace {
+		constexpr uint32_t Width = 8;
+
+		// Raw attribute pointers handed to the kernels
+		struct Streams {
+			float*    posX;
+			float*    posY;
+			float*    posZ;
+			float*    velX;
+			float*    velY;
+			float*    velZ;
+			float*    age;
+			float*    invLifetime;
+			float*    size;
+			uint32_t* color;
+		};
+
+		// Rounds to nearest even like _mm256_cvtps_epi32 in PackColor8, so both paths agree on ties
+		uint32_t PackColor(const float r, const float g, const float b, const float a) noexcept {
+			const auto channel = [](const float v) { return static_cast<uint32_t>(std::lrint(std::clamp(v, 0.0f, 1.0f) * 255.0f)); };
+			return channel(r) | channel(g) << 8 | channel(b) << 16 | channel(a) << 24;
+		}
+
+#pragma region Scalar
+		// Reference path; also what runs on CPUs without AVX2
+		uint32_t SimulateScalar(const Streams& s, const uint32_t count, const EmitterDesc& d, const float dt) noexcept {
+			uint32_t out = 0;
+
+			for (uint32_t i = 0; i < count; ++i) {
+				float p[3] = { s.posX[i], s.posY[i], s.posZ[i] };
+				float v[3] = { s.velX[i], s.velY[i], s.velZ[i] };
+
+				float a[3] = { d.gravity[0] - d.drag * v[0], d.gravity[1] - d.drag * v[1], d.gravity[2] - d.drag * v[2] };
+				for (const ParticleAttractor& attractor : d.attractors) {
+					const float delta[3] = { attractor.center[0] - p[0], attractor.center[1] - p[1], attractor.center[2] - p[2] };
+					const float d2 = delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2] + 1.0f;
+					const float scale = attractor.strength / (d2 * std::sqrt(d2));
+					for (uint32_t k = 0; k < 3; ++k)
+						a[k] += delta[k] * scale;
+				}
+				for (uint32_t k = 0; k < 3; ++k) {
+					v[k] += a[k] * dt;
+					p[k] += v[k] * dt;
+				}
+
+				const auto bounce = [&](const float* n, const float penetration) {
+					const float vn = n[0] * v[0] + n[1] * v[1] + n[2] * v[2];
+					for (uint32_t k = 0; k < 3; ++k)
+						p[k] -= n[k] * penetration;
+					if (vn < 0.0f) {
+						for (uint32_t k = 0; k < 3; ++k)
+							v[k] = (v[k] - n[k] * vn) * (1.0f - d.friction) - n[k] * vn * d.restitution;
+					}
+				};
+
+				for (const ParticlePlane& plane : d.planes) {
+					const float dist = plane.normal[0] * p[0] + plane.normal[1] * p[1] + plane.normal[2] * p[2] + plane.distance;
+					if (dist < 0.0f)
+						bounce(plane.normal, dist);
+				}
+				for (const ParticleSphere& sphere : d.spheres) {
+					const float delta[3] = { p[0] - sphere.center[0], p[1] - sphere.center[1], p[2] - sphere.center[2] };
+					const float d2 = delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2];
+					if (d2 < sphere.radius * sphere.radius) {
+						const float length = std::sqrt(std::max(d2, 1e-12f));
+						const float n[3] = { delta[0] / length, delta[1] / length, delta[2] / length };
+						bounce(n, length - sphere.radius);
+					}
+				}
+
+				const float age = s.age[i] + dt;
+				const float t = age * s.invLifetime[i];
+
+				// Always written, only kept when alive: the output cursor advances by 0 or 1
+				s.posX[out] = p[0]; s.posY[out] = p[1]; s.posZ[out] = p[2];
+				s.velX[out] = v[0]; s.velY[out] = v[1]; s.velZ[out] = v[2];
+				s.age[out] = age;
+				s.invLifetime[out] = s.invLifetime[i];
+				s.size[out] = d.sizeStart + (d.sizeEnd - d.sizeStart) * t;
+				s.color[out] = PackColor(
+					d.colorStart[0] + (d.colorEnd[0] - d.colorStart[0]) * t,
+					d.colorStart[1] + (d.colorEnd[1] - d.colorStart[1]) * t,
+					d.colorStart[2] + (d.colorEnd[2] - d.colorStart[2]) * t,
+					d.colorStart[3] + (d.colorEnd[3] - d.colorStart[3]) * t);
+				out += t < 1.0f ? 1u : 0u;
+			}
+
+			return out;
+		}
+#pragma endregion
+
+#pragma region AVX2
+		// Lane permutations that move the lanes set in an 8-bit mask to the front, in order
+		struct CompactTable {
+			alignas(32) uint32_t lanes[256][Width];
+
+			constexpr CompactTable() : lanes{} {
+				for (uint32_t mask = 0; mask < 256; ++mask) {
+					uint32_t next = 0;
+					for (uint32_t lane = 0; lane < Width; ++lane) {
+						if (mask & (1u << lane))
+							lanes[mask][next++] = lane;
+					}
+					// Unused lanes repeat lane 0; they are overwritten by the next group
+					while (next < Width)
+						lanes[mask][next++] = 0;
+				}
+			}
+		};
+
+		constexpr CompactTable Compact{};
+
+		// Pushes points out along n and reflects the normal velocity component where the mask is set
+		ZENYTH_TARGET_AVX2 void Bounce8(const __m256 hit, const __m256 nx, const __m256 ny, const __m256 nz, const __m256 penetration,
+			__m256 p[3], __m256 v[3], const __m256 keepTangent, const __m256 restitution) noexcept
+		{
+			const __m256 push = _mm256_and_ps(hit, penetration);
+			p[0] = _mm256_fnmadd_ps(nx, push, p[0]);
+			p[1] = _mm256_fnmadd_ps(ny, push, p[1]);
+			p[2] = _mm256_fnmadd_ps(nz, push, p[2]);
+
+			const __m256 vn = _mm256_fmadd_ps(nx, v[0], _mm256_fmadd_ps(ny, v[1], _mm256_mul_ps(nz, v[2])));
+			const __m256 approaching = _mm256_and_ps(hit, _mm256_cmp_ps(vn, _mm256_setzero_ps(), _CMP_LT_OQ));
+			const __m256 n[3] = { nx, ny, nz };
+			const __m256 normalScale = _mm256_mul_ps(vn, restitution);
+			for (uint32_t k = 0; k < 3; ++k) {
+				const __m256 tangent = _mm256_fnmadd_ps(n[k], vn, v[k]);
+				const __m256 bounced = _mm256_fnmadd_ps(n[k], normalScale, _mm256_mul_ps(tangent, keepTangent));
+				v[k] = _mm256_blendv_ps(v[k], bounced, approaching);
+			}
+		}
+
+		ZENYTH_TARGET_AVX2 __m256i PackColor8(const __m256 t, const EmitterDesc& d) noexcept {
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 zero = _mm256_setzero_ps();
+			__m256i packed = _mm256_setzero_si256();
+			for (uint32_t c = 0; c < 4; ++c) {
+				const __m256 start = _mm256_set1_ps(d.colorStart[c]);
+				__m256 value = _mm256_fmadd_ps(_mm256_set1_ps(d.colorEnd[c] - d.colorStart[c]), t, start);
+				value = _mm256_min_ps(_mm256_max_ps(value, zero), one);
+				const __m256i byte = _mm256_cvtps_epi32(_mm256_mul_ps(value, _mm256_set1_ps(255.0f)));
+				packed = _mm256_or_si256(packed, _mm256_slli_epi32(byte, static_cast<int>(c * 8)));
+			}
+			return packed;
+		}
+
+		ZENYTH_TARGET_AVX2 void StorePacked(float* dst, const __m256 value, const __m256i permute) noexcept {
+			_mm256_storeu_ps(dst, _mm256_permutevar8x32_ps(value, permute));
+		}
+
+		ZENYTH_TARGET_AVX2 uint32_t SimulateAvx2(const Streams& s, const uint32_t count, const EmitterDesc& d, const float dt) noexcept {
+			const __m256 vdt = _mm256_set1_ps(dt);
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 drag = _mm256_set1_ps(d.drag);
+			const __m256 gravity[3] = { _mm256_set1_ps(d.gravity[0]), _mm256_set1_ps(d.gravity[1]), _mm256_set1_ps(d.gravity[2]) };
+			const __m256 keepTangent = _mm256_set1_ps(1.0f - d.friction);
+			const __m256 restitution = _mm256_set1_ps(d.restitution);
+			const __m256 sizeStart = _mm256_set1_ps(d.sizeStart);
+			const __m256 sizeDelta = _mm256_set1_ps(d.sizeEnd - d.sizeStart);
+			const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+			uint32_t out = 0;
+			for (uint32_t i = 0; i < count; i += Width) {
+				__m256 p[3] = { _mm256_loadu_ps(s.posX + i), _mm256_loadu_ps(s.posY + i), _mm256_loadu_ps(s.posZ + i) };
+				__m256 v[3] = { _mm256_loadu_ps(s.velX + i), _mm256_loadu_ps(s.velY + i), _mm256_loadu_ps(s.velZ + i) };
+
+				__m256 a[3];
+				for (uint32_t k = 0; k < 3; ++k)
+					a[k] = _mm256_fnmadd_ps(drag, v[k], gravity[k]);
+
+				for (const ParticleAttractor& attractor : d.attractors) {
+					const __m256 dx = _mm256_sub_ps(_mm256_set1_ps(attractor.center[0]), p[0]);
+					const __m256 dy = _mm256_sub_ps(_mm256_set1_ps(attractor.center[1]), p[1]);
+					const __m256 dz = _mm256_sub_ps(_mm256_set1_ps(attractor.center[2]), p[2]);
+					const __m256 d2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_fmadd_ps(dz, dz, one)));
+					const __m256 scale = _mm256_div_ps(_mm256_set1_ps(attractor.strength), _mm256_mul_ps(d2, _mm256_sqrt_ps(d2)));
+					a[0] = _mm256_fmadd_ps(dx, scale, a[0]);
+					a[1] = _mm256_fmadd_ps(dy, scale, a[1]);
+					a[2] = _mm256_fmadd_ps(dz, scale, a[2]);
+				}
+
+				for (uint32_t k = 0; k < 3; ++k) {
+					v[k] = _mm256_fmadd_ps(a[k], vdt, v[k]);
+					p[k] = _mm256_fmadd_ps(v[k], vdt, p[k]);
+				}
+
+				for (const ParticlePlane& plane : d.planes) {
+					const __m256 nx = _mm256_set1_ps(plane.normal[0]);
+					const __m256 ny = _mm256_set1_ps(plane.normal[1]);
+					const __m256 nz = _mm256_set1_ps(plane.normal[2]);
+					const __m256 dist = _mm256_fmadd_ps(nx, p[0], _mm256_fmadd_ps(ny, p[1], _mm256_fmadd_ps(nz, p[2], _mm256_set1_ps(plane.distance))));
+					const __m256 hit = _mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_LT_OQ);
+					Bounce8(hit, nx, ny, nz, dist, p, v, keepTangent, restitution);
+				}
+
+				for (const ParticleSphere& sphere : d.spheres) {
+					const __m256 dx = _mm256_sub_ps(p[0], _mm256_set1_ps(sphere.center[0]));
+					const __m256 dy = _mm256_sub_ps(p[1], _mm256_set1_ps(sphere.center[1]));
+					const __m256 dz = _mm256_sub_ps(p[2], _mm256_set1_ps(sphere.center[2]));
+					const __m256 d2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+					const __m256 radius = _mm256_set1_ps(sphere.radius);
+					const __m256 hit = _mm256_cmp_ps(d2, _mm256_mul_ps(radius, radius), _CMP_LT_OQ);
+					if (_mm256_testz_ps(hit, hit))
+						continue;
+
+					const __m256 length = _mm256_sqrt_ps(_mm256_max_ps(d2, _mm256_set1_ps(1e-12f)));
+					const __m256 inv = _mm256_div_ps(one, length);
+					Bounce8(hit, _mm256_mul_ps(dx, inv), _mm256_mul_ps(dy, inv), _mm256_mul_ps(dz, inv),
+						_mm256_sub_ps(length, radius), p, v, keepTangent, restitution);
+				}
+
+				const __m256 age = _mm256_add_ps(_mm256_loadu_ps(s.age + i), vdt);
+				const __m256 invLifetime = _mm256_loadu_ps(s.invLifetime + i);
+				const __m256 t = _mm256_mul_ps(age, invLifetime);
+
+				// Alive and not past the end of the pool: the padding lanes of the last group hold garbage
+				const __m256 inRange = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count - i)), laneIndex));
+				const __m256 alive = _mm256_and_ps(_mm256_cmp_ps(t, one, _CMP_LT_OQ), inRange);
+				const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(alive));
+
+				// Left-pack the survivors; out <= i, so the store never reaches unread particles
+				const __m256i permute = _mm256_load_si256(reinterpret_cast<const __m256i*>(Compact.lanes[mask]));
+				StorePacked(s.posX + out, p[0], permute); StorePacked(s.posY + out, p[1], permute); StorePacked(s.posZ + out, p[2], permute);
+				StorePacked(s.velX + out, v[0], permute); StorePacked(s.velY + out, v[1], permute); StorePacked(s.velZ + out, v[2], permute);
+				StorePacked(s.age + out, age, permute);
+				StorePacked(s.invLifetime + out, invLifetime, permute);
+				StorePacked(s.size + out, _mm256_fmadd_ps(sizeDelta, t, sizeStart), permute);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(s.color + out), _mm256_permutevar8x32_epi32(PackColor8(t, d), permute));
+
+				out += static_cast<uint32_t>(std::popcount(mask));
+			}
+
+			return out;
+		}
+#pragma endregion
+
+		using SimulateFn = uint32_t (*)(const Streams&, uint32_t, const EmitterDesc&, float) noexcept;
+
+		SimulateFn SelectSimulate() noexcept {
+			const CpuFeatures& cpu = GetCpuFeatures();
+			return cpu.avx2 && cpu.fma ? SimulateAvx2 : SimulateScalar;
+		}
+
+		// Order-preserving map from float to unsigned
+		uint32_t SortableKey(const float value) noexcept {
+			const uint32_t bits = std::bit_cast<uint32_t>(value);
+			return bits ^ (bits & 0x80000000u ? 0xFFFFFFFFu : 0x80000000u);
+		}
+	}
+
+	ParticleEmitter::ParticleEmitter(EmitterDesc desc, const uint32_t seed)
+		: m_desc(std::move(desc)), m_rng(seed ? seed : 1)
+	{
+		if (m_desc.capacity == 0)
+			throw std::invalid_argument("ParticleEmitter : capacity must be positive");
+		if (m_desc.lifetimeMin <= 0.0f || m_desc.lifetimeMax < m_desc.lifetimeMin)
+			throw std::invalid_argument("ParticleEmitter : lifetimes must be positive and ordered");
+
+		const size_t padded = (static_cast<size_t>(m_desc.capacity) + Width - 1) / Width * Width;
+		for (auto* stream : { &m_posX, &m_posY, &m_posZ, &m_velX, &m_velY, &m_velZ, &m_age, &m_invLifetime, &m_size })
+			stream->resize(padded);
+		m_color.resize(padded);
+	}
+
+	float ParticleEmitter::Random() noexcept {
+		// xorshift32: cheap, and deterministic per emitter
+		m_rng ^= m_rng << 13;
+		m_rng ^= m_rng >> 17;
+		m_rng ^= m_rng << 5;
+		return static_cast<float>(m_rng >> 8) * (1.0f / 16777216.0f);
+	}
+
+	void ParticleEmitter::Update(const float dt) {
+		static const SimulateFn simulate = SelectSimulate();
+
+		if (m_count > 0) {
+			const Streams streams{
+				m_posX.data(), m_posY.data(), m_posZ.data(),
+				m_velX.data(), m_velY.data(), m_velZ.data(),
+				m_age.data(), m_invLifetime.data(), m_size.data(), m_color.data()
+			};
+			m_count = simulate(streams, m_count, m_desc, dt);
+		}
+		m_sorted.clear();
+
+		m_spawnAccumulator += m_desc.rate * dt;
+		const auto spawn = static_cast<uint32_t>(m_spawnAccumulator);
+		m_spawnAccumulator -= static_cast<float>(spawn);
+		Emit(spawn);
+	}
+
+	uint32_t ParticleEmitter::Emit(const uint32_t count) {
+		const uint32_t spawned = std::min(count, m_desc.capacity - m_count);
+		const uint32_t color = PackColor(m_desc.colorStart[0], m_desc.colorStart[1], m_desc.colorStart[2], m_desc.colorStart[3]);
+
+		for (uint32_t n = 0; n < spawned; ++n) {
+			const uint32_t i = m_count + n;
+
+			// Rejection sample the unit ball for both the spawn offset and the velocity jitter
+			float offset[3], jitter[3];
+			for (float* out : { offset, jitter }) {
+				do {
+					for (uint32_t k = 0; k < 3; ++k)
+						out[k] = Random() * 2.0f - 1.0f;
+				} while (out[0] * out[0] + out[1] * out[1] + out[2] * out[2] > 1.0f);
+			}
+
+			m_posX[i] = m_desc.position[0] + offset[0] * m_desc.spawnRadius;
+			m_posY[i] = m_desc.position[1] + offset[1] * m_desc.spawnRadius;
+			m_posZ[i] = m_desc.position[2] + offset[2] * m_desc.spawnRadius;
+			m_velX[i] = m_desc.velocity[0] + jitter[0] * m_desc.velocitySpread;
+			m_velY[i] = m_desc.velocity[1] + jitter[1] * m_desc.velocitySpread;
+			m_velZ[i] = m_desc.velocity[2] + jitter[2] * m_desc.velocitySpread;
+			m_age[i] = 0.0f;
+			m_invLifetime[i] = 1.0f / (m_desc.lifetimeMin + (m_desc.lifetimeMax - m_desc.lifetimeMin) * Random());
+			m_size[i] = m_desc.sizeStart;
+			m_color[i] = color;
+		}
+
+		m_count += spawned;
+		m_sorted.clear();
+		return spawned;
+	}
+
+	void ParticleEmitter::SortBackToFront(const vec3& eye, const vec3& forward) {
+		const uint32_t count = m_count;
+		m_sortKeys.resize(count);
+		m_sortKeyScratch.resize(count);
+		m_sorted.resize(count);
+		m_sortScratch.resize(count);
+
+		// Far particles first: invert the ascending depth key
+		for (uint32_t i = 0; i < count; ++i) {
+			const float depth = (m_posX[i] - eye.x()) * forward.x() + (m_posY[i] - eye.y()) * forward.y() + (m_posZ[i] - eye.z()) * forward.z();
+			m_sortKeys[i] = ~SortableKey(depth);
+			m_sorted[i] = i;
+		}
+
+		// LSD radix sort, 8 bits per pass; all four histograms come from one read of the keys
+		uint32_t histogram[4][256] = {};
+		for (const uint32_t key : m_sortKeys)
+			for (uint32_t pass = 0; pass < 4; ++pass)
+				++histogram[pass][(key >> (pass * 8)) & 0xFF];
+
+		uint32_t* keys = m_sortKeys.data();
+		uint32_t* values = m_sorted.data();
+		uint32_t* keysOut = m_sortKeyScratch.data();
+		uint32_t* valuesOut = m_sortScratch.data();
+
+		for (uint32_t pass = 0; pass < 4; ++pass) {
+			const uint32_t shift = pass * 8;
+			// Every key shares this digit: the pass would not move anything
+			if (count == 0 || histogram[pass][(keys[0] >> shift) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram[pass]) {
+				const uint32_t n = bucket;
+				bucket = offset;
+				offset += n;
+			}
+			for (uint32_t i = 0; i < count; ++i) {
+				const uint32_t slot = histogram[pass][(keys[i] >> shift) & 0xFF]++;
+				keysOut[slot] = keys[i];
+				valuesOut[slot] = values[i];
+			}
+			std::swap(keys, keysOut);
+			std::swap(values, valuesOut);
+		}
+
+		if (values != m_sorted.data())
+			std::copy_n(values, count, m_sorted.data());
+	}
+
+	ParticleEmitter& ParticleSystem::CreateEmitter(EmitterDesc desc) {
+		return *m_emitters.emplace_back(std::make_unique<ParticleEmitter>(std::move(desc), m_nextSeed++ * 0x9E3779B9u));
+	}
+
+	void ParticleSystem::DestroyEmitter(const ParticleEmitter& emitter) {
+		std::erase_if(m_emitters, [&](const std::unique_ptr<ParticleEmitter>& e) { return e.get() == &emitter; });
+	}
+
+	void ParticleSystem::Update(const float dt, JobSystem* jobs) {
+		const auto update = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				m_emitters[i]->Update(dt);
+		};
+
+		if (jobs)
+			jobs->ParallelFor(EmitterCount(), 1, update);
+		else
+			update(0, EmitterCount());
+	}
+
+	void ParticleSystem::SortBackToFront(const vec3& eye, const vec3& forward, JobSystem* jobs) {
+		const auto sort = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				m_emitters[i]->SortBackToFront(eye, forward);
+		};
+
+		if (jobs)
+			jobs->ParallelFor(EmitterCount(), 1, sort);
+		else
+			sort(0, EmitterCount());
+	}
+
+	uint32_t ParticleSystem::ParticleCount() const noexcept {
+		uint32_t total = 0;
+		for (const auto& emitter : m_emitters)
+			total += emitter->Count();
+		return total;
+	}
+
+} // namespace Zenyth
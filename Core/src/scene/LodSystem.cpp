@@ -0,0 +1,316 @@
+#include "pch.hpp"
+#include "scene/LodSystem.hpp"
+
+#include <immintrin.h>
+
+namespace Zenyth {
+
+	using namespace zenyth::math;
+
+	namespace {
+		constexpr float    Infinity = std::numeric_limits<float>::infinity();
+		// Keeps the camera inside a bounding sphere from dividing by zero; it selects level 0 anyway
+		constexpr float    MinDistance = 1e-3f;
+		// Coarsest levels load before any refinement
+		constexpr float    BasePriority = std::numeric_limits<float>::max();
+
+		constexpr uint32_t Padded(const uint32_t count) noexcept { return (count + 3) & ~3u; }
+	}
+
+	LodSystem::LodSystem(AssetStreamer* streamer, const LodSettings& settings)
+		: m_streamer(streamer)
+		, m_settings(settings)
+	{
+	}
+
+	LodSystem::~LodSystem() {
+		if (!m_streamer)
+			return;
+		for (uint32_t i = 0; i < m_count; ++i) {
+			if (m_held[i] != InvalidAsset)
+				m_streamer->Release(m_held[i]);
+			if (m_base[i] != InvalidAsset)
+				m_streamer->Release(m_base[i]);
+		}
+	}
+
+#pragma region Objects
+	LodHandle LodSystem::Add(const std::span<const LodLevel> levels, const vec3& center, const float radius) {
+		if (levels.empty() || levels.size() > MaxLevels)
+			throw std::invalid_argument("LodSystem::Add : a chain needs 1 to MaxLevels levels");
+		if (levels.front().error < 0.0f || !std::ranges::is_sorted(levels, {}, &LodLevel::error))
+			throw std::invalid_argument("LodSystem::Add : level errors must be non-negative and non-decreasing");
+
+		LodHandle handle;
+		if (!m_freeHandles.empty()) {
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		else {
+			handle = static_cast<LodHandle>(m_handleToDense.size());
+			m_handleToDense.push_back(NoIndex);
+		}
+
+		const uint32_t index = m_count;
+		Resize(m_count + 1);
+		m_handleToDense[handle] = index;
+		m_denseToHandle[index] = handle;
+
+		m_centerX[index] = center.x();
+		m_centerY[index] = center.y();
+		m_centerZ[index] = center.z();
+		m_radius[index] = radius;
+		for (uint32_t l = 0; l < levels.size(); ++l) {
+			m_error[l][index] = levels[l].error;
+			m_assets[index][l] = levels[l].asset;
+		}
+		// Starting at the coarsest level lets the first Update() refine straight to the right one
+		m_level[index] = static_cast<int32_t>(levels.size() - 1);
+
+		if (m_streamer && levels.back().asset != 0)
+			m_base[index] = m_streamer->Request(levels.back().asset, BasePriority);
+		return handle;
+	}
+
+	void LodSystem::Remove(const LodHandle handle) {
+		const uint32_t index = Dense(handle);
+		if (m_streamer) {
+			if (m_held[index] != InvalidAsset)
+				m_streamer->Release(m_held[index]);
+			if (m_base[index] != InvalidAsset)
+				m_streamer->Release(m_base[index]);
+		}
+
+		const uint32_t last = m_count - 1;
+		if (index != last) {
+			Move(last, index);
+			m_handleToDense[m_denseToHandle[index]] = index;
+		}
+		Clear(last);
+		Resize(last);
+
+		m_handleToDense[handle] = NoIndex;
+		m_freeHandles.push_back(handle);
+	}
+
+	void LodSystem::SetBounds(const LodHandle handle, const vec3& center, const float radius) {
+		const uint32_t index = Dense(handle);
+		m_centerX[index] = center.x();
+		m_centerY[index] = center.y();
+		m_centerZ[index] = center.z();
+		m_radius[index] = radius;
+	}
+
+	uint32_t LodSystem::GetLevel(const LodHandle handle) const {
+		return static_cast<uint32_t>(m_level[Dense(handle)]);
+	}
+
+	float LodSystem::GetScreenError(const LodHandle handle) const {
+		return m_screenError[Dense(handle)];
+	}
+
+	float LodSystem::GetPriority(const LodHandle handle) const {
+		return m_priority[Dense(handle)];
+	}
+
+	AssetHandle LodSystem::GetAsset(const LodHandle handle) const {
+		const uint32_t index = Dense(handle);
+		return IsCoarsest(index, m_level[index]) ? m_base[index] : m_held[index];
+	}
+
+	bool LodSystem::IsValid(const LodHandle handle) const noexcept {
+		return handle < m_handleToDense.size() && m_handleToDense[handle] != NoIndex;
+	}
+
+	bool LodSystem::IsCoarsest(const uint32_t index, const int32_t level) const noexcept {
+		return level + 1 == static_cast<int32_t>(MaxLevels) || std::isinf(m_error[level + 1][index]);
+	}
+
+	uint32_t LodSystem::Dense(const LodHandle handle) const {
+		if (!IsValid(handle))
+			throw std::runtime_error("LodSystem : invalid LOD handle");
+		return m_handleToDense[handle];
+	}
+
+	void LodSystem::Resize(const uint32_t count) {
+		const uint32_t oldSize = Padded(m_count);
+		const uint32_t size = Padded(count);
+
+		m_centerX.resize(size);
+		m_centerY.resize(size);
+		m_centerZ.resize(size);
+		m_radius.resize(size);
+		for (std::vector<float>& error : m_error)
+			error.resize(size);
+		m_level.resize(size);
+		m_screenError.resize(size);
+		m_priority.resize(size);
+		m_assets.resize(size);
+		m_held.resize(size);
+		m_heldLevel.resize(size);
+		m_base.resize(size);
+		m_denseToHandle.resize(size);
+
+		for (uint32_t i = oldSize; i < size; ++i)
+			Clear(i);
+		m_count = count;
+	}
+
+	void LodSystem::Clear(const uint32_t index) noexcept {
+		m_centerX[index] = m_centerY[index] = m_centerZ[index] = 0.0f;
+		m_radius[index] = 0.0f;
+		for (std::vector<float>& error : m_error)
+			error[index] = Infinity;
+		m_level[index] = 0;
+		m_screenError[index] = 0.0f;
+		m_priority[index] = 0.0f;
+		m_assets[index] = {};
+		m_held[index] = InvalidAsset;
+		m_heldLevel[index] = -1;
+		m_base[index] = InvalidAsset;
+		m_denseToHandle[index] = InvalidLod;
+	}
+
+	void LodSystem::Move(const uint32_t from, const uint32_t to) noexcept {
+		m_centerX[to] = m_centerX[from];
+		m_centerY[to] = m_centerY[from];
+		m_centerZ[to] = m_centerZ[from];
+		m_radius[to] = m_radius[from];
+		for (std::vector<float>& error : m_error)
+			error[to] = error[from];
+		m_level[to] = m_level[from];
+		m_screenError[to] = m_screenError[from];
+		m_priority[to] = m_priority[from];
+		m_assets[to] = m_assets[from];
+		m_held[to] = m_held[from];
+		m_heldLevel[to] = m_heldLevel[from];
+		m_base[to] = m_base[from];
+		m_denseToHandle[to] = m_denseToHandle[from];
+	}
+#pragma endregion
+
+#pragma region Selection
+	void LodSystem::Update(const LodView& view, JobSystem* jobs) {
+		const uint32_t size = Padded(m_count);
+		std::atomic<uint32_t> changed = 0;
+
+		if (jobs && m_count > JobGrain) {
+			jobs->ParallelFor(size / 4, JobGrain / 4, [&](const uint32_t b, const uint32_t e) {
+				changed.fetch_add(SelectRange(view, b * 4, e * 4), std::memory_order_relaxed);
+			});
+		}
+		else {
+			changed.fetch_add(SelectRange(view, 0, size), std::memory_order_relaxed);
+		}
+		m_lastChangeCount = changed.load(std::memory_order_relaxed);
+
+		if (m_streamer)
+			Stream();
+	}
+
+	uint32_t LodSystem::SelectRange(const LodView& view, const uint32_t begin, const uint32_t end) noexcept {
+		const __m128 eyeX = _mm_set1_ps(view.position.x());
+		const __m128 eyeY = _mm_set1_ps(view.position.y());
+		const __m128 eyeZ = _mm_set1_ps(view.position.z());
+		const __m128 pixels = _mm_set1_ps(view.pixelsPerUnit);
+		const __m128 minDistance = _mm_set1_ps(MinDistance);
+		const __m128 refine = _mm_set1_ps(m_settings.pixelError);
+		const __m128 coarsen = _mm_set1_ps(m_settings.pixelError * (1.0f - m_settings.hysteresis));
+		const __m128 infinity = _mm_set1_ps(Infinity);
+
+		uint32_t changed = 0;
+		for (uint32_t i = begin; i < end; i += 4) {
+			const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_centerX[i]), eyeX);
+			const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_centerY[i]), eyeY);
+			const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&m_centerZ[i]), eyeZ);
+			const __m128 radius = _mm_loadu_ps(&m_radius[i]);
+
+			// Distance to the nearest point of the sphere; projected size falls off as 1 / distance
+			const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+			const __m128 scale = _mm_div_ps(pixels, _mm_max_ps(_mm_sub_ps(length, radius), minDistance));
+
+			// Errors are non-decreasing, so counting the levels under a threshold finds the coarsest one
+			// under it. Comparison masks are -1 per passing lane.
+			__m128  projected[MaxLevels];
+			__m128i fine = _mm_setzero_si128();
+			__m128i coarse = _mm_setzero_si128();
+			for (uint32_t l = 0; l < MaxLevels; ++l) {
+				projected[l] = _mm_mul_ps(_mm_loadu_ps(&m_error[l][i]), scale);
+				if (l > 0) {
+					fine = _mm_sub_epi32(fine, _mm_castps_si128(_mm_cmple_ps(projected[l], refine)));
+					coarse = _mm_sub_epi32(coarse, _mm_castps_si128(_mm_cmple_ps(projected[l], coarsen)));
+				}
+			}
+
+			// Refine straight away, coarsen only past the hysteresis band (coarse <= fine always)
+			const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_level[i]));
+			const __m128i level = _mm_max_epi32(_mm_min_epi32(current, fine), coarse);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&m_level[i]), level);
+			changed += static_cast<uint32_t>(std::popcount(static_cast<uint32_t>(
+				_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(current, level))) ^ 0xF)));
+
+			// The selected level's error, and the next coarser one's as the streaming priority; past
+			// the end of the chain the priority is the projected radius instead
+			const __m128i next = _mm_add_epi32(level, _mm_set1_epi32(1));
+			__m128 error = projected[0];
+			__m128 priority = infinity;
+			for (uint32_t l = 1; l < MaxLevels; ++l) {
+				const __m128i index = _mm_set1_epi32(static_cast<int32_t>(l));
+				error = _mm_blendv_ps(error, projected[l], _mm_castsi128_ps(_mm_cmpeq_epi32(level, index)));
+				priority = _mm_blendv_ps(priority, projected[l], _mm_castsi128_ps(_mm_cmpeq_epi32(next, index)));
+			}
+			priority = _mm_blendv_ps(priority, _mm_mul_ps(radius, scale), _mm_cmpeq_ps(priority, infinity));
+
+			_mm_storeu_ps(&m_screenError[i], error);
+			_mm_storeu_ps(&m_priority[i], priority);
+		}
+		return changed;
+	}
+#pragma endregion
+
+#pragma region Streaming
+	void LodSystem::Stream() {
+		for (uint32_t i = 0; i < m_count; ++i) {
+			const int32_t level = m_level[i];
+			if (level == m_heldLevel[i])
+				continue;
+
+			// The coarsest level is already held as the base; requesting it again would lower its
+			// priority. Request before releasing, so an asset shared by both levels is never dropped.
+			const uint64_t    asset = IsCoarsest(i, level) ? 0 : m_assets[i][level];
+			const AssetHandle handle = asset != 0 ? m_streamer->Request(asset, m_priority[i]) : InvalidAsset;
+			if (m_held[i] != InvalidAsset)
+				m_streamer->Release(m_held[i]);
+			m_held[i] = handle;
+			m_heldLevel[i] = level;
+			// Request() overwrote the priority for every holder; the pass below restores the highest
+			if (handle != InvalidAsset)
+				m_sentPriority[handle] = m_priority[i];
+		}
+
+		// The streamer keeps one priority per asset, so objects sharing one would overwrite each
+		// other: send the highest among its holders instead
+		m_assetPriority.clear();
+		const auto hold = [this](const AssetHandle handle, const float priority) {
+			if (handle == InvalidAsset)
+				return;
+			const auto [it, inserted] = m_assetPriority.try_emplace(handle, priority);
+			if (!inserted)
+				it->second = std::max(it->second, priority);
+		};
+		for (uint32_t i = 0; i < m_count; ++i) {
+			hold(m_base[i], BasePriority);
+			hold(m_held[i], m_priority[i]);
+		}
+
+		for (const auto& [handle, priority] : m_assetPriority) {
+			const auto sent = m_sentPriority.find(handle);
+			if (sent == m_sentPriority.end() || sent->second != priority)
+				m_streamer->UpdatePriority(handle, priority);
+		}
+		// Assets nobody holds any more drop out of the sent set
+		std::swap(m_sentPriority, m_assetPriority);
+	}
+#pragma endregion
+
+} // namespace Zenyth
@@ -0,0 +1,362 @@
+#include "pch.hpp"
+#include "scene/TransformHierarchy.hpp"
+
+#include <immintrin.h>
+
+using namespace zenyth::math;
+
+namespace Zenyth {
+
+	TransformHandle TransformHierarchy::Create(const TransformHandle parent) {
+		const uint32_t parentIndex = parent == InvalidTransform ? NoParent : Dense(parent);
+		const uint32_t index = static_cast<uint32_t>(m_parent.size());
+
+		TransformHandle handle;
+		if (!m_freeHandles.empty()) {
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+			m_handleToDense[handle] = index;
+		}
+		else {
+			handle = static_cast<TransformHandle>(m_handleToDense.size());
+			m_handleToDense.push_back(index);
+		}
+
+		m_posX.push_back(0.0f);   m_posY.push_back(0.0f);   m_posZ.push_back(0.0f);
+		m_rotX.push_back(0.0f);   m_rotY.push_back(0.0f);   m_rotZ.push_back(0.0f); m_rotW.push_back(1.0f);
+		m_scaleX.push_back(1.0f); m_scaleY.push_back(1.0f); m_scaleZ.push_back(1.0f);
+
+		m_parent.push_back(parentIndex);
+		m_dirty.push_back(1);
+		m_alive.push_back(1);
+		m_world.push_back(mat3x4::identity());
+		m_denseToHandle.push_back(handle);
+
+		// The node sits at the end until the next Rebuild() moves it into its level
+		m_anyDirty = true;
+		m_needsRebuild = true;
+		return handle;
+	}
+
+	void TransformHierarchy::Destroy(const TransformHandle handle) {
+		const uint32_t index = Dense(handle);
+		m_alive[index] = 0;
+		m_pendingDestroy = true;
+		m_needsRebuild = true;
+	}
+
+	void TransformHierarchy::SetParent(const TransformHandle handle, const TransformHandle parent) {
+		const uint32_t index = Dense(handle);
+		uint32_t parentIndex = NoParent;
+
+		if (parent != InvalidTransform) {
+			parentIndex = Dense(parent);
+			for (uint32_t it = parentIndex; it != NoParent; it = m_parent[it]) {
+				if (it == index)
+					throw std::runtime_error("TransformHierarchy::SetParent : would create a cycle");
+			}
+		}
+
+		m_parent[index] = parentIndex;
+		MarkDirty(index);
+		m_needsRebuild = true;
+	}
+
+	TransformHandle TransformHierarchy::GetParent(const TransformHandle handle) const {
+		const uint32_t parent = m_parent[Dense(handle)];
+		return parent == NoParent ? InvalidTransform : m_denseToHandle[parent];
+	}
+
+	void TransformHierarchy::SetLocalPosition(const TransformHandle handle, const vec3& position) {
+		const uint32_t i = Dense(handle);
+		m_posX[i] = position.x(); m_posY[i] = position.y(); m_posZ[i] = position.z();
+		MarkDirty(i);
+	}
+
+	void TransformHierarchy::SetLocalRotation(const TransformHandle handle, const quat& rotation) {
+		const uint32_t i = Dense(handle);
+		m_rotX[i] = rotation.x(); m_rotY[i] = rotation.y(); m_rotZ[i] = rotation.z(); m_rotW[i] = rotation.w();
+		MarkDirty(i);
+	}
+
+	void TransformHierarchy::SetLocalScale(const TransformHandle handle, const vec3& scale) {
+		const uint32_t i = Dense(handle);
+		m_scaleX[i] = scale.x(); m_scaleY[i] = scale.y(); m_scaleZ[i] = scale.z();
+		MarkDirty(i);
+	}
+
+	void TransformHierarchy::SetLocal(const TransformHandle handle, const vec3& position, const quat& rotation, const vec3& scale) {
+		const uint32_t i = Dense(handle);
+		m_posX[i] = position.x(); m_posY[i] = position.y(); m_posZ[i] = position.z();
+		m_rotX[i] = rotation.x(); m_rotY[i] = rotation.y(); m_rotZ[i] = rotation.z(); m_rotW[i] = rotation.w();
+		m_scaleX[i] = scale.x(); m_scaleY[i] = scale.y(); m_scaleZ[i] = scale.z();
+		MarkDirty(i);
+	}
+
+	vec3 TransformHierarchy::GetLocalPosition(const TransformHandle handle) const {
+		const uint32_t i = Dense(handle);
+		return { m_posX[i], m_posY[i], m_posZ[i] };
+	}
+
+	quat TransformHierarchy::GetLocalRotation(const TransformHandle handle) const {
+		const uint32_t i = Dense(handle);
+		return { m_rotX[i], m_rotY[i], m_rotZ[i], m_rotW[i] };
+	}
+
+	vec3 TransformHierarchy::GetLocalScale(const TransformHandle handle) const {
+		const uint32_t i = Dense(handle);
+		return { m_scaleX[i], m_scaleY[i], m_scaleZ[i] };
+	}
+
+	const mat3x4& TransformHierarchy::GetWorldMatrix(const TransformHandle handle) const {
+		return m_world[Dense(handle)];
+	}
+
+	bool TransformHierarchy::IsValid(const TransformHandle handle) const noexcept {
+		return handle < m_handleToDense.size() && m_handleToDense[handle] != NoParent && !IsDestroyed(m_handleToDense[handle]);
+	}
+
+	uint32_t TransformHierarchy::Count() const noexcept {
+		const auto stored = static_cast<uint32_t>(m_parent.size());
+		if (!m_pendingDestroy)
+			return stored;
+
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < stored; ++i)
+			count += IsDestroyed(i) ? 0 : 1;
+		return count;
+	}
+
+	bool TransformHierarchy::IsDestroyed(const uint32_t index) const noexcept {
+		if (!m_pendingDestroy)
+			return false;
+		for (uint32_t it = index; it != NoParent; it = m_parent[it]) {
+			if (!m_alive[it])
+				return true;
+		}
+		return false;
+	}
+
+	uint32_t TransformHierarchy::Dense(const TransformHandle handle) const {
+		if (!IsValid(handle))
+			throw std::runtime_error("TransformHierarchy : invalid transform handle");
+		return m_handleToDense[handle];
+	}
+
+	void TransformHierarchy::MarkDirty(const uint32_t index) noexcept {
+		m_dirty[index] = 1;
+		m_anyDirty = true;
+	}
+
+	void TransformHierarchy::Update(JobSystem* jobs) {
+		if (m_needsRebuild)
+			Rebuild();
+
+		m_lastUpdateCount = 0;
+		if (!m_anyDirty)
+			return;
+
+		std::atomic<uint32_t> updated = 0;
+
+		// Levels run in order so a parent's world matrix and dirty flag are final before its children read them
+		for (size_t level = 0; level + 1 < m_levelStart.size(); ++level) {
+			const uint32_t begin = m_levelStart[level];
+			const uint32_t count = m_levelStart[level + 1] - begin;
+
+			if (jobs && count > JobGrain) {
+				jobs->ParallelFor(count, JobGrain, [&](const uint32_t b, const uint32_t e) {
+					updated.fetch_add(UpdateRange(begin + b, begin + e), std::memory_order_relaxed);
+				});
+			}
+			else {
+				updated.fetch_add(UpdateRange(begin, begin + count), std::memory_order_relaxed);
+			}
+		}
+
+		std::fill(m_dirty.begin(), m_dirty.end(), uint8_t{ 0 });
+		m_anyDirty = false;
+		m_lastUpdateCount = updated.load(std::memory_order_relaxed);
+	}
+
+	uint32_t TransformHierarchy::UpdateRange(const uint32_t begin, const uint32_t end) noexcept {
+		uint32_t batch[4];
+		uint32_t pending = 0;
+		uint32_t updated = 0;
+
+		for (uint32_t i = begin; i < end; ++i) {
+			const uint32_t parent = m_parent[i];
+			if (parent != NoParent && m_dirty[parent])
+				m_dirty[i] = 1;
+			if (!m_dirty[i])
+				continue;
+
+			batch[pending++] = i;
+			if (pending == 4) {
+				ComputeBatch(batch, 4);
+				updated += 4;
+				pending = 0;
+			}
+		}
+
+		if (pending) {
+			ComputeBatch(batch, pending);
+			updated += pending;
+		}
+		return updated;
+	}
+
+	void TransformHierarchy::ComputeBatch(const uint32_t* indices, const uint32_t count) noexcept {
+		// Unused lanes repeat the first node; their results are discarded
+		uint32_t lane[4];
+		for (uint32_t k = 0; k < 4; ++k)
+			lane[k] = indices[k < count ? k : 0];
+
+		const auto gather = [&lane](const std::vector<float>& v) {
+			return _mm_set_ps(v[lane[3]], v[lane[2]], v[lane[1]], v[lane[0]]);
+		};
+
+		const __m128 qx = gather(m_rotX), qy = gather(m_rotY), qz = gather(m_rotZ), qw = gather(m_rotW);
+		const __m128 sx = gather(m_scaleX), sy = gather(m_scaleY), sz = gather(m_scaleZ);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+
+		const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+		const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+		const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+		// Rotation * scale plus translation, one register per matrix element across 4 nodes,
+		// grouped by row to match the row-major mat3x4 layout
+		__m128 r0[4] = {
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+			gather(m_posX)
+		};
+		__m128 r1[4] = {
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+			gather(m_posY)
+		};
+		__m128 r2[4] = {
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+			gather(m_posZ)
+		};
+
+		// world = parentWorld * local, still SoA: the parents are transposed the same way, so the
+		// product is plain multiply-adds across the four nodes. Roots multiply by identity.
+		static const mat3x4 identity = mat3x4::identity();
+		const float* parents[4];
+		for (uint32_t k = 0; k < 4; ++k) {
+			const uint32_t parent = m_parent[lane[k]];
+			parents[k] = static_cast<const float*>((parent == NoParent ? identity : m_world[parent]).data());
+		}
+
+		__m128 world[3][4];
+		for (uint32_t r = 0; r < 3; ++r) {
+			__m128 p[4] = {
+				_mm_load_ps(parents[0] + r * 4), _mm_load_ps(parents[1] + r * 4),
+				_mm_load_ps(parents[2] + r * 4), _mm_load_ps(parents[3] + r * 4)
+			};
+			_MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);
+
+			for (uint32_t c = 0; c < 4; ++c) {
+				__m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], r0[c]), _mm_mul_ps(p[1], r1[c])), _mm_mul_ps(p[2], r2[c]));
+				if (c == 3)
+					v = _mm_add_ps(v, p[3]);
+				world[r][c] = v;
+			}
+		}
+
+		// SoA -> one row register per node; the implicit last row saves a fourth transpose
+		for (__m128 (&row)[4] : world)
+			_MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+
+		for (uint32_t k = 0; k < count; ++k) {
+			auto* out = static_cast<float*>(m_world[lane[k]].data());
+			_mm_store_ps(out, world[0][k]);
+			_mm_store_ps(out + 4, world[1][k]);
+			_mm_store_ps(out + 8, world[2][k]);
+		}
+	}
+
+	void TransformHierarchy::Rebuild() {
+		const uint32_t count = static_cast<uint32_t>(m_parent.size());
+
+		// Children lists in CSR form; nodes under a destroyed parent are unreachable and get dropped
+		std::vector<uint32_t> childStart(count + 1, 0);
+		for (uint32_t i = 0; i < count; ++i) {
+			if (m_alive[i] && m_parent[i] != NoParent)
+				++childStart[m_parent[i] + 1];
+		}
+		for (uint32_t i = 0; i < count; ++i)
+			childStart[i + 1] += childStart[i];
+
+		std::vector<uint32_t> children(childStart[count]);
+		std::vector<uint32_t> cursor(childStart.begin(), childStart.end() - 1);
+		for (uint32_t i = 0; i < count; ++i) {
+			if (m_alive[i] && m_parent[i] != NoParent)
+				children[cursor[m_parent[i]]++] = i;
+		}
+
+		// Breadth-first from every root at once: levels come out contiguous and siblings adjacent
+		std::vector<uint32_t> order;
+		order.reserve(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			if (m_alive[i] && m_parent[i] == NoParent)
+				order.push_back(i);
+		}
+
+		m_levelStart.clear();
+		m_levelStart.push_back(0);
+		for (size_t levelBegin = 0; levelBegin < order.size();) {
+			const size_t levelEnd = order.size();
+			for (size_t k = levelBegin; k < levelEnd; ++k) {
+				const uint32_t node = order[k];
+				for (uint32_t c = childStart[node]; c < childStart[node + 1]; ++c)
+					order.push_back(children[c]);
+			}
+			m_levelStart.push_back(static_cast<uint32_t>(levelEnd));
+			levelBegin = levelEnd;
+		}
+
+		std::vector<uint32_t> remap(count, NoParent);
+		for (uint32_t k = 0; k < order.size(); ++k)
+			remap[order[k]] = k;
+
+		// Release handles of everything that did not make it into the new order
+		for (uint32_t i = 0; i < count; ++i) {
+			if (remap[i] == NoParent) {
+				m_handleToDense[m_denseToHandle[i]] = NoParent;
+				m_freeHandles.push_back(m_denseToHandle[i]);
+			}
+		}
+
+		const auto permute = [&order]<typename T>(std::vector<T>& v) {
+			std::vector<T> sorted;
+			sorted.reserve(order.size());
+			for (const uint32_t i : order)
+				sorted.push_back(v[i]);
+			v.swap(sorted);
+		};
+
+		permute(m_posX);   permute(m_posY);   permute(m_posZ);
+		permute(m_rotX);   permute(m_rotY);   permute(m_rotZ); permute(m_rotW);
+		permute(m_scaleX); permute(m_scaleY); permute(m_scaleZ);
+		permute(m_dirty);  permute(m_alive);  permute(m_world);
+		permute(m_denseToHandle);
+		permute(m_parent);
+
+		for (uint32_t i = 0; i < m_parent.size(); ++i) {
+			if (m_parent[i] != NoParent)
+				m_parent[i] = remap[m_parent[i]];
+			m_handleToDense[m_denseToHandle[i]] = i;
+		}
+
+		m_needsRebuild = false;
+		m_pendingDestroy = false;
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,446 @@
+#include "pch.hpp"
+#include "spatial/BVH.hpp"
+
+using namespace zenyth::math;
+
+namespace Zenyth {
+
+	struct BVH::BuildNode {
+		AABB     bounds;
+		uint32_t left = 0;  // right child is left + 1
+		uint32_t start = 0;
+		uint32_t count = 0; // > 0 for leaves
+	};
+
+	namespace {
+		constexpr float Huge = std::numeric_limits<float>::max();
+
+		float Axis(const vec3& v, const int axis) noexcept {
+			return axis == 0 ? v.x() : axis == 1 ? v.y() : v.z();
+		}
+
+		// Plain float bounds for the build loops, which touch every primitive once per level
+		struct BuildBounds {
+			float min[3] = { Huge, Huge, Huge };
+			float max[3] = { -Huge, -Huge, -Huge };
+
+			void Expand(const BuildBounds& other) noexcept {
+				for (int a = 0; a < 3; ++a) {
+					min[a] = std::min(min[a], other.min[a]);
+					max[a] = std::max(max[a], other.max[a]);
+				}
+			}
+
+			void Expand(const float* point) noexcept {
+				for (int a = 0; a < 3; ++a) {
+					min[a] = std::min(min[a], point[a]);
+					max[a] = std::max(max[a], point[a]);
+				}
+			}
+
+			[[nodiscard]] float SurfaceArea() const noexcept {
+				const float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+				return dx < 0.0f ? 0.0f : 2.0f * (dx * dy + dy * dz + dz * dx);
+			}
+
+			[[nodiscard]] AABB ToAABB() const noexcept {
+				return { { min[0], min[1], min[2] }, { max[0], max[1], max[2] } };
+			}
+		};
+
+		struct Primitive {
+			BuildBounds bounds;
+			float  centroid[3];
+		};
+	}
+
+	struct BVH::BuildContext {
+		std::vector<Primitive> primitives;
+		std::vector<uint32_t>& indices;
+		std::vector<BuildNode> nodes;
+		std::atomic<uint32_t>  nodeCount = 1;
+		JobSystem*             jobs = nullptr;
+		JobCounter             pending;
+	};
+
+	void BVH::Build(const std::span<const AABB> boxes, JobSystem* jobs) {
+		m_nodes.clear();
+		m_bounds = {};
+
+		const uint32_t count = static_cast<uint32_t>(boxes.size());
+		m_primIndices.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+			m_primIndices[i] = i;
+
+		if (count == 0) {
+			m_leafBoxes.clear();
+			return;
+		}
+
+		BuildContext ctx{ {}, m_primIndices };
+		ctx.jobs = jobs;
+		ctx.primitives.resize(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			Primitive& prim = ctx.primitives[i];
+			prim.bounds = {
+				{ boxes[i].min.x(), boxes[i].min.y(), boxes[i].min.z() },
+				{ boxes[i].max.x(), boxes[i].max.y(), boxes[i].max.z() }
+			};
+			for (int a = 0; a < 3; ++a)
+				prim.centroid[a] = (prim.bounds.min[a] + prim.bounds.max[a]) * 0.5f;
+		}
+
+		// A binary tree over n primitives never needs more than 2n - 1 nodes
+		ctx.nodes.resize(2 * static_cast<size_t>(count));
+		Split(ctx, 0, 0, count);
+		if (jobs)
+			jobs->Wait(ctx.pending);
+		ctx.nodes.resize(ctx.nodeCount.load());
+
+		m_nodes.reserve(ctx.nodes.size() / 2 + 1);
+		Collapse(ctx.nodes, 0);
+
+		m_leafBoxes.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+			m_leafBoxes[i] = boxes[m_primIndices[i]];
+		m_bounds = ctx.nodes[0].bounds;
+	}
+
+	void BVH::Split(BuildContext& ctx, const uint32_t nodeIndex, const uint32_t start, const uint32_t count) {
+		const auto first = ctx.indices.begin() + start;
+		const auto last = first + count;
+
+		BuildBounds bounds;
+		BuildBounds centroidBounds;
+		for (auto it = first; it != last; ++it) {
+			bounds.Expand(ctx.primitives[*it].bounds);
+			centroidBounds.Expand(ctx.primitives[*it].centroid);
+		}
+
+		BuildNode& node = ctx.nodes[nodeIndex];
+		node.bounds = bounds.ToAABB();
+
+		if (count <= 1) {
+			node.start = start;
+			node.count = count;
+			return;
+		}
+
+		// Binned SAH over all three axes
+		struct Bin {
+			BuildBounds bounds;
+			uint32_t count = 0;
+		};
+
+		float bestCost = std::numeric_limits<float>::max();
+		int   bestAxis = -1;
+		int   bestSplit = 0;
+
+		for (int axis = 0; axis < 3; ++axis) {
+			const float lo = centroidBounds.min[axis];
+			const float extent = centroidBounds.max[axis] - lo;
+			if (extent <= 0.0f)
+				continue;
+
+			const float scale = static_cast<float>(BinCount) / extent;
+			std::array<Bin, BinCount> bins{};
+			for (auto it = first; it != last; ++it) {
+				const Primitive& prim = ctx.primitives[*it];
+				const uint32_t b = std::min(BinCount - 1, static_cast<uint32_t>((prim.centroid[axis] - lo) * scale));
+				bins[b].bounds.Expand(prim.bounds);
+				++bins[b].count;
+			}
+
+			// Sweep from the right to get suffix areas, then from the left to evaluate each plane
+			std::array<float, BinCount> rightArea{};
+			std::array<uint32_t, BinCount> rightCount{};
+			BuildBounds acc;
+			uint32_t accCount = 0;
+			for (int b = BinCount - 1; b > 0; --b) {
+				acc.Expand(bins[b].bounds);
+				accCount += bins[b].count;
+				rightArea[b] = acc.SurfaceArea();
+				rightCount[b] = accCount;
+			}
+
+			acc = {};
+			accCount = 0;
+			for (int b = 0; b < static_cast<int>(BinCount) - 1; ++b) {
+				acc.Expand(bins[b].bounds);
+				accCount += bins[b].count;
+				if (accCount == 0 || rightCount[b + 1] == 0)
+					continue;
+
+				const float cost = acc.SurfaceArea() * static_cast<float>(accCount)
+					+ rightArea[b + 1] * static_cast<float>(rightCount[b + 1]);
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+
+		// Compare against intersecting everything in a leaf (unit traversal and intersection costs)
+		const float parentArea = bounds.SurfaceArea();
+		const float splitCost = parentArea > 0.0f ? 1.0f + bestCost / parentArea : bestCost;
+		if (count <= MaxLeafSize && (bestAxis < 0 || splitCost >= static_cast<float>(count))) {
+			node.start = start;
+			node.count = count;
+			return;
+		}
+
+		uint32_t leftCount;
+		if (bestAxis >= 0) {
+			const float lo = centroidBounds.min[bestAxis];
+			const float scale = static_cast<float>(BinCount) / (centroidBounds.max[bestAxis] - lo);
+			const auto mid = std::partition(first, last, [&](const uint32_t i) {
+				const uint32_t b = std::min(BinCount - 1, static_cast<uint32_t>((ctx.primitives[i].centroid[bestAxis] - lo) * scale));
+				return static_cast<int>(b) <= bestSplit;
+			});
+			leftCount = static_cast<uint32_t>(mid - first);
+		}
+		else {
+			// Every centroid coincides: any split is as good as another
+			leftCount = count / 2;
+		}
+
+		const uint32_t left = ctx.nodeCount.fetch_add(2, std::memory_order_relaxed);
+		node.left = left;
+		node.count = 0;
+
+		const uint32_t rightCount = count - leftCount;
+		if (ctx.jobs && count >= ParallelBuildThreshold) {
+			ctx.jobs->Submit(ctx.pending, [&ctx, left, start, leftCount] {
+				Split(ctx, left, start, leftCount);
+			});
+		}
+		else {
+			Split(ctx, left, start, leftCount);
+		}
+		Split(ctx, left + 1, start + leftCount, rightCount);
+	}
+
+	uint32_t BVH::Collapse(const std::vector<BuildNode>& tree, const uint32_t binaryIndex) {
+		const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+
+		// Open up the largest inner children until four lanes are filled
+		uint32_t lanes[Width];
+		uint32_t laneCount = 0;
+
+		const BuildNode& root = tree[binaryIndex];
+		if (root.count > 0) {
+			lanes[laneCount++] = binaryIndex;
+		}
+		else {
+			lanes[laneCount++] = root.left;
+			lanes[laneCount++] = root.left + 1;
+		}
+
+		while (laneCount < Width) {
+			int   best = -1;
+			float bestArea = -1.0f;
+			for (uint32_t k = 0; k < laneCount; ++k) {
+				const BuildNode& candidate = tree[lanes[k]];
+				if (candidate.count == 0 && candidate.bounds.SurfaceArea() > bestArea) {
+					bestArea = candidate.bounds.SurfaceArea();
+					best = static_cast<int>(k);
+				}
+			}
+			if (best < 0)
+				break;
+
+			const uint32_t opened = lanes[best];
+			lanes[best] = tree[opened].left;
+			lanes[laneCount++] = tree[opened].left + 1;
+		}
+
+		int32_t  children[Width];
+		uint32_t counts[Width];
+		for (uint32_t k = 0; k < Width; ++k) {
+			if (k >= laneCount) {
+				children[k] = EmptyLane;
+				counts[k] = 0;
+				continue;
+			}
+
+			const BuildNode& child = tree[lanes[k]];
+			if (child.count > 0) {
+				children[k] = ~static_cast<int32_t>(child.start);
+				counts[k] = child.count;
+			}
+			else {
+				// Recursion appends to m_nodes, so only touch our node by index afterwards
+				children[k] = static_cast<int32_t>(Collapse(tree, lanes[k]));
+				counts[k] = 0;
+			}
+		}
+
+		Node& node = m_nodes[index];
+		for (uint32_t k = 0; k < Width; ++k) {
+			node.child[k] = children[k];
+			node.count[k] = counts[k];
+			SetLane(node, k, k < laneCount ? tree[lanes[k]].bounds : AABB{});
+		}
+		return index;
+	}
+
+	void BVH::Refit(const std::span<const AABB> boxes) {
+		if (boxes.size() != m_primIndices.size())
+			throw std::runtime_error("BVH::Refit : primitive count differs from the last Build");
+
+		for (uint32_t i = 0; i < m_primIndices.size(); ++i)
+			m_leafBoxes[i] = boxes[m_primIndices[i]];
+
+		// Children always follow their parent, so a reverse sweep sees them updated first
+		for (size_t n = m_nodes.size(); n-- > 0;) {
+			Node& node = m_nodes[n];
+			for (uint32_t lane = 0; lane < Width; ++lane) {
+				const int32_t child = node.child[lane];
+				if (child == EmptyLane)
+					continue;
+
+				AABB bounds;
+				if (child < 0) {
+					const uint32_t first = static_cast<uint32_t>(~child);
+					for (uint32_t p = first; p < first + node.count[lane]; ++p)
+						bounds.Expand(m_leafBoxes[p]);
+				}
+				else {
+					for (uint32_t k = 0; k < Width; ++k) {
+						if (m_nodes[child].child[k] != EmptyLane)
+							bounds.Expand(LaneBounds(m_nodes[child], k));
+					}
+				}
+				SetLane(node, lane, bounds);
+			}
+		}
+
+		m_bounds = {};
+		if (!m_nodes.empty()) {
+			for (uint32_t lane = 0; lane < Width; ++lane) {
+				if (m_nodes[0].child[lane] != EmptyLane)
+					m_bounds.Expand(LaneBounds(m_nodes[0], lane));
+			}
+		}
+	}
+
+	RayHit BVH::RayCast(const Ray& ray) const {
+		RayHit hit = TraverseRay(ray, [this](const uint32_t leaf, const Ray& r, const float tMax) {
+			return IntersectPrimitive(m_leafBoxes[leaf], r, tMax);
+		});
+		if (hit.IsHit())
+			hit.primitive = m_primIndices[hit.primitive];
+		return hit;
+	}
+
+	void BVH::RayCastBatch(const std::span<const Ray> rays, const std::span<RayHit> hits, JobSystem* jobs) const {
+		const auto run = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				hits[i] = RayCast(rays[i]);
+		};
+
+		const uint32_t count = static_cast<uint32_t>(std::min(rays.size(), hits.size()));
+		if (jobs)
+			jobs->ParallelFor(count, 64, run);
+		else
+			run(0, count);
+	}
+
+	void BVH::SetLane(Node& node, const uint32_t lane, const AABB& box) noexcept {
+		node.minX[lane] = box.min.x(); node.minY[lane] = box.min.y(); node.minZ[lane] = box.min.z();
+		node.maxX[lane] = box.max.x(); node.maxY[lane] = box.max.y(); node.maxZ[lane] = box.max.z();
+	}
+
+	AABB BVH::LaneBounds(const Node& node, const uint32_t lane) noexcept {
+		return {
+			{ node.minX[lane], node.minY[lane], node.minZ[lane] },
+			{ node.maxX[lane], node.maxY[lane], node.maxZ[lane] }
+		};
+	}
+
+	int BVH::IntersectRay(const Node& node, const __m128 origin[3], const __m128 invDir[3], const __m128 tMax, __m128& tNear) noexcept {
+		const __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), origin[0]), invDir[0]);
+		const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), origin[0]), invDir[0]);
+		const __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), origin[1]), invDir[1]);
+		const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), origin[1]), invDir[1]);
+		const __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), origin[2]), invDir[2]);
+		const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), origin[2]), invDir[2]);
+
+		const __m128 enter = _mm_max_ps(
+			_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+			_mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+		const __m128 exit = _mm_min_ps(
+			_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+			_mm_min_ps(_mm_max_ps(t0z, t1z), tMax));
+
+		tNear = enter;
+		return _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+	}
+
+	int BVH::IntersectBox(const Node& node, const AABB& box) noexcept {
+		const __m128 overlapX = _mm_and_ps(
+			_mm_cmple_ps(_mm_load_ps(node.minX), _mm_set1_ps(box.max.x())),
+			_mm_cmpge_ps(_mm_load_ps(node.maxX), _mm_set1_ps(box.min.x())));
+		const __m128 overlapY = _mm_and_ps(
+			_mm_cmple_ps(_mm_load_ps(node.minY), _mm_set1_ps(box.max.y())),
+			_mm_cmpge_ps(_mm_load_ps(node.maxY), _mm_set1_ps(box.min.y())));
+		const __m128 overlapZ = _mm_and_ps(
+			_mm_cmple_ps(_mm_load_ps(node.minZ), _mm_set1_ps(box.max.z())),
+			_mm_cmpge_ps(_mm_load_ps(node.maxZ), _mm_set1_ps(box.min.z())));
+
+		return _mm_movemask_ps(_mm_and_ps(overlapX, _mm_and_ps(overlapY, overlapZ)));
+	}
+
+	int BVH::IntersectFrustum(const Node& node, const Frustum& frustum, int& inside) noexcept {
+		__m128 outsideAny = _mm_setzero_ps();
+		__m128 straddleAny = _mm_setzero_ps();
+
+		for (uint32_t p = 0; p < Frustum::Count; ++p) {
+			const vec4& plane = frustum.GetPlane(p);
+			const __m128 nx = _mm_set1_ps(plane.x());
+			const __m128 ny = _mm_set1_ps(plane.y());
+			const __m128 nz = _mm_set1_ps(plane.z());
+			const __m128 d = _mm_set1_ps(plane.w());
+
+			// Corner furthest along the normal decides rejection, the opposite one containment
+			const float* px = plane.x() >= 0.0f ? node.maxX : node.minX;
+			const float* py = plane.y() >= 0.0f ? node.maxY : node.minY;
+			const float* pz = plane.z() >= 0.0f ? node.maxZ : node.minZ;
+			const float* qx = plane.x() >= 0.0f ? node.minX : node.maxX;
+			const float* qy = plane.y() >= 0.0f ? node.minY : node.maxY;
+			const float* qz = plane.z() >= 0.0f ? node.minZ : node.maxZ;
+
+			const __m128 far = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(px)), _mm_mul_ps(ny, _mm_load_ps(py))),
+				_mm_add_ps(_mm_mul_ps(nz, _mm_load_ps(pz)), d));
+			const __m128 near = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(qx)), _mm_mul_ps(ny, _mm_load_ps(qy))),
+				_mm_add_ps(_mm_mul_ps(nz, _mm_load_ps(qz)), d));
+
+			outsideAny = _mm_or_ps(outsideAny, _mm_cmplt_ps(far, _mm_setzero_ps()));
+			straddleAny = _mm_or_ps(straddleAny, _mm_cmplt_ps(near, _mm_setzero_ps()));
+		}
+
+		const int visible = ~_mm_movemask_ps(outsideAny) & 0xF;
+		inside = visible & ~_mm_movemask_ps(straddleAny);
+		return visible;
+	}
+
+	float BVH::IntersectPrimitive(const AABB& box, const Ray& ray, const float tMax) noexcept {
+		float enter = 0.0f;
+		float exit = tMax;
+
+		for (int axis = 0; axis < 3; ++axis) {
+			const float inv = 1.0f / Axis(ray.direction, axis);
+			float t0 = (Axis(box.min, axis) - Axis(ray.origin, axis)) * inv;
+			float t1 = (Axis(box.max, axis) - Axis(ray.origin, axis)) * inv;
+			if (t0 > t1)
+				std::swap(t0, t1);
+			enter = std::max(enter, t0);
+			exit = std::min(exit, t1);
+		}
+
+		return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+	}
+
+} // namespace Zenyth
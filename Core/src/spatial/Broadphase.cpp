@@ -0,0 +1,339 @@
+#include "pch.hpp"
+#include "spatial/Broadphase.hpp"
+#include "CpuFeatures.hpp"
+
+#include <bit>
+#include <immintrin.h>
+
+using namespace zenyth::math;
+
+namespace Zenyth {
+
+	namespace {
+		constexpr uint32_t Width = 8;
+		constexpr uint32_t MaxRegionsPerAxis = 256;
+
+		float Component(const vec3& v, const uint32_t axis) noexcept {
+			return axis == 0 ? v.x() : axis == 1 ? v.y() : v.z();
+		}
+
+		// The sweep stops at +inf sentinels, so no body may reach them: infinite bounds become the
+		// largest finite ones. NaN cannot be ordered at all and is rejected.
+		AABB ClampBounds(const AABB& box, const char* where) {
+			const auto clamp = [where](const float value) {
+				if (std::isnan(value))
+					throw std::invalid_argument(std::string(where) + " : box has NaN bounds");
+				return std::clamp(value, -std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+			};
+			return {
+				vec3(clamp(box.min.x()), clamp(box.min.y()), clamp(box.min.z())),
+				vec3(clamp(box.max.x()), clamp(box.max.y()), clamp(box.max.z()))
+			};
+		}
+
+		// Sorted sweep arrays for one region; entries [count, count + Width) are sentinels
+		struct SweepInput {
+			const float*    sweepMin;
+			const float*    sweepMax;
+			const float*    uMin;
+			const float*    uMax;
+			const float*    vMin;
+			const float*    vMax;
+			const uint32_t* handles;
+			uint32_t        count;
+		};
+
+		void SweepSse(const SweepInput& in, std::vector<BroadphasePair>& candidates) {
+			for (uint32_t i = 0; i < in.count; ++i) {
+				const __m128 maxS = _mm_set1_ps(in.sweepMax[i]);
+				const __m128 minU = _mm_set1_ps(in.uMin[i]);
+				const __m128 maxU = _mm_set1_ps(in.uMax[i]);
+				const __m128 minV = _mm_set1_ps(in.vMin[i]);
+				const __m128 maxV = _mm_set1_ps(in.vMax[i]);
+
+				for (uint32_t j = i + 1;; j += 4) {
+					// Sorted by minimum: the lanes still inside the sweep window form a prefix
+					const __m128 inWindow = _mm_cmple_ps(_mm_loadu_ps(in.sweepMin + j), maxS);
+					const __m128 overlapU = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(in.uMin + j), maxU), _mm_cmpge_ps(_mm_loadu_ps(in.uMax + j), minU));
+					const __m128 overlapV = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(in.vMin + j), maxV), _mm_cmpge_ps(_mm_loadu_ps(in.vMax + j), minV));
+
+					for (uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(inWindow, _mm_and_ps(overlapU, overlapV)))); mask; mask &= mask - 1)
+						candidates.push_back({ i, j + static_cast<uint32_t>(std::countr_zero(mask)) });
+
+					if (_mm_movemask_ps(inWindow) != 0xF)
+						break;
+				}
+			}
+		}
+
+		ZENYTH_TARGET_AVX2 void SweepAvx2(const SweepInput& in, std::vector<BroadphasePair>& candidates) {
+			for (uint32_t i = 0; i < in.count; ++i) {
+				const __m256 maxS = _mm256_set1_ps(in.sweepMax[i]);
+				const __m256 minU = _mm256_set1_ps(in.uMin[i]);
+				const __m256 maxU = _mm256_set1_ps(in.uMax[i]);
+				const __m256 minV = _mm256_set1_ps(in.vMin[i]);
+				const __m256 maxV = _mm256_set1_ps(in.vMax[i]);
+
+				for (uint32_t j = i + 1;; j += Width) {
+					const __m256 inWindow = _mm256_cmp_ps(_mm256_loadu_ps(in.sweepMin + j), maxS, _CMP_LE_OQ);
+					const __m256 overlapU = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(in.uMin + j), maxU, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(in.uMax + j), minU, _CMP_GE_OQ));
+					const __m256 overlapV = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(in.vMin + j), maxV, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(in.vMax + j), minV, _CMP_GE_OQ));
+
+					for (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(inWindow, _mm256_and_ps(overlapU, overlapV)))); mask; mask &= mask - 1)
+						candidates.push_back({ i, j + static_cast<uint32_t>(std::countr_zero(mask)) });
+
+					if (_mm256_movemask_ps(inWindow) != 0xFF)
+						break;
+				}
+			}
+		}
+
+		using SweepFn = void (*)(const SweepInput&, std::vector<BroadphasePair>&);
+
+		SweepFn SelectSweep() noexcept {
+			return GetCpuFeatures().avx2 ? SweepAvx2 : SweepSse;
+		}
+
+		// Nearly sorted input from the previous frame: each entry moves only as far as its body did
+		template<typename Entry>
+		void InsertionSort(std::vector<Entry>& entries) noexcept {
+			for (size_t i = 1; i < entries.size(); ++i) {
+				const Entry entry = entries[i];
+				size_t j = i;
+				for (; j > 0 && entries[j - 1].key > entry.key; --j)
+					entries[j] = entries[j - 1];
+				entries[j] = entry;
+			}
+		}
+	}
+
+	Broadphase::Broadphase(const BroadphaseDesc& desc) : m_desc(desc) {
+		if (desc.sweepAxis > 2)
+			throw std::invalid_argument("Broadphase : sweepAxis must be 0, 1 or 2");
+		if (desc.regionsU == 0 || desc.regionsV == 0 || desc.regionsU > MaxRegionsPerAxis || desc.regionsV > MaxRegionsPerAxis)
+			throw std::invalid_argument("Broadphase : region counts must be between 1 and " + std::to_string(MaxRegionsPerAxis));
+
+		m_axisU = (desc.sweepAxis + 1) % 3;
+		m_axisV = (desc.sweepAxis + 2) % 3;
+
+		if (desc.regionsU * desc.regionsV > 1) {
+			if (desc.worldBounds.IsEmpty())
+				throw std::invalid_argument("Broadphase : multiple regions need non-empty worldBounds");
+			const float extentU = Component(desc.worldBounds.max, m_axisU) - Component(desc.worldBounds.min, m_axisU);
+			const float extentV = Component(desc.worldBounds.max, m_axisV) - Component(desc.worldBounds.min, m_axisV);
+			m_cellScaleU = extentU > 0.0f ? static_cast<float>(desc.regionsU) / extentU : 0.0f;
+			m_cellScaleV = extentV > 0.0f ? static_cast<float>(desc.regionsV) / extentV : 0.0f;
+		}
+
+		m_regions.resize(static_cast<size_t>(desc.regionsU) * desc.regionsV);
+		for (uint32_t v = 0; v < desc.regionsV; ++v) {
+			for (uint32_t u = 0; u < desc.regionsU; ++u) {
+				Region& region = m_regions[static_cast<size_t>(v) * desc.regionsU + u];
+				region.u = u;
+				region.v = v;
+			}
+		}
+	}
+
+#pragma region Bodies
+	uint32_t Broadphase::Add(const AABB& box) {
+		const AABB clamped = ClampBounds(box, "Broadphase::Add");
+
+		uint32_t handle;
+		if (!m_freeHandles.empty()) {
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		else {
+			handle = static_cast<uint32_t>(m_bodies.size());
+			m_bodies.emplace_back();
+		}
+
+		Body& body = m_bodies[handle];
+		body.box = clamped;
+		body.cells = {};
+		body.alive = true;
+		++m_bodyCount;
+		MarkDirty(handle);
+		return handle;
+	}
+
+	void Broadphase::Move(const uint32_t handle, const AABB& box) {
+		if (handle >= m_bodies.size() || !m_bodies[handle].alive)
+			throw std::invalid_argument("Broadphase::Move : invalid handle");
+
+		Body& body = m_bodies[handle];
+		body.box = ClampBounds(box, "Broadphase::Move");
+		// Region membership only changes when a body crosses a cell boundary
+		if (m_regions.size() > 1)
+			MarkDirty(handle);
+	}
+
+	void Broadphase::Remove(const uint32_t handle) {
+		if (handle >= m_bodies.size() || !m_bodies[handle].alive)
+			throw std::invalid_argument("Broadphase::Remove : invalid handle");
+
+		m_bodies[handle].alive = false;
+		--m_bodyCount;
+		MarkDirty(handle);
+	}
+
+	void Broadphase::MarkDirty(const uint32_t handle) {
+		Body& body = m_bodies[handle];
+		if (!body.dirty) {
+			body.dirty = true;
+			m_dirty.push_back(handle);
+		}
+	}
+
+	uint32_t Broadphase::CellU(const float value) const noexcept {
+		const float cell = (value - Component(m_desc.worldBounds.min, m_axisU)) * m_cellScaleU;
+		return static_cast<uint32_t>(std::clamp(cell, 0.0f, static_cast<float>(m_desc.regionsU - 1)));
+	}
+
+	uint32_t Broadphase::CellV(const float value) const noexcept {
+		const float cell = (value - Component(m_desc.worldBounds.min, m_axisV)) * m_cellScaleV;
+		return static_cast<uint32_t>(std::clamp(cell, 0.0f, static_cast<float>(m_desc.regionsV - 1)));
+	}
+
+	Broadphase::CellRect Broadphase::ComputeCells(const AABB& box) const noexcept {
+		if (m_regions.size() == 1)
+			return { 0, 0, 0, 0 };
+		return {
+			static_cast<uint16_t>(CellU(Component(box.min, m_axisU))), static_cast<uint16_t>(CellU(Component(box.max, m_axisU))),
+			static_cast<uint16_t>(CellV(Component(box.min, m_axisV))), static_cast<uint16_t>(CellV(Component(box.max, m_axisV)))
+		};
+	}
+
+	void Broadphase::CommitMoves() {
+		for (const uint32_t handle : m_dirty) {
+			Body& body = m_bodies[handle];
+			body.dirty = false;
+
+			const CellRect previous = body.cells;
+			body.cells = body.alive ? ComputeCells(body.box) : CellRect{};
+			if (!body.alive) {
+				m_pendingFree.push_back(handle);
+				continue;
+			}
+
+			// Cells the body enters; cells it leaves drop it while their entries are refreshed
+			for (uint32_t v = body.cells.v0; v <= body.cells.v1; ++v) {
+				for (uint32_t u = body.cells.u0; u <= body.cells.u1; ++u) {
+					if (!previous.Contains(u, v))
+						m_regions[static_cast<size_t>(v) * m_desc.regionsU + u].added.push_back(handle);
+				}
+			}
+		}
+		m_dirty.clear();
+	}
+#pragma endregion
+
+#pragma region Sweep
+	void Broadphase::UpdateRegion(Region& region) {
+		const uint32_t axis = m_desc.sweepAxis;
+
+		// Refresh keys and drop bodies that were removed or left this cell
+		std::erase_if(region.entries, [&](SortEntry& entry) {
+			const Body& body = m_bodies[entry.handle];
+			if (!body.alive || !body.cells.Contains(region.u, region.v))
+				return true;
+			entry.key = Component(body.box.min, axis);
+			return false;
+		});
+
+		const size_t coherent = region.entries.size();
+		for (const uint32_t handle : region.added)
+			region.entries.push_back({ Component(m_bodies[handle].box.min, axis), handle });
+		region.added.clear();
+
+		// Appended bodies can be anywhere in the order; a bulk insert is cheaper to sort from scratch
+		const size_t appended = region.entries.size() - coherent;
+		if (appended > 64 && appended * 16 > region.entries.size())
+			std::sort(region.entries.begin(), region.entries.end(), [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+		else
+			InsertionSort(region.entries);
+
+		const auto count = static_cast<uint32_t>(region.entries.size());
+		const size_t padded = count + Width;
+		for (auto* stream : { &region.sweepMin, &region.sweepMax, &region.uMin, &region.uMax, &region.vMin, &region.vMax })
+			stream->resize(padded);
+		region.handles.resize(count);
+
+		for (uint32_t i = 0; i < count; ++i) {
+			const uint32_t handle = region.entries[i].handle;
+			const AABB& box = m_bodies[handle].box;
+			region.sweepMin[i] = region.entries[i].key;
+			region.sweepMax[i] = Component(box.max, axis);
+			region.uMin[i] = Component(box.min, m_axisU);
+			region.uMax[i] = Component(box.max, m_axisU);
+			region.vMin[i] = Component(box.min, m_axisV);
+			region.vMax[i] = Component(box.max, m_axisV);
+			region.handles[i] = handle;
+		}
+		// Sentinels start after everything and overlap nothing
+		for (size_t i = count; i < padded; ++i) {
+			region.sweepMin[i] = std::numeric_limits<float>::infinity();
+			region.sweepMax[i] = -std::numeric_limits<float>::infinity();
+			region.uMin[i] = region.vMin[i] = std::numeric_limits<float>::infinity();
+			region.uMax[i] = region.vMax[i] = -std::numeric_limits<float>::infinity();
+		}
+
+		static const SweepFn sweep = SelectSweep();
+		const SweepInput input{
+			region.sweepMin.data(), region.sweepMax.data(),
+			region.uMin.data(), region.uMax.data(),
+			region.vMin.data(), region.vMax.data(),
+			region.handles.data(), count
+		};
+
+		// Sorted indices first; mapped to handles and filtered by ownership afterwards
+		region.pairs.clear();
+		sweep(input, region.pairs);
+
+		const bool shared = m_regions.size() > 1;
+		size_t kept = 0;
+		for (const BroadphasePair& candidate : region.pairs) {
+			const uint32_t i = candidate.a, j = candidate.b;
+			if (shared) {
+				// The overlap's minimum corner lies in exactly one cell; only that region reports the pair
+				if (CellU(std::max(input.uMin[i], input.uMin[j])) != region.u || CellV(std::max(input.vMin[i], input.vMin[j])) != region.v)
+					continue;
+			}
+			const uint32_t a = input.handles[i], b = input.handles[j];
+			region.pairs[kept++] = a < b ? BroadphasePair{ a, b } : BroadphasePair{ b, a };
+		}
+		region.pairs.resize(kept);
+	}
+
+	std::span<const BroadphasePair> Broadphase::FindPairs(LinearArena& arena, JobSystem* jobs) {
+		CommitMoves();
+
+		const auto update = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t r = begin; r < end; ++r)
+				UpdateRegion(m_regions[r]);
+		};
+		if (jobs)
+			jobs->ParallelFor(RegionCount(), 1, update);
+		else
+			update(0, RegionCount());
+
+		// Every region has dropped its removed bodies; their handles may now be reused
+		m_freeHandles.insert(m_freeHandles.end(), m_pendingFree.begin(), m_pendingFree.end());
+		m_pendingFree.clear();
+
+		size_t total = 0;
+		for (const Region& region : m_regions)
+			total += region.pairs.size();
+
+		const std::span<BroadphasePair> pairs = arena.Allocate<BroadphasePair>(total);
+		size_t offset = 0;
+		for (const Region& region : m_regions) {
+			std::ranges::copy(region.pairs, pairs.begin() + static_cast<ptrdiff_t>(offset));
+			offset += region.pairs.size();
+		}
+		return pairs;
+	}
+#pragma endregion
+
+} // namespace Zenyth
@@ -0,0 +1,60 @@
+#include "pch.hpp"
+#include "spatial/Frustum.hpp"
+
+using namespace zenyth::math;
+
+namespace Zenyth {
+
+	namespace {
+		vec4 Row(const mat4& m, const size_t r) noexcept {
+			return { m[r, 0], m[r, 1], m[r, 2], m[r, 3] };
+		}
+
+		vec4 Normalize(const vec4& plane) noexcept {
+			const float len = std::sqrt(plane.x() * plane.x() + plane.y() * plane.y() + plane.z() * plane.z());
+			return len > 0.0f ? plane / len : plane;
+		}
+
+		// Signed distance of the box corner furthest along (positive) or against (negative) the normal
+		float Distance(const vec4& plane, const AABB& box, const bool positive) noexcept {
+			const bool px = (plane.x() >= 0.0f) == positive;
+			const bool py = (plane.y() >= 0.0f) == positive;
+			const bool pz = (plane.z() >= 0.0f) == positive;
+			return plane.x() * (px ? box.max.x() : box.min.x())
+				+ plane.y() * (py ? box.max.y() : box.min.y())
+				+ plane.z() * (pz ? box.max.z() : box.min.z())
+				+ plane.w();
+		}
+	}
+
+	Frustum::Frustum(const mat4& viewProjection) noexcept {
+		const vec4 r0 = Row(viewProjection, 0);
+		const vec4 r1 = Row(viewProjection, 1);
+		const vec4 r2 = Row(viewProjection, 2);
+		const vec4 r3 = Row(viewProjection, 3);
+
+		m_planes[Left] = Normalize(r3 + r0);
+		m_planes[Right] = Normalize(r3 - r0);
+		m_planes[Bottom] = Normalize(r3 + r1);
+		m_planes[Top] = Normalize(r3 - r1);
+		m_planes[Near] = Normalize(r2);
+		m_planes[Far] = Normalize(r3 - r2);
+	}
+
+	bool Frustum::Intersects(const AABB& box) const noexcept {
+		for (const vec4& plane : m_planes) {
+			if (Distance(plane, box, true) < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::Contains(const AABB& box) const noexcept {
+		for (const vec4& plane : m_planes) {
+			if (Distance(plane, box, false) < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,948 @@
+#include "pch.hpp"
+#include "texture/BlockCompression.hpp"
+#include "CpuFeatures.hpp"
+
+#include <bit>
+#include <immintrin.h>
+#include <numeric>
+
+namespace Zenyth {
+
+	namespace {
+		constexpr uint16_t AllPixels = 0xFFFF;
+
+		// 4x4 pixels as float channels (r, g, b, a), one row of 16 per channel
+		struct alignas(32) Block {
+			float c[4][16];
+		};
+
+		struct alignas(32) Palette {
+			float    c[4][16];
+			uint32_t count = 0;
+		};
+
+		struct ChannelWeights {
+			float c[4];
+		};
+
+		constexpr ChannelWeights WeightsRGBA{ { 1.0f, 1.0f, 1.0f, 1.0f } };
+		constexpr ChannelWeights WeightsRGB{ { 1.0f, 1.0f, 1.0f, 0.0f } };
+
+		constexpr ChannelWeights SingleChannel(const uint32_t channel) noexcept {
+			ChannelWeights w{};
+			w.c[channel] = 1.0f;
+			return w;
+		}
+
+		// BC7 interpolation weights (out of 64) for 2, 3 and 4 bit indices
+		constexpr int Bc7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+		constexpr int Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// Two-subset partitions: bit i set when pixel i belongs to subset 1
+		constexpr uint16_t Bc7Partitions2[64] = {
+			0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+			0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+			0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+			0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+		};
+
+		// Pixel whose index drops its top bit in subset 1
+		constexpr uint8_t Bc7Anchors2[64] = {
+			15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+			15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+			15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+			 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+		};
+
+#pragma region Palette search
+		using FindIndicesFn = void (*)(const Block&, const Palette&, const ChannelWeights&, uint8_t*, float*);
+
+		void FindIndicesSse(const Block& block, const Palette& palette, const ChannelWeights& weights, uint8_t* indices, float* errors) {
+			const __m128 w[4] = {
+				_mm_set1_ps(weights.c[0]), _mm_set1_ps(weights.c[1]), _mm_set1_ps(weights.c[2]), _mm_set1_ps(weights.c[3])
+			};
+
+			for (uint32_t g = 0; g < 16; g += 4) {
+				const __m128 px[4] = {
+					_mm_load_ps(&block.c[0][g]), _mm_load_ps(&block.c[1][g]), _mm_load_ps(&block.c[2][g]), _mm_load_ps(&block.c[3][g])
+				};
+
+				__m128  best = _mm_set1_ps(std::numeric_limits<float>::max());
+				__m128i bestIndex = _mm_setzero_si128();
+				for (uint32_t k = 0; k < palette.count; ++k) {
+					__m128 error = _mm_setzero_ps();
+					for (uint32_t c = 0; c < 4; ++c) {
+						const __m128 d = _mm_sub_ps(px[c], _mm_set1_ps(palette.c[c][k]));
+						error = _mm_add_ps(error, _mm_mul_ps(w[c], _mm_mul_ps(d, d)));
+					}
+					const __m128 closer = _mm_cmplt_ps(error, best);
+					best = _mm_min_ps(error, best);
+					bestIndex = _mm_blendv_epi8(bestIndex, _mm_set1_epi32(static_cast<int>(k)), _mm_castps_si128(closer));
+				}
+
+				_mm_store_ps(errors + g, best);
+				alignas(16) int32_t index[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(index), bestIndex);
+				for (uint32_t i = 0; i < 4; ++i)
+					indices[g + i] = static_cast<uint8_t>(index[i]);
+			}
+		}
+
+		ZENYTH_TARGET_AVX2 void FindIndicesAvx2(const Block& block, const Palette& palette, const ChannelWeights& weights, uint8_t* indices, float* errors) {
+			const __m256 w[4] = {
+				_mm256_set1_ps(weights.c[0]), _mm256_set1_ps(weights.c[1]), _mm256_set1_ps(weights.c[2]), _mm256_set1_ps(weights.c[3])
+			};
+
+			for (uint32_t g = 0; g < 16; g += 8) {
+				const __m256 px[4] = {
+					_mm256_load_ps(&block.c[0][g]), _mm256_load_ps(&block.c[1][g]), _mm256_load_ps(&block.c[2][g]), _mm256_load_ps(&block.c[3][g])
+				};
+
+				__m256  best = _mm256_set1_ps(std::numeric_limits<float>::max());
+				__m256i bestIndex = _mm256_setzero_si256();
+				for (uint32_t k = 0; k < palette.count; ++k) {
+					__m256 error = _mm256_setzero_ps();
+					for (uint32_t c = 0; c < 4; ++c) {
+						const __m256 d = _mm256_sub_ps(px[c], _mm256_set1_ps(palette.c[c][k]));
+						error = _mm256_fmadd_ps(_mm256_mul_ps(w[c], d), d, error);
+					}
+					const __m256 closer = _mm256_cmp_ps(error, best, _CMP_LT_OQ);
+					best = _mm256_min_ps(error, best);
+					bestIndex = _mm256_blendv_epi8(bestIndex, _mm256_set1_epi32(static_cast<int>(k)), _mm256_castps_si256(closer));
+				}
+
+				_mm256_store_ps(errors + g, best);
+				alignas(32) int32_t index[8];
+				_mm256_store_si256(reinterpret_cast<__m256i*>(index), bestIndex);
+				for (uint32_t i = 0; i < 8; ++i)
+					indices[g + i] = static_cast<uint8_t>(index[i]);
+			}
+		}
+
+		// Nearest palette entry for every pixel; returns the weighted squared error over the pixels in mask
+		float Match(const Block& block, const Palette& palette, const ChannelWeights& weights, const uint16_t mask, uint8_t* indices) {
+			static const FindIndicesFn findIndices = GetCpuFeatures().avx2 && GetCpuFeatures().fma ? FindIndicesAvx2 : FindIndicesSse;
+
+			alignas(32) float errors[16];
+			findIndices(block, palette, weights, indices, errors);
+
+			float total = 0.0f;
+			for (uint32_t i = 0; i < 16; ++i) {
+				if (mask & (1u << i))
+					total += errors[i];
+			}
+			return total;
+		}
+#pragma endregion
+
+#pragma region Endpoint fitting
+		struct Endpoints {
+			float e[2][4];
+		};
+
+		// Mean and dominant direction of the masked pixels over the first `channels` channels
+		void PrincipalAxis(const Block& block, const uint16_t mask, const uint32_t channels, float mean[4], float axis[4]) {
+			const float n = static_cast<float>(std::popcount(mask));
+			for (uint32_t c = 0; c < 4; ++c) {
+				mean[c] = 0.0f;
+				axis[c] = 0.0f;
+			}
+			if (n == 0.0f)
+				return;
+
+			for (uint32_t i = 0; i < 16; ++i) {
+				if (mask & (1u << i)) {
+					for (uint32_t c = 0; c < channels; ++c)
+						mean[c] += block.c[c][i];
+				}
+			}
+			for (uint32_t c = 0; c < channels; ++c)
+				mean[c] /= n;
+
+			float cov[4][4] = {};
+			for (uint32_t i = 0; i < 16; ++i) {
+				if (!(mask & (1u << i)))
+					continue;
+				float d[4];
+				for (uint32_t c = 0; c < channels; ++c)
+					d[c] = block.c[c][i] - mean[c];
+				for (uint32_t j = 0; j < channels; ++j)
+					for (uint32_t k = 0; k < channels; ++k)
+						cov[j][k] += d[j] * d[k];
+			}
+
+			// Power iteration seeded with the covariance column of the widest channel
+			uint32_t widest = 0;
+			for (uint32_t c = 1; c < channels; ++c) {
+				if (cov[c][c] > cov[widest][widest])
+					widest = c;
+			}
+
+			float v[4] = {};
+			for (uint32_t c = 0; c < channels; ++c)
+				v[c] = cov[c][widest];
+
+			for (int iteration = 0; iteration < 8; ++iteration) {
+				float next[4] = {};
+				float largest = 0.0f;
+				for (uint32_t j = 0; j < channels; ++j) {
+					for (uint32_t k = 0; k < channels; ++k)
+						next[j] += cov[j][k] * v[k];
+					largest = std::max(largest, std::abs(next[j]));
+				}
+				if (largest == 0.0f)
+					break;
+				for (uint32_t c = 0; c < channels; ++c)
+					v[c] = next[c] / largest;
+			}
+
+			float length = 0.0f;
+			for (uint32_t c = 0; c < channels; ++c)
+				length += v[c] * v[c];
+			length = std::sqrt(length);
+
+			for (uint32_t c = 0; c < channels; ++c)
+				axis[c] = length > 0.0f ? v[c] / length : 1.0f / std::sqrt(static_cast<float>(channels));
+		}
+
+		void ClampEndpoints(Endpoints& ep) noexcept {
+			for (auto& e : ep.e)
+				for (float& c : e)
+					c = std::clamp(c, 0.0f, 255.0f);
+		}
+
+		// Extremes of the masked pixels projected on their principal axis
+		Endpoints RangeFit(const Block& block, const uint16_t mask, const uint32_t channels) {
+			float mean[4], axis[4];
+			PrincipalAxis(block, mask, channels, mean, axis);
+
+			float tMin = std::numeric_limits<float>::max();
+			float tMax = std::numeric_limits<float>::lowest();
+			for (uint32_t i = 0; i < 16; ++i) {
+				if (!(mask & (1u << i)))
+					continue;
+				float t = 0.0f;
+				for (uint32_t c = 0; c < channels; ++c)
+					t += (block.c[c][i] - mean[c]) * axis[c];
+				tMin = std::min(tMin, t);
+				tMax = std::max(tMax, t);
+			}
+			if (tMin > tMax)
+				tMin = tMax = 0.0f;
+
+			Endpoints ep{};
+			for (uint32_t c = 0; c < channels; ++c) {
+				ep.e[0][c] = mean[c] + axis[c] * tMin;
+				ep.e[1][c] = mean[c] + axis[c] * tMax;
+			}
+			for (uint32_t c = channels; c < 4; ++c)
+				ep.e[0][c] = ep.e[1][c] = 255.0f;
+			ClampEndpoints(ep);
+			return ep;
+		}
+
+		// Endpoints minimizing the squared error for fixed indices; weights[i] is how far index i lies toward e1
+		bool LeastSquares(const Block& block, const uint16_t mask, const uint32_t channels, const uint8_t* indices, const float* weights, Endpoints& ep) {
+			double a = 0.0, b = 0.0, c = 0.0;
+			double d0[4] = {}, d1[4] = {};
+
+			for (uint32_t i = 0; i < 16; ++i) {
+				if (!(mask & (1u << i)))
+					continue;
+				const double w = weights[indices[i]];
+				a += (1.0 - w) * (1.0 - w);
+				b += (1.0 - w) * w;
+				c += w * w;
+				for (uint32_t ch = 0; ch < channels; ++ch) {
+					d0[ch] += (1.0 - w) * block.c[ch][i];
+					d1[ch] += w * block.c[ch][i];
+				}
+			}
+
+			const double det = a * c - b * b;
+			if (std::abs(det) < 1e-6)
+				return false;
+
+			for (uint32_t ch = 0; ch < channels; ++ch) {
+				ep.e[0][ch] = static_cast<float>((c * d0[ch] - b * d1[ch]) / det);
+				ep.e[1][ch] = static_cast<float>((a * d1[ch] - b * d0[ch]) / det);
+			}
+			ClampEndpoints(ep);
+			return true;
+		}
+
+		int RefinementPasses(const CompressionQuality quality) noexcept {
+			switch (quality) {
+				case CompressionQuality::Fast:   return 1;
+				case CompressionQuality::Normal: return 2;
+				default:                         return 4;
+			}
+		}
+#pragma endregion
+
+#pragma region BC1
+		constexpr float Bc1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		constexpr int   Bc1Limits[3] = { 31, 63, 31 };
+
+		struct Bc1Endpoints {
+			int q[2][3]; // 5:6:5
+		};
+
+		Bc1Endpoints Quantize565(const Endpoints& ep) noexcept {
+			Bc1Endpoints out;
+			for (uint32_t k = 0; k < 2; ++k)
+				for (uint32_t c = 0; c < 3; ++c)
+					out.q[k][c] = std::clamp(static_cast<int>(ep.e[k][c] * Bc1Limits[c] / 255.0f + 0.5f), 0, Bc1Limits[c]);
+			return out;
+		}
+
+		float Expand565(const int q, const uint32_t channel) noexcept {
+			return static_cast<float>(channel == 1 ? (q << 2) | (q >> 4) : (q << 3) | (q >> 2));
+		}
+
+		float EvaluateBc1(const Block& block, const Bc1Endpoints& ep, uint8_t* indices) {
+			Palette palette{};
+			palette.count = 4;
+			for (uint32_t c = 0; c < 3; ++c) {
+				const float c0 = Expand565(ep.q[0][c], c);
+				const float c1 = Expand565(ep.q[1][c], c);
+				palette.c[c][0] = c0;
+				palette.c[c][1] = c1;
+				palette.c[c][2] = (2.0f * c0 + c1) / 3.0f;
+				palette.c[c][3] = (c0 + 2.0f * c1) / 3.0f;
+			}
+			return Match(block, palette, WeightsRGB, AllPixels, indices);
+		}
+
+		void WriteBc1(const Bc1Endpoints& ep, const uint8_t* indices, uint8_t* out) noexcept {
+			uint16_t c0 = static_cast<uint16_t>(ep.q[0][0] << 11 | ep.q[0][1] << 5 | ep.q[0][2]);
+			uint16_t c1 = static_cast<uint16_t>(ep.q[1][0] << 11 | ep.q[1][1] << 5 | ep.q[1][2]);
+
+			// Four color mode needs c0 > c1; equal endpoints decode every index 0 to c0 either way
+			uint32_t bits = 0;
+			if (c0 != c1) {
+				const uint32_t flip = c0 < c1 ? 1u : 0u;
+				if (flip)
+					std::swap(c0, c1);
+				for (uint32_t i = 0; i < 16; ++i)
+					bits |= (indices[i] ^ flip) << (i * 2);
+			}
+
+			out[0] = static_cast<uint8_t>(c0);
+			out[1] = static_cast<uint8_t>(c0 >> 8);
+			out[2] = static_cast<uint8_t>(c1);
+			out[3] = static_cast<uint8_t>(c1 >> 8);
+			for (uint32_t i = 0; i < 4; ++i)
+				out[4 + i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+
+		void EncodeBc1(const Block& block, const CompressionQuality quality, uint8_t* out) {
+			Endpoints    fit = RangeFit(block, AllPixels, 3);
+			Bc1Endpoints best = Quantize565(fit);
+			uint8_t      indices[16], trial[16];
+			float        bestError = EvaluateBc1(block, best, indices);
+
+			if (quality != CompressionQuality::Fast) {
+				for (int pass = 0; pass < RefinementPasses(quality); ++pass) {
+					Endpoints refined = fit;
+					if (!LeastSquares(block, AllPixels, 3, indices, Bc1Weights, refined))
+						break;
+
+					const Bc1Endpoints candidate = Quantize565(refined);
+					const float error = EvaluateBc1(block, candidate, trial);
+					if (error >= bestError)
+						break;
+
+					fit = refined;
+					best = candidate;
+					bestError = error;
+					std::copy_n(trial, 16, indices);
+				}
+			}
+
+			if (quality == CompressionQuality::High) {
+				// Greedy single-step search around the quantized endpoints
+				for (int round = 0; round < 8; ++round) {
+					bool improved = false;
+					for (uint32_t k = 0; k < 2; ++k) {
+						for (uint32_t c = 0; c < 3; ++c) {
+							for (const int step : { -1, 1 }) {
+								Bc1Endpoints candidate = best;
+								candidate.q[k][c] += step;
+								if (candidate.q[k][c] < 0 || candidate.q[k][c] > Bc1Limits[c])
+									continue;
+
+								const float error = EvaluateBc1(block, candidate, trial);
+								if (error < bestError) {
+									best = candidate;
+									bestError = error;
+									std::copy_n(trial, 16, indices);
+									improved = true;
+								}
+							}
+						}
+					}
+					if (!improved)
+						break;
+				}
+			}
+
+			WriteBc1(best, indices, out);
+		}
+#pragma endregion
+
+#pragma region BC4
+		// Index weights toward e1 in the 8 value (e0 > e1) and 6 value (e0 <= e1) modes
+		constexpr float Bc4Weights8[8] = { 0.0f, 1.0f, 1.0f / 7, 2.0f / 7, 3.0f / 7, 4.0f / 7, 5.0f / 7, 6.0f / 7 };
+		constexpr float Bc4Weights6[8] = { 0.0f, 1.0f, 1.0f / 5, 2.0f / 5, 3.0f / 5, 4.0f / 5, 0.0f, 0.0f };
+
+		float EvaluateBc4(const Block& block, const uint32_t channel, const int e0, const int e1, uint8_t* indices) {
+			Palette palette{};
+			palette.count = 8;
+			float* p = palette.c[channel];
+			p[0] = static_cast<float>(e0);
+			p[1] = static_cast<float>(e1);
+
+			if (e0 > e1) {
+				for (int i = 2; i < 8; ++i)
+					p[i] = static_cast<float>((8 - i) * e0 + (i - 1) * e1) / 7.0f;
+			}
+			else {
+				for (int i = 2; i < 6; ++i)
+					p[i] = static_cast<float>((6 - i) * e0 + (i - 1) * e1) / 5.0f;
+				p[6] = 0.0f;
+				p[7] = 255.0f;
+			}
+			return Match(block, palette, SingleChannel(channel), AllPixels, indices);
+		}
+
+		void EncodeBc4(const Block& block, const uint32_t channel, const CompressionQuality quality, uint8_t* out) {
+			const float* values = block.c[channel];
+			const auto [lo, hi] = std::minmax_element(values, values + 16);
+
+			int     best0 = static_cast<int>(*hi + 0.5f);
+			int     best1 = static_cast<int>(*lo + 0.5f);
+			uint8_t indices[16] = {};
+			uint8_t trial[16];
+			float   bestError = 0.0f;
+
+			if (best0 != best1) {
+				bestError = EvaluateBc4(block, channel, best0, best1, indices);
+
+				const auto tryEndpoints = [&](const int e0, const int e1) {
+					if (e0 < 0 || e0 > 255 || e1 < 0 || e1 > 255 || e0 == e1)
+						return;
+					const float error = EvaluateBc4(block, channel, e0, e1, trial);
+					if (error < bestError) {
+						best0 = e0;
+						best1 = e1;
+						bestError = error;
+						std::copy_n(trial, 16, indices);
+					}
+				};
+
+				if (quality != CompressionQuality::Fast) {
+					for (int pass = 0; pass < RefinementPasses(quality); ++pass) {
+						Endpoints ep{};
+						ep.e[0][channel] = static_cast<float>(best0);
+						ep.e[1][channel] = static_cast<float>(best1);
+
+						// Pixels snapped to the fixed 0/255 entries of the 6 value mode take no part in the fit
+						uint16_t mask = AllPixels;
+						if (best0 <= best1) {
+							for (uint32_t i = 0; i < 16; ++i)
+								if (indices[i] >= 6)
+									mask &= static_cast<uint16_t>(~(1u << i));
+						}
+
+						const float* weights = best0 > best1 ? Bc4Weights8 : Bc4Weights6;
+						Block single{};
+						std::copy_n(values, 16, single.c[channel]);
+						if (!mask || !LeastSquares(single, mask, channel + 1, indices, weights, ep))
+							break;
+
+						const float before = bestError;
+						int e0 = static_cast<int>(ep.e[0][channel] + 0.5f);
+						int e1 = static_cast<int>(ep.e[1][channel] + 0.5f);
+						if ((best0 > best1) != (e0 > e1))
+							std::swap(e0, e1);
+						tryEndpoints(e0, e1);
+						if (bestError >= before)
+							break;
+					}
+
+					// Six value mode keeps exact 0 and 255 for blocks that touch the extremes
+					float innerLo = 255.0f, innerHi = 0.0f;
+					bool  extremes = false;
+					for (uint32_t i = 0; i < 16; ++i) {
+						if (values[i] <= 0.0f || values[i] >= 255.0f) {
+							extremes = true;
+							continue;
+						}
+						innerLo = std::min(innerLo, values[i]);
+						innerHi = std::max(innerHi, values[i]);
+					}
+					if (extremes && innerLo <= innerHi)
+						tryEndpoints(static_cast<int>(innerLo + 0.5f), std::max(static_cast<int>(innerHi + 0.5f), static_cast<int>(innerLo + 0.5f) + 1));
+				}
+
+				if (quality == CompressionQuality::High) {
+					const int center0 = best0, center1 = best1;
+					for (int d0 = -2; d0 <= 2; ++d0) {
+						for (int d1 = -2; d1 <= 2; ++d1) {
+							const int e0 = center0 + d0, e1 = center1 + d1;
+							if ((e0 > e1) == (center0 > center1))
+								tryEndpoints(e0, e1);
+						}
+					}
+				}
+			}
+
+			out[0] = static_cast<uint8_t>(best0);
+			out[1] = static_cast<uint8_t>(best1);
+			uint64_t bits = 0;
+			for (uint32_t i = 0; i < 16; ++i)
+				bits |= static_cast<uint64_t>(indices[i] & 7) << (i * 3);
+			for (uint32_t i = 0; i < 6; ++i)
+				out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+#pragma endregion
+
+#pragma region BC7
+		class BitWriter {
+		public:
+			void Write(const uint32_t value, const uint32_t bits) noexcept {
+				const uint64_t v = value & ((1ull << bits) - 1);
+				if (m_position < 64) {
+					m_low |= v << m_position;
+					if (m_position + bits > 64)
+						m_high |= v >> (64 - m_position);
+				}
+				else {
+					m_high |= v << (m_position - 64);
+				}
+				m_position += bits;
+			}
+
+			void Store(uint8_t* out) const noexcept {
+				for (uint32_t i = 0; i < 8; ++i) {
+					out[i] = static_cast<uint8_t>(m_low >> (i * 8));
+					out[8 + i] = static_cast<uint8_t>(m_high >> (i * 8));
+				}
+			}
+
+		private:
+			uint64_t m_low = 0;
+			uint64_t m_high = 0;
+			uint32_t m_position = 0;
+		};
+
+		// (bits + 1)-bit endpoint with its p-bit, widened to 8 bits the way the decoder does
+		int ExpandEndpoint(const int q, const int p, const int bits) noexcept {
+			const int total = bits + 1;
+			const int v = (q << 1) | p;
+			return total == 8 ? v : (v << (8 - total)) | (v >> (2 * total - 8));
+		}
+
+		int QuantizeEndpoint(const float target, const int bits, const int p, float* error = nullptr) noexcept {
+			const int   maxQ = (1 << bits) - 1;
+			const float scaled = target / 255.0f * static_cast<float>((1 << (bits + 1)) - 1);
+			const int   guess = std::clamp(static_cast<int>(std::lround((scaled - static_cast<float>(p)) * 0.5f)), 0, maxQ);
+
+			int   best = guess;
+			float bestError = std::numeric_limits<float>::max();
+			for (int q = std::max(0, guess - 1); q <= std::min(maxQ, guess + 1); ++q) {
+				const float e = std::abs(static_cast<float>(ExpandEndpoint(q, p, bits)) - target);
+				if (e < bestError) {
+					bestError = e;
+					best = q;
+				}
+			}
+			if (error)
+				*error = bestError * bestError;
+			return best;
+		}
+
+		// Mode 6: one subset, RGBA 7.7.7.7 endpoints with a p-bit each, 4-bit indices
+		struct Mode6 {
+			int     q[2][4];
+			int     p[2];
+			uint8_t indices[16];
+			float   error;
+		};
+
+		float EvaluateMode6(const Block& block, Mode6& m) {
+			Palette palette{};
+			palette.count = 16;
+			for (uint32_t c = 0; c < 4; ++c) {
+				const int e0 = ExpandEndpoint(m.q[0][c], m.p[0], 7);
+				const int e1 = ExpandEndpoint(m.q[1][c], m.p[1], 7);
+				for (uint32_t i = 0; i < 16; ++i)
+					palette.c[c][i] = static_cast<float>(((64 - Bc7Weights4[i]) * e0 + Bc7Weights4[i] * e1 + 32) >> 6);
+			}
+			m.error = Match(block, palette, WeightsRGBA, AllPixels, m.indices);
+			return m.error;
+		}
+
+		Mode6 QuantizeMode6(const Block& block, const Endpoints& ep) {
+			Mode6 m{};
+			for (uint32_t k = 0; k < 2; ++k) {
+				float bestError = std::numeric_limits<float>::max();
+				for (int p = 0; p < 2; ++p) {
+					int   q[4];
+					float total = 0.0f;
+					for (uint32_t c = 0; c < 4; ++c) {
+						float e;
+						q[c] = QuantizeEndpoint(ep.e[k][c], 7, p, &e);
+						total += e;
+					}
+					if (total < bestError) {
+						bestError = total;
+						m.p[k] = p;
+						std::copy_n(q, 4, m.q[k]);
+					}
+				}
+			}
+			EvaluateMode6(block, m);
+			return m;
+		}
+
+		Mode6 EncodeMode6(const Block& block, const CompressionQuality quality) {
+			static const auto weights = [] {
+				std::array<float, 16> w{};
+				for (uint32_t i = 0; i < 16; ++i)
+					w[i] = static_cast<float>(Bc7Weights4[i]) / 64.0f;
+				return w;
+			}();
+
+			Endpoints fit = RangeFit(block, AllPixels, 4);
+			Mode6     best = QuantizeMode6(block, fit);
+
+			for (int pass = 0; pass < RefinementPasses(quality); ++pass) {
+				Endpoints refined = fit;
+				if (!LeastSquares(block, AllPixels, 4, best.indices, weights.data(), refined))
+					break;
+				const Mode6 candidate = QuantizeMode6(block, refined);
+				if (candidate.error >= best.error)
+					break;
+				fit = refined;
+				best = candidate;
+			}
+
+			if (quality == CompressionQuality::High) {
+				// Every p-bit pairing, then single steps on each quantized channel
+				for (int pairing = 0; pairing < 4; ++pairing) {
+					Mode6 candidate = best;
+					for (uint32_t k = 0; k < 2; ++k) {
+						candidate.p[k] = (pairing >> k) & 1;
+						for (uint32_t c = 0; c < 4; ++c)
+							candidate.q[k][c] = QuantizeEndpoint(fit.e[k][c], 7, candidate.p[k]);
+					}
+					if (EvaluateMode6(block, candidate) < best.error)
+						best = candidate;
+				}
+
+				for (int round = 0; round < 4; ++round) {
+					bool improved = false;
+					for (uint32_t k = 0; k < 2; ++k) {
+						for (uint32_t c = 0; c < 4; ++c) {
+							for (const int step : { -1, 1 }) {
+								Mode6 candidate = best;
+								candidate.q[k][c] += step;
+								if (candidate.q[k][c] < 0 || candidate.q[k][c] > 127)
+									continue;
+								if (EvaluateMode6(block, candidate) < best.error) {
+									best = candidate;
+									improved = true;
+								}
+							}
+						}
+					}
+					if (!improved)
+						break;
+				}
+			}
+
+			return best;
+		}
+
+		void WriteMode6(Mode6 m, uint8_t* out) noexcept {
+			// The anchor index drops its top bit
+			if (m.indices[0] & 8) {
+				std::swap(m.q[0], m.q[1]);
+				std::swap(m.p[0], m.p[1]);
+				for (uint8_t& index : m.indices)
+					index = static_cast<uint8_t>(15 - index);
+			}
+
+			BitWriter writer;
+			writer.Write(1u << 6, 7);
+			for (uint32_t c = 0; c < 4; ++c) {
+				writer.Write(static_cast<uint32_t>(m.q[0][c]), 7);
+				writer.Write(static_cast<uint32_t>(m.q[1][c]), 7);
+			}
+			writer.Write(static_cast<uint32_t>(m.p[0]), 1);
+			writer.Write(static_cast<uint32_t>(m.p[1]), 1);
+			for (uint32_t i = 0; i < 16; ++i)
+				writer.Write(m.indices[i], i == 0 ? 3 : 4);
+			writer.Store(out);
+		}
+
+		// Mode 1: two subsets, RGB 6.6.6 endpoints with one shared p-bit per subset, 3-bit indices
+		struct Mode1 {
+			uint32_t partition;
+			int      q[2][2][3]; // [subset][endpoint][channel]
+			int      p[2];
+			uint8_t  indices[16];
+			float    error;
+		};
+
+		uint16_t SubsetMask(const uint32_t partition, const uint32_t subset) noexcept {
+			return subset ? Bc7Partitions2[partition] : static_cast<uint16_t>(~Bc7Partitions2[partition]);
+		}
+
+		float EvaluateMode1Subset(const Block& block, const uint16_t mask, const int q[2][3], const int p, uint8_t* indices) {
+			Palette palette{};
+			palette.count = 8;
+			for (uint32_t c = 0; c < 3; ++c) {
+				const int e0 = ExpandEndpoint(q[0][c], p, 6);
+				const int e1 = ExpandEndpoint(q[1][c], p, 6);
+				for (uint32_t i = 0; i < 8; ++i)
+					palette.c[c][i] = static_cast<float>(((64 - Bc7Weights3[i]) * e0 + Bc7Weights3[i] * e1 + 32) >> 6);
+			}
+			return Match(block, palette, WeightsRGB, mask, indices);
+		}
+
+		float EncodeMode1Subset(const Block& block, const uint16_t mask, const CompressionQuality quality, int q[2][3], int& p, uint8_t* indices) {
+			static const auto weights = [] {
+				std::array<float, 8> w{};
+				for (uint32_t i = 0; i < 8; ++i)
+					w[i] = static_cast<float>(Bc7Weights3[i]) / 64.0f;
+				return w;
+			}();
+
+			const auto quantize = [&](const Endpoints& ep, int out[2][3], int& outP, uint8_t* outIndices) {
+				float best = std::numeric_limits<float>::max();
+				for (int pBit = 0; pBit < 2; ++pBit) {
+					int     candidate[2][3];
+					uint8_t candidateIndices[16];
+					for (uint32_t k = 0; k < 2; ++k)
+						for (uint32_t c = 0; c < 3; ++c)
+							candidate[k][c] = QuantizeEndpoint(ep.e[k][c], 6, pBit);
+
+					const float error = EvaluateMode1Subset(block, mask, candidate, pBit, candidateIndices);
+					if (error < best) {
+						best = error;
+						outP = pBit;
+						std::copy_n(&candidate[0][0], 6, &out[0][0]);
+						std::copy_n(candidateIndices, 16, outIndices);
+					}
+				}
+				return best;
+			};
+
+			Endpoints fit = RangeFit(block, mask, 3);
+			float     bestError = quantize(fit, q, p, indices);
+
+			for (int pass = 0; pass < RefinementPasses(quality); ++pass) {
+				Endpoints refined = fit;
+				if (!LeastSquares(block, mask, 3, indices, weights.data(), refined))
+					break;
+
+				int     candidate[2][3];
+				int     candidateP = 0;
+				uint8_t candidateIndices[16];
+				const float error = quantize(refined, candidate, candidateP, candidateIndices);
+				if (error >= bestError)
+					break;
+
+				fit = refined;
+				bestError = error;
+				p = candidateP;
+				std::copy_n(&candidate[0][0], 6, &q[0][0]);
+				std::copy_n(candidateIndices, 16, indices);
+			}
+			return bestError;
+		}
+
+		// Squared distance of each subset's pixels from its principal axis, summed
+		float PartitionEstimate(const Block& block, const uint32_t partition) {
+			float total = 0.0f;
+			for (uint32_t subset = 0; subset < 2; ++subset) {
+				const uint16_t mask = SubsetMask(partition, subset);
+				float mean[4], axis[4];
+				PrincipalAxis(block, mask, 3, mean, axis);
+				for (uint32_t i = 0; i < 16; ++i) {
+					if (!(mask & (1u << i)))
+						continue;
+					float d[3], t = 0.0f, lengthSq = 0.0f;
+					for (uint32_t c = 0; c < 3; ++c) {
+						d[c] = block.c[c][i] - mean[c];
+						t += d[c] * axis[c];
+						lengthSq += d[c] * d[c];
+					}
+					total += lengthSq - t * t;
+				}
+			}
+			return total;
+		}
+
+		Mode1 EncodeMode1(const Block& block, const CompressionQuality quality) {
+			uint32_t candidates[64];
+			uint32_t candidateCount = 64;
+			std::iota(candidates, candidates + 64, 0u);
+
+			if (quality != CompressionQuality::High) {
+				float estimates[64];
+				for (uint32_t i = 0; i < 64; ++i)
+					estimates[i] = PartitionEstimate(block, i);
+				candidateCount = 4;
+				std::partial_sort(candidates, candidates + candidateCount, candidates + 64,
+					[&](const uint32_t a, const uint32_t b) { return estimates[a] < estimates[b]; });
+			}
+
+			Mode1 best{};
+			best.error = std::numeric_limits<float>::max();
+			for (uint32_t n = 0; n < candidateCount; ++n) {
+				Mode1 m{};
+				m.partition = candidates[n];
+				m.error = 0.0f;
+
+				uint8_t subsetIndices[2][16];
+				for (uint32_t subset = 0; subset < 2 && m.error < best.error; ++subset)
+					m.error += EncodeMode1Subset(block, SubsetMask(m.partition, subset), quality, m.q[subset], m.p[subset], subsetIndices[subset]);
+
+				if (m.error < best.error) {
+					const uint16_t second = Bc7Partitions2[m.partition];
+					for (uint32_t i = 0; i < 16; ++i)
+						m.indices[i] = subsetIndices[(second >> i) & 1][i];
+					best = m;
+				}
+			}
+			return best;
+		}
+
+		void WriteMode1(Mode1 m, uint8_t* out) noexcept {
+			const uint16_t second = Bc7Partitions2[m.partition];
+			const uint32_t anchors[2] = { 0, Bc7Anchors2[m.partition] };
+
+			for (uint32_t subset = 0; subset < 2; ++subset) {
+				if (!(m.indices[anchors[subset]] & 4))
+					continue;
+				std::swap(m.q[subset][0], m.q[subset][1]);
+				for (uint32_t i = 0; i < 16; ++i) {
+					if (((second >> i) & 1) == subset)
+						m.indices[i] = static_cast<uint8_t>(7 - m.indices[i]);
+				}
+			}
+
+			BitWriter writer;
+			writer.Write(1u << 1, 2);
+			writer.Write(m.partition, 6);
+			for (uint32_t c = 0; c < 3; ++c)
+				for (uint32_t subset = 0; subset < 2; ++subset)
+					for (uint32_t k = 0; k < 2; ++k)
+						writer.Write(static_cast<uint32_t>(m.q[subset][k][c]), 6);
+			writer.Write(static_cast<uint32_t>(m.p[0]), 1);
+			writer.Write(static_cast<uint32_t>(m.p[1]), 1);
+			for (uint32_t i = 0; i < 16; ++i)
+				writer.Write(m.indices[i], i == anchors[0] || i == anchors[1] ? 2 : 3);
+			writer.Store(out);
+		}
+
+		void EncodeBc7(const Block& block, const CompressionQuality quality, uint8_t* out) {
+			const Mode6 mode6 = EncodeMode6(block, quality);
+
+			bool opaque = true;
+			for (const float a : block.c[3])
+				opaque &= a >= 255.0f;
+
+			// Mode 1 has no alpha but twice the endpoints; worth it on opaque blocks with two distinct regions
+			if (quality != CompressionQuality::Fast && opaque && mode6.error > 0.0f) {
+				const Mode1 mode1 = EncodeMode1(block, quality);
+				if (mode1.error < mode6.error) {
+					WriteMode1(mode1, out);
+					return;
+				}
+			}
+			WriteMode6(mode6, out);
+		}
+#pragma endregion
+
+		Block LoadBlock(const uint8_t* rgba) noexcept {
+			Block block;
+			for (uint32_t i = 0; i < 16; ++i)
+				for (uint32_t c = 0; c < 4; ++c)
+					block.c[c][i] = rgba[i * 4 + c];
+			return block;
+		}
+	}
+
+	uint32_t BlockBytes(const BlockFormat format) noexcept {
+		return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+	}
+
+	size_t CompressedSize(const BlockFormat format, const uint32_t width, const uint32_t height) noexcept {
+		return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+	}
+
+	void EncodeBlock(const BlockFormat format, const uint8_t* rgba, const CompressionQuality quality, uint8_t* out) noexcept {
+		const Block block = LoadBlock(rgba);
+
+		switch (format) {
+			case BlockFormat::BC1:
+				EncodeBc1(block, quality, out);
+				break;
+			case BlockFormat::BC3:
+				EncodeBc4(block, 3, quality, out);
+				EncodeBc1(block, quality, out + 8);
+				break;
+			case BlockFormat::BC4:
+				EncodeBc4(block, 0, quality, out);
+				break;
+			case BlockFormat::BC5:
+				EncodeBc4(block, 0, quality, out);
+				EncodeBc4(block, 1, quality, out + 8);
+				break;
+			case BlockFormat::BC7:
+				EncodeBc7(block, quality, out);
+				break;
+		}
+	}
+
+	void CompressImage(const ImageView& image, const BlockFormat format, const CompressionQuality quality,
+		const std::span<std::byte> out, JobSystem* jobs)
+	{
+		if (out.size() < CompressedSize(format, image.width, image.height))
+			throw std::invalid_argument("CompressImage : output buffer too small");
+		if (image.width == 0 || image.height == 0)
+			return;
+
+		const uint32_t blocksX = (image.width + 3) / 4;
+		const uint32_t blocksY = (image.height + 3) / 4;
+		const uint32_t blockBytes = BlockBytes(format);
+		auto* dst = reinterpret_cast<uint8_t*>(out.data());
+
+		const auto encodeRows = [&](const uint32_t begin, const uint32_t end) {
+			uint8_t rgba[64];
+			for (uint32_t by = begin; by < end; ++by) {
+				for (uint32_t bx = 0; bx < blocksX; ++bx) {
+					for (uint32_t y = 0; y < 4; ++y) {
+						const uint8_t* row = image.Row(std::min(by * 4 + y, image.height - 1));
+						for (uint32_t x = 0; x < 4; ++x)
+							std::memcpy(rgba + (y * 4 + x) * 4, row + std::min(bx * 4 + x, image.width - 1) * 4, 4);
+					}
+					EncodeBlock(format, rgba, quality, dst + (static_cast<size_t>(by) * blocksX + bx) * blockBytes);
+				}
+			}
+		};
+
+		// Around 256 blocks per job
+		const uint32_t grain = std::max(1u, 256 / blocksX);
+		if (jobs)
+			jobs->ParallelFor(blocksY, grain, encodeRows);
+		else
+			encodeRows(0, blocksY);
+	}
+
+} // namespace Zenyth
@@ -0,0 +1,252 @@
+#include "pch.hpp"
+#include "texture/MipChain.hpp"
+
+#include <immintrin.h>
+
+namespace Zenyth {
+
+	namespace {
+		constexpr uint32_t KaiserTaps = 8;
+		constexpr uint32_t RowGrain = 16;
+
+		// One pixel, loaded and stored as an __m128
+		struct alignas(16) Float4 {
+			float v[4];
+		};
+
+		__m128 Load(const Float4& pixel) noexcept { return _mm_load_ps(pixel.v); }
+		void   Store(Float4& pixel, const __m128 value) noexcept { _mm_store_ps(pixel.v, value); }
+
+		// Linear float RGBA
+		struct FloatImage {
+			uint32_t            width = 0;
+			uint32_t            height = 0;
+			std::vector<Float4> pixels;
+
+			FloatImage(const uint32_t w, const uint32_t h) : width(w), height(h), pixels(static_cast<size_t>(w) * h) {}
+
+			[[nodiscard]] Float4*       Row(const uint32_t y) noexcept { return pixels.data() + static_cast<size_t>(y) * width; }
+			[[nodiscard]] const Float4* Row(const uint32_t y) const noexcept { return pixels.data() + static_cast<size_t>(y) * width; }
+		};
+
+		struct ColorTables {
+			float   toLinear[256];
+			uint8_t toSrgb[4096]; // indexed by linear * 4095
+
+			ColorTables() {
+				for (uint32_t i = 0; i < 256; ++i) {
+					const float c = static_cast<float>(i) / 255.0f;
+					toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				for (uint32_t i = 0; i < 4096; ++i) {
+					const float l = static_cast<float>(i) / 4095.0f;
+					const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+					toSrgb[i] = static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+		};
+
+		const ColorTables& Tables() {
+			static const ColorTables tables;
+			return tables;
+		}
+
+		double BesselI0(const double x) noexcept {
+			double sum = 1.0, term = 1.0;
+			for (int k = 1; k < 32; ++k) {
+				term *= (x / (2.0 * k)) * (x / (2.0 * k));
+				sum += term;
+			}
+			return sum;
+		}
+
+		// Weights for source pixels 2x-3 .. 2x+4 around destination pixel x
+		std::array<float, KaiserTaps> KaiserWeights() {
+			constexpr double Alpha = 4.0;
+			constexpr double Pi = 3.14159265358979323846;
+
+			std::array<double, KaiserTaps> w{};
+			double total = 0.0;
+			for (uint32_t i = 0; i < KaiserTaps; ++i) {
+				const double d = static_cast<double>(i) - 3.5;       // distance from the destination center, in source pixels
+				const double t = d * 0.5;                            // in destination pixels
+				const double sinc = t == 0.0 ? 1.0 : std::sin(Pi * t) / (Pi * t);
+				const double r = d / 4.0;
+				const double window = BesselI0(Alpha * std::sqrt(std::max(0.0, 1.0 - r * r))) / BesselI0(Alpha);
+				w[i] = sinc * window;
+				total += w[i];
+			}
+
+			std::array<float, KaiserTaps> weights{};
+			for (uint32_t i = 0; i < KaiserTaps; ++i)
+				weights[i] = static_cast<float>(w[i] / total);
+			return weights;
+		}
+
+		template<typename F>
+		void ForRows(JobSystem* jobs, const uint32_t rows, F&& fn) {
+			if (jobs)
+				jobs->ParallelFor(rows, RowGrain, fn);
+			else
+				fn(0u, rows);
+		}
+
+		FloatImage ToFloat(const ImageView& image, const bool srgb, JobSystem* jobs) {
+			FloatImage out(image.width, image.height);
+			const float* toLinear = Tables().toLinear;
+			const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+			ForRows(jobs, image.height, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t y = begin; y < end; ++y) {
+					const uint8_t* src = image.Row(y);
+					Float4* dst = out.Row(y);
+					for (uint32_t x = 0; x < image.width; ++x, src += 4) {
+						if (srgb)
+							Store(dst[x], _mm_setr_ps(toLinear[src[0]], toLinear[src[1]], toLinear[src[2]], src[3] / 255.0f));
+						else {
+							int packed;
+							std::memcpy(&packed, src, sizeof(packed));
+							Store(dst[x], _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed))), scale));
+						}
+					}
+				}
+			});
+			return out;
+		}
+
+		Image ToImage(const FloatImage& image, const bool srgb, JobSystem* jobs) {
+			Image out(image.width, image.height);
+			const uint8_t* toSrgb = Tables().toSrgb;
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+
+			ForRows(jobs, image.height, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t y = begin; y < end; ++y) {
+					const Float4* src = image.Row(y);
+					uint8_t* dst = out.Row(y);
+					for (uint32_t x = 0; x < image.width; ++x, dst += 4) {
+						const __m128 c = _mm_min_ps(_mm_max_ps(Load(src[x]), zero), one);
+						if (srgb) {
+							alignas(16) int32_t q[4];
+							_mm_store_si128(reinterpret_cast<__m128i*>(q), _mm_cvtps_epi32(_mm_mul_ps(c, _mm_setr_ps(4095.0f, 4095.0f, 4095.0f, 255.0f))));
+							dst[0] = toSrgb[q[0]];
+							dst[1] = toSrgb[q[1]];
+							dst[2] = toSrgb[q[2]];
+							dst[3] = static_cast<uint8_t>(q[3]);
+						}
+						else {
+							const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(c, _mm_set1_ps(255.0f)));
+							const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(q, q), _mm_setzero_si128());
+							const int rgba = _mm_cvtsi128_si32(packed);
+							std::memcpy(dst, &rgba, sizeof(rgba));
+						}
+					}
+				}
+			});
+			return out;
+		}
+
+		FloatImage DownsampleBox(const FloatImage& src, JobSystem* jobs) {
+			FloatImage dst(std::max(1u, src.width / 2), std::max(1u, src.height / 2));
+			const __m128 quarter = _mm_set1_ps(0.25f);
+
+			ForRows(jobs, dst.height, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t y = begin; y < end; ++y) {
+					const Float4* row0 = src.Row(std::min(y * 2, src.height - 1));
+					const Float4* row1 = src.Row(std::min(y * 2 + 1, src.height - 1));
+					Float4* out = dst.Row(y);
+					for (uint32_t x = 0; x < dst.width; ++x) {
+						const uint32_t x0 = std::min(x * 2, src.width - 1);
+						const uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+						const __m128 top = _mm_add_ps(Load(row0[x0]), Load(row0[x1]));
+						const __m128 bottom = _mm_add_ps(Load(row1[x0]), Load(row1[x1]));
+						Store(out[x], _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+					}
+				}
+			});
+			return dst;
+		}
+
+		FloatImage DownsampleKaiser(const FloatImage& src, JobSystem* jobs) {
+			static const std::array<float, KaiserTaps> weights = KaiserWeights();
+			const uint32_t dstWidth = std::max(1u, src.width / 2);
+			const uint32_t dstHeight = std::max(1u, src.height / 2);
+
+			__m128 w[KaiserTaps];
+			for (uint32_t i = 0; i < KaiserTaps; ++i)
+				w[i] = _mm_set1_ps(weights[i]);
+
+			const auto clampIndex = [](const int64_t i, const uint32_t size) {
+				return static_cast<uint32_t>(std::clamp<int64_t>(i, 0, size - 1));
+			};
+
+			// Horizontal pass first, keeping every source row
+			FloatImage horizontal(dstWidth, src.height);
+			if (src.width > 1) {
+				ForRows(jobs, src.height, [&](const uint32_t begin, const uint32_t end) {
+					for (uint32_t y = begin; y < end; ++y) {
+						const Float4* in = src.Row(y);
+						Float4* out = horizontal.Row(y);
+						for (uint32_t x = 0; x < dstWidth; ++x) {
+							const int64_t first = static_cast<int64_t>(x) * 2 - 3;
+							__m128 sum = _mm_setzero_ps();
+							for (uint32_t t = 0; t < KaiserTaps; ++t)
+								sum = _mm_add_ps(sum, _mm_mul_ps(w[t], Load(in[clampIndex(first + t, src.width)])));
+							Store(out[x], sum);
+						}
+					}
+				});
+			}
+			else {
+				horizontal.pixels = src.pixels;
+			}
+
+			if (src.height == 1)
+				return horizontal;
+
+			FloatImage dst(dstWidth, dstHeight);
+			ForRows(jobs, dstHeight, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t y = begin; y < end; ++y) {
+					const int64_t first = static_cast<int64_t>(y) * 2 - 3;
+					const Float4* rows[KaiserTaps];
+					for (uint32_t t = 0; t < KaiserTaps; ++t)
+						rows[t] = horizontal.Row(clampIndex(first + t, src.height));
+
+					Float4* out = dst.Row(y);
+					for (uint32_t x = 0; x < dstWidth; ++x) {
+						__m128 sum = _mm_setzero_ps();
+						for (uint32_t t = 0; t < KaiserTaps; ++t)
+							sum = _mm_add_ps(sum, _mm_mul_ps(w[t], Load(rows[t][x])));
+						Store(out[x], sum);
+					}
+				}
+			});
+			return dst;
+		}
+	}
+
+	uint32_t MipLevelCount(const uint32_t width, const uint32_t height) noexcept {
+		uint32_t levels = 1;
+		for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+			++levels;
+		return levels;
+	}
+
+	std::vector<Image> GenerateMips(const ImageView& base, const MipSettings& settings, JobSystem* jobs) {
+		std::vector<Image> mips;
+		if (base.width == 0 || base.height == 0)
+			return mips;
+
+		uint32_t levels = MipLevelCount(base.width, base.height);
+		if (settings.maxLevels > 0)
+			levels = std::min(levels, settings.maxLevels);
+
+		FloatImage current = ToFloat(base, settings.srgb, jobs);
+		for (uint32_t level = 1; level < levels; ++level) {
+			current = settings.filter == MipFilter::Box ? DownsampleBox(current, jobs) : DownsampleKaiser(current, jobs);
+			mips.push_back(ToImage(current, settings.srgb, jobs));
+		}
+		return mips;
+	}
+
+} // namespace Zenyth
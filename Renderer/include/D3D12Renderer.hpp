@@ -4,6 +4,7 @@
 
 namespace Zenyth {
 	class D3D12Renderer : public IRenderer {
+		void CreateDevice() override;
 		void Init(HWND hwnd, uint32_t width, uint32_t height) override;
 		void BeginFrame() override;
 		void EndFrame() override;
@@ -1,6 +1,10 @@
 #include "pch.hpp"
 #include "D3D12Renderer.hpp"
 
+void Zenyth::D3D12Renderer::CreateDevice()
+{
+}
+
 void Zenyth::D3D12Renderer::Init(HWND hwnd, uint32_t width, uint32_t height)
 {
 }
@@ -0,0 +1,80 @@
+#pragma once
+#include "BenchScene.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Sandbox {
+
+	struct BenchRunDesc {
+		std::string scene;
+		uint32_t    frames = 600;
+		uint32_t    warmupFrames = 60;  // stepped but not recorded
+		uint32_t    seed = 1234;
+		uint32_t    workerThreads = 0;  // 0 = hardware_concurrency - 1, at least 1
+		float       fixedDt = 1.0f / 60.0f;
+	};
+
+	struct SampleStats {
+		double mean = 0.0;
+		double median = 0.0;
+		double p95 = 0.0;
+		double min = 0.0;
+		double max = 0.0;
+		double stddev = 0.0;
+	};
+
+	[[nodiscard]] SampleStats ComputeStats(std::span<const double> samples);
+
+	// One timing per recorded frame, in milliseconds
+	struct BenchSeries {
+		std::string         name;
+		std::vector<double> samples;
+	};
+
+	struct BenchResult {
+		std::string scene;
+		std::string label;          // free-form build tag, e.g. a commit hash
+		std::string build;          // compiler and configuration
+		uint32_t    seed = 0;
+		uint32_t    frames = 0;
+		uint32_t    threads = 0;
+		double      setupMs = 0.0;
+		double      framesPerSecond = 0.0; // recorded frames over their total wall time
+		uint64_t    workload = 0;   // hash of the scene's results; differs when the runs did different work
+		std::vector<BenchSeries> series; // "frame" first, then every phase the scene uses
+	};
+
+	// Builds the scene and steps it headless with the fixed time step, timing every frame with the
+	// engine Timer and every phase within it
+	[[nodiscard]] BenchResult RunBenchmark(const BenchRunDesc& desc, std::string label = {});
+
+	void                     WriteResults(const std::filesystem::path& path, std::span<const BenchResult> results);
+	[[nodiscard]] std::vector<BenchResult> ReadResults(const std::filesystem::path& path);
+
+	struct BenchDelta {
+		std::string scene;
+		std::string series;
+		double      baselineMs = 0.0; // medians
+		double      currentMs = 0.0;
+		double      changePercent = 0.0;
+		double      t = 0.0;          // Welch's t statistic, positive when current is slower
+		bool        significant = false;
+		bool        regression = false;
+	};
+
+	struct BenchComparison {
+		std::vector<BenchDelta>  deltas;
+		std::vector<std::string> warnings; // scenes missing from one side, mismatched workloads
+		[[nodiscard]] bool HasRegression() const noexcept;
+	};
+
+	// A change is significant when |t| exceeds tThreshold and the medians differ by more than
+	// thresholdPercent and a hundredth of a millisecond; significant slowdowns are regressions
+	[[nodiscard]] BenchComparison CompareResults(std::span<const BenchResult> baseline, std::span<const BenchResult> current,
+		double thresholdPercent = 5.0, double tThreshold = 4.0);
+
+	[[nodiscard]] std::string FormatComparison(const BenchComparison& comparison);
+
+} // namespace Sandbox
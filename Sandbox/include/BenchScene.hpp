@@ -0,0 +1,143 @@
+#pragma once
+#include "JobSystem.hpp"
+#include "memory/LinearArena.hpp"
+#include "particles/ParticleSystem.hpp"
+#include "scene/LodSystem.hpp"
+#include "scene/TransformHierarchy.hpp"
+#include "spatial/BVH.hpp"
+#include "spatial/Broadphase.hpp"
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Sandbox {
+
+	// Workload of a named stress scene; a system is skipped when its count is zero
+	struct SceneDesc {
+		std::string_view name;
+		std::string_view description;
+		uint32_t objects = 0;             // transform roots, each with a chain of `depth` descendants
+		uint32_t depth = 0;
+		uint32_t cullViews = 0;           // frustums tested against the object BVH every frame
+		uint32_t bodies = 0;              // moving broadphase boxes
+		uint32_t emitters = 0;
+		uint32_t particlesPerEmitter = 0;
+		float    worldSize = 512.0f;      // edge of the cube everything lives in
+	};
+
+	[[nodiscard]] std::span<const SceneDesc> BenchScenes() noexcept;
+	[[nodiscard]] const SceneDesc*           FindBenchScene(std::string_view name) noexcept;
+
+	struct CameraKey {
+		float              time; // seconds
+		zenyth::math::vec3 position;
+		zenyth::math::vec3 target;
+	};
+
+	// Looping Catmull-Rom path through camera keys
+	class CameraPath {
+	public:
+		struct Pose {
+			zenyth::math::vec3 eye;
+			zenyth::math::vec3 target;
+		};
+
+		// Keys must have increasing times; the path wraps from the last key back to the first
+		explicit CameraPath(std::vector<CameraKey> keys);
+
+		// A fly-through weaving in and out of a cube of the given size, the same for the same seed
+		[[nodiscard]] static CameraPath Generate(uint32_t seed, float worldSize);
+
+		[[nodiscard]] Pose  Sample(float time) const noexcept;
+		[[nodiscard]] float Duration() const noexcept { return m_duration; }
+
+	private:
+		std::vector<CameraKey> m_keys;
+		float                  m_duration = 0.0f;
+	};
+
+	enum class Phase : uint32_t {
+		Camera,
+		Transforms,
+		Bounds,
+		Culling,
+		Lod,
+		Broadphase,
+		Particles,
+		ParticleSort,
+		Count
+	};
+
+	[[nodiscard]] std::string_view ToString(Phase phase) noexcept;
+
+	// Milliseconds spent in each phase during one step
+	using PhaseTimes = std::array<double, static_cast<size_t>(Phase::Count)>;
+
+	// A seeded scene stepped with a fixed time step, so the same desc and seed always produce the
+	// same work: only the time it takes differs between builds and machines
+	class BenchScene {
+	public:
+		BenchScene(const SceneDesc& desc, uint32_t seed, Zenyth::JobSystem& jobs);
+
+		BenchScene(const BenchScene&) = delete;
+		BenchScene& operator=(const BenchScene&) = delete;
+
+		PhaseTimes Step(float dt);
+
+		[[nodiscard]] const SceneDesc& Desc() const noexcept { return m_desc; }
+		// Sums over every step so far; equal between runs of the same scene and seed
+		[[nodiscard]] uint64_t VisibleTotal()   const noexcept { return m_visibleTotal; }
+		[[nodiscard]] uint64_t PairTotal()      const noexcept { return m_pairTotal; }
+		[[nodiscard]] uint64_t ParticleTotal()  const noexcept { return m_particleTotal; }
+		[[nodiscard]] uint64_t LodChangeTotal() const noexcept { return m_lodChangeTotal; }
+		// Safe to read from any thread
+		[[nodiscard]] size_t   ArenaHighWaterBytes() const noexcept { return m_arena.HighWaterBytes(); }
+
+	private:
+		struct Body {
+			Zenyth::AABB       box;
+			zenyth::math::vec3 velocity;
+			uint32_t           handle;
+		};
+
+		void UpdateCamera();
+		void UpdateTransforms();
+		void UpdateBounds();
+		void Cull();
+		void SelectLods();
+		void MoveBodies(float dt);
+		void SortParticles();
+
+		SceneDesc          m_desc;
+		Zenyth::JobSystem& m_jobs;
+		CameraPath         m_path;
+		float              m_time = 0.0f;
+
+		CameraPath::Pose             m_pose;
+		std::vector<Zenyth::Frustum> m_frustums;
+
+		Zenyth::TransformHierarchy           m_transforms;
+		std::vector<Zenyth::TransformHandle> m_roots;
+		std::vector<Zenyth::TransformHandle> m_nodes;
+		std::vector<float>                   m_spin;    // radians per second, per root
+		std::vector<Zenyth::AABB>            m_bounds;  // per node
+		Zenyth::BVH                          m_bvh;
+		std::vector<uint32_t>                m_visible; // per view
+		Zenyth::LodSystem                    m_lods;    // one chain per node, same order
+		Zenyth::LodView                      m_lodView;
+
+		Zenyth::Broadphase  m_broadphase;
+		std::vector<Body>   m_bodies;
+		Zenyth::LinearArena m_arena;
+
+		Zenyth::ParticleSystem m_particles;
+
+		uint64_t m_visibleTotal = 0;
+		uint64_t m_pairTotal = 0;
+		uint64_t m_particleTotal = 0;
+		uint64_t m_lodChangeTotal = 0;
+	};
+
+} // namespace Sandbox
@@ -1,11 +1,15 @@
 #pragma once
 #include "Application.hpp"
+#include "BenchScene.hpp"
 
+// Plays one of the benchmark scenes in a window, logging its phase timings periodically
 class SandboxApp : public Zenyth::Application {
 public:
-	explicit SandboxApp() : Application({ .title = L"Sandbox", .width = 1280, .height = 720 }) {}
+	// metricsEndpoint: see Zenyth::AppDesc::metricsEndpoint
+	explicit SandboxApp(std::string_view scene = "mixed", uint32_t seed = 1234, std::string metricsEndpoint = {});
 
 protected:
+	void OnConfigureStartup(Zenyth::StartupGraph& startup) override;
 	void OnInit() override;
 	void OnUpdate(float dt) override;
 	void OnRender() override;
@@ -13,4 +17,14 @@ protected:
 	void OnEvent(const Zenyth::Event& e) override;
 
 	void OnShutdown() override;
+
+private:
+	static constexpr uint32_t ReportInterval = 300; // frames
+
+	const Sandbox::SceneDesc*            m_sceneDesc;
+	uint32_t                             m_seed;
+	std::unique_ptr<Sandbox::BenchScene> m_scene;
+
+	Sandbox::PhaseTimes m_phaseTotals{};
+	uint32_t            m_framesSinceReport = 0;
 };
@@ -0,0 +1,479 @@
+#include "BenchHarness.hpp"
+#include "Timer.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+
+namespace Sandbox {
+
+	namespace {
+		// Below this, a change in the median is timer resolution and scheduling noise, whatever t says
+		constexpr double NoiseFloorMs = 0.01;
+
+		std::string BuildDescription() {
+			std::string build;
+#if defined(__clang__)
+			build = "clang " + std::to_string(__clang_major__) + "." + std::to_string(__clang_minor__);
+#elif defined(_MSC_VER)
+			build = "msvc " + std::to_string(_MSC_VER);
+#elif defined(__GNUC__)
+			build = "gcc " + std::to_string(__GNUC__) + "." + std::to_string(__GNUC_MINOR__);
+#else
+			build = "unknown";
+#endif
+#ifdef NDEBUG
+			build += " release";
+#else
+			build += " debug";
+#endif
+			return build;
+		}
+
+		uint64_t HashWorkload(const BenchScene& scene) noexcept {
+			uint64_t hash = 14695981039346656037ull;
+			for (const uint64_t value : { scene.VisibleTotal(), scene.PairTotal(), scene.ParticleTotal(), scene.LodChangeTotal() }) {
+				for (uint32_t byte = 0; byte < 8; ++byte) {
+					hash ^= (value >> (byte * 8)) & 0xff;
+					hash *= 1099511628211ull;
+				}
+			}
+			return hash;
+		}
+
+		double Mean(const std::span<const double> samples) noexcept {
+			double sum = 0.0;
+			for (const double sample : samples)
+				sum += sample;
+			return samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+		}
+
+		double Variance(const std::span<const double> samples, const double mean) noexcept {
+			if (samples.size() < 2)
+				return 0.0;
+			double sum = 0.0;
+			for (const double sample : samples)
+				sum += (sample - mean) * (sample - mean);
+			return sum / static_cast<double>(samples.size() - 1);
+		}
+
+#pragma region Json
+
+		void WriteString(std::ostream& out, const std::string_view text) {
+			out << '"';
+			for (const char c : text) {
+				switch (c) {
+					case '"':  out << "\\\""; break;
+					case '\\': out << "\\\\"; break;
+					case '\n': out << "\\n"; break;
+					case '\t': out << "\\t"; break;
+					default:
+						if (static_cast<unsigned char>(c) < 0x20)
+							out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+						else
+							out << c;
+				}
+			}
+			out << '"';
+		}
+
+		// Just enough JSON to read back what WriteResults() produces, and hand edited variants of it
+		struct JsonValue {
+			enum class Kind { Null, Bool, Number, String, Array, Object };
+
+			Kind                                           kind = Kind::Null;
+			bool                                           boolean = false;
+			double                                         number = 0.0;
+			std::string                                    string;
+			std::vector<JsonValue>                         array;
+			std::vector<std::pair<std::string, JsonValue>> object; // in file order
+
+			[[nodiscard]] const JsonValue* Find(const std::string_view key) const noexcept {
+				for (const auto& [name, value] : object) {
+					if (name == key)
+						return &value;
+				}
+				return nullptr;
+			}
+		};
+
+		class JsonParser {
+		public:
+			explicit JsonParser(const std::string_view text) : m_text(text) {}
+
+			JsonValue ParseDocument() {
+				JsonValue value = ParseValue();
+				SkipWhitespace();
+				if (m_pos != m_text.size())
+					Fail("trailing characters");
+				return value;
+			}
+
+		private:
+			[[noreturn]] void Fail(const std::string_view message) const {
+				throw std::runtime_error(std::string(message) + " at offset " + std::to_string(m_pos));
+			}
+
+			void SkipWhitespace() noexcept {
+				while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r'))
+					++m_pos;
+			}
+
+			bool Consume(const char c) {
+				SkipWhitespace();
+				if (m_pos < m_text.size() && m_text[m_pos] == c) {
+					++m_pos;
+					return true;
+				}
+				return false;
+			}
+
+			void Expect(const char c) {
+				if (!Consume(c))
+					Fail(std::string("expected '") + c + "'");
+			}
+
+			bool ConsumeWord(const std::string_view word) {
+				if (m_text.substr(m_pos, word.size()) != word)
+					return false;
+				m_pos += word.size();
+				return true;
+			}
+
+			JsonValue ParseValue() {
+				SkipWhitespace();
+				if (m_pos >= m_text.size())
+					Fail("unexpected end of input");
+
+				JsonValue value;
+				const char c = m_text[m_pos];
+				if (c == '{') {
+					value.kind = JsonValue::Kind::Object;
+					++m_pos;
+					if (!Consume('}')) {
+						do {
+							SkipWhitespace();
+							std::string key = ParseString();
+							Expect(':');
+							value.object.emplace_back(std::move(key), ParseValue());
+						} while (Consume(','));
+						Expect('}');
+					}
+				}
+				else if (c == '[') {
+					value.kind = JsonValue::Kind::Array;
+					++m_pos;
+					if (!Consume(']')) {
+						do {
+							value.array.push_back(ParseValue());
+						} while (Consume(','));
+						Expect(']');
+					}
+				}
+				else if (c == '"') {
+					value.kind = JsonValue::Kind::String;
+					value.string = ParseString();
+				}
+				else if (ConsumeWord("true")) {
+					value.kind = JsonValue::Kind::Bool;
+					value.boolean = true;
+				}
+				else if (ConsumeWord("false")) {
+					value.kind = JsonValue::Kind::Bool;
+				}
+				else if (ConsumeWord("null")) {
+					value.kind = JsonValue::Kind::Null;
+				}
+				else {
+					value.kind = JsonValue::Kind::Number;
+					const char* begin = m_text.data() + m_pos;
+					const auto [end, ec] = std::from_chars(begin, m_text.data() + m_text.size(), value.number);
+					if (ec != std::errc())
+						Fail("invalid value");
+					m_pos += static_cast<size_t>(end - begin);
+				}
+				return value;
+			}
+
+			std::string ParseString() {
+				if (m_pos >= m_text.size() || m_text[m_pos] != '"')
+					Fail("expected a string");
+				++m_pos;
+
+				std::string out;
+				while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+					char c = m_text[m_pos++];
+					if (c == '\\') {
+						if (m_pos >= m_text.size())
+							break;
+						switch (const char e = m_text[m_pos++]) {
+							case 'n': c = '\n'; break;
+							case 't': c = '\t'; break;
+							case 'r': c = '\r'; break;
+							case 'b': c = '\b'; break;
+							case 'f': c = '\f'; break;
+							case 'u': {
+								unsigned code = 0;
+								const auto [end, ec] = std::from_chars(m_text.data() + m_pos, m_text.data() + std::min(m_pos + 4, m_text.size()), code, 16);
+								if (ec != std::errc() || end != m_text.data() + m_pos + 4)
+									Fail("invalid escape");
+								m_pos += 4;
+								c = code < 0x80 ? static_cast<char>(code) : '?';
+								break;
+							}
+							default: c = e; break;
+						}
+					}
+					out += c;
+				}
+				if (m_pos >= m_text.size())
+					Fail("unterminated string");
+				++m_pos;
+				return out;
+			}
+
+			std::string_view m_text;
+			size_t           m_pos = 0;
+		};
+
+		const JsonValue& Member(const JsonValue& object, const std::string_view key, const JsonValue::Kind kind) {
+			const JsonValue* value = object.Find(key);
+			if (!value || value->kind != kind)
+				throw std::runtime_error("missing or mistyped \"" + std::string(key) + "\"");
+			return *value;
+		}
+
+		template<typename T>
+		T NumberMember(const JsonValue& object, const std::string_view key) {
+			return static_cast<T>(Member(object, key, JsonValue::Kind::Number).number);
+		}
+
+#pragma endregion
+	}
+
+	SampleStats ComputeStats(const std::span<const double> samples) {
+		SampleStats stats;
+		if (samples.empty())
+			return stats;
+
+		std::vector<double> sorted(samples.begin(), samples.end());
+		std::ranges::sort(sorted);
+
+		const size_t count = sorted.size();
+		stats.mean = Mean(sorted);
+		stats.median = count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5;
+		stats.p95 = sorted[std::min(count - 1, static_cast<size_t>(std::ceil(0.95 * static_cast<double>(count))) - 1)];
+		stats.min = sorted.front();
+		stats.max = sorted.back();
+		stats.stddev = std::sqrt(Variance(sorted, stats.mean));
+		return stats;
+	}
+
+	BenchResult RunBenchmark(const BenchRunDesc& desc, std::string label) {
+		const SceneDesc* sceneDesc = FindBenchScene(desc.scene);
+		if (!sceneDesc)
+			throw std::invalid_argument("RunBenchmark : unknown scene '" + desc.scene + "'");
+		if (desc.frames == 0 || desc.fixedDt <= 0.0f)
+			throw std::invalid_argument("RunBenchmark : frames and time step must be positive");
+
+		Zenyth::JobSystem jobs(desc.workerThreads);
+
+		const auto setupStart = std::chrono::steady_clock::now();
+		BenchScene scene(*sceneDesc, desc.seed, jobs);
+		const double setupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+		for (uint32_t i = 0; i < desc.warmupFrames; ++i)
+			(void)scene.Step(desc.fixedDt);
+
+		std::vector<double> frameMs(desc.frames);
+		std::vector<PhaseTimes> phaseMs(desc.frames);
+
+		Zenyth::Timer timer;
+		timer.Reset();
+		for (uint32_t i = 0; i < desc.frames; ++i) {
+			phaseMs[i] = scene.Step(desc.fixedDt);
+			frameMs[i] = static_cast<double>(timer.Tick()) * 1000.0;
+		}
+
+		BenchResult result;
+		result.scene = desc.scene;
+		result.label = std::move(label);
+		result.build = BuildDescription();
+		result.seed = desc.seed;
+		result.frames = desc.frames;
+		result.threads = jobs.ThreadCount();
+		result.setupMs = setupMs;
+		result.framesPerSecond = static_cast<double>(desc.frames) / timer.TotalTime();
+		result.workload = HashWorkload(scene);
+
+		result.series.push_back({ "frame", std::move(frameMs) });
+		for (size_t phase = 0; phase < static_cast<size_t>(Phase::Count); ++phase) {
+			BenchSeries series{ std::string(ToString(static_cast<Phase>(phase))), std::vector<double>(desc.frames) };
+			bool used = false;
+			for (uint32_t i = 0; i < desc.frames; ++i) {
+				series.samples[i] = phaseMs[i][phase];
+				used |= series.samples[i] > 0.0;
+			}
+			if (used)
+				result.series.push_back(std::move(series));
+		}
+		return result;
+	}
+
+	void WriteResults(const std::filesystem::path& path, const std::span<const BenchResult> results) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("WriteResults : cannot open " + path.string());
+
+		out << std::setprecision(6) << "{\n  \"runs\": [";
+		for (size_t r = 0; r < results.size(); ++r) {
+			const BenchResult& result = results[r];
+			char workload[17];
+			*std::to_chars(workload, workload + 16, result.workload, 16).ptr = '\0';
+
+			out << (r ? ",\n" : "\n") << "    {\n";
+			out << "      \"scene\": ";  WriteString(out, result.scene);  out << ",\n";
+			out << "      \"label\": ";  WriteString(out, result.label);  out << ",\n";
+			out << "      \"build\": ";  WriteString(out, result.build);  out << ",\n";
+			out << "      \"seed\": " << result.seed << ",\n"
+				<< "      \"frames\": " << result.frames << ",\n"
+				<< "      \"threads\": " << result.threads << ",\n"
+				<< "      \"setup_ms\": " << result.setupMs << ",\n"
+				<< "      \"frames_per_second\": " << result.framesPerSecond << ",\n"
+				<< "      \"workload\": \"" << workload << "\",\n"
+				<< "      \"series\": {";
+
+			for (size_t s = 0; s < result.series.size(); ++s) {
+				const BenchSeries& series = result.series[s];
+				const SampleStats stats = ComputeStats(series.samples);
+
+				out << (s ? ",\n" : "\n") << "        ";
+				WriteString(out, series.name);
+				out << ": { \"mean\": " << stats.mean << ", \"median\": " << stats.median << ", \"p95\": " << stats.p95
+					<< ", \"min\": " << stats.min << ", \"max\": " << stats.max << ", \"stddev\": " << stats.stddev << ", \"samples\": [";
+				for (size_t i = 0; i < series.samples.size(); ++i)
+					out << (i ? ", " : "") << series.samples[i];
+				out << "] }";
+			}
+			out << "\n      }\n    }";
+		}
+		out << "\n  ]\n}\n";
+
+		if (!out)
+			throw std::runtime_error("WriteResults : failed writing " + path.string());
+	}
+
+	std::vector<BenchResult> ReadResults(const std::filesystem::path& path) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			throw std::runtime_error("ReadResults : cannot open " + path.string());
+		const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		std::vector<BenchResult> results;
+		try {
+			const JsonValue document = JsonParser(text).ParseDocument();
+			for (const JsonValue& run : Member(document, "runs", JsonValue::Kind::Array).array) {
+				BenchResult result;
+				result.scene = Member(run, "scene", JsonValue::Kind::String).string;
+				if (const JsonValue* label = run.Find("label"); label && label->kind == JsonValue::Kind::String)
+					result.label = label->string;
+				if (const JsonValue* build = run.Find("build"); build && build->kind == JsonValue::Kind::String)
+					result.build = build->string;
+				result.seed = NumberMember<uint32_t>(run, "seed");
+				result.frames = NumberMember<uint32_t>(run, "frames");
+				result.threads = NumberMember<uint32_t>(run, "threads");
+				result.setupMs = NumberMember<double>(run, "setup_ms");
+				result.framesPerSecond = NumberMember<double>(run, "frames_per_second");
+
+				const std::string& workload = Member(run, "workload", JsonValue::Kind::String).string;
+				std::from_chars(workload.data(), workload.data() + workload.size(), result.workload, 16);
+
+				for (const auto& [name, series] : Member(run, "series", JsonValue::Kind::Object).object) {
+					BenchSeries& out = result.series.emplace_back();
+					out.name = name;
+					for (const JsonValue& sample : Member(series, "samples", JsonValue::Kind::Array).array) {
+						if (sample.kind != JsonValue::Kind::Number)
+							throw std::runtime_error("non-numeric sample in \"" + name + "\"");
+						out.samples.push_back(sample.number);
+					}
+				}
+				results.push_back(std::move(result));
+			}
+		}
+		catch (const std::runtime_error& e) {
+			throw std::runtime_error("ReadResults : " + path.string() + ": " + e.what());
+		}
+		return results;
+	}
+
+	bool BenchComparison::HasRegression() const noexcept {
+		return std::ranges::any_of(deltas, &BenchDelta::regression);
+	}
+
+	BenchComparison CompareResults(const std::span<const BenchResult> baseline, const std::span<const BenchResult> current,
+		const double thresholdPercent, const double tThreshold)
+	{
+		BenchComparison comparison;
+		for (const BenchResult& now : current) {
+			const auto before = std::ranges::find(baseline, now.scene, &BenchResult::scene);
+			if (before == baseline.end()) {
+				comparison.warnings.push_back("scene '" + now.scene + "' has no baseline");
+				continue;
+			}
+			if (before->seed != now.seed || before->workload != now.workload)
+				comparison.warnings.push_back("scene '" + now.scene + "' did different work than its baseline (seed or results differ)");
+
+			for (const BenchSeries& series : now.series) {
+				const auto old = std::ranges::find(before->series, series.name, &BenchSeries::name);
+				if (old == before->series.end() || old->samples.empty() || series.samples.empty())
+					continue;
+
+				BenchDelta delta;
+				delta.scene = now.scene;
+				delta.series = series.name;
+				delta.baselineMs = ComputeStats(old->samples).median;
+				delta.currentMs = ComputeStats(series.samples).median;
+				delta.changePercent = delta.baselineMs > 0.0 ? (delta.currentMs / delta.baselineMs - 1.0) * 100.0 : 0.0;
+
+				// Welch's t-test on the per-frame samples
+				const double meanBefore = Mean(old->samples), meanNow = Mean(series.samples);
+				const double error = std::sqrt(Variance(old->samples, meanBefore) / static_cast<double>(old->samples.size())
+					+ Variance(series.samples, meanNow) / static_cast<double>(series.samples.size()));
+				delta.t = error > 0.0 ? (meanNow - meanBefore) / error
+					: meanNow == meanBefore ? 0.0 : std::copysign(std::numeric_limits<double>::infinity(), meanNow - meanBefore);
+
+				delta.significant = std::abs(delta.t) > tThreshold && std::abs(delta.changePercent) > thresholdPercent
+					&& std::abs(delta.currentMs - delta.baselineMs) > NoiseFloorMs;
+				delta.regression = delta.significant && delta.changePercent > 0.0;
+				comparison.deltas.push_back(std::move(delta));
+			}
+		}
+
+		for (const BenchResult& before : baseline) {
+			if (std::ranges::find(current, before.scene, &BenchResult::scene) == current.end())
+				comparison.warnings.push_back("scene '" + before.scene + "' missing from the current run");
+		}
+		return comparison;
+	}
+
+	std::string FormatComparison(const BenchComparison& comparison) {
+		std::ostringstream out;
+		out << std::left << std::setw(12) << "scene" << std::setw(16) << "series"
+			<< std::right << std::setw(12) << "base ms" << std::setw(12) << "now ms" << std::setw(10) << "change" << std::setw(10) << "t" << "\n";
+
+		for (const BenchDelta& delta : comparison.deltas) {
+			out << std::left << std::setw(12) << delta.scene << std::setw(16) << delta.series << std::right << std::fixed
+				<< std::setw(12) << std::setprecision(3) << delta.baselineMs
+				<< std::setw(12) << delta.currentMs
+				<< std::setw(9) << std::showpos << std::setprecision(1) << delta.changePercent << "%"
+				<< std::setw(10) << delta.t << std::noshowpos
+				<< (delta.regression ? "  REGRESSION" : delta.significant ? "  improved" : "") << "\n";
+		}
+		for (const std::string& warning : comparison.warnings)
+			out << "warning: " << warning << "\n";
+
+		out << (comparison.HasRegression() ? "regressions found\n" : "no significant regressions\n");
+		return out.str();
+	}
+
+} // namespace Sandbox
@@ -0,0 +1,305 @@
+#include "BenchScene.hpp"
+
+#include <chrono>
+#include <numbers>
+#include <random>
+
+namespace Sandbox {
+
+	using namespace zenyth::math;
+	using Zenyth::AABB;
+	using Zenyth::Frustum;
+
+	namespace {
+		constexpr SceneDesc Scenes[] = {
+			{ .name = "objects", .description = "50k boxes moving through the broadphase",
+				.bodies = 50000 },
+			{ .name = "transforms", .description = "160k animated nodes in 8 deep chains, refit and culled",
+				.objects = 20000, .depth = 7, .cullViews = 1 },
+			{ .name = "particles", .description = "32 emitters of 32k particles, simulated and depth sorted",
+				.emitters = 32, .particlesPerEmitter = 32768 },
+			{ .name = "culling", .description = "100k nodes culled against 8 views per frame",
+				.objects = 50000, .depth = 1, .cullViews = 8 },
+			{ .name = "mixed", .description = "a bit of everything at game-like counts",
+				.objects = 8000, .depth = 3, .cullViews = 4, .bodies = 10000, .emitters = 8, .particlesPerEmitter = 16384 },
+		};
+
+		constexpr float FieldOfView = 60.0f * std::numbers::pi_v<float> / 180.0f;
+		constexpr float AspectRatio = 16.0f / 9.0f;
+		constexpr uint32_t BoundsGrain = 4096;
+		constexpr float ViewportHeight = 1080.0f;
+		// World-space error per level of the LOD chain every node gets; nodes are about a unit in size
+		constexpr Zenyth::LodLevel LodChain[] = { { 0.0f }, { 0.01f }, { 0.04f }, { 0.16f } };
+
+		vec3 CatmullRom(const vec3& p0, const vec3& p1, const vec3& p2, const vec3& p3, const float t) noexcept {
+			const float t2 = t * t;
+			const float t3 = t2 * t;
+			return (p1 * 2.0f + (p2 - p0) * t + (p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3) * t2 + (p1 * 3.0f - p0 - p2 * 3.0f + p3) * t3) * 0.5f;
+		}
+
+		// World space box of a unit cube (extents 1) transformed by m
+		AABB TransformUnitBox(const mat3x4& m) noexcept {
+			const vec3 center(m[0, 3], m[1, 3], m[2, 3]);
+			const vec3 extents(
+				std::abs(m[0, 0]) + std::abs(m[0, 1]) + std::abs(m[0, 2]),
+				std::abs(m[1, 0]) + std::abs(m[1, 1]) + std::abs(m[1, 2]),
+				std::abs(m[2, 0]) + std::abs(m[2, 1]) + std::abs(m[2, 2]));
+			return AABB::FromCenterExtents(center, extents);
+		}
+	}
+
+	std::span<const SceneDesc> BenchScenes() noexcept {
+		return Scenes;
+	}
+
+	const SceneDesc* FindBenchScene(const std::string_view name) noexcept {
+		for (const SceneDesc& scene : Scenes) {
+			if (scene.name == name)
+				return &scene;
+		}
+		return nullptr;
+	}
+
+	std::string_view ToString(const Phase phase) noexcept {
+		switch (phase) {
+			case Phase::Camera:       return "camera";
+			case Phase::Transforms:   return "transforms";
+			case Phase::Bounds:       return "bounds";
+			case Phase::Culling:      return "culling";
+			case Phase::Lod:          return "lod";
+			case Phase::Broadphase:   return "broadphase";
+			case Phase::Particles:    return "particles";
+			case Phase::ParticleSort: return "particle_sort";
+			default:                  return "unknown";
+		}
+	}
+
+#pragma region CameraPath
+
+	CameraPath::CameraPath(std::vector<CameraKey> keys)
+		: m_keys(std::move(keys))
+	{
+		if (m_keys.size() < 3)
+			throw std::invalid_argument("CameraPath : need at least three keys");
+		for (size_t i = 1; i < m_keys.size(); ++i) {
+			if (m_keys[i].time <= m_keys[i - 1].time)
+				throw std::invalid_argument("CameraPath : key times must increase");
+		}
+		m_duration = m_keys.back().time - m_keys.front().time;
+	}
+
+	CameraPath CameraPath::Generate(const uint32_t seed, const float worldSize) {
+		constexpr uint32_t KeyCount = 8;
+		constexpr float    KeySpacing = 4.0f; // seconds
+
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		const vec3 center(worldSize * 0.5f);
+		std::vector<CameraKey> keys;
+		for (uint32_t i = 0; i < KeyCount; ++i) {
+			const float angle = (static_cast<float>(i) + unit(rng) * 0.5f) * 2.0f * std::numbers::pi_v<float> / KeyCount;
+			const float radius = worldSize * (0.2f + unit(rng) * 0.4f);
+			const vec3  position(center.x() + std::cos(angle) * radius, worldSize * (0.05f + unit(rng) * 0.3f), center.z() + std::sin(angle) * radius);
+			const vec3  target = center + vec3(unit(rng) - 0.5f, (unit(rng) - 0.5f) * 0.2f, unit(rng) - 0.5f) * worldSize * 0.5f;
+			keys.push_back({ static_cast<float>(i) * KeySpacing, position, target });
+		}
+		// Close the loop
+		keys.push_back({ KeyCount * KeySpacing, keys.front().position, keys.front().target });
+		return CameraPath(std::move(keys));
+	}
+
+	CameraPath::Pose CameraPath::Sample(const float time) const noexcept {
+		// The last key repeats the first, so the distinct points are [0, count)
+		const size_t count = m_keys.size() - 1;
+		const float  local = m_keys.front().time + std::fmod(std::max(time, 0.0f), m_duration);
+
+		size_t segment = 0;
+		while (segment + 1 < count && m_keys[segment + 1].time <= local)
+			++segment;
+
+		const CameraKey& k0 = m_keys[(segment + count - 1) % count];
+		const CameraKey& k1 = m_keys[segment];
+		const CameraKey& k2 = m_keys[(segment + 1) % count];
+		const CameraKey& k3 = m_keys[(segment + 2) % count];
+		const float t = (local - k1.time) / (m_keys[segment + 1].time - k1.time);
+
+		return {
+			CatmullRom(k0.position, k1.position, k2.position, k3.position, t),
+			CatmullRom(k0.target, k1.target, k2.target, k3.target, t)
+		};
+	}
+
+#pragma endregion
+
+#pragma region BenchScene
+
+	BenchScene::BenchScene(const SceneDesc& desc, const uint32_t seed, Zenyth::JobSystem& jobs)
+		: m_desc(desc)
+		, m_jobs(jobs)
+		, m_path(CameraPath::Generate(seed, desc.worldSize))
+		, m_broadphase({ .sweepAxis = 0, .worldBounds = { vec3(0.0f), vec3(desc.worldSize) }, .regionsU = 4, .regionsV = 4 })
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		const auto randomPoint = [&](const float size) { return vec3(unit(rng), unit(rng), unit(rng)) * size; };
+		const auto randomAxis = [&] {
+			const vec3 axis(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f);
+			return axis.length_sq() > 1e-4f ? axis / axis.length() : vec3(0.0f, 1.0f, 0.0f);
+		};
+
+		for (uint32_t i = 0; i < desc.objects; ++i) {
+			Zenyth::TransformHandle node = m_transforms.Create();
+			m_transforms.SetLocalPosition(node, randomPoint(desc.worldSize));
+			m_roots.push_back(node);
+			m_nodes.push_back(node);
+			m_spin.push_back((unit(rng) - 0.5f) * 2.0f);
+
+			for (uint32_t d = 0; d < desc.depth; ++d) {
+				node = m_transforms.Create(node);
+				m_transforms.SetLocal(node, vec3(0.0f, 2.5f, 0.0f), quat::from_axis_angle(randomAxis(), unit(rng)), vec3(0.9f));
+				m_nodes.push_back(node);
+			}
+		}
+
+		if (!m_nodes.empty()) {
+			m_transforms.Update(&m_jobs);
+			m_bounds.resize(m_nodes.size());
+			UpdateBounds();
+			m_bvh.Build(m_bounds, &m_jobs);
+			for (const AABB& box : m_bounds)
+				m_lods.Add(LodChain, box.Center(), box.Extents().length());
+		}
+		m_frustums.resize(desc.objects > 0 ? std::max(desc.cullViews, 1u) : 0);
+		m_visible.resize(m_frustums.size());
+
+		for (uint32_t i = 0; i < desc.bodies; ++i) {
+			const AABB box = AABB::FromCenterExtents(randomPoint(desc.worldSize), vec3(0.25f) + randomPoint(1.75f));
+			const vec3 velocity = (randomPoint(2.0f) - vec3(1.0f)) * 10.0f;
+			m_bodies.push_back({ box, velocity, m_broadphase.Add(box) });
+		}
+
+		for (uint32_t i = 0; i < desc.emitters; ++i) {
+			Zenyth::EmitterDesc emitter;
+			emitter.capacity = desc.particlesPerEmitter + desc.particlesPerEmitter / 4;
+			emitter.lifetimeMin = 1.0f;
+			emitter.lifetimeMax = 3.0f;
+			emitter.rate = static_cast<float>(desc.particlesPerEmitter) / 2.0f; // steady state at the average lifetime
+			emitter.spawnRadius = 1.0f;
+			emitter.velocity[1] = 8.0f;
+			emitter.velocitySpread = 4.0f;
+			emitter.drag = 0.1f;
+
+			const vec3 position = randomPoint(desc.worldSize);
+			emitter.position[0] = position.x();
+			emitter.position[1] = position.y();
+			emitter.position[2] = position.z();
+			emitter.planes.push_back({ { 0.0f, 1.0f, 0.0f }, -(position.y() - 2.0f) });
+			emitter.attractors.push_back({ { position.x() + 4.0f, position.y() + 6.0f, position.z() }, 20.0f });
+
+			m_particles.CreateEmitter(std::move(emitter)).Emit(desc.particlesPerEmitter / 2);
+		}
+	}
+
+	PhaseTimes BenchScene::Step(const float dt) {
+		PhaseTimes times{};
+		const auto measure = [&times](const Phase phase, auto&& fn) {
+			const auto start = std::chrono::steady_clock::now();
+			fn();
+			times[static_cast<size_t>(phase)] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		m_time += dt;
+		measure(Phase::Camera, [&] { UpdateCamera(); });
+
+		if (!m_nodes.empty()) {
+			measure(Phase::Transforms, [&] { UpdateTransforms(); });
+			measure(Phase::Bounds, [&] { UpdateBounds(); m_bvh.Refit(m_bounds); });
+			measure(Phase::Culling, [&] { Cull(); });
+			measure(Phase::Lod, [&] { SelectLods(); });
+		}
+		if (!m_bodies.empty())
+			measure(Phase::Broadphase, [&] { MoveBodies(dt); });
+		if (m_particles.EmitterCount() > 0) {
+			measure(Phase::Particles, [&] { m_particles.Update(dt, &m_jobs); });
+			measure(Phase::ParticleSort, [&] { SortParticles(); });
+		}
+		return times;
+	}
+
+	void BenchScene::UpdateCamera() {
+		m_pose = m_path.Sample(m_time);
+
+		const mat4 projection = mat4::perspective(FieldOfView, AspectRatio, 0.5f, m_desc.worldSize * 2.0f);
+		const vec3 forward = m_pose.target - m_pose.eye;
+		m_lodView = Zenyth::LodView::FromProjection(m_pose.eye, projection, ViewportHeight);
+
+		// Extra views turn around the camera, like the faces of a shadow cube
+		for (uint32_t i = 0; i < m_frustums.size(); ++i) {
+			const float angle = static_cast<float>(i) * 2.0f * std::numbers::pi_v<float> / static_cast<float>(m_frustums.size());
+			const float c = std::cos(angle), s = std::sin(angle);
+			const vec3  direction(forward.x() * c - forward.z() * s, forward.y(), forward.x() * s + forward.z() * c);
+			m_frustums[i] = Frustum(projection * mat4::look_at(m_pose.eye, m_pose.eye + direction, vec3(0.0f, 1.0f, 0.0f)));
+		}
+	}
+
+	void BenchScene::UpdateTransforms() {
+		for (size_t i = 0; i < m_roots.size(); ++i)
+			m_transforms.SetLocalRotation(m_roots[i], quat::from_axis_angle(vec3(0.0f, 1.0f, 0.0f), m_spin[i] * m_time));
+		m_transforms.Update(&m_jobs);
+	}
+
+	void BenchScene::UpdateBounds() {
+		m_jobs.ParallelFor(static_cast<uint32_t>(m_nodes.size()), BoundsGrain, [this](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				m_bounds[i] = TransformUnitBox(m_transforms.GetWorldMatrix(m_nodes[i]));
+		});
+	}
+
+	void BenchScene::Cull() {
+		std::ranges::fill(m_visible, 0u);
+		// Each view is queried by a single job, so the per-view counters need no synchronization
+		m_bvh.QueryFrustumBatch(m_frustums, &m_jobs, [this](const uint32_t view, uint32_t) { ++m_visible[view]; });
+		for (const uint32_t visible : m_visible)
+			m_visibleTotal += visible;
+	}
+
+	void BenchScene::SelectLods() {
+		// Nodes were added in order and never removed, so handles are node indices
+		m_jobs.ParallelFor(static_cast<uint32_t>(m_bounds.size()), BoundsGrain, [this](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				m_lods.SetBounds(i, m_bounds[i].Center(), m_bounds[i].Extents().length());
+		});
+		m_lods.Update(m_lodView, &m_jobs);
+		m_lodChangeTotal += m_lods.LastChangeCount();
+	}
+
+	void BenchScene::MoveBodies(const float dt) {
+		const float size = m_desc.worldSize;
+		for (Body& body : m_bodies) {
+			vec3 center = body.box.Center() + body.velocity * dt;
+			for (uint32_t axis = 0; axis < 3; ++axis) {
+				float& position = axis == 0 ? center.x() : axis == 1 ? center.y() : center.z();
+				float& velocity = axis == 0 ? body.velocity.x() : axis == 1 ? body.velocity.y() : body.velocity.z();
+				if (position < 0.0f || position > size) {
+					position = std::clamp(position, 0.0f, size);
+					velocity = -velocity;
+				}
+			}
+			body.box = AABB::FromCenterExtents(center, body.box.Extents());
+			m_broadphase.Move(body.handle, body.box);
+		}
+
+		m_pairTotal += m_broadphase.FindPairs(m_arena, &m_jobs).size();
+		m_arena.Reset();
+	}
+
+	void BenchScene::SortParticles() {
+		const vec3 forward = m_pose.target - m_pose.eye;
+		m_particles.SortBackToFront(m_pose.eye, forward / forward.length(), &m_jobs);
+		m_particleTotal += m_particles.ParticleCount();
+	}
+
+#pragma endregion
+
+} // namespace Sandbox
@@ -1,11 +1,47 @@
 #include "SandboxApp.hpp"
+#include "logging/Log.hpp"
+
+SandboxApp::SandboxApp(const std::string_view scene, const uint32_t seed, std::string metricsEndpoint)
+	: Application({ .title = L"Sandbox", .width = 1280, .height = 720, .metricsEndpoint = std::move(metricsEndpoint) })
+	, m_sceneDesc(Sandbox::FindBenchScene(scene))
+	, m_seed(seed)
+{
+	if (!m_sceneDesc)
+		throw std::invalid_argument("SandboxApp : unknown scene '" + std::string(scene) + "'");
+}
+
+void SandboxApp::OnConfigureStartup(Zenyth::StartupGraph& startup)
+{
+	// Scene generation does not need the window or the device, so it overlaps with them
+	startup.Add("scene", {}, [this] {
+		m_scene = std::make_unique<Sandbox::BenchScene>(*m_sceneDesc, m_seed, GetJobSystem());
+	});
+}
 
 void SandboxApp::OnInit()
 {
+	GetMetrics().AddGaugeFn("zenyth_arena_high_water_bytes", "Most bytes a frame took from a linear arena",
+		[this] { return static_cast<double>(m_scene->ArenaHighWaterBytes()); }, "arena=\"broadphase\"");
 }
 
 void SandboxApp::OnUpdate(float dt)
 {
+	// The scripted camera and simulation always advance by the same step, whatever the frame rate
+	const Sandbox::PhaseTimes times = m_scene->Step(1.0f / 60.0f);
+	for (size_t i = 0; i < times.size(); ++i)
+		m_phaseTotals[i] += times[i];
+
+	if (++m_framesSinceReport < ReportInterval)
+		return;
+
+	for (size_t i = 0; i < m_phaseTotals.size(); ++i) {
+		if (m_phaseTotals[i] > 0.0) {
+			ZENYTH_LOG_INFO(Game, "{} {}: {:.3f} ms", m_sceneDesc->name, Sandbox::ToString(static_cast<Sandbox::Phase>(i)),
+				m_phaseTotals[i] / m_framesSinceReport);
+		}
+	}
+	m_phaseTotals = {};
+	m_framesSinceReport = 0;
 }
 
 void SandboxApp::OnRender()
@@ -19,4 +55,5 @@ void SandboxApp::OnEvent(const Zenyth::Event& e)
 
 void SandboxApp::OnShutdown()
 {
-}
\ No newline at end of file
+	m_scene.reset();
+}
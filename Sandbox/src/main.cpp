@@ -1,27 +1,150 @@
 #include "SandboxApp.hpp"
+#include "BenchHarness.hpp"
 #include "D3D12Renderer.hpp"
+#include "logging/Log.hpp"
+#include "logging/LogSinks.hpp"
 #include "math/vector.hpp"
 #include "math/matrix.hpp"
 
+#include <charconv>
 
+namespace {
 
-int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, const int nShowCmd)
-{
-	zenyth::math::vec4 vec{ 1, 2, 3, 4 };
-	zenyth::math::mat4 mat;
-	const float foo = mat[0, 0];
+	std::string ToUtf8(const std::wstring_view text)
+	{
+		if (text.empty())
+			return {};
+		const int size = ::WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+		std::string out(static_cast<size_t>(size), '\0');
+		::WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), out.data(), size, nullptr, nullptr);
+		return out;
+	}
+
+	std::vector<std::string> CommandLineArgs()
+	{
+		int count = 0;
+		LPWSTR* argv = ::CommandLineToArgvW(::GetCommandLineW(), &count);
+		if (!argv)
+			return {};
+
+		std::vector<std::string> args;
+		for (int i = 1; i < count; ++i)
+			args.push_back(ToUtf8(argv[i]));
+		::LocalFree(argv);
+		return args;
+	}
+
+	std::filesystem::path Utf8Path(const std::string_view text)
+	{
+		return std::u8string(reinterpret_cast<const char8_t*>(text.data()), text.size());
+	}
+
+	template<typename T>
+	T ParseNumber(const std::string_view option, const std::string_view text)
+	{
+		T value{};
+		const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (ec != std::errc() || end != text.data() + text.size())
+			throw std::runtime_error("invalid value '" + std::string(text) + "' for " + std::string(option));
+		return value;
+	}
+
+	// Sandbox --bench <scene|all> [--frames n] [--warmup n] [--seed n] [--jobs n] [--label text] [--out file.json]
+	// Sandbox --compare <baseline.json> <current.json> [--threshold percent], exits with 1 on regressions;
+	// the report is logged and written to stdout, which a WIN32 program only has when redirected
+	// Sandbox [--scene name] [--seed n] [--metrics host:port|unix:path]
+	int Run(const std::vector<std::string>& args)
+	{
+		Sandbox::BenchRunDesc bench;
+		std::string benchScene, label, metrics, scene = "mixed";
+		std::filesystem::path output = "bench.json";
+		std::vector<std::filesystem::path> compare;
+		double threshold = 5.0;
+
+		for (size_t i = 0; i < args.size(); ++i) {
+			const std::string_view arg = args[i];
+			const auto value = [&]() -> std::string_view {
+				if (i + 1 >= args.size())
+					throw std::runtime_error("missing value for " + std::string(arg));
+				return args[++i];
+			};
+
+			if (arg == "--bench")            benchScene = value();
+			else if (arg == "--frames")      bench.frames = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--warmup")      bench.warmupFrames = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--seed")        bench.seed = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--jobs")        bench.workerThreads = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--label")       label = value();
+			else if (arg == "--out")         output = Utf8Path(value());
+			else if (arg == "--threshold")   threshold = ParseNumber<double>(arg, value());
+			else if (arg == "--scene")       scene = value();
+			else if (arg == "--metrics")     metrics = value();
+			else if (arg == "--compare") {
+				compare.push_back(Utf8Path(value()));
+				compare.push_back(Utf8Path(value()));
+			}
+			else
+				throw std::runtime_error("unknown option " + std::string(arg));
+		}
 
-	std::stringstream ss;
-	ss << foo << "\n";
+		if (!compare.empty()) {
+			const Sandbox::BenchComparison comparison = Sandbox::CompareResults(
+				Sandbox::ReadResults(compare[0]), Sandbox::ReadResults(compare[1]), threshold);
+			const std::string report = Sandbox::FormatComparison(comparison);
+			std::cout << report;
+			ZENYTH_LOG_INFO(General, "benchmark comparison:\n{}", std::string_view(report));
+			return comparison.HasRegression() ? 1 : 0;
+		}
 
-	OutputDebugStringA(ss.str().c_str());
+		if (!benchScene.empty()) {
+			std::vector<Sandbox::BenchResult> results;
+			for (const Sandbox::SceneDesc& desc : Sandbox::BenchScenes()) {
+				if (benchScene != "all" && benchScene != desc.name)
+					continue;
+				bench.scene = desc.name;
+				results.push_back(Sandbox::RunBenchmark(bench, label));
+				ZENYTH_LOG_INFO(General, "bench {}: {:.1f} frames/s over {} frames", desc.name, results.back().framesPerSecond, bench.frames);
+			}
+			if (results.empty())
+				throw std::runtime_error("unknown scene " + benchScene);
+			Sandbox::WriteResults(output, results);
+			return 0;
+		}
 
-	SandboxApp app;
+		zenyth::math::vec4 vec{ 1, 2, 3, 4 };
+		zenyth::math::mat4 mat;
+		const float foo = mat[0, 0];
+
+		ZENYTH_LOG_DEBUG(General, "{}", foo);
+
+		SandboxApp app(scene, bench.seed, metrics);
+
+		std::unique_ptr<Zenyth::IRenderer> renderer = std::make_unique<Zenyth::D3D12Renderer>();
+		app.SetRenderer(std::move(renderer));
+
+		app.Run();
+		return 0;
+	}
+
+}
+
+int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, const int nShowCmd)
+{
+	using namespace Zenyth::logging;
 
-	std::unique_ptr<Zenyth::IRenderer> renderer = std::make_unique<Zenyth::D3D12Renderer>();
-	app.SetRenderer(std::move(renderer));
+	Logger::AddSink(std::make_unique<DebuggerSink>());
+	Logger::AddSink(std::make_unique<FileSink>("Sandbox.log"));
+	Logger::Start();
 
-	app.Run();
+	int exitCode = 0;
+	try {
+		exitCode = Run(CommandLineArgs());
+	}
+	catch (const std::exception& e) {
+		ZENYTH_LOG_FATAL(General, "{}", std::string_view(e.what()));
+		exitCode = 1;
+	}
 
-	return 0;
+	Logger::Stop();
+	return exitCode;
 }
@@ -0,0 +1,51 @@
+#pragma once
+#include <charconv>
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Zenyth::Bench {
+
+	struct BenchmarkOptions {
+		uint32_t                      iterations = 20;
+		uint32_t                      jobs = 0;    // worker threads for the parallel runs, 0 for one per core
+		uint32_t                      seed = 1234;
+		std::vector<std::string_view> args;        // benchmark specific, parsed by the benchmark itself
+	};
+
+	struct Benchmark {
+		std::string_view name;
+		std::string_view description;
+		int (*run)(const BenchmarkOptions& options);
+	};
+
+	int RunSkinning(const BenchmarkOptions& options);
+	int RunDelegate(const BenchmarkOptions& options);
+
+	// Median wall time of fn() in milliseconds after one warm-up call
+	template<typename F>
+	[[nodiscard]] double MeasureMs(const uint32_t iterations, F&& fn) {
+		fn();
+
+		std::vector<double> samples(std::max(iterations, 1u));
+		for (double& sample : samples) {
+			const auto start = std::chrono::steady_clock::now();
+			fn();
+			sample = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+		std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+		return samples[samples.size() / 2];
+	}
+
+	template<typename T>
+	[[nodiscard]] T ParseNumber(const std::string_view option, const std::string_view text) {
+		T value{};
+		const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (ec != std::errc() || end != text.data() + text.size())
+			throw std::runtime_error("invalid value '" + std::string(text) + "' for " + std::string(option));
+		return value;
+	}
+
+} // namespace Zenyth::Bench
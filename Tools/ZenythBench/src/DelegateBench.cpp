@@ -0,0 +1,161 @@
+#include "pch.hpp"
+#include "Benchmark.hpp"
+#include "EventDispatcher.hpp"
+
+#include <iomanip>
+#include <random>
+
+namespace Zenyth::Bench {
+
+	namespace {
+		// Stand-in for Application: the window callback forwards to a virtual OnEvent
+		class AppBase {
+		public:
+			virtual ~AppBase() = default;
+
+			void OnWindowEvent(const Event& e) { OnEvent(e); }
+
+			virtual void OnEvent(const Event& e) = 0;
+
+			uint64_t checksum = 0;
+		};
+
+		class KeyApp final : public AppBase {
+		public:
+			void OnEvent(const Event& e) override { checksum += e.type == EventType::KeyDown ? e.key.keycode : 1; }
+		};
+
+		class MouseApp final : public AppBase {
+		public:
+			void OnEvent(const Event& e) override { checksum += e.type == EventType::MouseMove ? static_cast<uint32_t>(e.mouseMove.x) : 2; }
+		};
+
+		// Chosen at run time so the compiler cannot devirtualize OnEvent
+		std::unique_ptr<AppBase> MakeApp(const uint32_t seed) {
+			if (seed % 2)
+				return std::make_unique<KeyApp>();
+			return std::make_unique<MouseApp>();
+		}
+
+		struct Listener {
+			uint64_t  checksum = 0;
+			EventType type;
+
+			bool Handle(const Event& e) {
+				checksum += static_cast<uint32_t>(e.type) + 1;
+				return false;
+			}
+		};
+
+		std::vector<Event> MakeEvents(const uint32_t seed, const uint32_t count) {
+			std::mt19937 rng(seed);
+			std::uniform_int_distribution<uint32_t> type(0, EventTypeCount - 1);
+			std::uniform_int_distribution<int32_t>  coordinate(0, 4096);
+
+			std::vector<Event> events(count);
+			for (Event& e : events) {
+				e.type = static_cast<EventType>(type(rng));
+				e.mouseMove = { coordinate(rng), coordinate(rng) };
+			}
+			return events;
+		}
+	}
+
+	int RunDelegate(const BenchmarkOptions& options) {
+		uint32_t eventCount = 1u << 20;
+		uint32_t listenerCount = 4;
+
+		for (size_t i = 0; i < options.args.size(); ++i) {
+			const std::string_view arg = options.args[i];
+			const auto value = [&]() -> std::string_view {
+				if (i + 1 >= options.args.size())
+					throw std::runtime_error("missing value for " + std::string(arg));
+				return options.args[++i];
+			};
+
+			if (arg == "--events")         eventCount = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--listeners") listenerCount = ParseNumber<uint32_t>(arg, value());
+			else
+				throw std::runtime_error("delegate: unknown option " + std::string(arg));
+		}
+		if (eventCount == 0 || listenerCount == 0 || listenerCount > EventDispatcher::MaxListenersPerType)
+			throw std::runtime_error("delegate: counts must be positive and listeners at most " + std::to_string(EventDispatcher::MaxListenersPerType));
+
+		const std::vector<Event> events = MakeEvents(options.seed, eventCount);
+		const std::unique_ptr<AppBase> app = MakeApp(options.seed);
+
+		std::cout << "delegate: " << eventCount << " events, " << listenerCount << " listeners per event type, "
+			<< options.iterations << " iterations\n"
+			<< "sizeof std::function " << sizeof(std::function<void(const Event&)>) << " B, Delegate "
+			<< sizeof(Delegate<void(const Event&)>) << " B\n\n"
+			<< std::left << std::setw(36) << "path" << std::right << std::setw(12) << "ns/event" << std::setw(10) << "speedup" << "\n";
+
+		double baselineNs = 0.0;
+		const auto report = [&](const std::string_view name, const double ms) {
+			const double ns = ms * 1e6 / eventCount;
+			if (baselineNs == 0.0)
+				baselineNs = ns;
+			std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+				<< std::setw(12) << std::setprecision(2) << ns
+				<< std::setw(9) << baselineNs / ns << "x" << std::defaultfloat << "\n";
+		};
+
+		// Single callback, as Window drives Application
+		{
+			const std::function<void(const Event&)> callback = [&](const Event& e) { app->OnWindowEvent(e); };
+			report("std::function -> virtual OnEvent", MeasureMs(options.iterations, [&] {
+				for (const Event& e : events)
+					callback(e);
+			}));
+
+			const Delegate<void(const Event&)> delegate = Delegate<void(const Event&)>::Bind<&AppBase::OnWindowEvent>(app.get());
+			report("Delegate -> virtual OnEvent", MeasureMs(options.iterations, [&] {
+				for (const Event& e : events)
+					delegate(e);
+			}));
+		}
+
+		// Fan-out: one std::function list where every listener filters by type, against per-type subscription
+		std::vector<Listener> listeners(static_cast<size_t>(listenerCount) * EventTypeCount);
+		for (size_t i = 0; i < listeners.size(); ++i)
+			listeners[i].type = static_cast<EventType>(i % EventTypeCount);
+
+		{
+			std::vector<std::function<bool(const Event&)>> callbacks;
+			for (Listener& listener : listeners) {
+				callbacks.emplace_back([&listener](const Event& e) {
+					return e.type == listener.type && listener.Handle(e);
+				});
+			}
+
+			baselineNs = 0.0;
+			std::cout << "\n";
+			report("std::function list, filtered", MeasureMs(options.iterations, [&] {
+				for (const Event& e : events) {
+					for (const auto& callback : callbacks) {
+						if (callback(e))
+							break;
+					}
+				}
+			}));
+		}
+
+		{
+			EventDispatcher dispatcher;
+			for (Listener& listener : listeners)
+				dispatcher.Subscribe<&Listener::Handle>(listener.type, &listener);
+
+			report("EventDispatcher, per type", MeasureMs(options.iterations, [&] {
+				for (const Event& e : events)
+					dispatcher.Dispatch(e);
+			}));
+		}
+
+		uint64_t checksum = app->checksum;
+		for (const Listener& listener : listeners)
+			checksum += listener.checksum;
+		std::cout << "\nchecksum " << checksum << "\n";
+		return 0;
+	}
+
+} // namespace Zenyth::Bench
@@ -0,0 +1,193 @@
+#include "pch.hpp"
+#include "Benchmark.hpp"
+#include "CpuFeatures.hpp"
+#include "animation/Skinning.hpp"
+
+#include <iomanip>
+#include <random>
+
+namespace Zenyth::Bench {
+
+	using namespace zenyth::math;
+
+	namespace {
+		struct Character {
+			std::vector<float>         positions;
+			std::vector<float>         normals;
+			std::vector<SkinInfluence> influences;
+			std::vector<mat4>          matrices;
+			std::vector<DualQuat>      dualQuats;
+
+			[[nodiscard]] SkinningInput Input() const noexcept { return { positions, normals, influences }; }
+		};
+
+		// A random blob of vertices bound to a chain of bones bent into an arc; palettes are rigid so
+		// linear and dual quaternion results are directly comparable
+		Character MakeCharacter(std::mt19937& rng, const uint32_t vertexCount, const uint32_t boneCount) {
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			std::uniform_int_distribution<int>    bone(0, static_cast<int>(boneCount) - 1);
+			std::uniform_int_distribution<int>    influenceCount(1, 4);
+
+			Character c;
+			c.positions.resize(static_cast<size_t>(vertexCount) * 3);
+			c.normals.resize(static_cast<size_t>(vertexCount) * 3);
+			c.influences.resize(vertexCount);
+
+			for (uint32_t v = 0; v < vertexCount; ++v) {
+				float n[3] = { unit(rng), unit(rng), unit(rng) };
+				const float length = std::max(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]), 1e-3f);
+				for (uint32_t k = 0; k < 3; ++k) {
+					c.positions[v * 3 + k] = unit(rng) * 2.0f;
+					c.normals[v * 3 + k] = n[k] / length;
+				}
+
+				SkinInfluence& influence = c.influences[v];
+				const int      used = influenceCount(rng);
+				float          total = 0.0f;
+				for (int k = 0; k < 4; ++k) {
+					influence.bones[k] = static_cast<uint16_t>(bone(rng));
+					influence.weights[k] = k < used ? (unit(rng) + 1.0f) * 0.5f + 0.01f : 0.0f;
+					total += influence.weights[k];
+				}
+				for (float& w : influence.weights)
+					w /= total;
+			}
+
+			const float phase = unit(rng) * 3.14159f;
+			for (uint32_t b = 0; b < boneCount; ++b) {
+				const float angle = phase + static_cast<float>(b) * 0.1f;
+				const quat  rotation = quat::from_axis_angle(vec3(0.3f, 1.0f, 0.2f), angle);
+				const vec3  translation(std::sin(angle), static_cast<float>(b) * 0.05f, std::cos(angle));
+				c.dualQuats.push_back(DualQuat::FromRotationTranslation(rotation, translation));
+				c.matrices.push_back(mat4::from_translation(translation) * rotation.to_mat4());
+			}
+			return c;
+		}
+
+		struct Error {
+			float position = 0.0f;
+			float normal = 0.0f;
+		};
+
+		Error Compare(std::span<const SkinnedVertex> a, std::span<const SkinnedVertex> b) {
+			Error error;
+			for (size_t i = 0; i < a.size(); ++i) {
+				for (uint32_t k = 0; k < 3; ++k) {
+					error.position = std::max(error.position, std::abs(a[i].position[k] - b[i].position[k]));
+					error.normal = std::max(error.normal, std::abs(a[i].normal[k] - b[i].normal[k]));
+				}
+			}
+			return error;
+		}
+
+		const char* PathName(const SkinningPath path) {
+			switch (path) {
+				case SkinningPath::Scalar: return "scalar";
+				case SkinningPath::Sse:    return "sse";
+				case SkinningPath::Avx2:   return "avx2";
+				default:                   return "auto";
+			}
+		}
+	}
+
+	int RunSkinning(const BenchmarkOptions& options) {
+		uint32_t vertexCount = 8192;
+		uint32_t characterCount = 32;
+		uint32_t boneCount = 64;
+
+		for (size_t i = 0; i < options.args.size(); ++i) {
+			const std::string_view arg = options.args[i];
+			const auto value = [&]() -> std::string_view {
+				if (i + 1 >= options.args.size())
+					throw std::runtime_error("missing value for " + std::string(arg));
+				return options.args[++i];
+			};
+
+			if (arg == "--vertices")        vertexCount = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--characters") characterCount = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--bones")      boneCount = ParseNumber<uint32_t>(arg, value());
+			else
+				throw std::runtime_error("skinning: unknown option " + std::string(arg));
+		}
+		if (vertexCount == 0 || characterCount == 0 || boneCount == 0 || boneCount > 65536)
+			throw std::runtime_error("skinning: counts must be positive and bones at most 65536");
+
+		std::mt19937 rng(options.seed);
+		std::vector<Character> characters;
+		for (uint32_t i = 0; i < characterCount; ++i)
+			characters.push_back(MakeCharacter(rng, vertexCount, boneCount));
+
+		const size_t totalVertices = static_cast<size_t>(vertexCount) * characterCount;
+		std::vector<SkinnedVertex> reference(totalVertices), output(totalVertices);
+
+		std::vector<SkinningPath> paths = { SkinningPath::Scalar, SkinningPath::Sse };
+		if (GetCpuFeatures().avx2 && GetCpuFeatures().fma)
+			paths.push_back(SkinningPath::Avx2);
+
+		JobSystem jobs(options.jobs);
+		// Two frames in flight, each holding one full crowd
+		UploadRing ring(2 * (totalVertices * sizeof(SkinnedVertex) + characterCount * UploadRing::MaxAlignment), 2);
+
+		std::cout << "skinning: " << characterCount << " characters x " << vertexCount << " vertices, "
+			<< boneCount << " bones, " << options.iterations << " iterations\n\n"
+			<< std::left << std::setw(10) << "method" << std::setw(10) << "path" << std::setw(9) << "threads"
+			<< std::right << std::setw(10) << "ms" << std::setw(12) << "Mverts/s" << std::setw(10) << "speedup"
+			<< std::setw(12) << "pos err" << std::setw(12) << "nrm err" << "\n";
+
+		for (const bool dualQuat : { false, true }) {
+			const auto skin = [&](const Character& c, const std::span<SkinnedVertex> out, JobSystem* js, const SkinningPath path) {
+				if (dualQuat)
+					SkinDualQuat(c.dualQuats, c.Input(), out, js, path);
+				else
+					SkinLinear(c.matrices, c.Input(), out, js, path);
+			};
+			const auto skinAll = [&](std::vector<SkinnedVertex>& out, JobSystem* js, const SkinningPath path) {
+				for (uint32_t i = 0; i < characterCount; ++i)
+					skin(characters[i], std::span(out).subspan(static_cast<size_t>(i) * vertexCount, vertexCount), js, path);
+			};
+
+			double scalarMs = 0.0;
+			const auto report = [&](const SkinningPath path, const uint32_t threads, const double ms, const Error& error) {
+				if (path == SkinningPath::Scalar && threads == 1)
+					scalarMs = ms;
+				std::cout << std::left << std::setw(10) << (dualQuat ? "dualquat" : "linear") << std::setw(10) << PathName(path)
+					<< std::setw(9) << threads << std::right << std::fixed
+					<< std::setw(10) << std::setprecision(3) << ms
+					<< std::setw(12) << std::setprecision(1) << static_cast<double>(totalVertices) / (ms * 1000.0)
+					<< std::setw(9) << std::setprecision(2) << scalarMs / ms << "x"
+					<< std::setw(12) << std::scientific << std::setprecision(1) << error.position
+					<< std::setw(12) << error.normal << std::defaultfloat << "\n";
+			};
+
+			skinAll(reference, nullptr, SkinningPath::Scalar);
+
+			for (const SkinningPath path : paths) {
+				const double ms = MeasureMs(options.iterations, [&] { skinAll(output, nullptr, path); });
+				report(path, 1, ms, Compare(reference, output));
+			}
+
+			// Frame loop shape: every character skins into this frame's upload memory, chunked over the workers
+			std::vector<UploadRing::Allocation> allocations(characterCount);
+			const double ms = MeasureMs(options.iterations, [&] {
+				ring.BeginFrame();
+				for (uint32_t i = 0; i < characterCount; ++i) {
+					const Character& c = characters[i];
+					allocations[i] = dualQuat
+						? SkinDualQuat(c.dualQuats, c.Input(), ring, &jobs)
+						: SkinLinear(c.matrices, c.Input(), ring, &jobs);
+					if (!allocations[i])
+						throw std::runtime_error("skinning: upload ring exhausted");
+				}
+			});
+
+			for (uint32_t i = 0; i < characterCount; ++i) {
+				const auto skinned = allocations[i].As<SkinnedVertex>();
+				std::copy(skinned.begin(), skinned.end(), output.begin() + static_cast<ptrdiff_t>(i) * vertexCount);
+			}
+			report(SkinningPath::Auto, jobs.ThreadCount(), ms, Compare(reference, output));
+		}
+
+		return 0;
+	}
+
+} // namespace Zenyth::Bench
@@ -0,0 +1,81 @@
+#include "pch.hpp"
+#include "Benchmark.hpp"
+
+namespace {
+
+	constexpr Zenyth::Bench::Benchmark Benchmarks[] = {
+		{ "skinning", "linear blend and dual quaternion skinning, SIMD paths against the scalar reference", Zenyth::Bench::RunSkinning },
+		{ "delegate", "event dispatch through Delegate and EventDispatcher against std::function", Zenyth::Bench::RunDelegate },
+	};
+
+	void PrintUsage() {
+		std::cout <<
+			"Usage: ZenythBench [options] <benchmark> [benchmark options]\n"
+			"\n"
+			"  --iterations <n>             timed runs per measurement, the median is reported (default: 20)\n"
+			"  -j, --jobs <n>               worker threads for parallel runs (default: one per core)\n"
+			"  --seed <n>                   random seed for generated data (default: 1234)\n"
+			"\n"
+			"Benchmarks:\n";
+		for (const auto& benchmark : Benchmarks)
+			std::cout << "  " << benchmark.name << std::string(29 - benchmark.name.size(), ' ') << benchmark.description << "\n";
+		std::cout <<
+			"\n"
+			"skinning options: --vertices <n> (8192), --characters <n> (32), --bones <n> (64)\n"
+			"delegate options: --events <n> (1048576), --listeners <n> per event type (4)\n";
+	}
+
+	int Run(const int argc, char** argv) {
+		Zenyth::Bench::BenchmarkOptions options;
+		const Zenyth::Bench::Benchmark* selected = nullptr;
+
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg = argv[i];
+			if (selected) {
+				options.args.push_back(arg);
+				continue;
+			}
+
+			const auto value = [&]() -> std::string_view {
+				if (i + 1 >= argc)
+					throw std::runtime_error("missing value for " + std::string(arg));
+				return argv[++i];
+			};
+
+			if (arg == "-h" || arg == "--help") {
+				PrintUsage();
+				return 0;
+			}
+			else if (arg == "--iterations")           options.iterations = Zenyth::Bench::ParseNumber<uint32_t>(arg, value());
+			else if (arg == "-j" || arg == "--jobs")  options.jobs = Zenyth::Bench::ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--seed")                 options.seed = Zenyth::Bench::ParseNumber<uint32_t>(arg, value());
+			else if (arg.starts_with("-"))
+				throw std::runtime_error("unknown option " + std::string(arg));
+			else {
+				for (const auto& benchmark : Benchmarks) {
+					if (benchmark.name == arg)
+						selected = &benchmark;
+				}
+				if (!selected)
+					throw std::runtime_error("unknown benchmark " + std::string(arg));
+			}
+		}
+
+		if (!selected) {
+			PrintUsage();
+			return 1;
+		}
+		return selected->run(options);
+	}
+
+}
+
+int main(const int argc, char** argv) {
+	try {
+		return Run(argc, argv);
+	}
+	catch (const std::exception& e) {
+		std::cerr << "ZenythBench: " << e.what() << "\n";
+		return 1;
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "assets/AssetPack.hpp"
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace Zenyth::Cook {
+
+	// Bump whenever a cooker change alters its output for the same source and settings; every
+	// cached asset is recooked after that
+	inline constexpr uint32_t CookerVersion = 1;
+
+	// 128-bit content hash, used for cache keys and object names
+	struct ContentHash {
+		uint64_t lo = 0;
+		uint64_t hi = 0;
+
+		[[nodiscard]] bool operator==(const ContentHash&) const = default;
+
+		[[nodiscard]] std::string ToString() const;
+		[[nodiscard]] static std::optional<ContentHash> Parse(std::string_view text) noexcept;
+	};
+
+	struct ContentHashHasher {
+		[[nodiscard]] size_t operator()(const ContentHash& h) const noexcept { return static_cast<size_t>(h.lo); }
+	};
+
+	// Streaming hash over bytes, two independent 64-bit lanes. Fast rather than cryptographic:
+	// keys only need to tell honest inputs apart.
+	class Hasher {
+	public:
+		void Update(std::span<const std::byte> bytes) noexcept;
+		void Update(std::string_view text) noexcept;
+
+		// Fields are added one by one: struct padding would make the hash nondeterministic
+		template<typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+		void Add(const T value) noexcept { Update(std::as_bytes(std::span(&value, 1))); }
+		void Add(const ContentHash& hash) noexcept { Add(hash.lo); Add(hash.hi); }
+
+		[[nodiscard]] ContentHash Finish() const noexcept;
+
+	private:
+		void Block(uint64_t word) noexcept;
+
+		uint64_t m_a = 0x9e3779b97f4a7c15ull;
+		uint64_t m_b = 0xc2b2ae3d27d4eb4full;
+		uint64_t m_tail = 0;       // bytes not yet forming a whole word
+		uint32_t m_tailBytes = 0;
+		uint64_t m_length = 0;
+	};
+
+	// Incremental cook cache on disk:
+	//
+	//   <root>/objects/ab/<hash>   cooked payloads, named by the hash of their bytes
+	//   <root>/bundles/<key>.zpak  the last pack built, hard-linked to the output
+	//   <root>/manifest            cook key -> object, source stat -> source hash, last bundle key and content hash
+	//
+	// A cook key hashes everything an asset's cooked bytes depend on (source bytes, CookerVersion,
+	// asset kind and settings), so an unchanged key means the stored object can be used as is.
+	// Identical outputs share one object. Find(), Store() and HashSource() may be called from any
+	// thread; Save() writes the manifest and is expected once at the end of a cook.
+	class CookCache {
+	public:
+		struct Entry {
+			ContentHash object;
+			AssetType   type = AssetType::Raw;
+			uint64_t    size = 0;
+		};
+
+		struct CacheStats {
+			uint32_t hits = 0;
+			uint32_t misses = 0;
+			uint32_t sourcesHashed = 0; // read in full; the rest matched their recorded size and write time
+		};
+
+		// Loads the manifest when there is one; a missing or unreadable manifest starts an empty cache
+		explicit CookCache(std::filesystem::path root);
+
+		CookCache(const CookCache&) = delete;
+		CookCache& operator=(const CookCache&) = delete;
+
+		[[nodiscard]] ContentHash HashSource(const std::filesystem::path& path);
+
+		// Empty when the key is unknown or its object has gone missing
+		[[nodiscard]] std::optional<Entry> Find(const ContentHash& key);
+		Entry Store(const ContentHash& key, AssetType type, std::span<const std::byte> payload);
+		[[nodiscard]] MappedFile Map(const Entry& entry) const;
+
+		// Writes the pack into the cache unless the bundle key matches the last one built and the
+		// bundle's bytes still hash to what was written, then hard-links it to output (copying where
+		// links are unsupported). Returns false when the pack was reused.
+		bool Publish(const ContentHash& bundleKey, const AssetPackWriter& writer, const std::filesystem::path& output);
+
+		// Forgets keys and sources not used since the cache was opened and deletes unreferenced objects
+		void Prune();
+
+		void Save() const;
+
+		[[nodiscard]] const std::filesystem::path& Root()  const noexcept { return m_root; }
+		[[nodiscard]] CacheStats                   Stats() const;
+
+	private:
+		struct Source {
+			uint64_t    size = 0;
+			int64_t     writeTime = 0;
+			ContentHash hash;
+			bool        used = false;
+		};
+
+		struct Record {
+			Entry entry;
+			bool  used = false;
+		};
+
+		void Load();
+		[[nodiscard]] std::filesystem::path ObjectPath(const ContentHash& object) const;
+		[[nodiscard]] std::filesystem::path BundlePath(const ContentHash& key) const;
+
+		std::filesystem::path m_root;
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<ContentHash, Record, ContentHashHasher> m_records;
+		std::unordered_map<std::string, Source>                    m_sources; // by absolute path
+		std::optional<ContentHash>                                 m_bundle;
+		std::optional<ContentHash>                                 m_bundleContent; // hash of the bundle's bytes
+		CacheStats                                                 m_stats;
+	};
+
+} // namespace Zenyth::Cook
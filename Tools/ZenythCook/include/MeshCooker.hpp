@@ -0,0 +1,45 @@
+#pragma once
+#include "SourceMesh.hpp"
+#include "assets/AssetPack.hpp"
+
+namespace Zenyth::Cook {
+
+	struct MeshCookSettings {
+		uint32_t lodCount = 4;            // including the full detail level
+		float    lodRatio = 0.5f;         // index count of each level relative to the previous one
+		float    lodMaxError = 0.05f;     // relative to the mesh extent, accumulated over the chain
+		bool     meshlets = true;
+		uint32_t meshletMaxVertices = 64;
+		uint32_t meshletMaxTriangles = 124;
+		bool     quantize = true;
+	};
+
+	struct MeshCookStats {
+		uint32_t sourceVertices = 0;
+		uint32_t sourceTriangles = 0;
+		uint32_t vertices = 0;
+		float    acmrBefore = 0.0f;
+		float    acmrAfter = 0.0f;
+		uint32_t lodTriangles[8] = {};
+	};
+
+	struct CookedMesh {
+		std::string              name;
+		MeshHeader               header{};
+		std::vector<std::byte>   vertices;
+		std::vector<std::byte>   indices;
+		std::vector<MeshLod>     lods;
+		std::vector<MeshletDesc> meshlets;
+		std::vector<uint32_t>    meshletVertices;
+		std::vector<uint8_t>     meshletTriangles;
+		MeshCookStats            stats;
+
+		void AddTo(AssetPackWriter& writer) const;
+	};
+
+	// Builds the LOD chain, optimizes every level for the vertex cache, overdraw and vertex fetch,
+	// clusters it into meshlets and encodes the vertex buffer. Pure function of its inputs, so
+	// meshes can be cooked concurrently.
+	[[nodiscard]] CookedMesh CookMesh(const SourceMesh& mesh, const MeshCookSettings& settings);
+
+} // namespace Zenyth::Cook
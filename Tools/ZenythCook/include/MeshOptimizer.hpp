@@ -0,0 +1,59 @@
+#pragma once
+#include "SourceMesh.hpp"
+
+#include <span>
+#include <vector>
+
+// Index and vertex buffer optimizations run by the cooker. All functions work on triangle lists.
+namespace Zenyth::Cook {
+
+	inline constexpr uint32_t DefaultCacheSize = 16;
+	inline constexpr uint32_t MaxMeshletVertices = 255;
+	inline constexpr uint32_t MaxMeshletTriangles = 512;
+
+	struct Meshlet {
+		uint32_t vertexOffset;   // into the meshlet vertex array
+		uint32_t triangleOffset; // into the meshlet triangle byte array
+		uint32_t vertexCount;
+		uint32_t triangleCount;
+	};
+
+	struct MeshletBounds {
+		Float3 center;
+		float  radius;
+		Float3 coneApex;
+		Float3 coneAxis;
+		float  coneCutoff; // 1 when the triangles face too many directions to ever be culled
+	};
+
+	// Average cache misses per triangle for a FIFO post-transform cache
+	[[nodiscard]] float ComputeAcmr(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = DefaultCacheSize);
+
+	// Tipsify (Sander et al. 2007): reorders triangles for post-transform cache locality in linear time.
+	// `clusters` receives the first triangle of every run that starts after a cache flush, for OptimizeOverdraw.
+	[[nodiscard]] std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount,
+		std::vector<uint32_t>* clusters = nullptr, uint32_t cacheSize = DefaultCacheSize);
+
+	// Reorders the clusters produced by OptimizeVertexCache so outward facing ones draw first, reducing overdraw
+	// from any viewpoint. Clusters are split further while that keeps ACMR within `threshold` of the input.
+	void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const uint32_t> clusters, std::span<const Float3> positions,
+		float threshold = 1.05f, uint32_t cacheSize = DefaultCacheSize);
+
+	// Remap table ordering vertices by first use; unused vertices map to ~0u. Returns the used vertex count.
+	uint32_t OptimizeVertexFetchRemap(std::span<const uint32_t> indices, std::span<uint32_t> remap);
+
+	// Quadric edge collapse that only moves vertices onto existing ones, so every level can share the
+	// source vertex buffer. UV seams and open borders are kept intact. targetError is relative to the
+	// mesh extent; the reached error is written to resultError.
+	[[nodiscard]] std::vector<uint32_t> Simplify(std::span<const uint32_t> indices, std::span<const Float3> positions,
+		size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+	// Splits the triangle list, in order, into meshlets of at most maxVertices/maxTriangles.
+	// Triangle runs are padded to 4 bytes.
+	void BuildMeshlets(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t maxVertices, uint32_t maxTriangles,
+		std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles);
+
+	[[nodiscard]] MeshletBounds ComputeMeshletBounds(const Meshlet& meshlet, std::span<const uint32_t> meshletVertices,
+		std::span<const uint8_t> meshletTriangles, std::span<const Float3> positions);
+
+} // namespace Zenyth::Cook
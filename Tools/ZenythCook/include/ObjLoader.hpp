@@ -0,0 +1,12 @@
+#pragma once
+#include "SourceMesh.hpp"
+
+#include <filesystem>
+
+namespace Zenyth::Cook {
+
+	// Loads a Wavefront OBJ as a single mesh. Polygons are fan triangulated, identical
+	// position/uv/normal corners are welded, and missing normals are generated from the faces.
+	[[nodiscard]] SourceMesh LoadObj(const std::filesystem::path& path);
+
+} // namespace Zenyth::Cook
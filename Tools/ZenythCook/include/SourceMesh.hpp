@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Zenyth::Cook {
+
+	struct Float3 {
+		float x, y, z;
+	};
+
+	// Uncooked vertex, also the layout written for VertexLayout::PositionNormalUV
+	struct SourceVertex {
+		Float3 position;
+		Float3 normal;
+		float  uv[2];
+	};
+
+	// Indexed triangle list as it comes out of an importer
+	struct SourceMesh {
+		std::string               name;
+		std::vector<SourceVertex> vertices;
+		std::vector<uint32_t>     indices;
+	};
+
+	static_assert(sizeof(SourceVertex) == 32);
+
+} // namespace Zenyth::Cook
@@ -0,0 +1,40 @@
+#pragma once
+#include "assets/AssetPack.hpp"
+#include "texture/BlockCompression.hpp"
+#include "texture/MipChain.hpp"
+
+namespace Zenyth::Cook {
+
+	enum class TextureTarget : uint8_t {
+		Auto, // BC1 for opaque images, BC3 when any pixel has alpha
+		BC1,
+		BC3,
+		BC4,
+		BC5,
+		BC7,
+		RGBA8,
+	};
+
+	struct TextureCookSettings {
+		TextureTarget      format = TextureTarget::Auto;
+		CompressionQuality quality = CompressionQuality::Normal;
+		bool               srgb = true;  // color data; ignored by BC4/BC5, which are always linear
+		bool               mips = true;
+		MipFilter          mipFilter = MipFilter::Kaiser;
+	};
+
+	struct CookedTexture {
+		std::string                         name;
+		TextureHeader                       header{};
+		std::vector<std::vector<std::byte>> levels;
+		std::vector<uint32_t>               rowPitches;
+		std::vector<uint32_t>               rowCounts;
+
+		void AddTo(AssetPackWriter& writer) const;
+	};
+
+	// Generates the mip chain and encodes every level. Mips and blocks are spread over `jobs`
+	// when set, so a single large texture still uses every core.
+	[[nodiscard]] CookedTexture CookTexture(std::string name, const Image& image, const TextureCookSettings& settings, JobSystem* jobs = nullptr);
+
+} // namespace Zenyth::Cook
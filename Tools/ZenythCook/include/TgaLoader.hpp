@@ -0,0 +1,11 @@
+#pragma once
+#include "texture/Image.hpp"
+
+#include <filesystem>
+
+namespace Zenyth::Cook {
+
+	// Loads an uncompressed or RLE Truevision TGA (8-bit grey, 24 or 32-bit color) as RGBA8, top row first
+	[[nodiscard]] Image LoadTga(const std::filesystem::path& path);
+
+} // namespace Zenyth::Cook
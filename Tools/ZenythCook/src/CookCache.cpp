@@ -0,0 +1,334 @@
+#include "pch.hpp"
+#include "CookCache.hpp"
+
+#include <bit>
+#include <charconv>
+
+namespace Zenyth::Cook {
+
+	namespace {
+		constexpr std::string_view ManifestMagic = "zenyth-cook-cache";
+		constexpr uint32_t         ManifestVersion = 1;
+
+		// MurmurHash3 finalizer
+		constexpr uint64_t Mix(uint64_t x) noexcept {
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdull;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ull;
+			x ^= x >> 33;
+			return x;
+		}
+
+		int64_t WriteTime(const std::filesystem::path& path) {
+			return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+		}
+
+		// Writes next to the destination, then renames over it, so readers never see a partial file
+		void WriteAtomically(const std::filesystem::path& path, const std::filesystem::path& temp, const std::span<const std::byte> bytes) {
+			{
+				std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+				if (!out)
+					throw std::runtime_error("CookCache : cannot open " + temp.string());
+				out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+				if (!out)
+					throw std::runtime_error("CookCache : failed writing " + temp.string());
+			}
+			std::filesystem::rename(temp, path);
+		}
+
+		std::optional<ContentHash> HashFile(const std::filesystem::path& path) {
+			try {
+				const MappedFile file(path);
+				Hasher hasher;
+				hasher.Update(file.Data());
+				return hasher.Finish();
+			}
+			catch (const std::exception&) {
+				return std::nullopt;
+			}
+		}
+	}
+
+#pragma region ContentHash
+	std::string ContentHash::ToString() const {
+		return std::format("{:016x}{:016x}", hi, lo);
+	}
+
+	std::optional<ContentHash> ContentHash::Parse(const std::string_view text) noexcept {
+		if (text.size() != 32)
+			return std::nullopt;
+
+		ContentHash hash;
+		const auto parse = [&](const std::string_view digits, uint64_t& out) {
+			const auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), out, 16);
+			return ec == std::errc() && end == digits.data() + digits.size();
+		};
+		if (!parse(text.substr(0, 16), hash.hi) || !parse(text.substr(16), hash.lo))
+			return std::nullopt;
+		return hash;
+	}
+#pragma endregion
+
+#pragma region Hasher
+	void Hasher::Block(const uint64_t word) noexcept {
+		m_a = std::rotl(m_a ^ (word * 0x87c37b91114253d5ull), 31) * 0x9e3779b97f4a7c15ull;
+		m_b = std::rotl(m_b ^ (word * 0x4cf5ad432745937full), 27) * 0xc2b2ae3d27d4eb4full + m_a;
+	}
+
+	void Hasher::Update(std::span<const std::byte> bytes) noexcept {
+		m_length += bytes.size();
+
+		while (m_tailBytes != 0 && !bytes.empty()) {
+			m_tail |= static_cast<uint64_t>(bytes.front()) << (m_tailBytes * 8);
+			bytes = bytes.subspan(1);
+			if (++m_tailBytes == 8) {
+				Block(m_tail);
+				m_tail = 0;
+				m_tailBytes = 0;
+			}
+		}
+
+		while (bytes.size() >= 8) {
+			uint64_t word;
+			std::memcpy(&word, bytes.data(), 8);
+			Block(word);
+			bytes = bytes.subspan(8);
+		}
+
+		for (const std::byte b : bytes)
+			m_tail |= static_cast<uint64_t>(b) << (m_tailBytes++ * 8);
+	}
+
+	void Hasher::Update(const std::string_view text) noexcept {
+		// Length first, so consecutive strings cannot run into each other
+		Add(static_cast<uint64_t>(text.size()));
+		Update(std::as_bytes(std::span(text)));
+	}
+
+	ContentHash Hasher::Finish() const noexcept {
+		uint64_t a = m_a ^ Mix(m_tail ^ m_tailBytes);
+		uint64_t b = m_b ^ Mix(m_length);
+		a = Mix(a + b);
+		b = Mix(b ^ a);
+		return { a, b };
+	}
+#pragma endregion
+
+#pragma region CookCache
+	CookCache::CookCache(std::filesystem::path root)
+		: m_root(std::move(root))
+	{
+		std::filesystem::create_directories(m_root / "objects");
+		Load();
+	}
+
+	std::filesystem::path CookCache::ObjectPath(const ContentHash& object) const {
+		const std::string name = object.ToString();
+		return m_root / "objects" / name.substr(0, 2) / name;
+	}
+
+	std::filesystem::path CookCache::BundlePath(const ContentHash& key) const {
+		return m_root / "bundles" / (key.ToString() + ".zpak");
+	}
+
+	void CookCache::Load() {
+		std::ifstream in(m_root / "manifest");
+		if (!in)
+			return;
+
+		std::string line;
+		std::getline(in, line);
+		if (line != std::format("{} {}", ManifestMagic, ManifestVersion))
+			return; // another format: start over rather than guess
+
+		// A malformed line only loses that entry; the worst case is a recook
+		while (std::getline(in, line)) {
+			std::istringstream fields(line);
+			std::string kind, first;
+			fields >> kind >> first;
+
+			if (kind == "object") {
+				std::string object;
+				uint32_t    type = 0;
+				uint64_t    size = 0;
+				fields >> object >> type >> size;
+				const auto keyHash = ContentHash::Parse(first);
+				const auto objectHash = ContentHash::Parse(object);
+				if (fields && keyHash && objectHash)
+					m_records[*keyHash] = { { *objectHash, static_cast<AssetType>(type), size } };
+			}
+			else if (kind == "source") {
+				Source   source;
+				std::string hash;
+				fields >> source.writeTime >> hash;
+				const auto parsed = ContentHash::Parse(hash);
+				std::string path;
+				std::getline(fields >> std::ws, path);
+				if (fields && parsed && !path.empty() && std::from_chars(first.data(), first.data() + first.size(), source.size).ec == std::errc()) {
+					source.hash = *parsed;
+					m_sources[path] = source;
+				}
+			}
+			else if (kind == "bundle") {
+				std::string content;
+				fields >> content;
+				m_bundle = ContentHash::Parse(first);
+				m_bundleContent = ContentHash::Parse(content);
+			}
+		}
+	}
+
+	void CookCache::Save() const {
+		std::string text = std::format("{} {}\n", ManifestMagic, ManifestVersion);
+		{
+			std::lock_guard lock(m_mutex);
+			for (const auto& [key, record] : m_records) {
+				text += std::format("object {} {} {} {}\n", key.ToString(), record.entry.object.ToString(),
+					static_cast<uint32_t>(record.entry.type), record.entry.size);
+			}
+			for (const auto& [path, source] : m_sources)
+				text += std::format("source {} {} {} {}\n", source.size, source.writeTime, source.hash.ToString(), std::string_view(path));
+			if (m_bundle && m_bundleContent)
+				text += std::format("bundle {} {}\n", m_bundle->ToString(), m_bundleContent->ToString());
+		}
+
+		WriteAtomically(m_root / "manifest", m_root / "manifest.tmp", std::as_bytes(std::span(text)));
+	}
+
+	ContentHash CookCache::HashSource(const std::filesystem::path& path) {
+		const std::string key = std::filesystem::absolute(path).lexically_normal().generic_string();
+		const uint64_t    size = std::filesystem::file_size(path);
+		const int64_t     writeTime = WriteTime(path);
+
+		{
+			std::lock_guard lock(m_mutex);
+			const auto it = m_sources.find(key);
+			if (it != m_sources.end() && it->second.size == size && it->second.writeTime == writeTime) {
+				it->second.used = true;
+				return it->second.hash;
+			}
+		}
+
+		Hasher hasher;
+		hasher.Update(MappedFile(path).Data());
+		const ContentHash hash = hasher.Finish();
+
+		std::lock_guard lock(m_mutex);
+		m_sources[key] = { size, writeTime, hash, true };
+		++m_stats.sourcesHashed;
+		return hash;
+	}
+
+	std::optional<CookCache::Entry> CookCache::Find(const ContentHash& key) {
+		std::lock_guard lock(m_mutex);
+
+		const auto it = m_records.find(key);
+		std::error_code ec;
+		if (it == m_records.end() || std::filesystem::file_size(ObjectPath(it->second.entry.object), ec) != it->second.entry.size || ec) {
+			++m_stats.misses;
+			return std::nullopt;
+		}
+
+		it->second.used = true;
+		++m_stats.hits;
+		return it->second.entry;
+	}
+
+	CookCache::Entry CookCache::Store(const ContentHash& key, const AssetType type, const std::span<const std::byte> payload) {
+		Hasher hasher;
+		hasher.Update(payload);
+		const Entry entry{ hasher.Finish(), type, payload.size() };
+
+		const std::filesystem::path path = ObjectPath(entry.object);
+		std::error_code ec;
+		if (std::filesystem::file_size(path, ec) != payload.size() || ec) {
+			std::filesystem::create_directories(path.parent_path());
+			// Named by key: two assets cooking to the same bytes may store concurrently
+			WriteAtomically(path, path.string() + "." + key.ToString() + ".tmp", payload);
+		}
+
+		std::lock_guard lock(m_mutex);
+		m_records[key] = { entry, true };
+		return entry;
+	}
+
+	MappedFile CookCache::Map(const Entry& entry) const {
+		return MappedFile(ObjectPath(entry.object));
+	}
+
+	bool CookCache::Publish(const ContentHash& bundleKey, const AssetPackWriter& writer, const std::filesystem::path& output) {
+		const std::filesystem::path bundle = BundlePath(bundleKey);
+		std::optional<ContentHash> previous, previousContent;
+		{
+			std::lock_guard lock(m_mutex);
+			previous = m_bundle;
+			previousContent = m_bundleContent;
+		}
+
+		// The bundle is only trusted if its bytes are still the ones written: anything writing
+		// through the output link would otherwise go unnoticed
+		std::optional<ContentHash> content;
+		if (previous == bundleKey && previousContent)
+			content = HashFile(bundle);
+		const bool reuse = content && content == previousContent;
+		if (!reuse) {
+			std::filesystem::create_directories(bundle.parent_path());
+			const std::filesystem::path temp = bundle.string() + ".tmp";
+			writer.Write(temp);
+			std::filesystem::rename(temp, bundle);
+			content = HashFile(bundle);
+		}
+
+		std::error_code ec;
+		if (!std::filesystem::equivalent(bundle, output, ec)) {
+			// Never write through the output: it may be a link to an older bundle
+			std::filesystem::remove(output, ec);
+			std::filesystem::create_hard_link(bundle, output, ec);
+			if (ec)
+				std::filesystem::copy_file(bundle, output, std::filesystem::copy_options::overwrite_existing);
+		}
+
+		if (previous && *previous != bundleKey)
+			std::filesystem::remove(BundlePath(*previous), ec);
+
+		std::lock_guard lock(m_mutex);
+		m_bundle = bundleKey;
+		m_bundleContent = content;
+		return !reuse;
+	}
+
+	void CookCache::Prune() {
+		std::lock_guard lock(m_mutex);
+
+		std::erase_if(m_records, [](const auto& record) { return !record.second.used; });
+		std::erase_if(m_sources, [](const auto& source) { return !source.second.used; });
+
+		std::unordered_set<std::string> referenced;
+		for (const auto& [key, record] : m_records)
+			referenced.insert(record.entry.object.ToString());
+
+		std::vector<std::filesystem::path> stale;
+		for (const auto& file : std::filesystem::recursive_directory_iterator(m_root / "objects")) {
+			if (file.is_regular_file() && !referenced.contains(file.path().filename().string()))
+				stale.push_back(file.path());
+		}
+		if (std::filesystem::exists(m_root / "bundles")) {
+			for (const auto& file : std::filesystem::directory_iterator(m_root / "bundles")) {
+				if (!m_bundle || file.path() != BundlePath(*m_bundle))
+					stale.push_back(file.path());
+			}
+		}
+
+		std::error_code ec;
+		for (const std::filesystem::path& path : stale)
+			std::filesystem::remove(path, ec);
+	}
+
+	CookCache::CacheStats CookCache::Stats() const {
+		std::lock_guard lock(m_mutex);
+		return m_stats;
+	}
+#pragma endregion
+
+} // namespace Zenyth::Cook
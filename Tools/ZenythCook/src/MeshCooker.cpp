@@ -0,0 +1,241 @@
+#include "pch.hpp"
+#include "MeshCooker.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <bit>
+
+namespace Zenyth::Cook {
+
+	namespace {
+		struct QuantizedVertex {
+			uint16_t position[4]; // unorm16 within the mesh bounds, w unused
+			int8_t   normal[4];   // snorm8, w unused
+			uint16_t uv[2];       // half
+		};
+		static_assert(sizeof(QuantizedVertex) == 16);
+
+		// Round to nearest even, with overflow to infinity and gradual underflow
+		uint16_t FloatToHalf(const float value) noexcept {
+			const uint32_t bits = std::bit_cast<uint32_t>(value);
+			const uint32_t sign = (bits >> 16) & 0x8000u;
+			const uint32_t biased = (bits >> 23) & 0xFFu;
+			uint32_t mantissa = bits & 0x7FFFFFu;
+
+			if (biased == 0xFF)
+				return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+			const int32_t exponent = static_cast<int32_t>(biased) - 127 + 15;
+			if (exponent >= 31)
+				return static_cast<uint16_t>(sign | 0x7C00u);
+
+			if (exponent <= 0) {
+				if (exponent < -10)
+					return static_cast<uint16_t>(sign);
+				mantissa |= 0x800000u;
+				const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+				const uint32_t rest = mantissa & ((1u << shift) - 1);
+				const uint32_t halfway = 1u << (shift - 1);
+				uint32_t half = mantissa >> shift;
+				if (rest > halfway || (rest == halfway && (half & 1)))
+					++half;
+				return static_cast<uint16_t>(sign | half);
+			}
+
+			uint32_t half = sign | static_cast<uint32_t>(exponent) << 10 | mantissa >> 13;
+			const uint32_t rest = mantissa & 0x1FFFu;
+			if (rest > 0x1000u || (rest == 0x1000u && (half & 1)))
+				++half; // a carry into the exponent is still the correctly rounded value
+			return static_cast<uint16_t>(half);
+		}
+
+		uint16_t QuantizeUnorm16(const float value) noexcept {
+			return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+		}
+
+		int8_t QuantizeSnorm8(const float value) noexcept {
+			const float scaled = std::clamp(value, -1.0f, 1.0f) * 127.0f;
+			return static_cast<int8_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+		}
+	}
+
+	CookedMesh CookMesh(const SourceMesh& mesh, const MeshCookSettings& settings) {
+		CookedMesh out;
+		out.name = mesh.name;
+
+		const uint32_t sourceVertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		if (mesh.indices.size() % 3 != 0)
+			throw std::runtime_error("CookMesh : " + mesh.name + " is not a triangle list");
+
+		std::vector<Float3> positions(sourceVertexCount);
+		for (uint32_t v = 0; v < sourceVertexCount; ++v)
+			positions[v] = mesh.vertices[v].position;
+
+		std::vector<uint32_t> base;
+		base.reserve(mesh.indices.size());
+		for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+			const uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+			if (a >= sourceVertexCount || b >= sourceVertexCount || c >= sourceVertexCount)
+				throw std::runtime_error("CookMesh : " + mesh.name + " has out of range indices");
+			if (a != b && b != c && a != c)
+				base.insert(base.end(), { a, b, c });
+		}
+
+		out.stats.sourceVertices = sourceVertexCount;
+		out.stats.sourceTriangles = static_cast<uint32_t>(mesh.indices.size() / 3);
+		out.stats.acmrBefore = ComputeAcmr(base, sourceVertexCount);
+
+		// Each level is simplified from the previous one; errors add up along the chain
+		const uint32_t lodCount = std::clamp(settings.lodCount, 1u, static_cast<uint32_t>(std::size(out.stats.lodTriangles)));
+		std::vector<std::vector<uint32_t>> levels;
+		std::vector<float> errors;
+		levels.push_back(std::move(base));
+		errors.push_back(0.0f);
+
+		while (levels.size() < lodCount) {
+			const std::vector<uint32_t>& previous = levels.back();
+			const size_t target = static_cast<size_t>(static_cast<float>(previous.size() / 3) * settings.lodRatio) * 3;
+
+			float error = 0.0f;
+			std::vector<uint32_t> next = Simplify(previous, positions, target, settings.lodMaxError - errors.back(), &error);
+
+			// Stop once the error budget leaves too little to remove
+			if (next.empty() || next.size() * 10 > previous.size() * 9)
+				break;
+
+			errors.push_back(errors.back() + error);
+			levels.push_back(std::move(next));
+		}
+
+		std::vector<uint32_t> clusters;
+		for (std::vector<uint32_t>& level : levels) {
+			clusters.clear();
+			level = OptimizeVertexCache(level, sourceVertexCount, &clusters);
+			OptimizeOverdraw(level, clusters, positions);
+		}
+		out.stats.acmrAfter = ComputeAcmr(levels[0], sourceVertexCount);
+
+		// One index buffer holding every level, most detailed first, and a vertex buffer in first-use order
+		std::vector<uint32_t> indices;
+		for (const std::vector<uint32_t>& level : levels)
+			indices.insert(indices.end(), level.begin(), level.end());
+
+		std::vector<uint32_t> remap(sourceVertexCount);
+		const uint32_t vertexCount = OptimizeVertexFetchRemap(indices, remap);
+		for (uint32_t& index : indices)
+			index = remap[index];
+
+		std::vector<SourceVertex> vertices(vertexCount);
+		for (uint32_t v = 0; v < sourceVertexCount; ++v) {
+			if (remap[v] != ~0u)
+				vertices[remap[v]] = mesh.vertices[v];
+		}
+		for (uint32_t v = 0; v < vertexCount; ++v)
+			positions[v] = vertices[v].position;
+		positions.resize(vertexCount);
+
+		std::vector<Meshlet> meshlets;
+		uint32_t offset = 0;
+		for (size_t l = 0; l < levels.size(); ++l) {
+			const uint32_t count = static_cast<uint32_t>(levels[l].size());
+			MeshLod lod{ offset, count, static_cast<uint32_t>(meshlets.size()), 0, errors[l], 0 };
+
+			if (settings.meshlets) {
+				BuildMeshlets(std::span(indices).subspan(offset, count), vertexCount, settings.meshletMaxVertices, settings.meshletMaxTriangles,
+					meshlets, out.meshletVertices, out.meshletTriangles);
+				lod.meshletCount = static_cast<uint32_t>(meshlets.size()) - lod.meshletOffset;
+			}
+
+			out.lods.push_back(lod);
+			out.stats.lodTriangles[l] = count / 3;
+			offset += count;
+		}
+
+		out.meshlets.reserve(meshlets.size());
+		for (const Meshlet& m : meshlets) {
+			const MeshletBounds b = ComputeMeshletBounds(m, out.meshletVertices, out.meshletTriangles, positions);
+
+			MeshletDesc desc{};
+			desc.vertexOffset = m.vertexOffset;
+			desc.triangleOffset = m.triangleOffset;
+			desc.vertexCount = static_cast<uint16_t>(m.vertexCount);
+			desc.triangleCount = static_cast<uint16_t>(m.triangleCount);
+			desc.center[0] = b.center.x;     desc.center[1] = b.center.y;     desc.center[2] = b.center.z;
+			desc.radius = b.radius;
+			desc.coneApex[0] = b.coneApex.x; desc.coneApex[1] = b.coneApex.y; desc.coneApex[2] = b.coneApex.z;
+			desc.coneAxis[0] = b.coneAxis.x; desc.coneAxis[1] = b.coneAxis.y; desc.coneAxis[2] = b.coneAxis.z;
+			desc.coneCutoff = b.coneCutoff;
+			out.meshlets.push_back(desc);
+		}
+
+		MeshHeader& header = out.header;
+		header.vertexCount = vertexCount;
+		header.indexCount = static_cast<uint32_t>(indices.size());
+
+		Float3 lo{ 0, 0, 0 }, hi{ 0, 0, 0 };
+		if (vertexCount > 0) {
+			lo = hi = positions[0];
+			for (const Float3& p : positions) {
+				lo = { std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z) };
+				hi = { std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z) };
+			}
+		}
+		header.boundsMin[0] = lo.x; header.boundsMin[1] = lo.y; header.boundsMin[2] = lo.z;
+		header.boundsMax[0] = hi.x; header.boundsMax[1] = hi.y; header.boundsMax[2] = hi.z;
+
+		if (settings.quantize) {
+			const float scale[3] = {
+				hi.x > lo.x ? 1.0f / (hi.x - lo.x) : 0.0f,
+				hi.y > lo.y ? 1.0f / (hi.y - lo.y) : 0.0f,
+				hi.z > lo.z ? 1.0f / (hi.z - lo.z) : 0.0f,
+			};
+
+			std::vector<QuantizedVertex> quantized(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; ++v) {
+				const SourceVertex& src = vertices[v];
+				QuantizedVertex& dst = quantized[v];
+				dst.position[0] = QuantizeUnorm16((src.position.x - lo.x) * scale[0]);
+				dst.position[1] = QuantizeUnorm16((src.position.y - lo.y) * scale[1]);
+				dst.position[2] = QuantizeUnorm16((src.position.z - lo.z) * scale[2]);
+				dst.position[3] = 0;
+				dst.normal[0] = QuantizeSnorm8(src.normal.x);
+				dst.normal[1] = QuantizeSnorm8(src.normal.y);
+				dst.normal[2] = QuantizeSnorm8(src.normal.z);
+				dst.normal[3] = 0;
+				dst.uv[0] = FloatToHalf(src.uv[0]);
+				dst.uv[1] = FloatToHalf(src.uv[1]);
+			}
+
+			header.vertexLayout = VertexLayout::QuantizedPositionNormalUV;
+			header.vertexStride = sizeof(QuantizedVertex);
+			const auto bytes = std::as_bytes(std::span(quantized));
+			out.vertices.assign(bytes.begin(), bytes.end());
+		}
+		else {
+			header.vertexLayout = VertexLayout::PositionNormalUV;
+			header.vertexStride = sizeof(SourceVertex);
+			const auto bytes = std::as_bytes(std::span(vertices));
+			out.vertices.assign(bytes.begin(), bytes.end());
+		}
+
+		if (vertexCount <= std::numeric_limits<uint16_t>::max() + 1u) {
+			header.indexFormat = IndexFormat::UInt16;
+			std::vector<uint16_t> narrow(indices.size());
+			std::transform(indices.begin(), indices.end(), narrow.begin(), [](const uint32_t i) { return static_cast<uint16_t>(i); });
+			const auto bytes = std::as_bytes(std::span(narrow));
+			out.indices.assign(bytes.begin(), bytes.end());
+		}
+		else {
+			header.indexFormat = IndexFormat::UInt32;
+			const auto bytes = std::as_bytes(std::span(indices));
+			out.indices.assign(bytes.begin(), bytes.end());
+		}
+
+		out.stats.vertices = vertexCount;
+		return out;
+	}
+
+	void CookedMesh::AddTo(AssetPackWriter& writer) const {
+		writer.AddMesh(name, header, vertices, indices, lods, meshlets, meshletVertices, meshletTriangles);
+	}
+
+} // namespace Zenyth::Cook
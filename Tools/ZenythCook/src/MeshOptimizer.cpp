@@ -0,0 +1,573 @@
+#include "pch.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <bit>
+#include <numeric>
+
+namespace Zenyth::Cook {
+
+	namespace {
+		Float3 Sub(const Float3& a, const Float3& b) noexcept { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+		float  Dot(const Float3& a, const Float3& b) noexcept { return a.x * b.x + a.y * b.y + a.z * b.z; }
+		float  Length(const Float3& a) noexcept { return std::sqrt(Dot(a, a)); }
+		Float3 Cross(const Float3& a, const Float3& b) noexcept {
+			return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+		}
+		Float3 Normalize(const Float3& a) noexcept {
+			const float length = Length(a);
+			return length > 0.0f ? Float3{ a.x / length, a.y / length, a.z / length } : Float3{ 0.0f, 0.0f, 0.0f };
+		}
+
+		// FIFO cache model: a vertex stays resident for `size` insertions after it was loaded
+		class FifoCache {
+		public:
+			FifoCache(const uint32_t vertexCount, const uint32_t size)
+				: m_loadTime(vertexCount, 0), m_size(size), m_time(size + 1) {}
+
+			// Returns 1 on a miss
+			uint32_t Access(const uint32_t vertex) noexcept {
+				if (m_time - m_loadTime[vertex] <= m_size)
+					return 0;
+				m_loadTime[vertex] = m_time++;
+				return 1;
+			}
+
+			void Flush() noexcept { m_time += m_size + 1; }
+
+		private:
+			std::vector<uint32_t> m_loadTime;
+			uint32_t              m_size;
+			uint32_t              m_time;
+		};
+
+		// Vertex -> triangle adjacency in CSR form
+		struct Adjacency {
+			std::vector<uint32_t> offsets;
+			std::vector<uint32_t> triangles;
+
+			void Build(const std::span<const uint32_t> indices, const uint32_t vertexCount) {
+				offsets.assign(vertexCount + 1, 0);
+				for (const uint32_t v : indices)
+					++offsets[v + 1];
+				std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+				triangles.resize(indices.size());
+				std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+				for (size_t i = 0; i < indices.size(); ++i)
+					triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			[[nodiscard]] std::span<const uint32_t> Of(const uint32_t vertex) const noexcept {
+				return { triangles.data() + offsets[vertex], offsets[vertex + 1] - offsets[vertex] };
+			}
+		};
+
+		// Symmetric 4x4 error quadric (Garland & Heckbert)
+		struct Quadric {
+			double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+			double a11 = 0, a12 = 0, a13 = 0;
+			double a22 = 0, a23 = 0;
+			double a33 = 0;
+
+			static Quadric FromPlane(const double a, const double b, const double c, const double d, const double w) noexcept {
+				return { w * a * a, w * a * b, w * a * c, w * a * d, w * b * b, w * b * c, w * b * d, w * c * c, w * c * d, w * d * d };
+			}
+
+			Quadric& operator+=(const Quadric& q) noexcept {
+				a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+				a11 += q.a11; a12 += q.a12; a13 += q.a13;
+				a22 += q.a22; a23 += q.a23;
+				a33 += q.a33;
+				return *this;
+			}
+
+			[[nodiscard]] double Evaluate(const Float3& p) const noexcept {
+				const double x = p.x, y = p.y, z = p.z;
+				const double r = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+					+ a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+					+ a22 * z * z + 2 * a23 * z
+					+ a33;
+				return std::max(r, 0.0);
+			}
+		};
+
+		struct PositionKey {
+			uint32_t x, y, z;
+			bool operator==(const PositionKey&) const = default;
+		};
+
+		struct PositionKeyHash {
+			size_t operator()(const PositionKey& k) const noexcept {
+				return static_cast<size_t>((k.x * 73856093u) ^ (k.y * 19349663u) ^ (k.z * 83492791u));
+			}
+		};
+	}
+
+	float ComputeAcmr(const std::span<const uint32_t> indices, const uint32_t vertexCount, const uint32_t cacheSize) {
+		if (indices.size() < 3)
+			return 0.0f;
+
+		FifoCache cache(vertexCount, cacheSize);
+		uint32_t misses = 0;
+		for (const uint32_t v : indices)
+			misses += cache.Access(v);
+		return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+	}
+
+	std::vector<uint32_t> OptimizeVertexCache(const std::span<const uint32_t> indices, const uint32_t vertexCount,
+		std::vector<uint32_t>* clusters, const uint32_t cacheSize)
+	{
+		const size_t triangleCount = indices.size() / 3;
+
+		Adjacency adjacency;
+		adjacency.Build(indices, vertexCount);
+
+		// Triangles still to be emitted around each vertex
+		std::vector<uint32_t> live(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+			live[v] = static_cast<uint32_t>(adjacency.Of(v).size());
+
+		std::vector<uint32_t> loadTime(vertexCount, 0);
+		std::vector<uint8_t>  emitted(triangleCount, 0);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+		std::vector<uint32_t> result;
+		deadEnd.reserve(indices.size());
+		result.reserve(indices.size());
+
+		uint32_t time = cacheSize + 1;
+		uint32_t cursor = 0;
+		int64_t  fanning = triangleCount > 0 ? 0 : -1;
+		bool     flushed = true;
+
+		while (fanning >= 0) {
+			candidates.clear();
+
+			for (const uint32_t t : adjacency.Of(static_cast<uint32_t>(fanning))) {
+				if (emitted[t])
+					continue;
+
+				if (flushed && clusters) {
+					clusters->push_back(static_cast<uint32_t>(result.size() / 3));
+					flushed = false;
+				}
+
+				for (uint32_t k = 0; k < 3; ++k) {
+					const uint32_t v = indices[t * 3 + k];
+					result.push_back(v);
+					deadEnd.push_back(v);
+					candidates.push_back(v);
+					--live[v];
+					if (time - loadTime[v] > cacheSize)
+						loadTime[v] = time++;
+				}
+				emitted[t] = 1;
+			}
+
+			// Prefer the candidate that will still be cached after its remaining triangles are emitted,
+			// oldest first so it is used before being evicted
+			int64_t  next = -1;
+			int64_t  bestPriority = -1;
+			for (const uint32_t v : candidates) {
+				if (live[v] == 0)
+					continue;
+				int64_t priority = 0;
+				if (time - loadTime[v] + 2 * live[v] <= cacheSize)
+					priority = time - loadTime[v];
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					next = v;
+				}
+			}
+
+			if (next < 0) {
+				flushed = true;
+				while (!deadEnd.empty() && next < 0) {
+					const uint32_t v = deadEnd.back();
+					deadEnd.pop_back();
+					if (live[v] > 0)
+						next = v;
+				}
+				while (next < 0 && cursor < vertexCount) {
+					if (live[cursor] > 0)
+						next = cursor;
+					++cursor;
+				}
+			}
+
+			fanning = next;
+		}
+
+		return result;
+	}
+
+	void OptimizeOverdraw(const std::span<uint32_t> indices, const std::span<const uint32_t> clusters, const std::span<const Float3> positions,
+		const float threshold, const uint32_t cacheSize)
+	{
+		const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+		const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+		if (triangleCount == 0 || clusters.empty())
+			return;
+
+		// Cut hard clusters wherever the run so far is already as cache friendly as the whole mesh needs to be
+		const float targetAcmr = ComputeAcmr(indices, vertexCount, cacheSize) * threshold;
+
+		std::vector<uint32_t> starts;
+		FifoCache cache(vertexCount, cacheSize);
+		for (size_t c = 0; c < clusters.size(); ++c) {
+			const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+			uint32_t start = clusters[c];
+			uint32_t misses = 0;
+
+			starts.push_back(start);
+			cache.Flush();
+
+			for (uint32_t t = start; t < end; ++t) {
+				misses += cache.Access(indices[t * 3]) + cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]);
+
+				if (t + 1 < end && static_cast<float>(misses) <= targetAcmr * static_cast<float>(t - start + 1)) {
+					start = t + 1;
+					misses = 0;
+					starts.push_back(start);
+					cache.Flush();
+				}
+			}
+		}
+
+		// Sander et al.: draw clusters facing away from the mesh centroid first
+		const size_t clusterCount = starts.size();
+		std::vector<Float3> centroids(clusterCount, Float3{ 0, 0, 0 });
+		std::vector<Float3> normals(clusterCount, Float3{ 0, 0, 0 });
+		std::vector<float>  areas(clusterCount, 0.0f);
+		Float3 meshCentroid{ 0, 0, 0 };
+		float  meshArea = 0.0f;
+
+		for (size_t c = 0; c < clusterCount; ++c) {
+			const uint32_t end = c + 1 < clusterCount ? starts[c + 1] : triangleCount;
+			for (uint32_t t = starts[c]; t < end; ++t) {
+				const Float3& p0 = positions[indices[t * 3]];
+				const Float3& p1 = positions[indices[t * 3 + 1]];
+				const Float3& p2 = positions[indices[t * 3 + 2]];
+
+				const Float3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+				const float  area = Length(n);
+				const Float3 center{ (p0.x + p1.x + p2.x) / 3.0f, (p0.y + p1.y + p2.y) / 3.0f, (p0.z + p1.z + p2.z) / 3.0f };
+
+				centroids[c] = { centroids[c].x + center.x * area, centroids[c].y + center.y * area, centroids[c].z + center.z * area };
+				normals[c] = { normals[c].x + n.x, normals[c].y + n.y, normals[c].z + n.z };
+				areas[c] += area;
+			}
+
+			meshCentroid = { meshCentroid.x + centroids[c].x, meshCentroid.y + centroids[c].y, meshCentroid.z + centroids[c].z };
+			meshArea += areas[c];
+		}
+
+		if (meshArea <= 0.0f)
+			return;
+		meshCentroid = { meshCentroid.x / meshArea, meshCentroid.y / meshArea, meshCentroid.z / meshArea };
+
+		std::vector<float> sortKey(clusterCount, 0.0f);
+		for (size_t c = 0; c < clusterCount; ++c) {
+			if (areas[c] <= 0.0f)
+				continue;
+			const Float3 center{ centroids[c].x / areas[c], centroids[c].y / areas[c], centroids[c].z / areas[c] };
+			sortKey[c] = Dot(Sub(center, meshCentroid), Normalize(normals[c]));
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](const uint32_t a, const uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+		const std::vector<uint32_t> source(indices.begin(), indices.end());
+		size_t write = 0;
+		for (const uint32_t c : order) {
+			const uint32_t end = c + 1 < clusterCount ? starts[c + 1] : triangleCount;
+			for (uint32_t i = starts[c] * 3; i < end * 3; ++i)
+				indices[write++] = source[i];
+		}
+	}
+
+	uint32_t OptimizeVertexFetchRemap(const std::span<const uint32_t> indices, const std::span<uint32_t> remap) {
+		std::fill(remap.begin(), remap.end(), ~0u);
+
+		uint32_t next = 0;
+		for (const uint32_t v : indices) {
+			if (remap[v] == ~0u)
+				remap[v] = next++;
+		}
+		return next;
+	}
+
+	std::vector<uint32_t> Simplify(const std::span<const uint32_t> indices, const std::span<const Float3> positions,
+		const size_t targetIndexCount, const float targetError, float* resultError)
+	{
+		std::vector<uint32_t> result(indices.begin(), indices.end());
+		const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+		if (resultError)
+			*resultError = 0.0f;
+		if (result.size() <= targetIndexCount || vertexCount == 0)
+			return result;
+
+		Float3 lo = positions[0], hi = positions[0];
+		for (const Float3& p : positions) {
+			lo = { std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z) };
+			hi = { std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z) };
+		}
+		const double extent = std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z });
+		if (extent <= 0.0)
+			return result;
+
+		const double errorScale = 1.0 / (extent * extent);
+		const double errorLimit = static_cast<double>(targetError) * targetError;
+
+		// Corners sharing a position form a UV/normal seam; those, and open or non-manifold edges, stay put
+		std::vector<uint32_t> canonical(vertexCount);
+		std::vector<uint32_t> groupSize(vertexCount, 0);
+		{
+			std::unordered_map<PositionKey, uint32_t, PositionKeyHash> unique;
+			unique.reserve(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; ++v) {
+				const PositionKey key{ std::bit_cast<uint32_t>(positions[v].x), std::bit_cast<uint32_t>(positions[v].y), std::bit_cast<uint32_t>(positions[v].z) };
+				canonical[v] = unique.try_emplace(key, v).first->second;
+				++groupSize[canonical[v]];
+			}
+		}
+
+		std::vector<uint8_t> locked(vertexCount, 0);
+		{
+			std::unordered_map<uint64_t, uint32_t> edgeUse;
+			edgeUse.reserve(result.size());
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (uint32_t e = 0; e < 3; ++e) {
+					const uint32_t a = canonical[result[i + e]];
+					const uint32_t b = canonical[result[i + (e + 1) % 3]];
+					++edgeUse[uint64_t{ std::min(a, b) } << 32 | std::max(a, b)];
+				}
+			}
+
+			std::vector<uint8_t> border(vertexCount, 0);
+			for (const auto& [edge, uses] : edgeUse) {
+				if (uses != 2) {
+					border[edge >> 32] = 1;
+					border[edge & 0xFFFFFFFFu] = 1;
+				}
+			}
+
+			for (uint32_t v = 0; v < vertexCount; ++v)
+				locked[v] = groupSize[canonical[v]] > 1 || border[canonical[v]];
+		}
+
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < result.size(); i += 3) {
+			const Float3& p0 = positions[result[i]];
+			const Float3& p1 = positions[result[i + 1]];
+			const Float3& p2 = positions[result[i + 2]];
+
+			const Float3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+			const double length = Length(n);
+			if (length <= 0.0)
+				continue;
+
+			const double a = n.x / length, b = n.y / length, c = n.z / length;
+			const double d = -(a * p0.x + b * p0.y + c * p0.z);
+			const Quadric q = Quadric::FromPlane(a, b, c, d, length * 0.5);
+			for (uint32_t k = 0; k < 3; ++k)
+				quadrics[result[i + k]] += q;
+		}
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			double   cost;
+		};
+
+		Adjacency             adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint8_t>  touched(vertexCount);
+		double                maxError = 0.0;
+
+		// Rejects collapses that flip or badly skew a surrounding triangle
+		const auto flips = [&](const uint32_t from, const uint32_t to) {
+			for (const uint32_t t : adjacency.Of(from)) {
+				const uint32_t* tri = &result[t * 3];
+				if (tri[0] == to || tri[1] == to || tri[2] == to)
+					continue;
+
+				const uint32_t k = tri[0] == from ? 0 : tri[1] == from ? 1 : 2;
+				const Float3& b = positions[tri[(k + 1) % 3]];
+				const Float3& c = positions[tri[(k + 2) % 3]];
+
+				const Float3 before = Cross(Sub(b, positions[from]), Sub(c, positions[from]));
+				const Float3 after = Cross(Sub(b, positions[to]), Sub(c, positions[to]));
+				if (Dot(before, after) <= 0.25f * Length(before) * Length(after))
+					return true;
+			}
+			return false;
+		};
+
+		while (result.size() > targetIndexCount) {
+			adjacency.Build(result, vertexCount);
+
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (uint32_t e = 0; e < 3; ++e) {
+					const uint32_t a = result[i + e];
+					const uint32_t b = result[i + (e + 1) % 3];
+					if (!locked[a])
+						collapses.push_back({ a, b, quadrics[a].Evaluate(positions[b]) * errorScale });
+					if (!locked[b])
+						collapses.push_back({ b, a, quadrics[b].Evaluate(positions[a]) * errorScale });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+			std::iota(remap.begin(), remap.end(), 0u);
+			std::fill(touched.begin(), touched.end(), uint8_t{ 0 });
+
+			// Independent collapses only: once a vertex neighbourhood changed this pass, its costs are stale
+			const size_t toRemove = (result.size() - targetIndexCount + 2) / 3;
+			size_t removed = 0;
+			size_t applied = 0;
+
+			for (const Collapse& c : collapses) {
+				if (c.cost > errorLimit || removed >= toRemove)
+					break;
+				if (touched[c.from] || touched[c.to] || flips(c.from, c.to))
+					continue;
+
+				remap[c.from] = c.to;
+				quadrics[c.to] += quadrics[c.from];
+				maxError = std::max(maxError, c.cost);
+				++applied;
+
+				for (const uint32_t t : adjacency.Of(c.from)) {
+					const uint32_t* tri = &result[t * 3];
+					touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+					removed += tri[0] == c.to || tri[1] == c.to || tri[2] == c.to;
+				}
+			}
+
+			if (applied == 0)
+				break;
+
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3) {
+				const uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+				if (a != b && b != c && a != c) {
+					result[write++] = a;
+					result[write++] = b;
+					result[write++] = c;
+				}
+			}
+			result.resize(write);
+		}
+
+		if (resultError)
+			*resultError = static_cast<float>(std::sqrt(maxError));
+		return result;
+	}
+
+	void BuildMeshlets(const std::span<const uint32_t> indices, const uint32_t vertexCount, const uint32_t maxVertices, const uint32_t maxTriangles,
+		std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles)
+	{
+		if (maxVertices < 3 || maxVertices > MaxMeshletVertices || maxTriangles < 1 || maxTriangles > MaxMeshletTriangles)
+			throw std::invalid_argument("BuildMeshlets : meshlet limits out of range");
+
+		std::vector<uint32_t> local(vertexCount, ~0u);
+		Meshlet current{ static_cast<uint32_t>(meshletVertices.size()), static_cast<uint32_t>(meshletTriangles.size()), 0, 0 };
+
+		const auto finish = [&] {
+			for (uint32_t i = 0; i < current.vertexCount; ++i)
+				local[meshletVertices[current.vertexOffset + i]] = ~0u;
+			while (meshletTriangles.size() % 4 != 0)
+				meshletTriangles.push_back(0);
+
+			meshlets.push_back(current);
+			current = { static_cast<uint32_t>(meshletVertices.size()), static_cast<uint32_t>(meshletTriangles.size()), 0, 0 };
+		};
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			const uint32_t tri[3] = { indices[i], indices[i + 1], indices[i + 2] };
+			if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2])
+				continue;
+
+			const uint32_t added = (local[tri[0]] == ~0u) + (local[tri[1]] == ~0u) + (local[tri[2]] == ~0u);
+			if (current.vertexCount + added > maxVertices || current.triangleCount + 1 > maxTriangles)
+				finish();
+
+			for (const uint32_t v : tri) {
+				if (local[v] == ~0u) {
+					local[v] = current.vertexCount++;
+					meshletVertices.push_back(v);
+				}
+				meshletTriangles.push_back(static_cast<uint8_t>(local[v]));
+			}
+			++current.triangleCount;
+		}
+
+		if (current.triangleCount > 0)
+			finish();
+	}
+
+	MeshletBounds ComputeMeshletBounds(const Meshlet& meshlet, const std::span<const uint32_t> meshletVertices,
+		const std::span<const uint8_t> meshletTriangles, const std::span<const Float3> positions)
+	{
+		MeshletBounds bounds{};
+		bounds.coneCutoff = 1.0f;
+		if (meshlet.vertexCount == 0)
+			return bounds;
+
+		const auto vertex = [&](const uint32_t i) -> const Float3& { return positions[meshletVertices[meshlet.vertexOffset + i]]; };
+
+		Float3 lo = vertex(0), hi = vertex(0);
+		for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+			const Float3& p = vertex(i);
+			lo = { std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z) };
+			hi = { std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z) };
+		}
+		bounds.center = { (lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f };
+		for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+			bounds.radius = std::max(bounds.radius, Length(Sub(vertex(i), bounds.center)));
+
+		// Normal cone over the unit triangle normals
+		std::vector<std::pair<Float3, Float3>> triangles; // (normal, first corner)
+		triangles.reserve(meshlet.triangleCount);
+		Float3 axis{ 0, 0, 0 };
+		for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+			const uint8_t* tri = &meshletTriangles[meshlet.triangleOffset + t * 3];
+			const Float3& p0 = vertex(tri[0]);
+			const Float3 n = Cross(Sub(vertex(tri[1]), p0), Sub(vertex(tri[2]), p0));
+			if (Length(n) <= 0.0f)
+				continue;
+
+			const Float3 unit = Normalize(n);
+			triangles.emplace_back(unit, p0);
+			axis = { axis.x + unit.x, axis.y + unit.y, axis.z + unit.z };
+		}
+
+		axis = Normalize(axis);
+		bounds.coneAxis = axis;
+		bounds.coneApex = bounds.center;
+		if (triangles.empty())
+			return bounds;
+
+		float minDot = 1.0f;
+		for (const auto& [n, p] : triangles)
+			minDot = std::min(minDot, Dot(n, axis));
+
+		// Spread beyond ~84 degrees never culls anything useful
+		if (minDot <= 0.1f)
+			return bounds;
+
+		// Move the apex back until it lies behind every triangle plane
+		float maxT = 0.0f;
+		for (const auto& [n, p] : triangles)
+			maxT = std::max(maxT, Dot(Sub(bounds.center, p), n) / Dot(axis, n));
+
+		bounds.coneApex = { bounds.center.x - axis.x * maxT, bounds.center.y - axis.y * maxT, bounds.center.z - axis.z * maxT };
+		bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		return bounds;
+	}
+
+} // namespace Zenyth::Cook
@@ -0,0 +1,193 @@
+#include "pch.hpp"
+#include "ObjLoader.hpp"
+
+#include <charconv>
+
+namespace Zenyth::Cook {
+
+	namespace {
+		struct Corner {
+			int32_t position;
+			int32_t uv;
+			int32_t normal;
+
+			bool operator==(const Corner&) const = default;
+		};
+
+		struct CornerHash {
+			size_t operator()(const Corner& c) const noexcept {
+				uint64_t h = static_cast<uint32_t>(c.position);
+				h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(c.uv);
+				h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(c.normal);
+				return static_cast<size_t>(h ^ (h >> 29));
+			}
+		};
+
+		void SkipSpaces(std::string_view& s) noexcept {
+			while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+				s.remove_prefix(1);
+		}
+
+		bool ParseFloat(std::string_view& s, float& out) noexcept {
+			SkipSpaces(s);
+			const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+			if (ec != std::errc())
+				return false;
+			s.remove_prefix(static_cast<size_t>(end - s.data()));
+			return true;
+		}
+
+		bool ParseInt(std::string_view& s, int32_t& out) noexcept {
+			const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+			if (ec != std::errc())
+				return false;
+			s.remove_prefix(static_cast<size_t>(end - s.data()));
+			return true;
+		}
+
+		// OBJ indices are 1-based, negative ones count back from the last element; -1 means absent here
+		int32_t ResolveIndex(const int32_t index, const size_t count) noexcept {
+			if (index > 0 && static_cast<size_t>(index) <= count)
+				return index - 1;
+			if (index < 0 && static_cast<size_t>(-index) <= count)
+				return static_cast<int32_t>(count) + index;
+			return -2;
+		}
+
+		Float3 Sub(const Float3& a, const Float3& b) noexcept { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+		Float3 Cross(const Float3& a, const Float3& b) noexcept {
+			return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+		}
+	}
+
+	SourceMesh LoadObj(const std::filesystem::path& path) {
+		std::ifstream file(path);
+		if (!file)
+			throw std::runtime_error("LoadObj : cannot open " + path.string());
+
+		std::vector<Float3>   positions;
+		std::vector<Float3>   normals;
+		std::vector<std::array<float, 2>> uvs;
+		std::vector<Corner>   face;
+		std::vector<Corner>   corners;   // one per output vertex
+		std::unordered_map<Corner, uint32_t, CornerHash> welded;
+
+		SourceMesh mesh;
+		mesh.name = path.stem().string();
+
+		const auto fail = [&path](const size_t line, const char* what) {
+			throw std::runtime_error(path.string() + "(" + std::to_string(line) + ") : " + what);
+		};
+
+		std::string line;
+		for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber) {
+			std::string_view s = line;
+			SkipSpaces(s);
+
+			if (s.starts_with("v ")) {
+				s.remove_prefix(2);
+				Float3 p;
+				if (!ParseFloat(s, p.x) || !ParseFloat(s, p.y) || !ParseFloat(s, p.z))
+					fail(lineNumber, "malformed vertex");
+				positions.push_back(p);
+			}
+			else if (s.starts_with("vn ")) {
+				s.remove_prefix(3);
+				Float3 n;
+				if (!ParseFloat(s, n.x) || !ParseFloat(s, n.y) || !ParseFloat(s, n.z))
+					fail(lineNumber, "malformed normal");
+				normals.push_back(n);
+			}
+			else if (s.starts_with("vt ")) {
+				s.remove_prefix(3);
+				std::array<float, 2> uv;
+				if (!ParseFloat(s, uv[0]) || !ParseFloat(s, uv[1]))
+					fail(lineNumber, "malformed texture coordinate");
+				uvs.push_back(uv);
+			}
+			else if (s.starts_with("f ")) {
+				s.remove_prefix(2);
+				face.clear();
+
+				for (SkipSpaces(s); !s.empty() && s.front() != '\r'; SkipSpaces(s)) {
+					int32_t p = 0, t = 0, n = 0;
+					if (!ParseInt(s, p))
+						fail(lineNumber, "malformed face");
+					if (!s.empty() && s.front() == '/') {
+						s.remove_prefix(1);
+						if (!s.empty() && s.front() != '/' && !ParseInt(s, t))
+							fail(lineNumber, "malformed face");
+						if (!s.empty() && s.front() == '/') {
+							s.remove_prefix(1);
+							if (!ParseInt(s, n))
+								fail(lineNumber, "malformed face");
+						}
+					}
+
+					Corner corner{ ResolveIndex(p, positions.size()), t ? ResolveIndex(t, uvs.size()) : -1, n ? ResolveIndex(n, normals.size()) : -1 };
+					if (corner.position < 0 || corner.uv < -1 || corner.normal < -1)
+						fail(lineNumber, "face index out of range");
+					face.push_back(corner);
+				}
+
+				if (face.size() < 3)
+					fail(lineNumber, "face with fewer than 3 corners");
+
+				uint32_t ids[3];
+				for (size_t k = 0; k < face.size(); ++k) {
+					const auto [it, inserted] = welded.try_emplace(face[k], static_cast<uint32_t>(corners.size()));
+					if (inserted)
+						corners.push_back(face[k]);
+
+					// Fan triangulation around the first corner
+					if (k == 0)
+						ids[0] = it->second;
+					else if (k == 1)
+						ids[1] = it->second;
+					else {
+						ids[2] = it->second;
+						mesh.indices.insert(mesh.indices.end(), std::begin(ids), std::end(ids));
+						ids[1] = ids[2];
+					}
+				}
+			}
+		}
+
+		mesh.vertices.resize(corners.size());
+		bool missingNormals = false;
+		for (size_t i = 0; i < corners.size(); ++i) {
+			const Corner& c = corners[i];
+			SourceVertex& v = mesh.vertices[i];
+			v.position = positions[c.position];
+			v.normal = c.normal >= 0 ? normals[c.normal] : Float3{ 0.0f, 0.0f, 0.0f };
+			v.uv[0] = c.uv >= 0 ? uvs[c.uv][0] : 0.0f;
+			v.uv[1] = c.uv >= 0 ? 1.0f - uvs[c.uv][1] : 0.0f; // OBJ has v pointing up
+			missingNormals |= c.normal < 0;
+		}
+
+		if (missingNormals) {
+			// Smooth normals shared by every corner at the same position
+			std::vector<Float3> accum(positions.size(), Float3{ 0.0f, 0.0f, 0.0f });
+			for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+				const Corner* c[3] = { &corners[mesh.indices[i]], &corners[mesh.indices[i + 1]], &corners[mesh.indices[i + 2]] };
+				const Float3 n = Cross(Sub(positions[c[1]->position], positions[c[0]->position]), Sub(positions[c[2]->position], positions[c[0]->position]));
+				for (const Corner* corner : c) {
+					accum[corner->position].x += n.x;
+					accum[corner->position].y += n.y;
+					accum[corner->position].z += n.z;
+				}
+			}
+
+			for (size_t i = 0; i < corners.size(); ++i) {
+				if (corners[i].normal >= 0)
+					continue;
+				const Float3& n = accum[corners[i].position];
+				const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+				mesh.vertices[i].normal = length > 0.0f ? Float3{ n.x / length, n.y / length, n.z / length } : Float3{ 0.0f, 1.0f, 0.0f };
+			}
+		}
+
+		return mesh;
+	}
+
+} // namespace Zenyth::Cook
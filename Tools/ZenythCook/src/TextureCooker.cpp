@@ -0,0 +1,87 @@
+#include "pch.hpp"
+#include "TextureCooker.hpp"
+
+namespace Zenyth::Cook {
+
+	namespace {
+		bool HasAlpha(const Image& image) noexcept {
+			for (size_t i = 3; i < image.pixels.size(); i += 4) {
+				if (image.pixels[i] != 255)
+					return true;
+			}
+			return false;
+		}
+
+		TextureFormat ToTextureFormat(const TextureTarget target, const bool srgb) noexcept {
+			switch (target) {
+				case TextureTarget::BC1:   return srgb ? TextureFormat::BC1_SRGB : TextureFormat::BC1;
+				case TextureTarget::BC3:   return srgb ? TextureFormat::BC3_SRGB : TextureFormat::BC3;
+				case TextureTarget::BC4:   return TextureFormat::BC4;
+				case TextureTarget::BC5:   return TextureFormat::BC5;
+				case TextureTarget::BC7:   return srgb ? TextureFormat::BC7_SRGB : TextureFormat::BC7;
+				default:                   return srgb ? TextureFormat::RGBA8_SRGB : TextureFormat::RGBA8;
+			}
+		}
+
+		BlockFormat ToBlockFormat(const TextureTarget target) noexcept {
+			switch (target) {
+				case TextureTarget::BC1: return BlockFormat::BC1;
+				case TextureTarget::BC3: return BlockFormat::BC3;
+				case TextureTarget::BC4: return BlockFormat::BC4;
+				case TextureTarget::BC5: return BlockFormat::BC5;
+				default:                 return BlockFormat::BC7;
+			}
+		}
+	}
+
+	CookedTexture CookTexture(std::string name, const Image& image, const TextureCookSettings& settings, JobSystem* jobs) {
+		if (image.width == 0 || image.height == 0)
+			throw std::runtime_error("CookTexture : empty image");
+
+		TextureTarget target = settings.format;
+		if (target == TextureTarget::Auto)
+			target = HasAlpha(image) ? TextureTarget::BC3 : TextureTarget::BC1;
+
+		const bool srgb = settings.srgb && target != TextureTarget::BC4 && target != TextureTarget::BC5;
+
+		MipSettings mipSettings;
+		mipSettings.filter = settings.mipFilter;
+		mipSettings.srgb = srgb;
+		const std::vector<Image> mips = settings.mips ? GenerateMips(image.View(), mipSettings, jobs) : std::vector<Image>{};
+
+		CookedTexture cooked;
+		cooked.name = std::move(name);
+		cooked.header.width = image.width;
+		cooked.header.height = image.height;
+		cooked.header.arraySize = 1;
+		cooked.header.mipCount = static_cast<uint32_t>(mips.size() + 1);
+		cooked.header.format = ToTextureFormat(target, srgb);
+
+		for (uint32_t level = 0; level < cooked.header.mipCount; ++level) {
+			const Image& src = level == 0 ? image : mips[level - 1];
+			std::vector<std::byte>& out = cooked.levels.emplace_back();
+
+			if (target == TextureTarget::RGBA8) {
+				out.resize(src.pixels.size());
+				std::memcpy(out.data(), src.pixels.data(), out.size());
+				cooked.rowPitches.push_back(src.width * 4);
+				cooked.rowCounts.push_back(src.height);
+				continue;
+			}
+
+			const BlockFormat format = ToBlockFormat(target);
+			out.resize(CompressedSize(format, src.width, src.height));
+			CompressImage(src.View(), format, settings.quality, out, jobs);
+			cooked.rowPitches.push_back((src.width + 3) / 4 * BlockBytes(format));
+			cooked.rowCounts.push_back((src.height + 3) / 4);
+		}
+
+		return cooked;
+	}
+
+	void CookedTexture::AddTo(AssetPackWriter& writer) const {
+		std::vector<std::span<const std::byte>> subresources(levels.begin(), levels.end());
+		writer.AddTexture(name, header, subresources, rowPitches, rowCounts);
+	}
+
+} // namespace Zenyth::Cook
@@ -0,0 +1,126 @@
+#include "pch.hpp"
+#include "TgaLoader.hpp"
+
+namespace Zenyth::Cook {
+
+	namespace {
+		enum TgaImageType : uint8_t {
+			TrueColor = 2,
+			Grey = 3,
+			RleTrueColor = 10,
+			RleGrey = 11,
+		};
+
+#pragma pack(push, 1)
+		struct TgaHeader {
+			uint8_t  idLength;
+			uint8_t  colorMapType;
+			uint8_t  imageType;
+			uint16_t colorMapStart;
+			uint16_t colorMapLength;
+			uint8_t  colorMapDepth;
+			uint16_t originX;
+			uint16_t originY;
+			uint16_t width;
+			uint16_t height;
+			uint8_t  bitsPerPixel;
+			uint8_t  descriptor;
+		};
+#pragma pack(pop)
+
+		static_assert(sizeof(TgaHeader) == 18);
+
+		// TGA stores BGR(A)
+		void ToRgba(const uint8_t* src, const uint32_t bytesPerPixel, uint8_t* dst) noexcept {
+			if (bytesPerPixel == 1) {
+				dst[0] = dst[1] = dst[2] = src[0];
+				dst[3] = 255;
+				return;
+			}
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = bytesPerPixel == 4 ? src[3] : 255;
+		}
+	}
+
+	Image LoadTga(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(path.string() + " : cannot open");
+
+		const std::vector<uint8_t> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+		const auto fail = [&](const char* message) { throw std::runtime_error(path.string() + " : " + message); };
+
+		if (data.size() < sizeof(TgaHeader))
+			fail("truncated header");
+
+		TgaHeader header;
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		const bool grey = header.imageType == Grey || header.imageType == RleGrey;
+		const bool rle = header.imageType == RleTrueColor || header.imageType == RleGrey;
+		if (header.colorMapType != 0 || (!grey && header.imageType != TrueColor && header.imageType != RleTrueColor))
+			fail("unsupported image type (color mapped images are not supported)");
+		if ((grey && header.bitsPerPixel != 8) || (!grey && header.bitsPerPixel != 24 && header.bitsPerPixel != 32))
+			fail("unsupported bit depth");
+		if (header.width == 0 || header.height == 0)
+			fail("empty image");
+
+		const uint32_t bytesPerPixel = header.bitsPerPixel / 8u;
+		const size_t   pixelCount = static_cast<size_t>(header.width) * header.height;
+
+		Image image(header.width, header.height);
+		std::vector<uint8_t> decoded(pixelCount * 4);
+
+		size_t pos = sizeof(TgaHeader) + header.idLength;
+		const auto need = [&](const size_t bytes) {
+			if (pos + bytes > data.size())
+				fail("truncated pixel data");
+		};
+
+		if (!rle) {
+			need(pixelCount * bytesPerPixel);
+			for (size_t i = 0; i < pixelCount; ++i, pos += bytesPerPixel)
+				ToRgba(&data[pos], bytesPerPixel, &decoded[i * 4]);
+		}
+		else {
+			// Packets: high bit set repeats one pixel, clear copies raw pixels; count is low 7 bits + 1
+			for (size_t i = 0; i < pixelCount;) {
+				need(1);
+				const uint8_t packet = data[pos++];
+				const size_t  count = std::min<size_t>((packet & 0x7F) + 1u, pixelCount - i);
+
+				if (packet & 0x80) {
+					need(bytesPerPixel);
+					for (size_t k = 0; k < count; ++k)
+						ToRgba(&data[pos], bytesPerPixel, &decoded[(i + k) * 4]);
+					pos += bytesPerPixel;
+				}
+				else {
+					need(count * bytesPerPixel);
+					for (size_t k = 0; k < count; ++k, pos += bytesPerPixel)
+						ToRgba(&data[pos], bytesPerPixel, &decoded[(i + k) * 4]);
+				}
+				i += count;
+			}
+		}
+
+		// Descriptor bit 5: rows stored top to bottom; bit 4: right to left
+		const bool topDown = header.descriptor & 0x20;
+		const bool rightToLeft = header.descriptor & 0x10;
+		for (uint32_t y = 0; y < image.height; ++y) {
+			const uint8_t* src = &decoded[static_cast<size_t>(topDown ? y : image.height - 1 - y) * image.width * 4];
+			uint8_t*       dst = image.Row(y);
+			if (!rightToLeft) {
+				std::memcpy(dst, src, static_cast<size_t>(image.width) * 4);
+				continue;
+			}
+			for (uint32_t x = 0; x < image.width; ++x)
+				std::memcpy(dst + x * 4, src + (image.width - 1 - x) * 4, 4);
+		}
+
+		return image;
+	}
+
+} // namespace Zenyth::Cook
@@ -0,0 +1,397 @@
+#include "pch.hpp"
+#include "CookCache.hpp"
+#include "JobSystem.hpp"
+#include "MeshCooker.hpp"
+#include "ObjLoader.hpp"
+#include "TextureCooker.hpp"
+#include "TgaLoader.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+
+namespace {
+
+	struct Options {
+		std::vector<std::filesystem::path> inputs;
+		std::filesystem::path              output = "assets.zpak";
+		std::filesystem::path              cache;   // empty: next to the output
+		bool                               useCache = true;
+		bool                               pruneCache = false;
+		Zenyth::Cook::MeshCookSettings     mesh;
+		Zenyth::Cook::TextureCookSettings  texture;
+		uint32_t                           jobs = 0;
+		bool                               verbose = false;
+	};
+
+	enum class InputKind : uint8_t {
+		Mesh,
+		Texture,
+	};
+
+	struct Input {
+		std::filesystem::path path;
+		std::string           name; // asset name in the pack
+		InputKind             kind;
+	};
+
+	void PrintUsage() {
+		std::cout <<
+			"Usage: ZenythCook [options] <mesh.obj | texture.tga | directory>...\n"
+			"\n"
+			"Cooks meshes and textures into a .zpak. Directories are searched recursively for .obj and .tga files;\n"
+			"assets are named by their path relative to the directory, without extension.\n"
+			"\n"
+			"  -o, --output <file>          output pack (default: assets.zpak)\n"
+			"  --cache <dir>                incremental cook cache (default: <output>.cache)\n"
+			"  --no-cache                   cook every input and write the pack directly\n"
+			"  --prune-cache                drop cached outputs this cook did not use\n"
+			"  --lods <n>                   levels of detail including the source, 1-8 (default: 4)\n"
+			"  --lod-ratio <r>              triangle ratio between consecutive levels (default: 0.5)\n"
+			"  --lod-error <e>              max simplification error relative to mesh size (default: 0.05)\n"
+			"  --meshlet-vertices <n>       max vertices per meshlet, up to 255 (default: 64)\n"
+			"  --meshlet-triangles <n>      max triangles per meshlet, up to 512 (default: 124)\n"
+			"  --no-meshlets                skip meshlet generation\n"
+			"  --no-quantize                keep float vertices\n"
+			"  --texture-format <f>         auto, bc1, bc3, bc4, bc5, bc7 or rgba8 (default: auto, BC1 or BC3 by alpha)\n"
+			"  --quality <q>                block compression effort: fast, normal or high (default: normal)\n"
+			"  --linear                     textures hold data rather than sRGB color\n"
+			"  --mip-filter <f>             box or kaiser (default: kaiser)\n"
+			"  --no-mips                    keep only the base level\n"
+			"  -j, --jobs <n>               worker threads (default: one per core)\n"
+			"  -v, --verbose                print per-mesh statistics\n";
+	}
+
+	template<typename T>
+	T ParseNumber(const std::string_view option, const std::string_view text) {
+		T value{};
+		const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (ec != std::errc() || end != text.data() + text.size())
+			throw std::runtime_error("invalid value '" + std::string(text) + "' for " + std::string(option));
+		return value;
+	}
+
+	Zenyth::Cook::TextureTarget ParseTextureFormat(const std::string_view text) {
+		if (text == "auto")  return Zenyth::Cook::TextureTarget::Auto;
+		if (text == "bc1")   return Zenyth::Cook::TextureTarget::BC1;
+		if (text == "bc3")   return Zenyth::Cook::TextureTarget::BC3;
+		if (text == "bc4")   return Zenyth::Cook::TextureTarget::BC4;
+		if (text == "bc5")   return Zenyth::Cook::TextureTarget::BC5;
+		if (text == "bc7")   return Zenyth::Cook::TextureTarget::BC7;
+		if (text == "rgba8") return Zenyth::Cook::TextureTarget::RGBA8;
+		throw std::runtime_error("unknown texture format '" + std::string(text) + "'");
+	}
+
+	Zenyth::CompressionQuality ParseQuality(const std::string_view text) {
+		if (text == "fast")   return Zenyth::CompressionQuality::Fast;
+		if (text == "normal") return Zenyth::CompressionQuality::Normal;
+		if (text == "high")   return Zenyth::CompressionQuality::High;
+		throw std::runtime_error("unknown quality '" + std::string(text) + "'");
+	}
+
+	Zenyth::MipFilter ParseMipFilter(const std::string_view text) {
+		if (text == "box")    return Zenyth::MipFilter::Box;
+		if (text == "kaiser") return Zenyth::MipFilter::Kaiser;
+		throw std::runtime_error("unknown mip filter '" + std::string(text) + "'");
+	}
+
+	Options ParseArguments(const int argc, char** argv) {
+		Options options;
+
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg = argv[i];
+			const auto value = [&]() -> std::string_view {
+				if (i + 1 >= argc)
+					throw std::runtime_error("missing value for " + std::string(arg));
+				return argv[++i];
+			};
+
+			if (arg == "-h" || arg == "--help") {
+				PrintUsage();
+				std::exit(0);
+			}
+			else if (arg == "-o" || arg == "--output")         options.output = value();
+			else if (arg == "--cache")                         options.cache = value();
+			else if (arg == "--no-cache")                      options.useCache = false;
+			else if (arg == "--prune-cache")                   options.pruneCache = true;
+			else if (arg == "--lods")                          options.mesh.lodCount = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--lod-ratio")                     options.mesh.lodRatio = ParseNumber<float>(arg, value());
+			else if (arg == "--lod-error")                     options.mesh.lodMaxError = ParseNumber<float>(arg, value());
+			else if (arg == "--meshlet-vertices")              options.mesh.meshletMaxVertices = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--meshlet-triangles")             options.mesh.meshletMaxTriangles = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "--no-meshlets")                   options.mesh.meshlets = false;
+			else if (arg == "--no-quantize")                   options.mesh.quantize = false;
+			else if (arg == "--texture-format")                options.texture.format = ParseTextureFormat(value());
+			else if (arg == "--quality")                       options.texture.quality = ParseQuality(value());
+			else if (arg == "--linear")                        options.texture.srgb = false;
+			else if (arg == "--mip-filter")                    options.texture.mipFilter = ParseMipFilter(value());
+			else if (arg == "--no-mips")                       options.texture.mips = false;
+			else if (arg == "-j" || arg == "--jobs")           options.jobs = ParseNumber<uint32_t>(arg, value());
+			else if (arg == "-v" || arg == "--verbose")        options.verbose = true;
+			else if (arg.starts_with("-"))
+				throw std::runtime_error("unknown option " + std::string(arg));
+			else
+				options.inputs.emplace_back(arg);
+		}
+
+		if (options.inputs.empty())
+			throw std::runtime_error("no inputs");
+		if (options.cache.empty())
+			options.cache = options.output.string() + ".cache";
+		if (options.mesh.lodCount < 1 || options.mesh.lodCount > 8)
+			throw std::runtime_error("--lods must be between 1 and 8");
+		if (options.mesh.lodRatio <= 0.0f || options.mesh.lodRatio >= 1.0f)
+			throw std::runtime_error("--lod-ratio must be between 0 and 1");
+		if (options.mesh.meshletMaxVertices < 3 || options.mesh.meshletMaxVertices > 255
+			|| options.mesh.meshletMaxTriangles < 1 || options.mesh.meshletMaxTriangles > 512)
+			throw std::runtime_error("meshlet limits out of range");
+
+		return options;
+	}
+
+	std::vector<Input> GatherInputs(const std::vector<std::filesystem::path>& paths) {
+		std::vector<Input> inputs;
+
+		const auto kindOf = [](const std::filesystem::path& p) -> std::optional<InputKind> {
+			std::string ext = p.extension().string();
+			std::transform(ext.begin(), ext.end(), ext.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			if (ext == ".obj")
+				return InputKind::Mesh;
+			if (ext == ".tga")
+				return InputKind::Texture;
+			return std::nullopt;
+		};
+
+		for (const std::filesystem::path& path : paths) {
+			if (std::filesystem::is_directory(path)) {
+				std::vector<Input> found;
+				for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+					if (!entry.is_regular_file())
+						continue;
+					if (const auto kind = kindOf(entry.path()))
+						found.push_back({ entry.path(), std::filesystem::relative(entry.path(), path).replace_extension().generic_string(), *kind });
+				}
+				// Directory iteration order is unspecified; keep packs reproducible
+				std::sort(found.begin(), found.end(), [](const Input& a, const Input& b) { return a.name < b.name; });
+				inputs.insert(inputs.end(), found.begin(), found.end());
+			}
+			else if (std::filesystem::is_regular_file(path)) {
+				const auto kind = kindOf(path);
+				if (!kind)
+					throw std::runtime_error("unsupported input type: " + path.string());
+				inputs.push_back({ path, path.stem().generic_string(), *kind });
+			}
+			else {
+				throw std::runtime_error("input not found: " + path.string());
+			}
+		}
+
+		return inputs;
+	}
+
+	// Everything an input's cooked bytes depend on
+	Zenyth::Cook::ContentHash CookKey(const Input& input, const Options& options, Zenyth::Cook::CookCache& cache) {
+		Zenyth::Cook::Hasher hasher;
+		hasher.Add(Zenyth::Cook::CookerVersion);
+		hasher.Add(Zenyth::PackVersion);
+		hasher.Add(input.kind);
+
+		if (input.kind == InputKind::Mesh) {
+			const Zenyth::Cook::MeshCookSettings& mesh = options.mesh;
+			hasher.Add(mesh.lodCount);
+			hasher.Add(mesh.lodRatio);
+			hasher.Add(mesh.lodMaxError);
+			hasher.Add(mesh.meshlets);
+			hasher.Add(mesh.meshletMaxVertices);
+			hasher.Add(mesh.meshletMaxTriangles);
+			hasher.Add(mesh.quantize);
+		}
+		else {
+			const Zenyth::Cook::TextureCookSettings& texture = options.texture;
+			hasher.Add(texture.format);
+			hasher.Add(texture.quality);
+			hasher.Add(texture.srgb);
+			hasher.Add(texture.mips);
+			hasher.Add(texture.mipFilter);
+		}
+
+		hasher.Add(cache.HashSource(input.path));
+		return hasher.Finish();
+	}
+
+	int Cook(const Options& options) {
+		const std::vector<Input> inputs = GatherInputs(options.inputs);
+
+		std::unordered_set<std::string> names;
+		for (const Input& input : inputs) {
+			if (!names.insert(input.name).second)
+				throw std::runtime_error("duplicate asset name " + input.name);
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+
+		// One mesh or texture per job; the calling thread takes part, so -j 1 needs no workers at all
+		std::optional<Zenyth::JobSystem> jobs;
+		if (options.jobs != 1)
+			jobs.emplace(options.jobs > 1 ? options.jobs - 1 : 0);
+		Zenyth::JobSystem* jobSystem = jobs ? &*jobs : nullptr;
+
+		std::optional<Zenyth::Cook::CookCache> cache;
+		if (options.useCache)
+			cache.emplace(options.cache);
+
+		std::vector<Zenyth::Cook::CookedMesh>    cookedMeshes(inputs.size());
+		std::vector<Zenyth::Cook::CookedTexture> cookedTextures(inputs.size());
+		std::vector<std::string>                 errors(inputs.size());
+		// With a cache every output ends up in the store, whether it was cooked now or before
+		std::vector<Zenyth::Cook::CookCache::Entry> entries(inputs.size());
+		std::vector<uint8_t>                        cooked(inputs.size(), 0);
+
+		// Only inputs whose key is unknown get cooked, so unchanged assets cost a stat (or a hash
+		// when touched) and a lookup
+		const auto cook = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				try {
+					Zenyth::Cook::ContentHash key;
+					if (cache) {
+						key = CookKey(inputs[i], options, *cache);
+						if (const auto entry = cache->Find(key)) {
+							entries[i] = *entry;
+							continue;
+						}
+					}
+
+					cooked[i] = 1;
+					if (inputs[i].kind == InputKind::Mesh) {
+						Zenyth::Cook::SourceMesh mesh = Zenyth::Cook::LoadObj(inputs[i].path);
+						mesh.name = inputs[i].name;
+						cookedMeshes[i] = Zenyth::Cook::CookMesh(mesh, options.mesh);
+					}
+					else {
+						// Block rows of a texture fan out again, so one large texture does not serialize the cook
+						const Zenyth::Image image = Zenyth::Cook::LoadTga(inputs[i].path);
+						cookedTextures[i] = Zenyth::Cook::CookTexture(inputs[i].name, image, options.texture, jobSystem);
+					}
+
+					if (cache) {
+						Zenyth::AssetPackWriter single;
+						if (inputs[i].kind == InputKind::Mesh)
+							cookedMeshes[i].AddTo(single);
+						else
+							cookedTextures[i].AddTo(single);
+						entries[i] = cache->Store(key, single.GetType(0), single.GetPayload(0));
+					}
+				}
+				catch (const std::exception& e) {
+					errors[i] = e.what();
+				}
+			}
+		};
+
+		if (jobs)
+			jobs->ParallelFor(static_cast<uint32_t>(inputs.size()), 1, cook);
+		else
+			cook(0, static_cast<uint32_t>(inputs.size()));
+
+		size_t failures = 0;
+		Zenyth::AssetPackWriter writer;
+		Zenyth::Cook::Hasher    bundleKey;
+		bundleKey.Add(Zenyth::PackVersion);
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			if (!errors[i].empty()) {
+				std::cerr << "error: " << inputs[i].path.string() << ": " << errors[i] << "\n";
+				++failures;
+				continue;
+			}
+
+			// Stored outputs go into the pack straight from their mapping
+			if (cache) {
+				writer.AddMapped(inputs[i].name, entries[i].type, cache->Map(entries[i]));
+				bundleKey.Update(inputs[i].name);
+				bundleKey.Add(entries[i].type);
+				bundleKey.Add(entries[i].object);
+			}
+
+			if (!cooked[i]) {
+				if (options.verbose)
+					std::cout << inputs[i].name << ": cached\n";
+				continue;
+			}
+
+			if (inputs[i].kind == InputKind::Texture) {
+				const Zenyth::Cook::CookedTexture& texture = cookedTextures[i];
+				if (!cache)
+					texture.AddTo(writer);
+
+				if (options.verbose) {
+					size_t bytes = 0;
+					for (const auto& level : texture.levels)
+						bytes += level.size();
+					std::cout << texture.name << ": " << texture.header.width << "x" << texture.header.height << ", "
+						<< texture.header.mipCount << " mips, format " << static_cast<uint32_t>(texture.header.format) << ", " << bytes << " bytes\n";
+				}
+				continue;
+			}
+
+			const Zenyth::Cook::CookedMesh& mesh = cookedMeshes[i];
+			if (!cache)
+				mesh.AddTo(writer);
+
+			if (options.verbose) {
+				const auto& s = mesh.stats;
+				std::cout << std::fixed << std::setprecision(3)
+					<< mesh.name << ": " << s.sourceTriangles << " tris, " << s.sourceVertices << " -> " << s.vertices << " verts, "
+					<< "acmr " << s.acmrBefore << " -> " << s.acmrAfter << ", lods";
+				for (size_t l = 0; l < mesh.lods.size(); ++l)
+					std::cout << " " << s.lodTriangles[l];
+				std::cout << ", " << mesh.meshlets.size() << " meshlets\n";
+			}
+		}
+
+		if (failures > 0) {
+			// What did cook is kept, so the next attempt only redoes the failures
+			if (cache)
+				cache->Save();
+			std::cerr << failures << " of " << inputs.size() << " inputs failed, " << options.output.string() << " not written\n";
+			return 1;
+		}
+
+		bool written = true;
+		if (cache) {
+			written = cache->Publish(bundleKey.Finish(), writer, options.output);
+			if (options.pruneCache)
+				cache->Prune();
+			cache->Save();
+		}
+		else {
+			// Replace rather than write through: after a cached cook the output is a hard link to
+			// the cache's bundle
+			const std::filesystem::path temp = options.output.string() + ".tmp";
+			writer.Write(temp);
+			std::filesystem::rename(temp, options.output);
+		}
+
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << (written ? "Cooked " : "Up to date: ") << writer.EntryCount() << " assets in " << options.output.string()
+			<< " in " << std::fixed << std::setprecision(2) << seconds << "s using " << (jobs ? jobs->ThreadCount() : 1) << " threads";
+		if (cache) {
+			const auto stats = cache->Stats();
+			std::cout << " (" << stats.misses << " cooked, " << stats.hits << " cached, " << stats.sourcesHashed << " sources hashed)";
+		}
+		std::cout << "\n";
+		return 0;
+	}
+
+}
+
+int main(const int argc, char** argv) {
+	try {
+		return Cook(ParseArguments(argc, argv));
+	}
+	catch (const std::exception& e) {
+		std::cerr << "ZenythCook: " << e.what() << "\n";
+		if (argc < 2)
+			PrintUsage();
+		return 1;
+	}
+}